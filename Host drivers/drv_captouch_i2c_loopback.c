@@ -0,0 +1,204 @@
+/****************************************************************************************
+  I2C Capacitive Touch Driver: i2c-dev Loopback
+
+  File Name:
+    drv_captouch_i2c_loopback.c
+
+  Summary:
+    Host stand-in for /dev/i2c-N on top of the simulated I2C controller.
+
+  Description:
+    Messages are run with the blocking fsl_i2c master calls the way the kernel
+    i2c core runs them: a START before the first message, a repeated START
+    between messages and one STOP at the end. With SetSmbusOnly the adapter
+    reports the functionality of the i2c-stub module, which has no I2C_RDWR.
+ ***************************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include <errno.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+#include "drv_captouch_i2c.h"
+#include "drv_captouch_i2c_loopback.h"
+#include "fsl_i2c_sim.h"
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Defines
+
+#define LOOPBACK_FD                 0x7C0   // never handed out by the host kernel for this process
+#define LOOPBACK_FUNCS_I2C          (I2C_FUNC_I2C | I2C_FUNC_SMBUS_I2C_BLOCK)
+#define LOOPBACK_FUNCS_STUB         (I2C_FUNC_SMBUS_QUICK | I2C_FUNC_SMBUS_BYTE | I2C_FUNC_SMBUS_BYTE_DATA | \
+                                     I2C_FUNC_SMBUS_WORD_DATA | I2C_FUNC_SMBUS_I2C_BLOCK)
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Variables
+
+static bool loopbackOpen = false;
+static bool loopbackSmbusOnly = false;
+static uint16_t loopbackAddress = 0;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+
+static bool LOOPBACK_Start(bool repeated, uint16_t address, i2c_direction_t direction)
+{
+    if(repeated)
+        I2C_MasterRepeatedStart(I2C_BASEADDR, address, direction);
+    else
+        I2C_MasterStart(I2C_BASEADDR, address, direction);
+
+    return !(I2C_BASEADDR->I2SR & kI2C_ReceiveNakFlag);
+}
+
+static int LOOPBACK_Rdwr(struct i2c_rdwr_ioctl_data *xfer)
+{
+    if(loopbackSmbusOnly){
+        errno = EOPNOTSUPP;
+        return -1;
+    }
+
+    if(xfer->nmsgs == 0 || xfer->nmsgs > I2C_RDWR_IOCTL_MAX_MSGS){
+        errno = EINVAL;
+        return -1;
+    }
+
+    for(uint32_t i = 0; i < xfer->nmsgs; i++){
+        struct i2c_msg *msg = &xfer->msgs[i];
+        i2c_direction_t direction = (msg->flags & I2C_M_RD) ? kI2C_Read : kI2C_Write;
+
+        if(!LOOPBACK_Start(i > 0, msg->addr, direction)){
+            I2C_MasterStop(I2C_BASEADDR);
+            errno = ENXIO;
+            return -1;
+        }
+
+        if(direction == kI2C_Read){
+            I2C_MasterReadBlocking(I2C_BASEADDR, msg->buf, msg->len, kI2C_TransferNoStopFlag);
+        }else if(I2C_MasterWriteBlocking(I2C_BASEADDR, msg->buf, msg->len, kI2C_TransferNoStopFlag) != kStatus_Success){
+            // fsl_i2c already released the bus
+            errno = EREMOTEIO;
+            return -1;
+        }
+    }
+
+    I2C_MasterStop(I2C_BASEADDR);
+
+    return xfer->nmsgs;
+}
+
+static int LOOPBACK_Smbus(struct i2c_smbus_ioctl_data *args)
+{
+    uint8_t command = args->command;
+    uint8_t len;
+
+    if(args->size != I2C_SMBUS_I2C_BLOCK_DATA){
+        errno = EOPNOTSUPP;
+        return -1;
+    }
+
+    len = args->data->block[0];
+    if(len == 0 || len > I2C_SMBUS_BLOCK_MAX){
+        errno = EINVAL;
+        return -1;
+    }
+
+    if(!LOOPBACK_Start(false, loopbackAddress, kI2C_Write)){
+        I2C_MasterStop(I2C_BASEADDR);
+        errno = ENXIO;
+        return -1;
+    }
+
+    if(args->read_write == I2C_SMBUS_READ){
+        if(I2C_MasterWriteBlocking(I2C_BASEADDR, &command, 1, kI2C_TransferNoStopFlag) != kStatus_Success
+           || !LOOPBACK_Start(true, loopbackAddress, kI2C_Read)){
+            I2C_MasterStop(I2C_BASEADDR);
+            errno = EREMOTEIO;
+            return -1;
+        }
+        I2C_MasterReadBlocking(I2C_BASEADDR, &args->data->block[1], len, kI2C_TransferDefaultFlag);
+    }else{
+        if(I2C_MasterWriteBlocking(I2C_BASEADDR, &command, 1, kI2C_TransferNoStopFlag) != kStatus_Success
+           || I2C_MasterWriteBlocking(I2C_BASEADDR, &args->data->block[1], len, kI2C_TransferDefaultFlag) != kStatus_Success){
+            errno = EREMOTEIO;
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Loopback Functions
+
+int DRV_CAPTOUCH_I2C_LOOPBACK_Open(const char *path)
+{
+    if(loopbackOpen){
+        errno = EBUSY;
+        return -1;
+    }
+
+    // The kernel adapter runs at the bus frequency from the device tree
+    I2C_SimSetBusClock(I2C_BASEADDR, I2C_BAUDRATE);
+    loopbackAddress = 0;
+    loopbackOpen = true;
+
+    return LOOPBACK_FD;
+}
+
+int DRV_CAPTOUCH_I2C_LOOPBACK_Ioctl(int fd, unsigned long request, unsigned long arg)
+{
+    if(!loopbackOpen || fd != LOOPBACK_FD){
+        errno = EBADF;
+        return -1;
+    }
+
+    switch(request){
+      case I2C_FUNCS:
+        *(unsigned long *)arg = loopbackSmbusOnly ? LOOPBACK_FUNCS_STUB : LOOPBACK_FUNCS_I2C;
+        return 0;
+      case I2C_SLAVE:
+      case I2C_SLAVE_FORCE:
+        if(arg > 0x7F){
+            errno = EINVAL;
+            return -1;
+        }
+        loopbackAddress = (uint16_t)arg;
+        return 0;
+      case I2C_RDWR:
+        return LOOPBACK_Rdwr((struct i2c_rdwr_ioctl_data *)arg);
+      case I2C_SMBUS:
+        return LOOPBACK_Smbus((struct i2c_smbus_ioctl_data *)arg);
+      default:
+        errno = ENOTTY;
+        return -1;
+    }
+}
+
+int DRV_CAPTOUCH_I2C_LOOPBACK_Close(int fd)
+{
+    if(!loopbackOpen || fd != LOOPBACK_FD){
+        errno = EBADF;
+        return -1;
+    }
+
+    loopbackOpen = false;
+
+    return 0;
+}
+
+void DRV_CAPTOUCH_I2C_LOOPBACK_SetSmbusOnly(bool enable)
+{
+    loopbackSmbusOnly = enable;
+}
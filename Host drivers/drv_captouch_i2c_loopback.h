@@ -0,0 +1,48 @@
+/****************************************************************************************
+  I2C Capacitive Touch Driver: i2c-dev Loopback Header File
+
+  File Name:
+    drv_captouch_i2c_loopback.h
+
+  Summary:
+    This header file provides a stand-in for the Linux i2c-dev character device.
+
+  Description:
+    Included by drv_captouch_i2c_i2cdev.c when built with I2CDEV_LOOPBACK. The
+    I2C_FUNCS, I2C_SLAVE, I2C_RDWR and I2C_SMBUS (I2C block) requests are executed
+    on the simulated I2C_BASEADDR bus, so the i2c-dev transport talks to the
+    virtual FT5X46 with the same bus timing as the fsl_i2c transport.
+ ***************************************************************************************/
+
+
+#ifndef DRV_CAPTOUCH_I2C_LOOPBACK_H
+#define DRV_CAPTOUCH_I2C_LOOPBACK_H
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include <stdint.h>
+#include <stdbool.h>
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Defines
+
+#define I2CDEV_OPEN(path)               DRV_CAPTOUCH_I2C_LOOPBACK_Open(path)
+#define I2CDEV_IOCTL(fd, request, arg)  DRV_CAPTOUCH_I2C_LOOPBACK_Ioctl(fd, request, (unsigned long)(arg))
+#define I2CDEV_CLOSE(fd)                DRV_CAPTOUCH_I2C_LOOPBACK_Close(fd)
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Loopback Functions
+
+int DRV_CAPTOUCH_I2C_LOOPBACK_Open(const char *path);
+int DRV_CAPTOUCH_I2C_LOOPBACK_Ioctl(int fd, unsigned long request, unsigned long arg);
+int DRV_CAPTOUCH_I2C_LOOPBACK_Close(int fd);
+void DRV_CAPTOUCH_I2C_LOOPBACK_SetSmbusOnly(bool enable);
+
+#endif //DRV_CAPTOUCH_I2C_LOOPBACK_H
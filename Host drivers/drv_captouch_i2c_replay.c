@@ -0,0 +1,212 @@
+/****************************************************************************************
+  I2C Capacitive Touch Driver: Trace Replay
+
+  File Name:
+    drv_captouch_i2c_replay.c
+
+  Summary:
+    Host-side replay of captured I2C traffic through the FT5X46 simulator.
+
+  Description:
+    Write records only track the device mode so later reads land in the right
+    register page; the pipeline under test issues its own configuration writes.
+    A read covering OP_REG_TDSTATUS starts a frame: an idle frame is that one
+    byte, and the records of the contacts may follow in a second burst. The
+    frame is delivered when the next one starts or the trace ends, once all of
+    its reads are in the register file.
+ ***************************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "drv_captouch_i2c_replay.h"
+#include "drv_captouch_i2c_sim.h"
+#include "drv_captouch_i2c_trace.h"
+#include "fsl_i2c_sim.h"
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Types
+
+/* Frame started by a TD_STATUS read, delivered once the next one starts */
+typedef struct
+{
+    bool                    open;
+    uint32_t                timestamp;
+    uint64_t                ticks;
+    uint32_t                tick_hz;
+    uint64_t                sim_start;
+    uint64_t                wall_start;
+    REPLAY_MODE             mode;
+    REPLAY_FRAME_CALLBACK   frame;
+    void                    *ctx;
+} REPLAY_PENDING_OBJ;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+
+static uint32_t REPLAY_Get32(const uint8_t *src)
+{
+    return (uint32_t)src[0] | ((uint32_t)src[1] << 8) | ((uint32_t)src[2] << 16) | ((uint32_t)src[3] << 24);
+}
+
+static uint64_t REPLAY_Now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static void REPLAY_SleepUntil(uint64_t deadline)
+{
+    struct timespec ts;
+
+    ts.tv_sec = deadline / 1000000000ULL;
+    ts.tv_nsec = deadline % 1000000000ULL;
+    while(clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) != 0){}
+}
+
+static void REPLAY_Deliver(REPLAY_PENDING_OBJ *p, REPLAY_STATS_OBJ *st)
+{
+    uint64_t traceNs;
+
+    if(!p->open)
+        return;
+
+    traceNs = p->ticks * 1000000000ULL / p->tick_hz;
+
+    // Keep the simulated clock on the recorded timeline
+    if(I2C_SimGetTime() - p->sim_start < traceNs)
+        I2C_SimAdvanceTime(traceNs - (I2C_SimGetTime() - p->sim_start));
+
+    if(p->mode == REPLAY_REALTIME)
+        REPLAY_SleepUntil(p->wall_start + traceNs);
+
+    if(p->frame != NULL)
+        p->frame(p->timestamp, p->ctx);
+    st->frames++;
+    p->open = false;
+}
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Replay Functions
+
+int8_t DRV_CAPTOUCH_I2C_REPLAY_LoadFile(const char *path, uint8_t **trace, uint32_t *len)
+{
+    FILE *f;
+    long size;
+
+    f = fopen(path, "rb");
+    if(f == NULL)
+        return ERR_ARGUMENT;
+
+    fseek(f, 0, SEEK_END);
+    size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+
+    if(size < TRACE_HEADER_SIZE){
+        fclose(f);
+        return ERR_FORMAT;
+    }
+
+    *trace = malloc(size);
+    if(*trace == NULL || fread(*trace, 1, size, f) != (size_t)size){
+        free(*trace);
+        fclose(f);
+        return ERR_OVERFLOW;
+    }
+
+    fclose(f);
+    *len = (uint32_t)size;
+
+    return ERR_NONE;
+}
+
+int8_t DRV_CAPTOUCH_I2C_REPLAY_Run(const uint8_t *trace, uint32_t len, REPLAY_MODE mode,
+                                   REPLAY_FRAME_CALLBACK frame, void *ctx, REPLAY_STATS_OBJ *stats)
+{
+    REPLAY_STATS_OBJ st = {0};
+    REPLAY_PENDING_OBJ pending = {0};
+    uint32_t tickHz, last = 0;
+    uint64_t traceTicks = 0;
+    uint32_t pos = TRACE_HEADER_SIZE;
+    bool testMode = false;
+
+    if(len < TRACE_HEADER_SIZE || trace[0] != TRACE_MAGIC0 || trace[1] != TRACE_MAGIC1 ||
+       trace[2] != TRACE_MAGIC2 || trace[3] != TRACE_MAGIC3 || trace[4] != TRACE_VERSION)
+        return ERR_FORMAT;
+
+    tickHz = REPLAY_Get32(&trace[8]);
+    if(tickHz == 0)
+        return ERR_FORMAT;
+
+    pending.mode = mode;
+    pending.tick_hz = tickHz;
+    pending.frame = frame;
+    pending.ctx = ctx;
+    pending.sim_start = I2C_SimGetTime();
+    pending.wall_start = REPLAY_Now();
+
+    while(pos + TRACE_RECORD_SIZE <= len){
+        uint32_t ts = REPLAY_Get32(&trace[pos]);
+        uint8_t reg = trace[pos + 4];
+        bool read = (trace[pos + 5] & TRACE_DIR_READ) != 0;
+        uint8_t n = trace[pos + 5] & TRACE_LEN_MASK;
+        const uint8_t *payload = &trace[pos + TRACE_RECORD_SIZE];
+
+        if(pos + TRACE_RECORD_SIZE + n > len)
+            return ERR_FORMAT;
+
+        // Free running counter: accumulate the wrapped differences
+        if(st.records == 0)
+            last = ts;
+        traceTicks += (uint32_t)(ts - last);
+        last = ts;
+        st.records++;
+
+        if(!read){
+            if(reg == OP_REG_DEVICEMODE && n > 0)
+                testMode = ((payload[0] & 0x70) == 0x40) || ((payload[0] & 0x3F) == TEST_MODE);
+        }
+        else{
+            // The previous frame is complete before the next one overwrites its registers
+            if(!testMode && reg <= OP_REG_TDSTATUS && reg + n > OP_REG_TDSTATUS){
+                REPLAY_Deliver(&pending, &st);
+                pending.open = true;
+                pending.timestamp = ts;
+                pending.ticks = traceTicks;
+            }
+
+            for(uint8_t i = 0; i < n; i++){
+                if(testMode)
+                    DRV_CAPTOUCH_I2C_SIM_SetTestRegister(reg + i, payload[i]);
+                else
+                    DRV_CAPTOUCH_I2C_SIM_SetRegister(reg + i, payload[i]);
+            }
+        }
+
+        pos += TRACE_RECORD_SIZE + n;
+    }
+
+    REPLAY_Deliver(&pending, &st);
+
+    st.trace_ns = traceTicks * 1000000000ULL / tickHz;
+    st.wall_ns = REPLAY_Now() - pending.wall_start;
+
+    if(stats != NULL)
+        *stats = st;
+
+    return (pos == len) ? ERR_NONE : ERR_FORMAT;
+}
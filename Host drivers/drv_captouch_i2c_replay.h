@@ -0,0 +1,62 @@
+/****************************************************************************************
+  I2C Capacitive Touch Driver: Trace Replay Header File
+
+  File Name:
+    drv_captouch_i2c_replay.h
+
+  Summary:
+    This header file provides the API of the host-side trace replayer.
+
+  Description:
+    Replays a stream captured with drv_captouch_i2c_trace.c into the FT5X46
+    simulator. Recorded reads are loaded into the register file and the frame
+    callback runs the driver pipeline on each touch report, either as fast as
+    possible or paced to the recorded timestamps.
+ ***************************************************************************************/
+
+
+#ifndef DRV_CAPTOUCH_I2C_REPLAY_H
+#define DRV_CAPTOUCH_I2C_REPLAY_H
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "drv_captouch_i2c_defines.h"
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Types
+
+/* Pacing */
+typedef enum {
+    REPLAY_FAST         = 0x00,
+    REPLAY_REALTIME     = 0x01
+} REPLAY_MODE;
+
+/* Called once per recorded touch report, timestamp in trace ticks */
+typedef void (*REPLAY_FRAME_CALLBACK)(uint32_t timestamp, void *ctx);
+
+/* Replay Statistics */
+typedef struct
+{
+    uint32_t    records;            // records consumed
+    uint32_t    frames;             // touch reports delivered to the callback
+    uint64_t    trace_ns;           // time span covered by the trace
+    uint64_t    wall_ns;            // host time spent replaying
+} REPLAY_STATS_OBJ;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Replay Functions
+
+int8_t DRV_CAPTOUCH_I2C_REPLAY_LoadFile(const char *path, uint8_t **trace, uint32_t *len);
+int8_t DRV_CAPTOUCH_I2C_REPLAY_Run(const uint8_t *trace, uint32_t len, REPLAY_MODE mode,
+                                   REPLAY_FRAME_CALLBACK frame, void *ctx, REPLAY_STATS_OBJ *stats);
+
+#endif //DRV_CAPTOUCH_I2C_REPLAY_H
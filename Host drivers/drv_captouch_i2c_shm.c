@@ -0,0 +1,191 @@
+/****************************************************************************************
+  I2C Capacitive Touch Driver: POSIX Shared Memory Channel
+
+  File Name:
+    drv_captouch_i2c_shm.c
+
+  Summary:
+    Frame channel over shm_open/mmap with a named semaphore as doorbell.
+
+  Description:
+    The producer creates the shared memory object "<name>" and the semaphore
+    "<name>.db", the consumer opens both. The channel header is initialized by
+    the producer exactly as the M4 does in its shared region.
+ ***************************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "drv_captouch_i2c_shm.h"
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+
+static void SHM_Doorbell(void *ctx)
+{
+    sem_post((sem_t *)ctx);
+}
+
+static int8_t SHM_Names(SHM_CHANNEL_OBJ *shm, const char *name)
+{
+    memset(shm, 0, sizeof(*shm));
+
+    if(name == NULL || name[0] != '/')
+        return ERR_ARGUMENT;
+
+    if(snprintf(shm->name, sizeof(shm->name), "%s", name) >= (int)sizeof(shm->name)
+       || snprintf(shm->bell, sizeof(shm->bell), "%s.db", name) >= (int)sizeof(shm->bell))
+        return ERR_OVERFLOW;
+
+    return ERR_NONE;
+}
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Shared Memory Functions
+
+int8_t DRV_CAPTOUCH_I2C_SHM_Create(SHM_CHANNEL_OBJ *shm, const char *name, uint32_t slots)
+{
+    int8_t error = 0;
+    int fd;
+
+    error = SHM_Names(shm, name);
+    if(error){
+        return error;
+    }
+
+    shm->owner = true;
+    shm->size = CHANNEL_SIZE(slots);
+
+    // Start from fresh objects, a stale ring could still hold frames
+    shm_unlink(shm->name);
+    sem_unlink(shm->bell);
+
+    fd = shm_open(shm->name, O_CREAT | O_EXCL | O_RDWR, 0600);
+    if(fd < 0)
+        return ERR_NODEVICE;
+
+    if(ftruncate(fd, shm->size) < 0){
+        close(fd);
+        DRV_CAPTOUCH_I2C_SHM_Close(shm);
+        return ERR_NODEVICE;
+    }
+
+    shm->base = mmap(NULL, shm->size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if(shm->base == MAP_FAILED){
+        shm->base = NULL;
+        DRV_CAPTOUCH_I2C_SHM_Close(shm);
+        return ERR_NODEVICE;
+    }
+
+    shm->doorbell = sem_open(shm->bell, O_CREAT | O_EXCL, 0600, 0);
+    if(shm->doorbell == SEM_FAILED){
+        shm->doorbell = NULL;
+        DRV_CAPTOUCH_I2C_SHM_Close(shm);
+        return ERR_NODEVICE;
+    }
+
+    error = DRV_CAPTOUCH_I2C_CHANNEL_Init(&shm->ch, shm->base, slots, SHM_Doorbell, shm->doorbell);
+    if(error){
+        DRV_CAPTOUCH_I2C_SHM_Close(shm);
+        return error;
+    }
+
+    return error;
+}
+
+int8_t DRV_CAPTOUCH_I2C_SHM_Open(SHM_CHANNEL_OBJ *shm, const char *name)
+{
+    struct stat st;
+    int8_t error = 0;
+    int fd;
+
+    error = SHM_Names(shm, name);
+    if(error){
+        return error;
+    }
+
+    fd = shm_open(shm->name, O_RDWR, 0);
+    if(fd < 0)
+        return ERR_NODEVICE;
+
+    if(fstat(fd, &st) < 0 || st.st_size < CHANNEL_HEADER_SIZE){
+        close(fd);
+        return ERR_FORMAT;
+    }
+
+    shm->size = (uint32_t)st.st_size;
+    shm->base = mmap(NULL, shm->size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if(shm->base == MAP_FAILED){
+        shm->base = NULL;
+        return ERR_NODEVICE;
+    }
+
+    shm->doorbell = sem_open(shm->bell, 0);
+    if(shm->doorbell == SEM_FAILED){
+        shm->doorbell = NULL;
+        DRV_CAPTOUCH_I2C_SHM_Close(shm);
+        return ERR_NODEVICE;
+    }
+
+    error = DRV_CAPTOUCH_I2C_CHANNEL_Attach(&shm->ch, shm->base, shm->size);
+    if(error){
+        DRV_CAPTOUCH_I2C_SHM_Close(shm);
+        return error;
+    }
+
+    return error;
+}
+
+int8_t DRV_CAPTOUCH_I2C_SHM_Wait(SHM_CHANNEL_OBJ *shm, uint32_t timeout_ms)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_REALTIME, &ts);
+    ts.tv_sec += timeout_ms / 1000;
+    ts.tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+    if(ts.tv_nsec >= 1000000000L){
+        ts.tv_sec++;
+        ts.tv_nsec -= 1000000000L;
+    }
+
+    while(sem_timedwait(shm->doorbell, &ts) < 0){
+        if(errno == ETIMEDOUT)
+            return ERR_TIMEOUT;
+        if(errno != EINTR)
+            return ERR_NODEVICE;
+    }
+
+    return ERR_NONE;
+}
+
+void DRV_CAPTOUCH_I2C_SHM_Close(SHM_CHANNEL_OBJ *shm)
+{
+    if(shm->doorbell != NULL)
+        sem_close(shm->doorbell);
+    if(shm->base != NULL)
+        munmap(shm->base, shm->size);
+
+    if(shm->owner){
+        shm_unlink(shm->name);
+        sem_unlink(shm->bell);
+    }
+
+    shm->doorbell = NULL;
+    shm->base = NULL;
+}
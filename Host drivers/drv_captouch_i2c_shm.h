@@ -0,0 +1,64 @@
+/****************************************************************************************
+  I2C Capacitive Touch Driver: POSIX Shared Memory Channel Header File
+
+  File Name:
+    drv_captouch_i2c_shm.h
+
+  Summary:
+    This header file provides the frame channel between two Linux processes.
+
+  Description:
+    Host stand-in for the M4/A53 shared memory region: the ring lives in a POSIX
+    shared memory object and the doorbell is a named semaphore, where the target
+    would raise a Messaging Unit interrupt.
+ ***************************************************************************************/
+
+
+#ifndef DRV_CAPTOUCH_I2C_SHM_H
+#define DRV_CAPTOUCH_I2C_SHM_H
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <semaphore.h>
+#include "drv_captouch_i2c_channel.h"
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Defines
+
+#define SHM_NAME_LENGTH             64
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Types
+
+/* Shared Memory Channel */
+typedef struct
+{
+    CHANNEL_OBJ     ch;
+    void            *base;
+    uint32_t        size;
+    sem_t           *doorbell;
+    bool            owner;                      // created the objects, unlinks them on close
+    char            name[SHM_NAME_LENGTH];
+    char            bell[SHM_NAME_LENGTH];
+} SHM_CHANNEL_OBJ;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Shared Memory Functions
+
+int8_t DRV_CAPTOUCH_I2C_SHM_Create(SHM_CHANNEL_OBJ *shm, const char *name, uint32_t slots);
+int8_t DRV_CAPTOUCH_I2C_SHM_Open(SHM_CHANNEL_OBJ *shm, const char *name);
+int8_t DRV_CAPTOUCH_I2C_SHM_Wait(SHM_CHANNEL_OBJ *shm, uint32_t timeout_ms);
+void DRV_CAPTOUCH_I2C_SHM_Close(SHM_CHANNEL_OBJ *shm);
+
+#endif //DRV_CAPTOUCH_I2C_SHM_H
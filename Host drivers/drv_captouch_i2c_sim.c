@@ -0,0 +1,449 @@
+/****************************************************************************************
+  I2C Capacitive Touch Driver: Host Simulator
+
+  File Name:
+    drv_captouch_i2c_sim.c
+
+  Summary:
+    Register-level model of the FT5X46 controller for Linux host builds.
+
+  Description:
+    The model keeps two register pages (operating mode and TEST_MODE), an auto
+    incrementing register pointer and the INT line. It answers the I2C3 bus model of
+    fsl_i2c_sim.c, which provides the transaction timing.
+ ***************************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#ifndef TEST_MODE_EN
+#define TEST_MODE_EN
+#endif
+
+#include "drv_captouch_i2c_sim.h"
+#include "drv_captouch_i2c.h"
+#include "fsl_gpio.h"
+#include "fsl_i2c_sim.h"
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Defines
+
+#define SIM_RECORD_SIZE             6
+#define SIM_RECORD_WEIGHT           4
+#define SIM_RECORD_MISC             5
+#define SIM_TOUCH_SIGNAL            600     // raw counts under a finger
+#define SIM_NOISE_MASK              0x0F    // +-8 counts of raw noise
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Variables
+
+//! Register pages
+static uint8_t opReg[256];
+static uint8_t teReg[256];
+
+//! Bus state
+static bool present = true;
+static bool hibernating = false;
+static bool testMode = false;
+static bool pointerPhase = false;
+static uint8_t pointer = 0;
+static bool touchDataRead = false;
+
+//! TEST_MODE scan state
+static bool scanning = false;
+static uint64_t scanStart = 0;
+static bool scanStuck = false;
+static bool userRaw = false;
+static uint16_t rawModel[SIM_MAX_ROWS][SIM_MAX_COLS];
+static uint16_t rawLatched[SIM_MAX_ROWS][SIM_MAX_COLS];
+static uint32_t noiseSeed = 0x12345678;
+
+//! Contacts currently reported, used for the synthetic raw frame
+static SIM_TOUCH_OBJ contacts[MAX_TOUCHES];
+static uint8_t contactCount = 0;
+
+//! INT line
+static bool intAsserted = false;
+static void (*intCallback)(void) = NULL;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+
+static void SIM_SetInt(bool assert)
+{
+    intAsserted = assert;
+
+    // INT is active low
+    if(assert){
+        INT_GPIO->DR  &= ~(1UL << INT_PIN);
+        INT_GPIO->PSR &= ~(1UL << INT_PIN);
+        INT_GPIO->ISR |= (1UL << INT_PIN);
+    }
+    else{
+        INT_GPIO->DR  |= (1UL << INT_PIN);
+        INT_GPIO->PSR |= (1UL << INT_PIN);
+    }
+
+    if(assert && intCallback != NULL && (INT_GPIO->IMR & (1UL << INT_PIN)) != 0U)
+        intCallback();
+}
+
+static bool SIM_IsReadOnly(uint8_t reg)
+{
+    if(reg >= OP_REG_GESTID && reg < OP_REG_THGROUP)
+        return true;
+
+    switch(reg){
+      case OP_REG_LIBVERSIONH:
+      case OP_REG_LIBVERSIONL:
+      case OP_REG_CIPHER:
+      case OP_REG_FIRMID:
+      case OP_REG_ERR:
+        return true;
+      default:
+        return false;
+    }
+}
+
+static uint16_t SIM_Noise(void)
+{
+    noiseSeed = noiseSeed * 1103515245u + 12345u;
+    return (noiseSeed >> 16) & SIM_NOISE_MASK;
+}
+
+static void SIM_LatchRawFrame(void)
+{
+    uint8_t rows = teReg[TE_REG_ROWNUM];
+    uint8_t cols = teReg[TE_REG_COLNUM];
+
+    for(uint8_t r = 0; r < rows; r++){
+        for(uint8_t c = 0; c < cols; c++){
+            if(userRaw){
+                rawLatched[r][c] = rawModel[r][c];
+                continue;
+            }
+
+            int32_t value = SIM_RAW_BASELINE + SIM_Noise() - (SIM_NOISE_MASK / 2);
+
+            for(uint8_t i = 0; i < contactCount; i++){
+                int32_t dr = (int32_t)r - (int32_t)((uint32_t)contacts[i].y * rows / MAX_Y_PIXEL);
+                int32_t dc = (int32_t)c - (int32_t)((uint32_t)contacts[i].x * cols / MAX_X_PIXEL);
+                int32_t d2 = dr * dr + dc * dc;
+
+                if(d2 <= 4)
+                    value -= SIM_TOUCH_SIGNAL >> d2;
+            }
+
+            rawLatched[r][c] = (uint16_t)value;
+        }
+    }
+}
+
+static void SIM_WriteRegister(uint8_t reg, uint8_t data)
+{
+    if(reg == OP_REG_DEVICEMODE){
+        testMode = ((data & 0x70) == 0x40) || ((data & 0x3F) == TEST_MODE);
+        opReg[OP_REG_DEVICEMODE] = data;
+        teReg[TE_REG_DEVICEMODE] = data;
+        scanning = false;
+        return;
+    }
+
+    if(testMode){
+        if(reg == TE_REG_STARTSCAN){
+            if(data & 0x80){
+                scanning = true;
+                scanStart = I2C_SimGetTime();
+                teReg[TE_REG_STARTSCAN] = data;
+            }
+            return;
+        }
+        if(reg == TE_REG_ROWNUM || reg == TE_REG_COLNUM || (reg >= TE_REG_RAWDATA0H && reg < TE_REG_THPOINTNUM))
+            return;
+        teReg[reg] = data;
+        return;
+    }
+
+    if(!SIM_IsReadOnly(reg))
+        opReg[reg] = data;
+
+    // Stops answering until woken
+    if(reg == OP_REG_PMODE && data == PMODE_HIBERNATE)
+        hibernating = true;
+}
+
+static uint8_t SIM_ReadRegister(uint8_t reg)
+{
+    if(!testMode){
+        if(reg >= OP_REG_TDSTATUS && reg < OP_REG_TOUCHX1H + MAX_TOUCHES * SIM_RECORD_SIZE)
+            touchDataRead = true;
+        return opReg[reg];
+    }
+
+    if(reg == TE_REG_STARTSCAN){
+        if(scanning && !scanStuck && (I2C_SimGetTime() - scanStart) >= SIM_SCAN_TIME_NS){
+            SIM_LatchRawFrame();
+            scanning = false;
+            teReg[TE_REG_STARTSCAN] &= ~0x80;
+        }
+        return teReg[TE_REG_STARTSCAN];
+    }
+
+    if(reg >= TE_REG_RAWDATA0H && reg < TE_REG_RAWDATA0H + 2 * teReg[TE_REG_COLNUM]){
+        uint8_t row = teReg[TE_REG_ROWADD];
+        uint8_t col = (reg - TE_REG_RAWDATA0H) / 2;
+
+        if(row >= teReg[TE_REG_ROWNUM])
+            return 0x00;
+        if((reg - TE_REG_RAWDATA0H) & 1)
+            return rawLatched[row][col] & 0xFF;
+        return rawLatched[row][col] >> 8;
+    }
+
+    return teReg[reg];
+}
+
+static bool SIM_BusStart(void *userData, i2c_direction_t direction)
+{
+    (void)userData;
+
+    if(!present || hibernating)
+        return false;
+
+    // A write always begins with the register pointer
+    pointerPhase = (direction == kI2C_Write);
+
+    return true;
+}
+
+static bool SIM_BusWrite(void *userData, uint8_t data)
+{
+    (void)userData;
+
+    if(pointerPhase){
+        pointer = data;
+        pointerPhase = false;
+        return true;
+    }
+
+    SIM_WriteRegister(pointer++, data);
+
+    return true;
+}
+
+static uint8_t SIM_BusRead(void *userData)
+{
+    (void)userData;
+
+    return SIM_ReadRegister(pointer++);
+}
+
+static void SIM_BusStop(void *userData)
+{
+    (void)userData;
+
+    pointerPhase = false;
+
+    // The controller releases INT once the host has fetched the report
+    if(touchDataRead){
+        touchDataRead = false;
+        if(intAsserted)
+            SIM_SetInt(false);
+    }
+}
+
+static const i2c_sim_slave_t simSlave = {
+    .address  = I2C_SLAVE_ADDR,
+    .start    = SIM_BusStart,
+    .write    = SIM_BusWrite,
+    .read     = SIM_BusRead,
+    .stop     = SIM_BusStop,
+    .userData = NULL,
+};
+
+// Register file as after power-on or a RST pulse
+static void SIM_PowerOn(void)
+{
+    memset(opReg, 0, sizeof(opReg));
+    memset(teReg, 0, sizeof(teReg));
+
+    // Records of absent contacts read as 0xFF
+    memset(&opReg[OP_REG_TOUCHX1H], 0xFF, MAX_TOUCHES * SIM_RECORD_SIZE);
+
+    // Power-on defaults from the datasheet
+    opReg[OP_REG_THGROUP]        = 280 / 4;
+    opReg[OP_REG_THPEAK]         = 60;
+    opReg[OP_REG_THCAL]          = 16;
+    opReg[OP_REG_THWATER]        = 60;
+    opReg[OP_REG_THTEMP]         = 10;
+    opReg[OP_REG_THTDIFF]        = 20;
+    opReg[OP_REG_CTRL]           = 0x01;
+    opReg[OP_REG_TIMMONITOR]     = 0x0A;
+    opReg[OP_REG_PERIODACTIVE]   = 0x0C;
+    opReg[OP_REG_PERIODMONITOR]  = 0x28;
+    opReg[OP_REG_AUTOCLBMONITOR] = 0x00;
+    opReg[OP_REG_LIBVERSIONH]    = 0x30;
+    opReg[OP_REG_LIBVERSIONL]    = 0x03;
+    opReg[OP_REG_CIPHER]         = SIM_CIPHER_FT5X46;
+    opReg[OP_REG_MODE]           = 0x01;
+    opReg[OP_REG_PMODE]          = 0x00;
+    opReg[OP_REG_FIRMID]         = 0x10;
+    opReg[OP_REG_STATE]          = WORK;
+
+    teReg[TE_REG_DEVICEMODE]     = 0x40;
+    teReg[TE_REG_ROWNUM]         = SIM_DEFAULT_ROWS;
+    teReg[TE_REG_COLNUM]         = SIM_DEFAULT_COLS;
+    for(uint8_t i = 0; i < SIM_MAX_ROWS; i++){
+        teReg[TE_REG_TXORDER0 + i] = i;
+        teReg[TE_REG_ROW0CAC + i] = 0x40;
+    }
+    for(uint8_t i = 0; i < SIM_MAX_COLS; i++)
+        teReg[TE_REG_COL0CAC + i] = 0x40;
+    for(uint8_t i = 0; i < SIM_MAX_ROWS / 2; i++)
+        teReg[TE_REG_ROW01OFF + i] = 0x88;
+    for(uint8_t i = 0; i < SIM_MAX_COLS / 2; i++)
+        teReg[TE_REG_COL01OFF + i] = 0x88;
+
+    hibernating = false;
+    testMode = false;
+    pointerPhase = false;
+    pointer = 0;
+    touchDataRead = false;
+    scanning = false;
+    scanStuck = false;
+    userRaw = false;
+    contactCount = 0;
+
+    SIM_SetInt(false);
+}
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Simulator Functions
+
+void DRV_CAPTOUCH_I2C_SIM_Init(void)
+{
+    SIM_PowerOn();
+    present = true;
+
+    I2C_SimAttachSlave(I2C_BASEADDR, &simSlave);
+}
+
+void DRV_CAPTOUCH_I2C_SIM_SetPresent(bool isPresent)
+{
+    present = isPresent;
+}
+
+void DRV_CAPTOUCH_I2C_SIM_Wake(void)
+{
+    hibernating = false;
+    opReg[OP_REG_PMODE] = PMODE_ACTIVE;
+}
+
+// Unlike an INT wake, the configuration written since power-on is lost
+void DRV_CAPTOUCH_I2C_SIM_Reset(void)
+{
+    SIM_PowerOn();
+}
+
+// A stuck scan never clears TE_REG_STARTSCAN bit 7
+void DRV_CAPTOUCH_I2C_SIM_SetScanStuck(bool stuck)
+{
+    scanStuck = stuck;
+}
+
+bool DRV_CAPTOUCH_I2C_SIM_IsHibernating(void)
+{
+    return hibernating;
+}
+
+void DRV_CAPTOUCH_I2C_SIM_SetTouches(const SIM_TOUCH_OBJ *touch, uint8_t n)
+{
+    if(n > MAX_TOUCHES)
+        n = MAX_TOUCHES;
+
+    memset(&opReg[OP_REG_TOUCHX1H], 0xFF, MAX_TOUCHES * SIM_RECORD_SIZE);
+
+    for(uint8_t i = 0; i < n; i++){
+        uint8_t *rec = &opReg[OP_REG_TOUCHX1H + i * SIM_RECORD_SIZE];
+
+        rec[0] = ((touch[i].event_flag & 0x03) << 6) | ((touch[i].x >> 8) & 0x0F);
+        rec[1] = touch[i].x & 0xFF;
+        rec[2] = ((touch[i].id & 0x0F) << 4) | ((touch[i].y >> 8) & 0x0F);
+        rec[3] = touch[i].y & 0xFF;
+        rec[SIM_RECORD_WEIGHT] = touch[i].weight;
+        rec[SIM_RECORD_MISC] = (touch[i].area & 0x0F) << 4;
+        contacts[i] = touch[i];
+    }
+
+    contactCount = n;
+    opReg[OP_REG_TDSTATUS] = n;
+
+    SIM_SetInt(true);
+}
+
+void DRV_CAPTOUCH_I2C_SIM_SetRegister(uint8_t reg, uint8_t data)
+{
+    opReg[reg] = data;
+}
+
+uint8_t DRV_CAPTOUCH_I2C_SIM_GetRegister(uint8_t reg)
+{
+    return opReg[reg];
+}
+
+void DRV_CAPTOUCH_I2C_SIM_SetTestRegister(uint8_t reg, uint8_t data)
+{
+    // The panel size indexes rawLatched
+    if(reg == TE_REG_ROWNUM && data > SIM_MAX_ROWS)
+        data = SIM_MAX_ROWS;
+    if(reg == TE_REG_COLNUM && data > SIM_MAX_COLS)
+        data = SIM_MAX_COLS;
+
+    teReg[reg] = data;
+}
+
+uint8_t DRV_CAPTOUCH_I2C_SIM_GetTestRegister(uint8_t reg)
+{
+    return teReg[reg];
+}
+
+void DRV_CAPTOUCH_I2C_SIM_SetRawFrame(const uint16_t *raw, uint8_t rows, uint8_t cols)
+{
+    if(raw == NULL){
+        userRaw = false;
+        return;
+    }
+
+    if(rows > SIM_MAX_ROWS)
+        rows = SIM_MAX_ROWS;
+    if(cols > SIM_MAX_COLS)
+        cols = SIM_MAX_COLS;
+
+    for(uint8_t r = 0; r < rows; r++)
+        for(uint8_t c = 0; c < cols; c++)
+            rawModel[r][c] = raw[r * cols + c];
+
+    teReg[TE_REG_ROWNUM] = rows;
+    teReg[TE_REG_COLNUM] = cols;
+    userRaw = true;
+}
+
+void DRV_CAPTOUCH_I2C_SIM_SetIntCallback(void (*callback)(void))
+{
+    intCallback = callback;
+}
+
+bool DRV_CAPTOUCH_I2C_SIM_GetInt(void)
+{
+    return intAsserted;
+}
@@ -0,0 +1,79 @@
+/****************************************************************************************
+  I2C Capacitive Touch Driver: Host Simulator Header File
+
+  File Name:
+    drv_captouch_i2c_sim.h
+
+  Summary:
+    This header file provides the API of the FT5X46 register-level simulator.
+
+  Description:
+    Virtual FT5X46 controller for Linux host builds. It owns the operating mode and
+    TEST_MODE register files and is attached as slave 0x38 to the I2C3 model in
+    fsl_i2c_sim.c, so the driver runs unmodified on x86.
+ ***************************************************************************************/
+
+
+#ifndef DRV_CAPTOUCH_I2C_SIM_H
+#define DRV_CAPTOUCH_I2C_SIM_H
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "drv_captouch_i2c_defines.h"
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Defines
+
+#define SIM_MAX_ROWS                40      // TE_REG_TXORDER0..39
+#define SIM_MAX_COLS                30      // TE_REG_RAWDATA0..29
+#define SIM_DEFAULT_ROWS            24
+#define SIM_DEFAULT_COLS            14
+#define SIM_RAW_BASELINE            0x1A00
+#define SIM_SCAN_TIME_NS            8000000 // 8 ms full panel scan in TEST_MODE
+
+#define SIM_CIPHER_FT5X46           0x54
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Object definitions
+
+/* Simulated Contact */
+typedef struct
+{
+    uint8_t     event_flag;         // EVENT_VALUE reported in TOUCHxH[7:6]
+    uint16_t    x;                  // raw controller X, 12 bit
+    uint16_t    y;                  // raw controller Y, 12 bit
+    uint8_t     id;                 // touch ID reported in TOUCHyH[7:4]
+    uint8_t     weight;             // TOUCHx_WEIGHT
+    uint8_t     area;               // TOUCHx_MISC[7:4]
+} SIM_TOUCH_OBJ;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Simulator Functions
+
+void DRV_CAPTOUCH_I2C_SIM_Init(void);
+void DRV_CAPTOUCH_I2C_SIM_SetPresent(bool present);
+void DRV_CAPTOUCH_I2C_SIM_Wake(void);
+void DRV_CAPTOUCH_I2C_SIM_Reset(void);
+bool DRV_CAPTOUCH_I2C_SIM_IsHibernating(void);
+void DRV_CAPTOUCH_I2C_SIM_SetTouches(const SIM_TOUCH_OBJ *touch, uint8_t n);
+void DRV_CAPTOUCH_I2C_SIM_SetRegister(uint8_t reg, uint8_t data);
+uint8_t DRV_CAPTOUCH_I2C_SIM_GetRegister(uint8_t reg);
+void DRV_CAPTOUCH_I2C_SIM_SetTestRegister(uint8_t reg, uint8_t data);
+uint8_t DRV_CAPTOUCH_I2C_SIM_GetTestRegister(uint8_t reg);
+void DRV_CAPTOUCH_I2C_SIM_SetScanStuck(bool stuck);
+void DRV_CAPTOUCH_I2C_SIM_SetRawFrame(const uint16_t *raw, uint8_t rows, uint8_t cols);
+void DRV_CAPTOUCH_I2C_SIM_SetIntCallback(void (*callback)(void));
+bool DRV_CAPTOUCH_I2C_SIM_GetInt(void);
+
+#endif //DRV_CAPTOUCH_I2C_SIM_H
@@ -0,0 +1,342 @@
+/****************************************************************************************
+  I2C Capacitive Touch Driver: uinput Bridge
+
+  File Name:
+    drv_captouch_i2c_uinput.c
+
+  Summary:
+    Multitouch protocol B device on top of /dev/uinput.
+
+  Description:
+    The controller touch ID is used as the slot number. A new tracking ID is
+    assigned when a slot goes from free to EVENT_DOWN/EVENT_HOLD, EVENT_UP or a
+    slot missing from the frame releases it. Values the kernel already has are
+    not sent again, so a still contact costs no events. The orientation
+    transform maps raw 0 to MAX_X_PIXEL/MAX_Y_PIXEL, so the axes span 0 to
+    those values inclusive.
+ ***************************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/uinput.h>
+#include "drv_captouch_i2c.h"
+#include "drv_captouch_i2c_uinput.h"
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Defines
+
+#if (ORIENTATION == 90) || (ORIENTATION == 270)
+#define UINPUT_MAX_X                MAX_Y_PIXEL
+#define UINPUT_MAX_Y                MAX_X_PIXEL
+#define UINPUT_WIDTH                HEIGHT
+#define UINPUT_HEIGHT               WIDTH
+#else
+#define UINPUT_MAX_X                MAX_X_PIXEL
+#define UINPUT_MAX_Y                MAX_Y_PIXEL
+#define UINPUT_WIDTH                WIDTH
+#define UINPUT_HEIGHT               HEIGHT
+#endif
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+
+static void UINPUT_Event(struct input_event *ev, uint32_t *count, uint16_t type, uint16_t code, int32_t value)
+{
+    struct input_event *e = &ev[(*count)++];
+
+    // The kernel stamps events written to uinput itself
+    memset(e, 0, sizeof(*e));
+    e->type = type;
+    e->code = code;
+    e->value = value;
+}
+
+static void UINPUT_Slot(UINPUT_OBJ *u, struct input_event *ev, uint32_t *count, int32_t slot)
+{
+    if(u->current_slot != slot){
+        UINPUT_Event(ev, count, EV_ABS, ABS_MT_SLOT, slot);
+        u->current_slot = slot;
+    }
+}
+
+static int8_t UINPUT_Abs(int fd, uint16_t code, int32_t max, int32_t resolution)
+{
+    struct uinput_abs_setup abs;
+
+    memset(&abs, 0, sizeof(abs));
+    abs.code = code;
+    abs.absinfo.minimum = 0;
+    abs.absinfo.maximum = max;
+    abs.absinfo.resolution = resolution;
+
+    if(ioctl(fd, UI_SET_ABSBIT, code) < 0 || ioctl(fd, UI_ABS_SETUP, &abs) < 0)
+        return ERR_NODEVICE;
+
+    return ERR_NONE;
+}
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: uinput Functions
+
+void DRV_CAPTOUCH_I2C_UINPUT_Reset(UINPUT_OBJ *u)
+{
+    memset(u, 0, sizeof(*u));
+    u->fd = -1;
+    u->event_fd = -1;
+    u->current_slot = -1;
+
+    for(uint8_t s = 0; s < UINPUT_SLOTS; s++)
+        u->slot[s].tracking_id = -1;
+}
+
+int8_t DRV_CAPTOUCH_I2C_UINPUT_Open(UINPUT_OBJ *u, const char *name)
+{
+    struct uinput_setup setup;
+    int8_t error = 0;
+
+    DRV_CAPTOUCH_I2C_UINPUT_Reset(u);
+
+    u->fd = open(UINPUT_PATH, O_WRONLY | O_NONBLOCK);
+    if(u->fd < 0)
+        return ERR_NODEVICE;
+
+    if(ioctl(u->fd, UI_SET_EVBIT, EV_KEY) < 0 || ioctl(u->fd, UI_SET_KEYBIT, BTN_TOUCH) < 0
+       || ioctl(u->fd, UI_SET_EVBIT, EV_ABS) < 0 || ioctl(u->fd, UI_SET_PROPBIT, INPUT_PROP_DIRECT) < 0){
+        error = ERR_NODEVICE;
+        goto fail;
+    }
+
+    // Resolution in units per mm
+    if((error = UINPUT_Abs(u->fd, ABS_X, UINPUT_MAX_X, UINPUT_MAX_X / UINPUT_WIDTH))
+       || (error = UINPUT_Abs(u->fd, ABS_Y, UINPUT_MAX_Y, UINPUT_MAX_Y / UINPUT_HEIGHT))
+       || (error = UINPUT_Abs(u->fd, ABS_MT_SLOT, UINPUT_SLOTS - 1, 0))
+       || (error = UINPUT_Abs(u->fd, ABS_MT_TRACKING_ID, 0xFFFF, 0))
+       || (error = UINPUT_Abs(u->fd, ABS_MT_POSITION_X, UINPUT_MAX_X, UINPUT_MAX_X / UINPUT_WIDTH))
+       || (error = UINPUT_Abs(u->fd, ABS_MT_POSITION_Y, UINPUT_MAX_Y, UINPUT_MAX_Y / UINPUT_HEIGHT)))
+        goto fail;
+
+    memset(&setup, 0, sizeof(setup));
+    setup.id.bustype = BUS_I2C;
+    setup.id.vendor = 0x2808;       // FocalTech
+    setup.id.product = 0x5446;
+    snprintf(setup.name, sizeof(setup.name), "%s", name ? name : UINPUT_NAME);
+
+    if(ioctl(u->fd, UI_DEV_SETUP, &setup) < 0 || ioctl(u->fd, UI_DEV_CREATE) < 0){
+        error = ERR_NODEVICE;
+        goto fail;
+    }
+
+    return ERR_NONE;
+
+fail:
+    close(u->fd);
+    u->fd = -1;
+
+    return error;
+}
+
+int8_t DRV_CAPTOUCH_I2C_UINPUT_OpenEventNode(UINPUT_OBJ *u)
+{
+    char sysname[64], path[300];
+    struct dirent *entry;
+    DIR *dir;
+    int clock = CLOCK_MONOTONIC;
+
+    if(u->fd < 0 || ioctl(u->fd, UI_GET_SYSNAME(sizeof(sysname)), sysname) < 0)
+        return ERR_NODEVICE;
+
+    snprintf(path, sizeof(path), "/sys/devices/virtual/input/%s", sysname);
+    dir = opendir(path);
+    if(dir == NULL)
+        return ERR_NODEVICE;
+
+    while((entry = readdir(dir)) != NULL){
+        if(strncmp(entry->d_name, "event", 5) == 0){
+            snprintf(path, sizeof(path), "/dev/input/%s", entry->d_name);
+            u->event_fd = open(path, O_RDONLY | O_NONBLOCK);
+            break;
+        }
+    }
+    closedir(dir);
+
+    if(u->event_fd < 0)
+        return ERR_NODEVICE;
+
+    // Same clock as the INT and frame timestamps
+    if(ioctl(u->event_fd, EVIOCSCLOCKID, &clock) < 0){
+        close(u->event_fd);
+        u->event_fd = -1;
+        return ERR_NODEVICE;
+    }
+
+    return ERR_NONE;
+}
+
+uint32_t DRV_CAPTOUCH_I2C_UINPUT_Encode(UINPUT_OBJ *u, const POINT_OBJ *point, uint8_t n,
+                                        struct input_event *ev)
+{
+    uint16_t seen = 0;
+    uint32_t count = 0;
+    bool touching = false;
+    int32_t first = -1;
+
+    if(n > UINPUT_SLOTS)
+        n = UINPUT_SLOTS;
+
+    for(uint8_t i = 0; i < n; i++){
+        int32_t s = point[i].id;
+        UINPUT_SLOT_OBJ *slot;
+
+        if(s >= UINPUT_SLOTS || (seen & (1u << s)))
+            continue;
+        seen |= 1u << s;
+        slot = &u->slot[s];
+
+        if(point[i].event_flag == EVENT_UP){
+            if(slot->tracking_id >= 0){
+                UINPUT_Slot(u, ev, &count, s);
+                UINPUT_Event(ev, &count, EV_ABS, ABS_MT_TRACKING_ID, -1);
+                slot->tracking_id = -1;
+            }
+            continue;
+        }
+
+        if(slot->tracking_id < 0){
+            UINPUT_Slot(u, ev, &count, s);
+            slot->tracking_id = u->next_tracking_id;
+            u->next_tracking_id = (u->next_tracking_id + 1) & 0xFFFF;
+            UINPUT_Event(ev, &count, EV_ABS, ABS_MT_TRACKING_ID, slot->tracking_id);
+            UINPUT_Event(ev, &count, EV_ABS, ABS_MT_POSITION_X, point[i].x);
+            UINPUT_Event(ev, &count, EV_ABS, ABS_MT_POSITION_Y, point[i].y);
+        }else{
+            if(point[i].x != slot->x){
+                UINPUT_Slot(u, ev, &count, s);
+                UINPUT_Event(ev, &count, EV_ABS, ABS_MT_POSITION_X, point[i].x);
+            }
+            if(point[i].y != slot->y){
+                UINPUT_Slot(u, ev, &count, s);
+                UINPUT_Event(ev, &count, EV_ABS, ABS_MT_POSITION_Y, point[i].y);
+            }
+        }
+        slot->x = point[i].x;
+        slot->y = point[i].y;
+
+        touching = true;
+        if(first < 0)
+            first = s;
+    }
+
+    // Contacts the controller stopped reporting without an EVENT_UP
+    for(uint8_t s = 0; s < UINPUT_SLOTS; s++){
+        if(u->slot[s].tracking_id >= 0 && !(seen & (1u << s))){
+            UINPUT_Slot(u, ev, &count, s);
+            UINPUT_Event(ev, &count, EV_ABS, ABS_MT_TRACKING_ID, -1);
+            u->slot[s].tracking_id = -1;
+        }
+    }
+
+    // Single touch emulation for legacy clients
+    if(touching != u->touching){
+        UINPUT_Event(ev, &count, EV_KEY, BTN_TOUCH, touching);
+        u->touching = touching;
+    }
+    if(first >= 0 && u->slot[first].x != u->x){
+        u->x = u->slot[first].x;
+        UINPUT_Event(ev, &count, EV_ABS, ABS_X, u->x);
+    }
+    if(first >= 0 && u->slot[first].y != u->y){
+        u->y = u->slot[first].y;
+        UINPUT_Event(ev, &count, EV_ABS, ABS_Y, u->y);
+    }
+
+    if(count > 0)
+        UINPUT_Event(ev, &count, EV_SYN, SYN_REPORT, 0);
+
+    return count;
+}
+
+int8_t DRV_CAPTOUCH_I2C_UINPUT_Frame(UINPUT_OBJ *u, const POINT_OBJ *point, uint8_t n)
+{
+    struct input_event ev[UINPUT_MAX_EVENTS];
+    uint32_t count;
+    ssize_t len;
+
+    count = DRV_CAPTOUCH_I2C_UINPUT_Encode(u, point, n, ev);
+    if(count == 0)
+        return ERR_NONE;
+
+    u->frames++;
+    u->events += count;
+
+    if(u->fd < 0)
+        return ERR_NONE;
+
+    // One write per frame, the kernel delivers it up to the SYN_REPORT at once
+    len = write(u->fd, ev, count * sizeof(ev[0]));
+    if(len < 0)
+        return (errno == EAGAIN) ? ERR_BUSY : ERR_NODEVICE;
+    if((size_t)len != count * sizeof(ev[0]))
+        return ERR_OVERFLOW;
+
+    return ERR_NONE;
+}
+
+int8_t DRV_CAPTOUCH_I2C_UINPUT_ReadSyn(UINPUT_OBJ *u, uint64_t *timestamp_ns)
+{
+    struct pollfd pfd;
+    struct input_event ev;
+    ssize_t len;
+
+    if(u->event_fd < 0)
+        return ERR_NODEVICE;
+
+    pfd.fd = u->event_fd;
+    pfd.events = POLLIN;
+
+    // Non-blocking node: a frame that produced no events must not hang the caller
+    for(;;){
+        len = read(u->event_fd, &ev, sizeof(ev));
+        if(len == sizeof(ev)){
+            if(ev.type == EV_SYN && ev.code == SYN_REPORT){
+                *timestamp_ns = (uint64_t)ev.input_event_sec * 1000000000ULL + (uint64_t)ev.input_event_usec * 1000ULL;
+                return ERR_NONE;
+            }
+            continue;
+        }
+        if(len >= 0 || errno != EAGAIN)
+            return ERR_NODEVICE;
+        if(poll(&pfd, 1, UINPUT_READ_TIMEOUT_MS) <= 0)
+            return ERR_TIMEOUT;
+    }
+}
+
+void DRV_CAPTOUCH_I2C_UINPUT_Close(UINPUT_OBJ *u)
+{
+    if(u->event_fd >= 0)
+        close(u->event_fd);
+    if(u->fd >= 0){
+        ioctl(u->fd, UI_DEV_DESTROY);
+        close(u->fd);
+    }
+
+    u->event_fd = -1;
+    u->fd = -1;
+}
@@ -0,0 +1,84 @@
+/****************************************************************************************
+  I2C Capacitive Touch Driver: uinput Bridge Header File
+
+  File Name:
+    drv_captouch_i2c_uinput.h
+
+  Summary:
+    This header file provides the Linux multitouch (protocol B) uinput device.
+
+  Description:
+    Decoded frames are turned into ABS_MT_SLOT/TRACKING_ID/POSITION events, one
+    slot per controller touch ID, and written to uinput with a single write()
+    ending in one SYN_REPORT.
+ ***************************************************************************************/
+
+
+#ifndef DRV_CAPTOUCH_I2C_UINPUT_H
+#define DRV_CAPTOUCH_I2C_UINPUT_H
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <linux/input.h>
+#include "drv_captouch_i2c_defines.h"
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Defines
+
+#define UINPUT_PATH                 "/dev/uinput"
+#define UINPUT_NAME                 "FT5X46 Capacitive Touch"
+#define UINPUT_SLOTS                MAX_TOUCHES
+// Per slot: SLOT, TRACKING_ID, POSITION_X, POSITION_Y; then BTN_TOUCH, ABS_X, ABS_Y, SYN_REPORT
+#define UINPUT_MAX_EVENTS           (UINPUT_SLOTS * 4 + 4)
+#define UINPUT_READ_TIMEOUT_MS      100     // ReadSyn gives up on a frame without events
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Types
+
+/* Slot State, mirrors what the kernel already knows */
+typedef struct
+{
+    int32_t     tracking_id;        // -1 when the slot is free
+    uint16_t    x;
+    uint16_t    y;
+} UINPUT_SLOT_OBJ;
+
+/* uinput Device */
+typedef struct
+{
+    int                 fd;             // uinput, -1 for a dry run
+    int                 event_fd;       // evdev node for read back, -1 if not opened
+    int32_t             next_tracking_id;
+    int32_t             current_slot;
+    bool                touching;
+    uint16_t            x;              // ABS_X/ABS_Y of the single touch emulation
+    uint16_t            y;
+    UINPUT_SLOT_OBJ     slot[UINPUT_SLOTS];
+    uint32_t            frames;
+    uint32_t            events;
+} UINPUT_OBJ;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: uinput Functions
+
+void DRV_CAPTOUCH_I2C_UINPUT_Reset(UINPUT_OBJ *u);
+int8_t DRV_CAPTOUCH_I2C_UINPUT_Open(UINPUT_OBJ *u, const char *name);
+int8_t DRV_CAPTOUCH_I2C_UINPUT_OpenEventNode(UINPUT_OBJ *u);
+uint32_t DRV_CAPTOUCH_I2C_UINPUT_Encode(UINPUT_OBJ *u, const POINT_OBJ *point, uint8_t n,
+                                        struct input_event *ev);
+int8_t DRV_CAPTOUCH_I2C_UINPUT_Frame(UINPUT_OBJ *u, const POINT_OBJ *point, uint8_t n);
+int8_t DRV_CAPTOUCH_I2C_UINPUT_ReadSyn(UINPUT_OBJ *u, uint64_t *timestamp_ns);
+void DRV_CAPTOUCH_I2C_UINPUT_Close(UINPUT_OBJ *u);
+
+#endif //DRV_CAPTOUCH_I2C_UINPUT_H
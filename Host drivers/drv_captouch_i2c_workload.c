@@ -0,0 +1,308 @@
+/****************************************************************************************
+  I2C Capacitive Touch Driver: Synthetic Workload
+
+  File Name:
+    drv_captouch_i2c_workload.c
+
+  Summary:
+    Synthetic multi-finger touch reports for throughput benchmarks.
+
+  Description:
+    Each finger runs the press (EVENT_DOWN), contact (EVENT_HOLD) and lift
+    (EVENT_UP) sequence of the controller, with touch IDs allocated lowest
+    free first so lifted IDs are reused the way the FT5X46 does.
+ ***************************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include <math.h>
+#include <string.h>
+#include "drv_captouch_i2c.h"
+#include "drv_captouch_i2c_workload.h"
+#include "fsl_i2c_sim.h"
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Defines
+
+#define WORKLOAD_MIXED_PERIOD       240     // frames per scenario in WORKLOAD_MIXED
+#define WORKLOAD_PI                 3.14159265f
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+
+static uint32_t WORKLOAD_Rand(WORKLOAD_OBJ *w)
+{
+    // xorshift32
+    w->rng ^= w->rng << 13;
+    w->rng ^= w->rng >> 17;
+    w->rng ^= w->rng << 5;
+
+    return w->rng;
+}
+
+static float WORKLOAD_Uniform(WORKLOAD_OBJ *w, float lo, float hi)
+{
+    return lo + (hi - lo) * (float)(WORKLOAD_Rand(w) >> 8) / (float)(1u << 24);
+}
+
+static uint8_t WORKLOAD_AllocId(WORKLOAD_OBJ *w)
+{
+    uint16_t used = 0;
+
+    for(uint8_t i = 0; i < MAX_TOUCHES; i++)
+        if(w->finger[i].active)
+            used |= 1u << w->finger[i].id;
+
+    for(uint8_t id = 0; id < 16; id++)
+        if(!(used & (1u << id)))
+            return id;
+
+    return 0x0F;
+}
+
+static void WORKLOAD_Press(WORKLOAD_OBJ *w, WORKLOAD_FINGER_OBJ *f, float x, float y, uint16_t life)
+{
+    f->id = WORKLOAD_AllocId(w);
+    f->active = true;
+    f->lifting = false;
+    f->age = 0;
+    f->life = life;
+    f->x = x;
+    f->y = y;
+    f->vx = 0;
+    f->vy = 0;
+    f->weight = 40;
+    f->area = 3;
+}
+
+static void WORKLOAD_Flick(WORKLOAD_OBJ *w)
+{
+    for(uint8_t i = 0; i < w->fingers; i++){
+        WORKLOAD_FINGER_OBJ *f = &w->finger[i];
+
+        if(!f->active){
+            if(WORKLOAD_Uniform(w, 0, 1) < 0.1f){
+                float a = WORKLOAD_Uniform(w, 0, 2 * WORKLOAD_PI);
+
+                WORKLOAD_Press(w, f, WORKLOAD_Uniform(w, 100, MAX_X_PIXEL - 100),
+                               WORKLOAD_Uniform(w, 80, MAX_Y_PIXEL - 80), 8 + WORKLOAD_Rand(w) % 13);
+                f->vx = 2 * cosf(a);
+                f->vy = 2 * sinf(a);
+            }
+            continue;
+        }
+
+        // Accelerate up to 60 px per report, like a flick at 100 Hz
+        f->x += f->vx;
+        f->y += f->vy;
+        if(fabsf(f->vx) + fabsf(f->vy) < 60){
+            f->vx *= 1.35f;
+            f->vy *= 1.35f;
+        }
+        if(f->age >= f->life || f->x < 0 || f->y < 0 || f->x >= MAX_X_PIXEL || f->y >= MAX_Y_PIXEL)
+            f->lifting = true;
+    }
+}
+
+static void WORKLOAD_Pinch(WORKLOAD_OBJ *w)
+{
+    float r = 60 + 120 * (0.5f + 0.5f * sinf(w->frame * 2 * WORKLOAD_PI / 120));
+    float rot = w->frame * 0.01f;
+
+    for(uint8_t i = 0; i < w->fingers; i++){
+        WORKLOAD_FINGER_OBJ *f = &w->finger[i];
+        float a = rot + i * 2 * WORKLOAD_PI / w->fingers;
+
+        if(!f->active)
+            WORKLOAD_Press(w, f, 0, 0, 0xFFFF);
+
+        f->x = MAX_X_PIXEL / 2 + r * cosf(a);
+        f->y = MAX_Y_PIXEL / 2 + r * sinf(a) * 0.8f;
+    }
+}
+
+static void WORKLOAD_Palm(WORKLOAD_OBJ *w)
+{
+    for(uint8_t i = 0; i < w->fingers; i++){
+        WORKLOAD_FINGER_OBJ *f = &w->finger[i];
+
+        if(i + 1 == w->fingers){
+            // One finger drawing a Lissajous figure next to the palm
+            if(!f->active)
+                WORKLOAD_Press(w, f, 0, 0, 0xFFFF);
+            f->x = 250 + 150 * sinf(w->frame * 0.031f);
+            f->y = 200 + 120 * sinf(w->frame * 0.047f);
+            continue;
+        }
+
+        if(!f->active){
+            WORKLOAD_Press(w, f, 650 + 30 * (i % 3), 380 + 30 * (i / 3), 0xFFFF);
+            f->weight = 200;
+            f->area = 15;
+        }
+        f->x += WORKLOAD_Uniform(w, -3, 3);
+        f->y += WORKLOAD_Uniform(w, -3, 3);
+    }
+}
+
+static void WORKLOAD_Jitter(WORKLOAD_OBJ *w)
+{
+    for(uint8_t i = 0; i < w->fingers; i++){
+        WORKLOAD_FINGER_OBJ *f = &w->finger[i];
+        float x = MAX_X_PIXEL * (1 + (i % 5)) / 6.0f;
+        float y = MAX_Y_PIXEL * (1 + (i / 5)) / 3.0f;
+
+        if(!f->active)
+            WORKLOAD_Press(w, f, x, y, 0xFFFF);
+
+        f->x = x + WORKLOAD_Uniform(w, -2, 2);
+        f->y = y + WORKLOAD_Uniform(w, -2, 2);
+    }
+}
+
+static void WORKLOAD_IdReuse(WORKLOAD_OBJ *w)
+{
+    for(uint8_t i = 0; i < w->fingers; i++){
+        WORKLOAD_FINGER_OBJ *f = &w->finger[i];
+
+        if(!f->active){
+            if(WORKLOAD_Rand(w) % 3 == 0)
+                WORKLOAD_Press(w, f, WORKLOAD_Uniform(w, 0, MAX_X_PIXEL), WORKLOAD_Uniform(w, 0, MAX_Y_PIXEL),
+                               3 + WORKLOAD_Rand(w) % 4);
+            continue;
+        }
+
+        f->x += WORKLOAD_Uniform(w, -4, 4);
+        f->y += WORKLOAD_Uniform(w, -4, 4);
+        if(f->age >= f->life)
+            f->lifting = true;
+    }
+}
+
+static uint16_t WORKLOAD_Clamp(float v, uint16_t max)
+{
+    if(v < 0)
+        return 0;
+    if(v > max - 1)
+        return max - 1;
+    return (uint16_t)v;
+}
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Workload Functions
+
+void DRV_CAPTOUCH_I2C_WORKLOAD_Init(WORKLOAD_OBJ *w, WORKLOAD_SCENARIO scenario, uint8_t fingers,
+                                    uint16_t report_hz, uint32_t seed)
+{
+    memset(w, 0, sizeof(*w));
+
+    if(fingers < 1)
+        fingers = 1;
+    if(fingers > MAX_TOUCHES)
+        fingers = MAX_TOUCHES;
+
+    w->scenario = scenario;
+    w->current = (scenario == WORKLOAD_MIXED) ? WORKLOAD_FLICK : scenario;
+    w->fingers = fingers;
+    w->report_hz = report_hz ? report_hz : 100;
+    w->rng = seed ? seed : 0x2545F491;
+}
+
+uint8_t DRV_CAPTOUCH_I2C_WORKLOAD_Next(WORKLOAD_OBJ *w, SIM_TOUCH_OBJ *touch)
+{
+    uint8_t n = 0;
+
+    if(w->scenario == WORKLOAD_MIXED){
+        WORKLOAD_SCENARIO next = (WORKLOAD_SCENARIO)((w->frame / WORKLOAD_MIXED_PERIOD) % WORKLOAD_MIXED);
+
+        // Lift everything on a scenario change
+        if(next != w->current){
+            w->current = next;
+            for(uint8_t i = 0; i < MAX_TOUCHES; i++)
+                if(w->finger[i].active)
+                    w->finger[i].lifting = true;
+        }
+    }
+
+    switch(w->current){
+      case WORKLOAD_PINCH:
+        WORKLOAD_Pinch(w);
+        break;
+      case WORKLOAD_PALM:
+        WORKLOAD_Palm(w);
+        break;
+      case WORKLOAD_JITTER:
+        WORKLOAD_Jitter(w);
+        break;
+      case WORKLOAD_ID_REUSE:
+        WORKLOAD_IdReuse(w);
+        break;
+      default:
+        WORKLOAD_Flick(w);
+        break;
+    }
+
+    for(uint8_t i = 0; i < MAX_TOUCHES; i++){
+        WORKLOAD_FINGER_OBJ *f = &w->finger[i];
+
+        if(!f->active)
+            continue;
+
+        touch[n].event_flag = (f->age == 0) ? EVENT_DOWN : (f->lifting ? EVENT_UP : EVENT_HOLD);
+        touch[n].x = WORKLOAD_Clamp(f->x, MAX_X_PIXEL);
+        touch[n].y = WORKLOAD_Clamp(f->y, MAX_Y_PIXEL);
+        touch[n].id = f->id;
+        touch[n].weight = f->weight;
+        touch[n].area = f->area;
+        n++;
+
+        if(f->lifting)
+            f->active = false;
+        else
+            f->age++;
+    }
+
+    w->frame++;
+
+    return n;
+}
+
+void DRV_CAPTOUCH_I2C_WORKLOAD_Image(const SIM_TOUCH_OBJ *touch, uint8_t n, uint8_t *image)
+{
+    uint8_t *rec = &image[1];
+
+    memset(image, 0xFF, WORKLOAD_IMAGE_SIZE);
+    image[0] = n;
+
+    for(uint8_t i = 0; i < n; i++, rec += 6){
+        rec[0] = ((touch[i].event_flag & 0x03) << 6) | ((touch[i].x >> 8) & 0x0F);
+        rec[1] = touch[i].x & 0xFF;
+        rec[2] = ((touch[i].id & 0x0F) << 4) | ((touch[i].y >> 8) & 0x0F);
+        rec[3] = touch[i].y & 0xFF;
+        rec[4] = touch[i].weight;
+        rec[5] = (touch[i].area & 0x0F) << 4;
+    }
+}
+
+uint8_t DRV_CAPTOUCH_I2C_WORKLOAD_Step(WORKLOAD_OBJ *w)
+{
+    SIM_TOUCH_OBJ touch[MAX_TOUCHES];
+    uint8_t n;
+
+    // One report period of simulated time per frame
+    I2C_SimAdvanceTime(1000000000ULL / w->report_hz);
+
+    n = DRV_CAPTOUCH_I2C_WORKLOAD_Next(w, touch);
+    DRV_CAPTOUCH_I2C_SIM_SetTouches(touch, n);
+
+    return n;
+}
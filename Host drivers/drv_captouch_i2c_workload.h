@@ -0,0 +1,90 @@
+/****************************************************************************************
+  I2C Capacitive Touch Driver: Synthetic Workload Header File
+
+  File Name:
+    drv_captouch_i2c_workload.h
+
+  Summary:
+    This header file provides the API of the synthetic multi-finger workload generator.
+
+  Description:
+    Deterministic (seeded) generator of 1..MAX_TOUCHES contacts moving along
+    realistic trajectories. Frames are produced as FT5X46 register images
+    (TD_STATUS followed by the 6-byte records from OP_REG_TOUCHX1H) or pushed
+    straight into the simulator at the configured report rate.
+ ***************************************************************************************/
+
+
+#ifndef DRV_CAPTOUCH_I2C_WORKLOAD_H
+#define DRV_CAPTOUCH_I2C_WORKLOAD_H
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "drv_captouch_i2c_defines.h"
+#include "drv_captouch_i2c_sim.h"
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Defines
+
+#define WORKLOAD_IMAGE_SIZE         (1 + MAX_TOUCHES * 6)   // TD_STATUS + records
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Types
+
+/* Scenario */
+typedef enum {
+    WORKLOAD_FLICK      = 0x00,     // short fast strokes, repeated
+    WORKLOAD_PINCH,                 // fingers on a circle that opens and closes
+    WORKLOAD_PALM,                  // large resting blobs plus one moving finger
+    WORKLOAD_JITTER,                // static fingers with +-2 px noise
+    WORKLOAD_ID_REUSE,              // rapid lift/press cycles recycling touch IDs
+    WORKLOAD_MIXED                  // rotates through the scenarios above
+} WORKLOAD_SCENARIO;
+
+/* Finger State */
+typedef struct
+{
+    bool        active;
+    bool        lifting;
+    uint8_t     id;
+    uint16_t    age;                // frames since press
+    uint16_t    life;               // frames until lift
+    float       x, y;
+    float       vx, vy;
+    uint8_t     weight;
+    uint8_t     area;
+} WORKLOAD_FINGER_OBJ;
+
+/* Generator */
+typedef struct
+{
+    WORKLOAD_SCENARIO   scenario;
+    WORKLOAD_SCENARIO   current;    // active scenario when MIXED
+    uint8_t             fingers;    // maximum simultaneous contacts
+    uint16_t            report_hz;
+    uint32_t            rng;
+    uint32_t            frame;
+    WORKLOAD_FINGER_OBJ finger[MAX_TOUCHES];
+} WORKLOAD_OBJ;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Workload Functions
+
+void DRV_CAPTOUCH_I2C_WORKLOAD_Init(WORKLOAD_OBJ *w, WORKLOAD_SCENARIO scenario, uint8_t fingers,
+                                    uint16_t report_hz, uint32_t seed);
+uint8_t DRV_CAPTOUCH_I2C_WORKLOAD_Next(WORKLOAD_OBJ *w, SIM_TOUCH_OBJ *touch);
+void DRV_CAPTOUCH_I2C_WORKLOAD_Image(const SIM_TOUCH_OBJ *touch, uint8_t n, uint8_t *image);
+uint8_t DRV_CAPTOUCH_I2C_WORKLOAD_Step(WORKLOAD_OBJ *w);
+
+#endif //DRV_CAPTOUCH_I2C_WORKLOAD_H
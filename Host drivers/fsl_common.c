@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2016, Freescale Semiconductor, Inc.
+ * Copyright 2016-2020 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include "fsl_common.h"
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+
+/*! @brief Host register blocks behind the I2Cx/GPIOx base pointers. */
+I2C_Type g_hostI2C[4];
+GPIO_Type g_hostGPIO[5];
+
+/*! @brief Host core debug blocks, CYCCNT follows the simulated time. */
+DWT_Type g_hostDWT;
+CoreDebug_Type g_hostCoreDebug;
+
+/*! @brief M4 core clock. */
+uint32_t SystemCoreClock = 400000000U;
+
+/*! @brief SYSTEM PLL1 output frequency of the i.MX8M mini. */
+#define HOST_SYSTEM_PLL1_FREQ 800000000U
+
+/*! @brief Root clock dividers, indexed by clock_root_control_t. */
+static uint32_t s_rootPreDiv[4]  = {1U, 1U, 1U, 1U};
+static uint32_t s_rootPostDiv[4] = {1U, 1U, 1U, 1U};
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+
+void CLOCK_EnableClock(clock_ip_name_t name)
+{
+    (void)name;
+}
+
+void CLOCK_DisableClock(clock_ip_name_t name)
+{
+    (void)name;
+}
+
+void CLOCK_SetRootMux(clock_root_control_t rootClock, uint32_t mux)
+{
+    /* Only SYSTEM PLL1 DIV5 is modelled, which is what the driver selects. */
+    (void)rootClock;
+    (void)mux;
+}
+
+void CLOCK_SetRootDivider(clock_root_control_t rootClock, uint32_t pre, uint32_t post)
+{
+    assert((uint32_t)rootClock < ARRAY_SIZE(s_rootPreDiv));
+    assert((pre != 0U) && (post != 0U));
+
+    s_rootPreDiv[rootClock]  = pre;
+    s_rootPostDiv[rootClock] = post;
+}
+
+uint32_t CLOCK_GetRootPreDivider(clock_root_control_t rootClock)
+{
+    return s_rootPreDiv[rootClock];
+}
+
+uint32_t CLOCK_GetRootPostDivider(clock_root_control_t rootClock)
+{
+    return s_rootPostDiv[rootClock];
+}
+
+uint32_t CLOCK_GetPllFreq(clock_pll_ctrl_t pll)
+{
+    (void)pll;
+
+    return HOST_SYSTEM_PLL1_FREQ;
+}
@@ -0,0 +1,223 @@
+/*
+ * Copyright (c) 2016, Freescale Semiconductor, Inc.
+ * Copyright 2016-2020 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#ifndef _FSL_COMMON_H_
+#define _FSL_COMMON_H_
+
+/*
+ * Host (x86 Linux) replacement for the MCUXpresso fsl_common.h and device header.
+ *
+ * It provides just enough of the i.MX8M mini M4 environment (status codes, I2C and
+ * GPIO register blocks, CCM root clock helpers) for the unmodified fsl_i2c.h,
+ * fsl_gpio.h/.c and drv_captouch_i2c.c to build on a workstation. The I2C3
+ * controller itself is modelled in fsl_i2c_sim.c.
+ */
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+/*! @brief Construct a status code value from a group and code number. */
+#define MAKE_STATUS(group, code) ((((group)*100) + (code)))
+
+/*! @brief Construct the version number for drivers. */
+#define MAKE_VERSION(major, minor, bugfix) (((major) << 16) | ((minor) << 8) | (bugfix))
+
+/*! @brief Computes the number of elements in an array. */
+#if !defined(ARRAY_SIZE)
+#define ARRAY_SIZE(x) (sizeof(x) / sizeof((x)[0]))
+#endif
+
+/*! @brief Status group numbers. */
+enum _status_groups
+{
+    kStatusGroup_Generic = 0,  /*!< Group number for generic status codes. */
+    kStatusGroup_I2C     = 13, /*!< Group number for I2C status codes. */
+};
+
+/*! @brief Generic status return codes. */
+enum
+{
+    kStatus_Success              = MAKE_STATUS(kStatusGroup_Generic, 0), /*!< Generic status for Success. */
+    kStatus_Fail                 = MAKE_STATUS(kStatusGroup_Generic, 1), /*!< Generic status for Fail. */
+    kStatus_ReadOnly             = MAKE_STATUS(kStatusGroup_Generic, 2), /*!< Generic status for read only failure. */
+    kStatus_OutOfRange           = MAKE_STATUS(kStatusGroup_Generic, 3), /*!< Generic status for out of range access. */
+    kStatus_InvalidArgument      = MAKE_STATUS(kStatusGroup_Generic, 4), /*!< Generic status for invalid argument check. */
+    kStatus_Timeout              = MAKE_STATUS(kStatusGroup_Generic, 5), /*!< Generic status for timeout. */
+    kStatus_NoTransferInProgress = MAKE_STATUS(kStatusGroup_Generic, 6), /*!< Generic status for no transfer in progress. */
+};
+
+/*! @brief Type used for all status and error return values. */
+typedef int32_t status_t;
+
+/*! @brief Interrupt number type, only used for table sizing on the host. */
+typedef int32_t IRQn_Type;
+
+/*! @brief Memory barriers, mapped onto the compiler/host equivalents. */
+#define __DSB() __sync_synchronize()
+#define __DMB() __sync_synchronize()
+#define __ISB() __sync_synchronize()
+
+/*******************************************************************************
+ * Core debug (DWT cycle counter)
+ ******************************************************************************/
+
+typedef struct
+{
+    volatile uint32_t CTRL;   /*!< Control Register */
+    volatile uint32_t CYCCNT; /*!< Cycle Count Register */
+} DWT_Type;
+
+typedef struct
+{
+    volatile uint32_t DEMCR; /*!< Debug Exception and Monitor Control Register */
+} CoreDebug_Type;
+
+#define DWT_CTRL_CYCCNTENA_Msk       (1UL)
+#define CoreDebug_DEMCR_TRCENA_Msk   (1UL << 24U)
+
+/*! @brief Host cycle counter, advanced by the simulated time of fsl_i2c_sim.c. */
+extern DWT_Type g_hostDWT;
+extern CoreDebug_Type g_hostCoreDebug;
+
+#define DWT       (&g_hostDWT)
+#define CoreDebug (&g_hostCoreDebug)
+
+/*! @brief M4 core clock of the i.MX8M mini. */
+extern uint32_t SystemCoreClock;
+
+/*******************************************************************************
+ * I2C register block (i.MX I2C, 16-bit registers)
+ ******************************************************************************/
+
+typedef struct
+{
+    volatile uint16_t IADR; /*!< I2C Address Register */
+    volatile uint16_t IFDR; /*!< I2C Frequency Divider Register */
+    volatile uint16_t I2CR; /*!< I2C Control Register */
+    volatile uint16_t I2SR; /*!< I2C Status Register */
+    volatile uint16_t I2DR; /*!< I2C Data I/O Register */
+} I2C_Type;
+
+#define I2C_I2SR_RXAK_MASK (0x1U)
+#define I2C_I2SR_IIF_MASK  (0x2U)
+#define I2C_I2SR_SRW_MASK  (0x4U)
+#define I2C_I2SR_IAL_MASK  (0x10U)
+#define I2C_I2SR_IBB_MASK  (0x20U)
+#define I2C_I2SR_IAAS_MASK (0x40U)
+#define I2C_I2SR_ICF_MASK  (0x80U)
+#define I2C_I2CR_RSTA_MASK (0x4U)
+#define I2C_I2CR_TXAK_MASK (0x8U)
+#define I2C_I2CR_MTX_MASK  (0x10U)
+#define I2C_I2CR_MSTA_MASK (0x20U)
+#define I2C_I2CR_IIEN_MASK (0x40U)
+#define I2C_I2CR_IEN_MASK  (0x80U)
+#define I2C_IFDR_IC(x)     ((uint16_t)((x)&0x3FU))
+#define I2C_I2CR_IEN(x)    ((uint16_t)(((uint16_t)(x) << 7U) & I2C_I2CR_IEN_MASK))
+
+/*! @brief Host instances of the I2C register blocks, defined in fsl_common.c. */
+extern I2C_Type g_hostI2C[4];
+
+#define I2C1          (&g_hostI2C[0])
+#define I2C2          (&g_hostI2C[1])
+#define I2C3          (&g_hostI2C[2])
+#define I2C4          (&g_hostI2C[3])
+#define I2C_BASE_PTRS {I2C1, I2C2, I2C3, I2C4}
+
+/*******************************************************************************
+ * GPIO register block
+ ******************************************************************************/
+
+typedef struct
+{
+    volatile uint32_t DR;       /*!< GPIO data register */
+    volatile uint32_t GDIR;     /*!< GPIO direction register */
+    volatile uint32_t PSR;      /*!< GPIO pad status register */
+    volatile uint32_t ICR1;     /*!< GPIO interrupt configuration register1 */
+    volatile uint32_t ICR2;     /*!< GPIO interrupt configuration register2 */
+    volatile uint32_t IMR;      /*!< GPIO interrupt mask register */
+    volatile uint32_t ISR;      /*!< GPIO interrupt status register */
+    volatile uint32_t EDGE_SEL; /*!< GPIO edge select register */
+} GPIO_Type;
+
+/*! @brief Host instances of the GPIO register blocks, defined in fsl_common.c. */
+extern GPIO_Type g_hostGPIO[5];
+
+#define GPIO1          (&g_hostGPIO[0])
+#define GPIO2          (&g_hostGPIO[1])
+#define GPIO3          (&g_hostGPIO[2])
+#define GPIO4          (&g_hostGPIO[3])
+#define GPIO5          (&g_hostGPIO[4])
+#define GPIO_BASE_PTRS {GPIO1, GPIO2, GPIO3, GPIO4, GPIO5}
+
+/*******************************************************************************
+ * Clock control (CCM)
+ ******************************************************************************/
+
+typedef enum _clock_ip_name
+{
+    kCLOCK_IpInvalid = -1,
+    kCLOCK_Gpio1     = 0,
+    kCLOCK_Gpio2,
+    kCLOCK_Gpio3,
+    kCLOCK_Gpio4,
+    kCLOCK_Gpio5,
+    kCLOCK_I2c1,
+    kCLOCK_I2c2,
+    kCLOCK_I2c3,
+    kCLOCK_I2c4,
+} clock_ip_name_t;
+
+#define GPIO_CLOCKS {kCLOCK_Gpio1, kCLOCK_Gpio2, kCLOCK_Gpio3, kCLOCK_Gpio4, kCLOCK_Gpio5}
+#define I2C_CLOCKS  {kCLOCK_I2c1, kCLOCK_I2c2, kCLOCK_I2c3, kCLOCK_I2c4}
+
+typedef enum _clock_root_control
+{
+    kCLOCK_RootI2c1 = 0,
+    kCLOCK_RootI2c2,
+    kCLOCK_RootI2c3,
+    kCLOCK_RootI2c4,
+} clock_root_control_t;
+
+typedef enum _clock_rootmux_i2c_clk_sel
+{
+    kCLOCK_I2cRootmuxOsc24M      = 0U,
+    kCLOCK_I2cRootmuxSysPll1Div5 = 1U,
+} clock_rootmux_i2c_clk_sel_t;
+
+typedef enum _clock_pll_ctrl
+{
+    kCLOCK_SystemPll1Ctrl = 0,
+} clock_pll_ctrl_t;
+
+/*******************************************************************************
+ * API
+ ******************************************************************************/
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+void CLOCK_EnableClock(clock_ip_name_t name);
+void CLOCK_DisableClock(clock_ip_name_t name);
+void CLOCK_SetRootMux(clock_root_control_t rootClock, uint32_t mux);
+void CLOCK_SetRootDivider(clock_root_control_t rootClock, uint32_t pre, uint32_t post);
+uint32_t CLOCK_GetRootPreDivider(clock_root_control_t rootClock);
+uint32_t CLOCK_GetRootPostDivider(clock_root_control_t rootClock);
+uint32_t CLOCK_GetPllFreq(clock_pll_ctrl_t pll);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* _FSL_COMMON_H_ */
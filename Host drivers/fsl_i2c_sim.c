@@ -0,0 +1,707 @@
+/*
+ * Copyright (c) 2016, Freescale Semiconductor, Inc.
+ * Copyright 2016-2020 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Host model of the i.MX I2C master controller.
+ *
+ * Implements the fsl_i2c.h master API on top of a bit-timed bus model. The transactional
+ * (non-blocking) API runs the same byte-level state machine as fsl_i2c.c, one "interrupt"
+ * per byte, but the interrupts are taken synchronously: the completion callback has already
+ * run when I2C_MasterTransferNonBlocking() returns. Slave mode is not modelled.
+ */
+
+#include <time.h>
+#include "fsl_i2c_sim.h"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+/*! @brief i2c transfer state, same encoding as fsl_i2c.c. */
+enum _i2c_transfer_states
+{
+    kIdleState             = 0x0U, /*!< I2C bus idle. */
+    kCheckAddressState     = 0x1U, /*!< 7-bit address check state. */
+    kSendCommandState      = 0x2U, /*!< Send command byte phase. */
+    kSendDataState         = 0x3U, /*!< Send data transfer phase. */
+    kReceiveDataBeginState = 0x4U, /*!< Receive data transfer phase begin. */
+    kReceiveDataState      = 0x5U, /*!< Receive data transfer phase. */
+};
+
+/*! @brief SCL cycles of the bus conditions. A byte is 8 data bits plus ACK. */
+#define I2C_SIM_CYCLES_START 1U
+#define I2C_SIM_CYCLES_STOP  1U
+#define I2C_SIM_CYCLES_BYTE  9U
+
+/*! @brief Per instance model state. */
+typedef struct _i2c_sim_instance
+{
+    const i2c_sim_slave_t *slave; /*!< Attached slave, NULL if the bus is empty. */
+    uint32_t baudRate_Bps;        /*!< SCL frequency programmed through IFDR. */
+    uint32_t overrideBaud_Bps;    /*!< SCL frequency forced by I2C_SimSetBusClock(), 0 if unused. */
+    bool slaveSelected;           /*!< Slave ACKed the current address phase. */
+    uint64_t pendingSleep_ns;     /*!< Bus time not yet slept off in real-time mode. */
+} i2c_sim_instance_t;
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+
+/*! @brief SCL clock divider used to calculate baudrate. */
+static const uint16_t s_i2cDividerTable[] = {
+    30,  32,  36,  42,  48,  52,  60,  72,  80,   88,   104,  128,  144,  160,  192,  240,
+    288, 320, 384, 480, 576, 640, 768, 960, 1152, 1280, 1536, 1920, 2304, 2560, 3072, 3840,
+    22,  24,  26,  28,  32,  36,  40,  44,  48,   56,   64,   72,   80,   96,   112,  128,
+    160, 192, 224, 256, 320, 384, 448, 512, 640,  768,  896,  1024, 1280, 1536, 1792, 2048};
+
+/*! @brief Pointers to i2c bases for each instance. */
+static I2C_Type *const s_i2cBases[] = I2C_BASE_PTRS;
+
+/*! @brief Model state for each instance. */
+static i2c_sim_instance_t s_i2cSim[ARRAY_SIZE(s_i2cBases)];
+
+/*! @brief Simulated time and statistics, shared by all instances. */
+static uint64_t s_simTime_ns;
+static uint64_t s_busyTime_ns;
+static uint32_t s_transferCount;
+static bool s_realTime;
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+
+static i2c_sim_instance_t *I2C_SimGetInstance(I2C_Type *base)
+{
+    uint32_t instance;
+
+    for (instance = 0U; instance < ARRAY_SIZE(s_i2cBases); instance++)
+    {
+        if (s_i2cBases[instance] == base)
+        {
+            break;
+        }
+    }
+
+    assert(instance < ARRAY_SIZE(s_i2cBases));
+
+    return &s_i2cSim[instance];
+}
+
+static void I2C_SimClock(i2c_sim_instance_t *sim, uint32_t cycles)
+{
+    uint32_t baud = (sim->overrideBaud_Bps != 0U) ? sim->overrideBaud_Bps : sim->baudRate_Bps;
+    uint64_t ns;
+
+    if (baud == 0U)
+    {
+        baud = 100000U;
+    }
+
+    ns = ((uint64_t)cycles * 1000000000ULL + baud - 1U) / baud;
+    I2C_SimAdvanceTime(ns);
+    s_busyTime_ns += ns;
+    sim->pendingSleep_ns += ns;
+}
+
+static void I2C_SimSleep(i2c_sim_instance_t *sim)
+{
+    if (s_realTime && (sim->pendingSleep_ns != 0U))
+    {
+        struct timespec ts;
+
+        ts.tv_sec  = (time_t)(sim->pendingSleep_ns / 1000000000ULL);
+        ts.tv_nsec = (long)(sim->pendingSleep_ns % 1000000000ULL);
+        (void)nanosleep(&ts, NULL);
+    }
+    sim->pendingSleep_ns = 0U;
+}
+
+/* START (or repeated START) followed by the address byte; returns true when ACKed. */
+static bool I2C_SimBusStart(I2C_Type *base, uint8_t address, i2c_direction_t direction)
+{
+    i2c_sim_instance_t *sim = I2C_SimGetInstance(base);
+    bool ack                = false;
+
+    I2C_SimClock(sim, I2C_SIM_CYCLES_START + I2C_SIM_CYCLES_BYTE);
+
+    if ((sim->slave != NULL) && (sim->slave->address == address))
+    {
+        ack = sim->slave->start(sim->slave->userData, direction);
+    }
+    sim->slaveSelected = ack;
+
+    base->I2SR |= (uint16_t)(kI2C_BusBusyFlag | kI2C_IntPendingFlag | kI2C_TransferCompleteFlag);
+    if (ack)
+    {
+        base->I2SR &= ~(uint16_t)kI2C_ReceiveNakFlag;
+    }
+    else
+    {
+        base->I2SR |= (uint16_t)kI2C_ReceiveNakFlag;
+    }
+
+    return ack;
+}
+
+static bool I2C_SimBusWrite(I2C_Type *base, uint8_t data)
+{
+    i2c_sim_instance_t *sim = I2C_SimGetInstance(base);
+    bool ack                = false;
+
+    I2C_SimClock(sim, I2C_SIM_CYCLES_BYTE);
+
+    base->I2DR = data;
+    if (sim->slaveSelected)
+    {
+        ack = sim->slave->write(sim->slave->userData, data);
+    }
+
+    base->I2SR |= (uint16_t)(kI2C_IntPendingFlag | kI2C_TransferCompleteFlag);
+    if (ack)
+    {
+        base->I2SR &= ~(uint16_t)kI2C_ReceiveNakFlag;
+    }
+    else
+    {
+        base->I2SR |= (uint16_t)kI2C_ReceiveNakFlag;
+    }
+
+    return ack;
+}
+
+static uint8_t I2C_SimBusRead(I2C_Type *base)
+{
+    i2c_sim_instance_t *sim = I2C_SimGetInstance(base);
+    uint8_t data            = 0xFFU; /* Released SDA reads as ones. */
+
+    I2C_SimClock(sim, I2C_SIM_CYCLES_BYTE);
+
+    if (sim->slaveSelected)
+    {
+        data = sim->slave->read(sim->slave->userData);
+    }
+
+    base->I2DR = data;
+    base->I2SR |= (uint16_t)(kI2C_IntPendingFlag | kI2C_TransferCompleteFlag);
+
+    return data;
+}
+
+static void I2C_SimBusStop(I2C_Type *base)
+{
+    i2c_sim_instance_t *sim = I2C_SimGetInstance(base);
+
+    I2C_SimClock(sim, I2C_SIM_CYCLES_STOP);
+
+    if (sim->slaveSelected)
+    {
+        sim->slave->stop(sim->slave->userData);
+    }
+    sim->slaveSelected = false;
+
+    base->I2SR &= ~(uint16_t)kI2C_BusBusyFlag;
+    base->I2CR &= ~((uint16_t)I2C_I2CR_MSTA_MASK | (uint16_t)I2C_I2CR_MTX_MASK | (uint16_t)I2C_I2CR_TXAK_MASK);
+
+    s_transferCount++;
+    I2C_SimSleep(sim);
+}
+
+static status_t I2C_SimRunStateMachine(I2C_Type *base, i2c_master_handle_t *handle, bool *isDone)
+{
+    status_t result      = kStatus_Success;
+    uint32_t statusFlags = base->I2SR;
+    bool ignoreNak       = ((handle->state == (uint8_t)kSendDataState) && (handle->transfer.dataSize == 0U)) ||
+                     ((handle->state == (uint8_t)kReceiveDataState) && (handle->transfer.dataSize == 1U));
+
+    *isDone = false;
+
+    if ((statusFlags & (uint32_t)kI2C_ReceiveNakFlag) != 0U)
+    {
+        result = kStatus_I2C_Nak;
+    }
+
+    /* Ignore Nak when it's appeared for last byte. */
+    if ((result == kStatus_I2C_Nak) && ignoreNak)
+    {
+        result = kStatus_Success;
+    }
+
+    /* Handle Check address state to check the slave address is Acked in slave probe application. */
+    if (handle->state == (uint8_t)kCheckAddressState)
+    {
+        if ((statusFlags & (uint32_t)kI2C_ReceiveNakFlag) != 0U)
+        {
+            result = kStatus_I2C_Addr_Nak;
+        }
+        else if (handle->transfer.subaddressSize > 0U)
+        {
+            handle->state = (uint8_t)kSendCommandState;
+        }
+        else if (handle->transfer.direction == kI2C_Write)
+        {
+            handle->state = (uint8_t)kSendDataState;
+        }
+        else
+        {
+            handle->state = (uint8_t)kReceiveDataBeginState;
+        }
+    }
+
+    if (result != kStatus_Success)
+    {
+        return result;
+    }
+
+    switch (handle->state)
+    {
+        case (uint8_t)kSendCommandState:
+            if (handle->transfer.subaddressSize != 0U)
+            {
+                handle->transfer.subaddressSize--;
+                (void)I2C_SimBusWrite(base,
+                                      (uint8_t)(handle->transfer.subaddress >> (8U * handle->transfer.subaddressSize)));
+            }
+            else if (handle->transfer.direction == kI2C_Write)
+            {
+                if (handle->transfer.dataSize > 0U)
+                {
+                    handle->state = (uint8_t)kSendDataState;
+                    (void)I2C_SimBusWrite(base, *handle->transfer.data);
+                    handle->transfer.data++;
+                    handle->transfer.dataSize--;
+                }
+                else
+                {
+                    *isDone = true;
+                }
+            }
+            else
+            {
+                /* Send repeated start and slave address, a NAK here is reported as a plain NAK. */
+                (void)I2C_SimBusStart(base, handle->transfer.slaveAddress, kI2C_Read);
+                handle->state = (uint8_t)kReceiveDataBeginState;
+            }
+            break;
+
+        case (uint8_t)kSendDataState:
+            if (handle->transfer.dataSize > 0U)
+            {
+                (void)I2C_SimBusWrite(base, *handle->transfer.data);
+                handle->transfer.data++;
+                handle->transfer.dataSize--;
+            }
+            else
+            {
+                *isDone = true;
+            }
+            break;
+
+        case (uint8_t)kReceiveDataBeginState:
+            /* The dummy read of I2DR clocks in the first byte. */
+            base->I2CR &= ~((uint16_t)I2C_I2CR_MTX_MASK | (uint16_t)I2C_I2CR_TXAK_MASK);
+            if (handle->transfer.dataSize > 0U)
+            {
+                (void)I2C_SimBusRead(base);
+            }
+            else
+            {
+                *isDone = true;
+            }
+            handle->state = (uint8_t)kReceiveDataState;
+            break;
+
+        case (uint8_t)kReceiveDataState:
+            if (0U != handle->transfer.dataSize--)
+            {
+                *handle->transfer.data = (uint8_t)base->I2DR;
+                handle->transfer.data++;
+
+                if (handle->transfer.dataSize == 0U)
+                {
+                    *isDone = true;
+                }
+                else
+                {
+                    (void)I2C_SimBusRead(base);
+                }
+            }
+            break;
+
+        default:
+            assert(false);
+            break;
+    }
+
+    return result;
+}
+
+static status_t I2C_SimInitTransferStateMachine(I2C_Type *base, i2c_master_handle_t *handle, i2c_master_transfer_t *xfer)
+{
+    i2c_direction_t direction = xfer->direction;
+
+    if ((base->I2SR & (uint16_t)kI2C_BusBusyFlag) != 0U)
+    {
+        return kStatus_I2C_Busy;
+    }
+
+    handle->transfer     = *xfer;
+    handle->transferSize = xfer->dataSize;
+
+    if ((handle->transfer.subaddressSize > 0U) && (xfer->direction == kI2C_Read))
+    {
+        direction = kI2C_Write;
+    }
+
+    /* The bus is never left claimed between transfers, so NoStart is only a data continuation. */
+    if ((handle->transfer.flags & (uint32_t)kI2C_TransferNoStartFlag) != 0U)
+    {
+        if (direction == kI2C_Read)
+        {
+            return kStatus_InvalidArgument;
+        }
+    }
+
+    handle->state = (uint8_t)kCheckAddressState;
+    base->I2CR |= I2C_I2CR_MSTA_MASK | I2C_I2CR_MTX_MASK;
+    (void)I2C_SimBusStart(base, handle->transfer.slaveAddress, direction);
+
+    return kStatus_Success;
+}
+
+void I2C_MasterInit(I2C_Type *base, const i2c_master_config_t *masterConfig, uint32_t srcClock_Hz)
+{
+    assert((masterConfig != NULL) && (srcClock_Hz != 0U));
+
+    base->IADR = 0;
+    base->IFDR = 0;
+    base->I2CR = 0;
+    base->I2SR = 0;
+
+    I2C_MasterSetBaudRate(base, masterConfig->baudRate_Bps, srcClock_Hz);
+
+    base->I2CR = I2C_I2CR_IEN(masterConfig->enableMaster);
+}
+
+void I2C_MasterDeinit(I2C_Type *base)
+{
+    I2C_Enable(base, false);
+}
+
+void I2C_MasterGetDefaultConfig(i2c_master_config_t *masterConfig)
+{
+    assert(masterConfig);
+
+    (void)memset(masterConfig, 0, sizeof(*masterConfig));
+
+    masterConfig->baudRate_Bps = 100000U;
+    masterConfig->enableMaster = true;
+}
+
+void I2C_EnableInterrupts(I2C_Type *base, uint32_t mask)
+{
+    if ((mask & (uint32_t)kI2C_GlobalInterruptEnable) != 0U)
+    {
+        base->I2CR |= I2C_I2CR_IIEN_MASK;
+    }
+}
+
+void I2C_DisableInterrupts(I2C_Type *base, uint32_t mask)
+{
+    if ((mask & (uint32_t)kI2C_GlobalInterruptEnable) != 0U)
+    {
+        base->I2CR &= ~(uint16_t)I2C_I2CR_IIEN_MASK;
+    }
+}
+
+void I2C_MasterSetBaudRate(I2C_Type *base, uint32_t baudRate_Bps, uint32_t srcClock_Hz)
+{
+    uint32_t computedRate;
+    uint32_t absError;
+    uint32_t bestError = UINT32_MAX;
+    uint32_t bestIcr   = 0u;
+    uint8_t i;
+
+    /* Same divider search as the hardware driver, so the modelled SCL matches the real one. */
+    for (i = 0u; i < ARRAY_SIZE(s_i2cDividerTable); ++i)
+    {
+        computedRate = srcClock_Hz / s_i2cDividerTable[i];
+        absError     = baudRate_Bps > computedRate ? (baudRate_Bps - computedRate) : (computedRate - baudRate_Bps);
+
+        if (absError < bestError)
+        {
+            bestIcr   = i;
+            bestError = absError;
+
+            if (absError == 0U)
+            {
+                break;
+            }
+        }
+    }
+
+    base->IFDR                                 = I2C_IFDR_IC(bestIcr);
+    I2C_SimGetInstance(base)->baudRate_Bps = srcClock_Hz / s_i2cDividerTable[bestIcr];
+}
+
+status_t I2C_MasterStart(I2C_Type *base, uint8_t address, i2c_direction_t direction)
+{
+    if ((base->I2SR & (uint16_t)kI2C_BusBusyFlag) != 0U)
+    {
+        return kStatus_I2C_Busy;
+    }
+
+    base->I2CR |= I2C_I2CR_MSTA_MASK | I2C_I2CR_MTX_MASK;
+    (void)I2C_SimBusStart(base, address, direction);
+
+    return kStatus_Success;
+}
+
+status_t I2C_MasterRepeatedStart(I2C_Type *base, uint8_t address, i2c_direction_t direction)
+{
+    if (((base->I2SR & (uint16_t)kI2C_BusBusyFlag) != 0U) && ((base->I2CR & (uint16_t)I2C_I2CR_MSTA_MASK) == 0U))
+    {
+        return kStatus_I2C_Busy;
+    }
+
+    base->I2CR |= I2C_I2CR_MSTA_MASK | I2C_I2CR_MTX_MASK;
+    (void)I2C_SimBusStart(base, address, direction);
+
+    return kStatus_Success;
+}
+
+status_t I2C_MasterStop(I2C_Type *base)
+{
+    I2C_SimBusStop(base);
+
+    return kStatus_Success;
+}
+
+status_t I2C_MasterWriteBlocking(I2C_Type *base, const uint8_t *txBuff, size_t txSize, uint32_t flags)
+{
+    status_t result = kStatus_Success;
+
+    while (txSize-- != 0U)
+    {
+        if (!I2C_SimBusWrite(base, *txBuff++) && (txSize != 0U))
+        {
+            result = kStatus_I2C_Nak;
+            break;
+        }
+    }
+
+    if ((result != kStatus_Success) || (0U == (flags & (uint32_t)kI2C_TransferNoStopFlag)))
+    {
+        (void)I2C_MasterStop(base);
+    }
+
+    return result;
+}
+
+status_t I2C_MasterReadBlocking(I2C_Type *base, uint8_t *rxBuff, size_t rxSize, uint32_t flags)
+{
+    while (rxSize-- != 0U)
+    {
+        *rxBuff++ = I2C_SimBusRead(base);
+    }
+
+    if (0U == (flags & (uint32_t)kI2C_TransferNoStopFlag))
+    {
+        (void)I2C_MasterStop(base);
+    }
+
+    return kStatus_Success;
+}
+
+status_t I2C_MasterTransferBlocking(I2C_Type *base, i2c_master_transfer_t *xfer)
+{
+    i2c_master_handle_t handle;
+    status_t result;
+    bool isDone = false;
+
+    assert(xfer);
+
+    (void)memset(&handle, 0, sizeof(handle));
+
+    result = I2C_SimInitTransferStateMachine(base, &handle, xfer);
+
+    while ((result == kStatus_Success) && !isDone)
+    {
+        result = I2C_SimRunStateMachine(base, &handle, &isDone);
+    }
+
+    if ((base->I2CR & I2C_I2CR_MSTA_MASK) != 0U)
+    {
+        if ((0U == (xfer->flags & (uint32_t)kI2C_TransferNoStopFlag)) || (result != kStatus_Success))
+        {
+            (void)I2C_MasterStop(base);
+        }
+    }
+
+    return result;
+}
+
+void I2C_MasterTransferCreateHandle(I2C_Type *base,
+                                    i2c_master_handle_t *handle,
+                                    i2c_master_transfer_callback_t callback,
+                                    void *userData)
+{
+    assert(handle);
+
+    (void)base;
+    (void)memset(handle, 0, sizeof(*handle));
+
+    handle->completionCallback = callback;
+    handle->userData           = userData;
+}
+
+status_t I2C_MasterTransferNonBlocking(I2C_Type *base, i2c_master_handle_t *handle, i2c_master_transfer_t *xfer)
+{
+    status_t result;
+
+    assert(handle);
+    assert(xfer);
+
+    if (handle->state != (uint8_t)kIdleState)
+    {
+        return kStatus_I2C_Busy;
+    }
+
+    result = I2C_SimInitTransferStateMachine(base, handle, xfer);
+    if (result != kStatus_Success)
+    {
+        return result;
+    }
+
+    I2C_EnableInterrupts(base, (uint32_t)kI2C_GlobalInterruptEnable);
+
+    /* Take the byte interrupts back to back until the handler returns the handle to idle. */
+    while (handle->state != (uint8_t)kIdleState)
+    {
+        I2C_MasterTransferHandleIRQ(base, handle);
+    }
+
+    return kStatus_Success;
+}
+
+status_t I2C_MasterTransferAbort(I2C_Type *base, i2c_master_handle_t *handle)
+{
+    assert(handle);
+
+    I2C_DisableInterrupts(base, (uint32_t)kI2C_GlobalInterruptEnable);
+    handle->state = (uint8_t)kIdleState;
+
+    if ((base->I2CR & I2C_I2CR_MSTA_MASK) != 0U)
+    {
+        (void)I2C_MasterStop(base);
+    }
+
+    return kStatus_Success;
+}
+
+status_t I2C_MasterTransferGetCount(I2C_Type *base, i2c_master_handle_t *handle, size_t *count)
+{
+    assert(handle);
+
+    (void)base;
+
+    if (NULL == count)
+    {
+        return kStatus_InvalidArgument;
+    }
+
+    *count = handle->transferSize - handle->transfer.dataSize;
+
+    return kStatus_Success;
+}
+
+void I2C_MasterTransferHandleIRQ(I2C_Type *base, void *i2cHandle)
+{
+    i2c_master_handle_t *handle = (i2c_master_handle_t *)i2cHandle;
+    status_t result;
+    bool isDone;
+
+    assert(i2cHandle);
+
+    base->I2SR &= ~(uint16_t)kI2C_IntPendingFlag;
+
+    result = I2C_SimRunStateMachine(base, handle, &isDone);
+
+    if (isDone || (result != kStatus_Success))
+    {
+        if ((0U == (handle->transfer.flags & (uint32_t)kI2C_TransferNoStopFlag)) || (result == kStatus_I2C_Nak) ||
+            (result == kStatus_I2C_Addr_Nak))
+        {
+            if ((base->I2CR & I2C_I2CR_MSTA_MASK) != 0U)
+            {
+                (void)I2C_MasterStop(base);
+            }
+        }
+
+        handle->state = (uint8_t)kIdleState;
+
+        I2C_DisableInterrupts(base, (uint32_t)kI2C_GlobalInterruptEnable);
+
+        if (handle->completionCallback != NULL)
+        {
+            handle->completionCallback(base, handle, result, handle->userData);
+        }
+    }
+}
+
+void I2C_SimAttachSlave(I2C_Type *base, const i2c_sim_slave_t *slave)
+{
+    I2C_SimGetInstance(base)->slave = slave;
+}
+
+void I2C_SimSetBusClock(I2C_Type *base, uint32_t baudRate_Bps)
+{
+    I2C_SimGetInstance(base)->overrideBaud_Bps = baudRate_Bps;
+}
+
+uint32_t I2C_SimGetBusClock(I2C_Type *base)
+{
+    i2c_sim_instance_t *sim = I2C_SimGetInstance(base);
+
+    return (sim->overrideBaud_Bps != 0U) ? sim->overrideBaud_Bps : sim->baudRate_Bps;
+}
+
+void I2C_SimSetRealTime(bool enable)
+{
+    s_realTime = enable;
+}
+
+uint64_t I2C_SimGetTime(void)
+{
+    return s_simTime_ns;
+}
+
+void I2C_SimAdvanceTime(uint64_t ns)
+{
+    s_simTime_ns += ns;
+
+    /* Keep the core cycle counter on the simulated timeline. */
+    DWT->CYCCNT = (uint32_t)(s_simTime_ns * (SystemCoreClock / 1000000U) / 1000U);
+}
+
+void I2C_SimGetStatistics(uint64_t *busyTime_ns, uint32_t *transfers)
+{
+    if (busyTime_ns != NULL)
+    {
+        *busyTime_ns = s_busyTime_ns;
+    }
+    if (transfers != NULL)
+    {
+        *transfers = s_transferCount;
+    }
+}
+
+void I2C_SimResetStatistics(void)
+{
+    s_busyTime_ns   = 0U;
+    s_transferCount = 0U;
+}
@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2016, Freescale Semiconductor, Inc.
+ * Copyright 2016-2020 NXP
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#ifndef _FSL_I2C_SIM_H_
+#define _FSL_I2C_SIM_H_
+
+#include "fsl_i2c.h"
+
+/*!
+ * @addtogroup i2c_sim
+ * @{
+ */
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+/*!
+ * @brief Software model of a slave device attached to a simulated I2C bus.
+ *
+ * The controller model calls these hooks in bus order: start (address phase, returns the
+ * ACK), then write/read for each data byte, then stop. A repeated start is reported as a
+ * second start without an intervening stop.
+ */
+typedef struct _i2c_sim_slave
+{
+    uint8_t address;                                            /*!< 7-bit slave address. */
+    bool (*start)(void *userData, i2c_direction_t direction);   /*!< Address phase, true to ACK. */
+    bool (*write)(void *userData, uint8_t data);                /*!< Master wrote a byte, true to ACK. */
+    uint8_t (*read)(void *userData);                            /*!< Master reads a byte. */
+    void (*stop)(void *userData);                               /*!< STOP condition on the bus. */
+    void *userData;                                             /*!< Parameter passed to the hooks. */
+} i2c_sim_slave_t;
+
+/*******************************************************************************
+ * API
+ ******************************************************************************/
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /*_cplusplus. */
+
+/*!
+ * @brief Attaches a slave model to a simulated I2C instance (one slave per bus).
+ *
+ * @param base I2C base pointer.
+ * @param slave Slave model, or NULL to leave the bus empty (every address NAKs).
+ */
+void I2C_SimAttachSlave(I2C_Type *base, const i2c_sim_slave_t *slave);
+
+/*!
+ * @brief Overrides the SCL frequency computed by I2C_MasterInit()/I2C_MasterSetBaudRate().
+ *
+ * @param base I2C base pointer.
+ * @param baudRate_Bps Bus clock in Hz, 0 to go back to the divider derived frequency.
+ */
+void I2C_SimSetBusClock(I2C_Type *base, uint32_t baudRate_Bps);
+
+/*!
+ * @brief Gets the SCL frequency the model is currently using for timing.
+ *
+ * @param base I2C base pointer.
+ * @return Bus clock in Hz.
+ */
+uint32_t I2C_SimGetBusClock(I2C_Type *base);
+
+/*!
+ * @brief Enables real-time pacing.
+ *
+ * When enabled every transfer sleeps for its modelled bus duration, otherwise transfers only
+ * advance the virtual bus clock and complete as fast as the host allows.
+ */
+void I2C_SimSetRealTime(bool enable);
+
+/*!
+ * @brief Gets the simulated time in nanoseconds, advanced by every modelled bus cycle.
+ *
+ * DWT->CYCCNT of the host fsl_common.h follows the same timeline at SystemCoreClock.
+ */
+uint64_t I2C_SimGetTime(void);
+
+/*!
+ * @brief Advances the simulated time, e.g. to model idle gaps between touch reports.
+ */
+void I2C_SimAdvanceTime(uint64_t ns);
+
+/*!
+ * @brief Gets the accumulated bus busy time and transfer count since the last reset.
+ *
+ * @param busyTime_ns Time the bus spent in START..STOP, may be NULL.
+ * @param transfers Number of completed master transfers, may be NULL.
+ */
+void I2C_SimGetStatistics(uint64_t *busyTime_ns, uint32_t *transfers);
+
+/*!
+ * @brief Clears the statistics returned by I2C_SimGetStatistics().
+ */
+void I2C_SimResetStatistics(void);
+
+#if defined(__cplusplus)
+}
+#endif /*_cplusplus. */
+
+/*! @} */
+
+#endif /* _FSL_I2C_SIM_H_ */
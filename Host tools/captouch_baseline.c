@@ -0,0 +1,165 @@
+/****************************************************************************************
+  I2C Capacitive Touch Driver: Baseline Benchmark
+
+  File Name:
+    captouch_baseline.c
+
+  Summary:
+    Delta frames, noise estimate and kernel cost of the baseline tracker.
+
+  Description:
+    Usage: captouch_baseline [idle_frames] [touch_frames]
+    Build with TEST_MODE_EN. Raw frames are captured from the simulated panel,
+    first without touch, then with a finger held down and again after it is
+    lifted. Each phase reports one JSON line with the touched node count, the
+    peak delta, the RMS noise, the cycles per frame of
+    DRV_CAPTOUCH_I2C_BASELINE_Process and the number of delta values that differ
+    from a plain scalar implementation of the same fixed-point filter.
+ ***************************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "drv_captouch_i2c.h"
+#include "drv_captouch_i2c_baseline.h"
+#include "drv_captouch_i2c_bench.h"
+#include "drv_captouch_i2c_raw.h"
+#include "drv_captouch_i2c_sim.h"
+#include "fsl_i2c_sim.h"
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Variables
+
+static RAW_FRAME_OBJ raw;
+static DELTA_FRAME_OBJ delta;
+
+//! Scalar reference state
+static int32_t refValue[BASELINE_NODES];
+static uint32_t refVariance[BASELINE_NODES];
+static bool refSeeded = false;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+
+// Returns the number of nodes whose delta differs from the tracker output
+static uint32_t RefProcess(const RAW_FRAME_OBJ *f, const DELTA_FRAME_OBJ *out)
+{
+    uint16_t n = f->rows * f->cols;
+    uint32_t mismatches = 0;
+
+    for(uint16_t i = 0; i < n; i++){
+        int32_t level, d, sq;
+
+        if(!refSeeded){
+            refValue[i] = (int32_t)f->data[i] << BASELINE_FRAC;
+            refVariance[i] = 0;
+        }
+
+        level = (refValue[i] + (1 << (BASELINE_FRAC - 1))) >> BASELINE_FRAC;
+        d = level - (int32_t)f->data[i];
+        if(d > INT16_MAX)
+            d = INT16_MAX;
+        if(d < INT16_MIN)
+            d = INT16_MIN;
+        if(d != out->data[i])
+            mismatches++;
+
+        if(d >= BASELINE_GATE_DEFAULT)
+            continue;
+
+        refValue[i] += (((int32_t)f->data[i] << BASELINE_FRAC) - refValue[i]) >> BASELINE_SHIFT_DEFAULT;
+        sq = d * d;
+        if(sq > BASELINE_SQUARE_MAX)
+            sq = BASELINE_SQUARE_MAX;
+        refVariance[i] += ((sq << BASELINE_NOISE_FRAC) - (int32_t)refVariance[i]) >> BASELINE_NOISE_SHIFT_DEFAULT;
+    }
+
+    refSeeded = true;
+
+    return mismatches;
+}
+
+static int8_t RunPhase(const char *name, uint32_t frames, const SIM_TOUCH_OBJ *finger)
+{
+    BASELINE_STATS_OBJ stats;
+    uint64_t cycles = 0;
+    uint32_t mismatches = 0;
+    int8_t error = 0;
+
+    DRV_CAPTOUCH_I2C_SIM_SetTouches(finger, finger ? 1 : 0);
+
+    for(uint32_t f = 0; f < frames; f++){
+        uint32_t start;
+
+        error = DRV_CAPTOUCH_I2C_RAW_Capture(&raw);
+        if(error){
+            return error;
+        }
+
+        start = DRV_CAPTOUCH_I2C_BENCH_CYCLES();
+        error = DRV_CAPTOUCH_I2C_BASELINE_Process(&raw, &delta);
+        cycles += DRV_CAPTOUCH_I2C_BENCH_CYCLES() - start;
+        if(error){
+            return error;
+        }
+
+        mismatches += RefProcess(&raw, &delta);
+    }
+
+    DRV_CAPTOUCH_I2C_BASELINE_GetStats(&stats);
+    printf("{\"bench\":\"baseline\",\"phase\":\"%s\",\"frames\":%u,\"nodes\":%u,\"touched\":%u,\"peak\":%d,"
+           "\"noise_rms\":%u.%02u,\"energy\":%u,\"cycles_per_frame\":%llu,\"mismatches\":%u}\n",
+           name, frames, raw.rows * raw.cols, stats.touched, stats.peak,
+           stats.noise >> (BASELINE_NOISE_FRAC / 2), (stats.noise & ((1u << (BASELINE_NOISE_FRAC / 2)) - 1)) * 25,
+           stats.energy, (unsigned long long)(frames ? cycles / frames : 0), mismatches);
+
+    return (mismatches == 0) ? ERR_NONE : ERR_FORMAT;
+}
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Main
+
+int main(int argc, char **argv)
+{
+    static const SIM_TOUCH_OBJ finger = { EVENT_HOLD, 400, 240, 0, 40, 3 };
+    uint32_t idle = 64, touch = 32;
+    int8_t error = 0;
+
+    if(argc > 1)
+        idle = (uint32_t)atoi(argv[1]);
+    if(argc > 2)
+        touch = (uint32_t)atoi(argv[2]);
+
+    DRV_CAPTOUCH_I2C_SIM_Init();
+    I2C_SimSetBusClock(I2C3, 400000);
+    error = DRV_CAPTOUCH_I2C_Init();
+    if(!error)
+        error = DRV_CAPTOUCH_I2C_RAW_Start();
+    if(error){
+        fprintf(stderr, "raw start failed: %d\n", error);
+        return 1;
+    }
+
+    DRV_CAPTOUCH_I2C_BASELINE_Init(NULL);
+
+    if(!error)
+        error = RunPhase("idle", idle, NULL);
+    if(!error)
+        error = RunPhase("touch", touch, &finger);
+    if(!error)
+        error = RunPhase("lift", idle, NULL);
+
+    DRV_CAPTOUCH_I2C_RAW_Stop();
+
+    return error ? 1 : 0;
+}
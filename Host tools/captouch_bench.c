@@ -0,0 +1,184 @@
+/****************************************************************************************
+  I2C Capacitive Touch Driver: Host Benchmark
+
+  File Name:
+    captouch_bench.c
+
+  Summary:
+    Benchmark of the acquisition pipeline on the host simulator.
+
+  Description:
+    Usage: captouch_bench [scenario] [fingers] [frames] [report_hz] [--limit stage=cycles]...
+    Synthetic workload frames are published into the simulator and acquired with
+    DRV_CAPTOUCH_I2C_BENCH_RunFrame. Build with BENCH_EN. Every stage is printed
+    as a JSON line followed by a summary line per scenario; the exit status is 1
+    when a stage mean exceeds its --limit.
+ ***************************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "drv_captouch_i2c.h"
+#include "drv_captouch_i2c_bench.h"
+#include "drv_captouch_i2c_sim.h"
+#include "drv_captouch_i2c_workload.h"
+#include "fsl_i2c_sim.h"
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Variables
+
+static const char *scenarioName[] = {"flick", "pinch", "palm", "jitter", "idreuse", "mixed"};
+
+static BENCH_LIMIT_OBJ limits;
+
+//! Consumer state, kept so the delivery stage cannot be optimized away
+static volatile uint32_t checksum = 0;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+
+static uint64_t BenchNow(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static void BenchOutput(const char *line)
+{
+    puts(line);
+}
+
+static void BenchDeliver(const POINT_OBJ *point, uint8_t n)
+{
+    uint32_t sum = 0;
+
+    for(uint8_t i = 0; i < n; i++)
+        sum += point[i].x ^ (point[i].y << 11) ^ (point[i].id << 22) ^ (point[i].event_flag << 28);
+
+    checksum += sum;
+}
+
+static bool BenchParseLimit(const char *arg)
+{
+    for(uint8_t s = 0; s < BENCH_STAGES; s++){
+        const char *name = DRV_CAPTOUCH_I2C_BENCH_GetStageName((BENCH_STAGE)s);
+        size_t len = strlen(name);
+
+        if(strncmp(arg, name, len) == 0 && arg[len] == '='){
+            limits.mean_max[s] = (uint32_t)strtoul(&arg[len + 1], NULL, 0);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static int BenchScenario(WORKLOAD_SCENARIO scenario, uint8_t fingers, uint32_t frames, uint16_t report_hz)
+{
+    WORKLOAD_OBJ w;
+    POINT_OBJ points[MAX_TOUCHES];
+    uint64_t start, wall, busy;
+    uint32_t contacts = 0, transfers;
+    uint8_t regressions;
+
+    DRV_CAPTOUCH_I2C_WORKLOAD_Init(&w, scenario, fingers, report_hz, 1);
+    DRV_CAPTOUCH_I2C_BENCH_Reset();
+    I2C_SimResetStatistics();
+    wall = 0;
+
+    for(uint32_t f = 0; f < frames; f++){
+        uint8_t n;
+
+        DRV_CAPTOUCH_I2C_WORKLOAD_Step(&w);
+
+        start = BenchNow();
+        if(DRV_CAPTOUCH_I2C_BENCH_RunFrame(points, &n, BenchDeliver))
+            return -1;
+        wall += BenchNow() - start;
+        contacts += n;
+    }
+
+    I2C_SimGetStatistics(&busy, &transfers);
+
+    regressions = DRV_CAPTOUCH_I2C_BENCH_Report(scenarioName[scenario], &limits, BenchOutput);
+
+    printf("{\"bench\":\"%s\",\"fingers\":%u,\"frames\":%u,\"contacts\":%u,\"host_fps\":%.0f,"
+           "\"bus_us_per_frame\":%.1f,\"transfers_per_frame\":%.2f,\"max_report_hz\":%.1f,\"regressions\":%u}\n",
+           scenarioName[scenario], fingers, frames, contacts, wall ? frames * 1e9 / wall : 0.0,
+           busy / 1e3 / frames, (double)transfers / frames, busy ? frames * 1e9 / busy : 0.0, regressions);
+
+    return regressions;
+}
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Main
+
+int main(int argc, char **argv)
+{
+    int first = 0, last = WORKLOAD_MIXED;
+    uint8_t fingers = 5;
+    uint32_t frames = 10000;
+    uint16_t report_hz = 100;
+    int positional = 0, failed = 0;
+
+    for(int a = 1; a < argc; a++){
+        if(strcmp(argv[a], "--limit") == 0 && a + 1 < argc){
+            if(!BenchParseLimit(argv[++a])){
+                fprintf(stderr, "unknown stage in --limit %s\n", argv[a]);
+                return 2;
+            }
+            continue;
+        }
+
+        switch(positional++){
+          case 0:
+            for(first = 0; first <= WORKLOAD_MIXED; first++)
+                if(strcmp(argv[a], scenarioName[first]) == 0)
+                    break;
+            if(first > WORKLOAD_MIXED){
+                fprintf(stderr, "usage: %s [flick|pinch|palm|jitter|idreuse|mixed] [fingers] [frames] [report_hz]"
+                                " [--limit stage=cycles]...\n", argv[0]);
+                return 2;
+            }
+            last = first;
+            break;
+          case 1:
+            fingers = (uint8_t)atoi(argv[a]);
+            break;
+          case 2:
+            frames = (uint32_t)atoi(argv[a]);
+            break;
+          default:
+            report_hz = (uint16_t)atoi(argv[a]);
+            break;
+        }
+    }
+
+    DRV_CAPTOUCH_I2C_SIM_Init();
+    DRV_CAPTOUCH_I2C_Init();
+
+    for(int s = first; s <= last; s++){
+        int result = BenchScenario((WORKLOAD_SCENARIO)s, fingers, frames, report_hz);
+
+        if(result < 0)
+            return 1;
+        failed |= result;
+    }
+
+    return failed ? 1 : 0;
+}
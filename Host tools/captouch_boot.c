@@ -0,0 +1,203 @@
+/****************************************************************************************
+  I2C Capacitive Touch Driver: Boot Benchmark
+
+  File Name:
+    captouch_boot.c
+
+  Summary:
+    Cold-boot-to-first-touch time of the blocking and the asynchronous bring-up.
+
+  Description:
+    Usage: captouch_boot [power_on_ms] [display_ms] [touch_ms]
+    The simulated controller answers power_on_ms after reset, the display init
+    takes display_ms of CPU time and a finger lands at touch_ms. The serial run
+    probes the controller with blocking reads before initializing the display,
+    the overlapped run advances DRV_CAPTOUCH_I2C_BOOT_Task between display init
+    steps. One JSON line per run reports the probe count and the times at which
+    the touch controller became ready, the display was done and the first touch
+    frame was read.
+ ***************************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "drv_captouch_i2c.h"
+#include "drv_captouch_i2c_boot.h"
+#include "drv_captouch_i2c_profile.h"
+#include "drv_captouch_i2c_sim.h"
+#include "fsl_i2c_sim.h"
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Defines
+
+#define BOOT_STEP_NS                1000000ULL      // 1 ms per loop iteration
+#define BOOT_LIMIT_MS               5000
+#define BOOT_PROBE_MS               5
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Types
+
+typedef struct
+{
+    uint32_t    power_on_ms;
+    uint32_t    display_ms;
+    uint32_t    touch_ms;
+} BOOT_SCENARIO_OBJ;
+
+typedef struct
+{
+    uint32_t    ready_ms;
+    uint32_t    display_ms;
+    uint32_t    touch_ms;
+    uint32_t    probes;
+} BOOT_RESULT_OBJ;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Variables
+
+static uint64_t bootReset;
+static bool bootLanded;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+
+// Board time since reset
+static uint32_t BootMs(void)
+{
+    return (uint32_t)((I2C_SimGetTime() - bootReset) / 1000000);
+}
+
+// One millisecond of board time: the controller comes out of reset and the finger lands on schedule
+static void BootTick(const BOOT_SCENARIO_OBJ *sc)
+{
+    static const SIM_TOUCH_OBJ finger = { EVENT_DOWN, 400, 240, 0, 40, 3 };
+
+    I2C_SimAdvanceTime(BOOT_STEP_NS);
+
+    if(BootMs() >= sc->power_on_ms)
+        DRV_CAPTOUCH_I2C_SIM_SetPresent(true);
+    if(BootMs() >= sc->touch_ms && !bootLanded){
+        DRV_CAPTOUCH_I2C_SIM_SetTouches(&finger, 1);
+        bootLanded = true;
+    }
+}
+
+static bool BootTouch(void)
+{
+    uint8_t n;
+
+    if(!DRV_CAPTOUCH_I2C_SIM_GetInt())
+        return false;
+
+    return DRV_CAPTOUCH_I2C_GetNumberOfTouch(&n) == ERR_NONE && n > 0;
+}
+
+static void BootReset(void)
+{
+    DRV_CAPTOUCH_I2C_SIM_Init();
+    DRV_CAPTOUCH_I2C_SIM_SetPresent(false);
+    I2C_SimResetStatistics();
+    bootReset = I2C_SimGetTime();
+    bootLanded = false;
+}
+
+static void BootSerial(const BOOT_SCENARIO_OBJ *sc, BOOT_RESULT_OBJ *res)
+{
+    uint8_t md;
+
+    BootReset();
+    DRV_CAPTOUCH_I2C_Init();
+
+    // Blocking probe, nothing else runs until the controller answers
+    while(DRV_CAPTOUCH_I2C_GetDeviceMode(&md) != ERR_NONE && BootMs() < BOOT_LIMIT_MS){
+        res->probes++;
+        for(uint8_t i = 0; i < BOOT_PROBE_MS; i++)
+            BootTick(sc);
+    }
+    res->probes++;
+    DRV_CAPTOUCH_I2C_PROFILE_Apply(PROFILE_NORMAL);
+    res->ready_ms = BootMs();
+
+    for(uint32_t i = 0; i < sc->display_ms; i++)
+        BootTick(sc);
+    res->display_ms = BootMs();
+
+    while(!BootTouch() && BootMs() < BOOT_LIMIT_MS)
+        BootTick(sc);
+    res->touch_ms = BootMs();
+}
+
+static void BootOverlapped(const BOOT_SCENARIO_OBJ *sc, BOOT_RESULT_OBJ *res)
+{
+    uint32_t display_left = sc->display_ms;
+    const BOOT_INFO_OBJ *info = DRV_CAPTOUCH_I2C_BOOT_GetInfo();
+
+    BootReset();
+    DRV_CAPTOUCH_I2C_BOOT_Start(PROFILE_NORMAL, NULL, DRV_CAPTOUCH_I2C_TIMESTAMP());
+
+    while(BootMs() < BOOT_LIMIT_MS){
+        BOOT_STATE state = DRV_CAPTOUCH_I2C_BOOT_Task(DRV_CAPTOUCH_I2C_TIMESTAMP());
+
+        if(state == BOOT_FAILED)
+            break;
+        if(state == BOOT_READY && display_left == 0 && BootTouch()){
+            DRV_CAPTOUCH_I2C_BOOT_Touch(DRV_CAPTOUCH_I2C_TIMESTAMP());
+            break;
+        }
+
+        // Display init step in between
+        if(display_left > 0 && --display_left == 0)
+            res->display_ms = BootMs();
+        BootTick(sc);
+    }
+
+    res->probes = info->probes;
+    res->ready_ms = (uint32_t)((uint64_t)info->ready_time * 1000 / DRV_CAPTOUCH_I2C_TIMESTAMP_HZ);
+    res->touch_ms = (uint32_t)((uint64_t)info->first_touch_time * 1000 / DRV_CAPTOUCH_I2C_TIMESTAMP_HZ);
+}
+
+static void BootReport(const char *name, const BOOT_SCENARIO_OBJ *sc, const BOOT_RESULT_OBJ *res)
+{
+    printf("{\"bench\":\"boot\",\"mode\":\"%s\",\"power_on_ms\":%u,\"display_ms\":%u,\"touch_at_ms\":%u,"
+           "\"probes\":%u,\"ready_ms\":%u,\"display_done_ms\":%u,\"first_touch_ms\":%u}\n",
+           name, sc->power_on_ms, sc->display_ms, sc->touch_ms,
+           res->probes, res->ready_ms, res->display_ms, res->touch_ms);
+}
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Main
+
+int main(int argc, char **argv)
+{
+    BOOT_SCENARIO_OBJ sc = { 200, 150, 0 };
+    BOOT_RESULT_OBJ serial = { 0 }, overlapped = { 0 };
+
+    if(argc > 1)
+        sc.power_on_ms = (uint32_t)atoi(argv[1]);
+    if(argc > 2)
+        sc.display_ms = (uint32_t)atoi(argv[2]);
+    if(argc > 3)
+        sc.touch_ms = (uint32_t)atoi(argv[3]);
+
+    BootSerial(&sc, &serial);
+    BootReport("serial", &sc, &serial);
+
+    BootOverlapped(&sc, &overlapped);
+    BootReport("overlapped", &sc, &overlapped);
+
+    return (DRV_CAPTOUCH_I2C_BOOT_GetState() == BOOT_READY) ? 0 : 1;
+}
@@ -0,0 +1,191 @@
+/****************************************************************************************
+  I2C Capacitive Touch Driver: Frame Channel Benchmark
+
+  File Name:
+    captouch_channel.c
+
+  Summary:
+    Two process benchmark of the shared memory frame channel.
+
+  Description:
+    Usage: captouch_channel [frames] [slots] [rate_hz]
+    The parent creates the channel and produces synthetic touch frames into a POSIX shared memory ring
+    (flat out, or paced at rate_hz), a forked consumer opens it by name, sleeps on
+    the doorbell and checks every frame. Both sides print key=value results;
+    the consumer reports the producer to consumer latency.
+ ***************************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "drv_captouch_i2c.h"
+#include "drv_captouch_i2c_channel.h"
+#include "drv_captouch_i2c_shm.h"
+#include "drv_captouch_i2c_workload.h"
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Defines
+
+#define CHANNEL_NAME                "/captouch-channel"
+#define CHANNEL_TIMEOUT_MS          2000
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+
+static uint32_t ChannelNow(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint32_t)ts.tv_sec * 1000000U + (uint32_t)(ts.tv_nsec / 1000);
+}
+
+static int ChannelConsumer(uint32_t frames)
+{
+    SHM_CHANNEL_OBJ shm;
+    const CHANNEL_FRAME_OBJ *frame;
+    uint32_t received = 0, lost = 0, wakeups = 0, expected = 0;
+    uint64_t latency = 0;
+    uint32_t latency_max = 0;
+    int8_t error;
+
+    error = DRV_CAPTOUCH_I2C_SHM_Open(&shm, CHANNEL_NAME);
+    if(error){
+        fprintf(stderr, "consumer: cannot open channel (%d)\n", error);
+        return 1;
+    }
+
+    while(received + lost < frames){
+        if(DRV_CAPTOUCH_I2C_SHM_Wait(&shm, CHANNEL_TIMEOUT_MS))
+            break;
+        wakeups++;
+
+        // Drain completely, the doorbell only rings on empty to non-empty
+        while((frame = DRV_CAPTOUCH_I2C_CHANNEL_Peek(&shm.ch)) != NULL){
+            uint32_t delay = ChannelNow() - frame->timestamp;
+
+            if(frame->sequence != expected)
+                lost += frame->sequence - expected;
+            expected = frame->sequence + 1;
+
+            latency += delay;
+            if(delay > latency_max)
+                latency_max = delay;
+            received++;
+
+            DRV_CAPTOUCH_I2C_CHANNEL_Release(&shm.ch);
+        }
+    }
+
+    printf("consumer frames=%u lost=%u wakeups=%u frames_per_wakeup=%.2f latency_us=%.1f latency_max_us=%u\n",
+           received, lost, wakeups, wakeups ? (double)received / wakeups : 0.0,
+           received ? (double)latency / received : 0.0, latency_max);
+
+    DRV_CAPTOUCH_I2C_SHM_Close(&shm);
+
+    return (received == frames) ? 0 : 1;
+}
+
+static void ChannelProducer(SHM_CHANNEL_OBJ *shm, uint32_t frames, uint32_t rate_hz)
+{
+    WORKLOAD_OBJ w;
+    SIM_TOUCH_OBJ touch[MAX_TOUCHES];
+    CHANNEL_FRAME_OBJ *frame;
+    uint32_t full = 0, start, elapsed;
+
+    DRV_CAPTOUCH_I2C_WORKLOAD_Init(&w, WORKLOAD_MIXED, MAX_TOUCHES, 100, 1);
+    start = ChannelNow();
+
+    for(uint32_t f = 0; f < frames; f++){
+        uint8_t n = DRV_CAPTOUCH_I2C_WORKLOAD_Next(&w, touch);
+
+        if(rate_hz){
+            uint32_t due = start + (uint32_t)((uint64_t)f * 1000000U / rate_hz);
+
+            while((int32_t)(due - ChannelNow()) > 0)
+                usleep(50);
+        }
+
+        // Lossless benchmark: wait for the consumer instead of dropping
+        while((frame = DRV_CAPTOUCH_I2C_CHANNEL_Reserve(&shm->ch)) == NULL){
+            full++;
+            sched_yield();
+        }
+
+        frame->sequence = f;
+        frame->n = n;
+        frame->gesture = GESTURE_NO;
+        for(uint8_t i = 0; i < n; i++){
+            frame->point[i].event_flag = touch[i].event_flag;
+            frame->point[i].x = touch[i].x;
+            frame->point[i].y = touch[i].y;
+            frame->point[i].id = touch[i].id;
+        }
+        frame->timestamp = ChannelNow();
+
+        DRV_CAPTOUCH_I2C_CHANNEL_Commit(&shm->ch);
+    }
+
+    elapsed = ChannelNow() - start;
+
+    printf("producer frames=%u slots=%u fps=%.0f doorbells=%u ring_full=%u\n",
+           frames, shm->ch.mask + 1, elapsed ? frames * 1e6 / elapsed : 0.0, shm->ch.doorbells, full);
+    fflush(stdout);
+}
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Main
+
+int main(int argc, char **argv)
+{
+    SHM_CHANNEL_OBJ shm;
+    uint32_t frames = (argc > 1) ? (uint32_t)atoi(argv[1]) : 100000;
+    uint32_t slots = (argc > 2) ? (uint32_t)atoi(argv[2]) : 16;
+    uint32_t rate_hz = (argc > 3) ? (uint32_t)atoi(argv[3]) : 0;
+    int status = 0;
+    int8_t error;
+    pid_t pid;
+
+    error = DRV_CAPTOUCH_I2C_SHM_Create(&shm, CHANNEL_NAME, slots);
+    if(error){
+        fprintf(stderr, "producer: cannot create channel (%d)\n", error);
+        return 1;
+    }
+
+    fflush(stdout);
+    pid = fork();
+    if(pid < 0){
+        DRV_CAPTOUCH_I2C_SHM_Close(&shm);
+        return 1;
+    }
+    if(pid == 0){
+        // Attach by name like an independent consumer process would
+        shm.owner = false;
+        DRV_CAPTOUCH_I2C_SHM_Close(&shm);
+        return ChannelConsumer(frames);
+    }
+
+    ChannelProducer(&shm, frames, rate_hz);
+
+    // Keep the objects until the consumer is done with them
+    waitpid(pid, &status, 0);
+    DRV_CAPTOUCH_I2C_SHM_Close(&shm);
+
+    return (WIFEXITED(status) && WEXITSTATUS(status) == 0) ? 0 : 1;
+}
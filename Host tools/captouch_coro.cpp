@@ -0,0 +1,199 @@
+/****************************************************************************************
+  I2C Capacitive Touch Driver: Coroutine Check
+
+  File Name:
+    captouch_coro.cpp
+
+  Summary:
+    Runs many coroutines awaiting frame reads and configuration writes on the simulator.
+
+  Description:
+    Usage: captouch_coro [rounds] [tasks]
+    Build the driver sources as C and this file as C++20. Each round steps the
+    workload once, takes a reference frame with DRV_CAPTOUCH_I2C_GetFrame and
+    spawns the tasks: every task awaits two read_frame() calls and every fourth
+    one also a write_config(). All of them are suspended on the bus at the same
+    time and are resumed one by one by the scheduler as i2c_master_callback
+    reports their transfers. Frames are compared with the reference and the
+    last configuration written is read back from the controller. A final spawn
+    beyond CORO_FRAMES_MAX checks that a full pool fails the spawn rather than
+    allocating. One JSON line reports the counts; the exit status is 1 on any
+    error, mismatch or heap allocation.
+ ***************************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#define CORO_FRAMES_MAX             64
+
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include "drv_captouch_i2c_coro.hpp"
+
+extern "C" {
+#include "drv_captouch_i2c_sim.h"
+#include "drv_captouch_i2c_variant.h"
+#include "drv_captouch_i2c_workload.h"
+#include "fsl_i2c_sim.h"
+}
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Types
+
+using Touch = captouch::AsyncFt5x46<>;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Variables
+
+static POINT_OBJ reference[MAX_TOUCHES];
+static uint8_t referenceCount = 0;
+static uint32_t errors = 0, mismatches = 0, reads = 0, writes = 0;
+static uint8_t lastWritten = 0;
+static unsigned long allocations = 0;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Allocation Counter
+
+void *operator new(std::size_t size)
+{
+    allocations++;
+
+    if(void *p = std::malloc(size ? size : 1))
+        return p;
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Tasks
+
+static bool SamePoints(const POINT_OBJ *a, const POINT_OBJ *b, uint8_t n)
+{
+    for(uint8_t i = 0; i < n; i++)
+        if(a[i].x != b[i].x || a[i].y != b[i].y || a[i].id != b[i].id || a[i].event_flag != b[i].event_flag)
+            return false;
+
+    return true;
+}
+
+static captouch::Task Client(Touch &touch, uint32_t id, uint32_t round)
+{
+    for(uint8_t i = 0; i < 2; i++){
+        auto [error, frame] = co_await touch.read_frame();
+
+        reads++;
+        if(error)
+            errors++;
+        else if(frame.count != referenceCount || !SamePoints(frame.point.data(), reference, frame.count))
+            mismatches++;
+    }
+
+    if(id % 4 == 0){
+        CONFIG_OBJ cfg = {};
+        const uint8_t period = 3 + (round + id) % 11;
+
+        cfg.set = CONFIG_PERIODACTIVE;
+        cfg.period_active = period;
+
+        if(co_await touch.write_config(cfg))
+            errors++;
+        else
+            lastWritten = period;
+        writes++;
+    }
+}
+
+static captouch::Task Idle(void)
+{
+    co_return;
+}
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Main
+
+int main(int argc, char **argv)
+{
+    uint32_t rounds = 200, tasks = 48;
+    uint32_t readback = 0, spawnFailures = 0, poolRefused = 0;
+    const TRANSPORT_OBJ *t;
+    WORKLOAD_OBJ w;
+    uint64_t busy;
+    uint32_t xfers;
+
+    if(argc > 1)
+        rounds = (uint32_t)std::atoi(argv[1]);
+    if(argc > 2)
+        tasks = (uint32_t)std::atoi(argv[2]);
+    if(tasks < 1 || tasks > CORO_FRAMES_MAX)
+        tasks = CORO_FRAMES_MAX;
+
+    DRV_CAPTOUCH_I2C_SIM_Init();
+    DRV_CAPTOUCH_I2C_Init();
+    DRV_CAPTOUCH_I2C_VARIANT_Detect();
+    DRV_CAPTOUCH_I2C_WORKLOAD_Init(&w, WORKLOAD_MIXED, MAX_TOUCHES, 100, 5);
+    t = DRV_CAPTOUCH_I2C_GetTransport();
+
+    captouch::Scheduler scheduler;
+    Touch touch(scheduler);
+    const unsigned long allocs = allocations;
+
+    I2C_SimResetStatistics();
+
+    for(uint32_t r = 0; r < rounds; r++){
+        uint8_t period;
+
+        DRV_CAPTOUCH_I2C_WORKLOAD_Step(&w);
+        if(DRV_CAPTOUCH_I2C_GetFrame(reference, &referenceCount))
+            errors++;
+
+        for(uint32_t i = 0; i < tasks; i++)
+            if(!scheduler.spawn(Client(touch, i, r)))
+                spawnFailures++;
+
+        scheduler.run();
+
+        // Straight from the controller, past the shadow
+        if(t->read(t->ctx, OP_REG_PERIODACTIVE, &period, BYTE) || period != lastWritten)
+            readback++;
+    }
+
+    I2C_SimGetStatistics(&busy, &xfers);
+
+    // A full pool refuses the spawn
+    for(uint32_t i = 0; i <= CORO_FRAMES_MAX; i++)
+        if(!scheduler.spawn(Idle()))
+            poolRefused++;
+    scheduler.run();
+
+    std::printf("{\"bench\":\"coro\",\"rounds\":%u,\"tasks\":%u,\"reads\":%u,\"writes\":%u,\"transfers\":%u,"
+                "\"bus_ms\":%.1f,\"errors\":%u,\"mismatches\":%u,\"readback\":%u,\"spawn_failures\":%u,"
+                "\"pool_peak\":%zu,\"frame_bytes\":%zu,\"pool_refused\":%u,\"allocations\":%lu}\n",
+                rounds, tasks, reads, writes, scheduler.transfers(), busy / 1e6, errors, mismatches, readback,
+                spawnFailures, captouch::framePool.peak(), captouch::framePool.largest(), poolRefused,
+                allocations - allocs);
+
+    return (errors || mismatches || readback || spawnFailures || poolRefused != 1 || allocations != allocs) ? 1 : 0;
+}
@@ -0,0 +1,210 @@
+/****************************************************************************************
+  I2C Capacitive Touch Driver: C++ Layer Benchmark
+
+  File Name:
+    captouch_cpp.cpp
+
+  Summary:
+    Compares the templated C++ decode and frame read with the C driver path.
+
+  Description:
+    Usage: captouch_cpp [frames] [repeat]
+    Build the driver sources as C and this file as C++17. Workload register
+    images are decoded by DRV_CAPTOUCH_I2C_DecodeRecords and by
+    captouch::Ft5x46::decode for the default panel, then whole frames are read
+    from the simulator with DRV_CAPTOUCH_I2C_GetFrame and Ft5x46::read_frame.
+    One JSON line per comparison reports cycles per frame of both paths, output
+    mismatches and heap allocations made by the C++ path (counted through
+    operator new). A second configuration (rotated, 5 contacts) is instantiated
+    to show that several panels fit in one build. The exit status is 1 on any
+    mismatch or allocation.
+ ***************************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include "drv_captouch_i2c.hpp"
+
+extern "C" {
+#include "drv_captouch_i2c_bench.h"
+#include "drv_captouch_i2c_sim.h"
+#include "drv_captouch_i2c_variant.h"
+#include "drv_captouch_i2c_workload.h"
+#include "fsl_i2c_sim.h"
+}
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Defines
+
+#define CPP_FRAMES_MAX              4000
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Types
+
+using Touch = captouch::Ft5x46<>;
+using Portrait = captouch::Ft5x46<captouch::DriverTransport, captouch::PanelGeometry<480, 800>,
+                                  captouch::Orientation::Deg90, 5>;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Variables
+
+static uint8_t image[CPP_FRAMES_MAX][WORKLOAD_IMAGE_SIZE];
+static uint8_t contacts[CPP_FRAMES_MAX];
+static POINT_OBJ pointC[MAX_TOUCHES], pointCpp[MAX_TOUCHES];
+static unsigned long allocations = 0;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Allocation Counter
+
+void *operator new(std::size_t size)
+{
+    allocations++;
+
+    if(void *p = std::malloc(size ? size : 1))
+        return p;
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+
+static bool SamePoints(const POINT_OBJ *a, const POINT_OBJ *b, uint8_t n)
+{
+    for(uint8_t i = 0; i < n; i++)
+        if(a[i].x != b[i].x || a[i].y != b[i].y || a[i].id != b[i].id || a[i].event_flag != b[i].event_flag)
+            return false;
+
+    return true;
+}
+
+static void Report(const char *name, uint32_t frames, uint64_t c_cycles, uint64_t cpp_cycles,
+                   uint32_t mismatches, unsigned long allocs)
+{
+    std::printf("{\"bench\":\"cpp\",\"path\":\"%s\",\"frames\":%u,\"c_cycles\":%llu,\"cpp_cycles\":%llu,"
+                "\"mismatches\":%u,\"allocations\":%lu}\n",
+                name, frames, (unsigned long long)(c_cycles / frames), (unsigned long long)(cpp_cycles / frames),
+                mismatches, allocs);
+}
+
+static uint32_t DecodeBench(uint32_t frames, uint32_t repeat)
+{
+    WORKLOAD_OBJ w;
+    SIM_TOUCH_OBJ touch[MAX_TOUCHES];
+    POINT_OBJ portrait[5];
+    uint64_t c_cycles = 0, cpp_cycles = 0;
+    uint32_t mismatches = 0;
+    unsigned long allocs = allocations;
+
+    DRV_CAPTOUCH_I2C_WORKLOAD_Init(&w, WORKLOAD_MIXED, MAX_TOUCHES, 100, 7);
+    for(uint32_t f = 0; f < frames; f++){
+        contacts[f] = DRV_CAPTOUCH_I2C_WORKLOAD_Next(&w, touch);
+        DRV_CAPTOUCH_I2C_WORKLOAD_Image(touch, contacts[f], image[f]);
+    }
+
+    for(uint32_t r = 0; r < repeat; r++){
+        for(uint32_t f = 0; f < frames; f++){
+            uint32_t start = DRV_CAPTOUCH_I2C_BENCH_CYCLES();
+            DRV_CAPTOUCH_I2C_DecodeRecords(&image[f][1], pointC, contacts[f]);
+            uint32_t mid = DRV_CAPTOUCH_I2C_BENCH_CYCLES();
+            Touch::decode(&image[f][1], pointCpp, contacts[f]);
+            uint32_t end = DRV_CAPTOUCH_I2C_BENCH_CYCLES();
+
+            c_cycles += mid - start;
+            cpp_cycles += end - mid;
+            if(!SamePoints(pointC, pointCpp, contacts[f]))
+                mismatches++;
+
+            // Second configuration, same records
+            Portrait::decode(&image[f][1], portrait, contacts[f] < 5 ? contacts[f] : 5);
+        }
+    }
+
+    Report("decode", frames * repeat, c_cycles, cpp_cycles, mismatches, allocations - allocs);
+
+    return mismatches + (uint32_t)(allocations - allocs);
+}
+
+static uint32_t FrameBench(uint32_t frames)
+{
+    static Touch touch;
+    Touch::Frame frame;
+    WORKLOAD_OBJ w;
+    uint64_t c_cycles = 0, cpp_cycles = 0;
+    uint32_t mismatches = 0;
+    unsigned long allocs = allocations;
+    uint8_t n;
+
+    DRV_CAPTOUCH_I2C_SIM_Init();
+    DRV_CAPTOUCH_I2C_Init();
+    DRV_CAPTOUCH_I2C_VARIANT_Detect();
+    DRV_CAPTOUCH_I2C_WORKLOAD_Init(&w, WORKLOAD_MIXED, MAX_TOUCHES, 100, 7);
+
+    for(uint32_t f = 0; f < frames; f++){
+        DRV_CAPTOUCH_I2C_WORKLOAD_Step(&w);
+
+        uint32_t start = DRV_CAPTOUCH_I2C_BENCH_CYCLES();
+        int8_t error = DRV_CAPTOUCH_I2C_GetFrame(pointC, &n);
+        uint32_t mid = DRV_CAPTOUCH_I2C_BENCH_CYCLES();
+        error |= touch.read_frame(frame);
+        uint32_t end = DRV_CAPTOUCH_I2C_BENCH_CYCLES();
+
+        c_cycles += mid - start;
+        cpp_cycles += end - mid;
+        if(error || n != frame.count || !SamePoints(pointC, frame.point.data(), n))
+            mismatches++;
+    }
+
+    Report("frame", frames, c_cycles, cpp_cycles, mismatches, allocations - allocs);
+
+    return mismatches + (uint32_t)(allocations - allocs);
+}
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Main
+
+int main(int argc, char **argv)
+{
+    uint32_t frames = 3000, repeat = 20;
+    uint32_t failures = 0;
+
+    if(argc > 1)
+        frames = (uint32_t)std::atoi(argv[1]);
+    if(argc > 2)
+        repeat = (uint32_t)std::atoi(argv[2]);
+    if(frames < 1 || frames > CPP_FRAMES_MAX)
+        frames = CPP_FRAMES_MAX;
+
+    failures += DecodeBench(frames, repeat);
+    failures += FrameBench(frames);
+
+    return failures ? 1 : 0;
+}
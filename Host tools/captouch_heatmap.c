@@ -0,0 +1,487 @@
+/****************************************************************************************
+  I2C Capacitive Touch Driver: Heatmap Export Tool
+
+  File Name:
+    captouch_heatmap.c
+
+  Summary:
+    Records compressed raw and delta heatmap streams and decodes them for analysis.
+
+  Description:
+    Usage: captouch_heatmap record <stream.bin> [frames] [dead_zone]
+           captouch_heatmap decode <stream.bin> <prefix> [offset]
+    Build with TEST_MODE_EN. record captures frames from the simulated panel,
+    half of them idle and half with a finger moving across it, runs the baseline
+    tracker and writes both streams interleaved to stream.bin. Every frame is
+    decoded again and checked; one JSON line per phase and stream reports the
+    bytes per frame and the compression ratio against 16 bit frames with the
+    same header fields. Then the file is read back once from the start and
+    twice as a receiver joining mid-stream, at a residual frame and in the
+    middle of a frame: from the first keyframe on, the joined receivers must
+    decode every frame up to the end, identical to the full read. decode writes
+    prefix.csv (one line per frame: kind, sequence, timestamp, rows, cols,
+    values) and prefix_raw.npy and prefix_delta.npy arrays of shape (frames,
+    rows, cols), starting at offset.
+ ***************************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "drv_captouch_i2c.h"
+#include "drv_captouch_i2c_baseline.h"
+#include "drv_captouch_i2c_heatmap.h"
+#include "drv_captouch_i2c_raw.h"
+#include "drv_captouch_i2c_sim.h"
+#include "fsl_i2c_sim.h"
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Defines
+
+#define HEATMAP_FRAMES_DEFAULT      128
+#define HEATMAP_PLAIN_HEADER        12      // sequence, timestamp, rows, cols as fixed fields
+#define HEATMAP_NPY_HEADER          128
+#define HEATMAP_BUFFER_SIZE         HEATMAP_MAX_FRAME_SIZE(HEATMAP_NODES)
+#define HEATMAP_JOIN_FRAME          5       // frame pair the boundary join starts at, a residual
+#define HEATMAP_MAX_CHECK           4096    // frames per stream the join check compares
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Types
+
+typedef struct
+{
+    uint32_t    frames;
+    uint64_t    bytes;
+    uint64_t    plain;
+    int32_t     max_error;
+} HEATMAP_RUN_OBJ;
+
+typedef struct
+{
+    FILE        *file;
+    uint32_t    frames;
+    uint8_t     rows;
+    uint8_t     cols;
+} HEATMAP_NPY_OBJ;
+
+/* Decode Output Files */
+typedef struct
+{
+    const char          *prefix;
+    FILE                *csv;
+    HEATMAP_NPY_OBJ     npy[2];
+} HEATMAP_OUTPUT_OBJ;
+
+/* One pass over a recorded stream */
+typedef struct
+{
+    uint32_t    frames[2];
+    uint32_t    first[2];           // sequence of the first and last decoded frame
+    uint32_t    last[2];
+    uint32_t    waiting;            // residual frames skipped without a reference
+    uint32_t    resyncs;
+    uint32_t    skipped;            // bytes dropped to find a keyframe again
+    uint32_t    mismatches;         // frames that differ from the full read
+} HEATMAP_READ_OBJ;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Variables
+
+static const char *kindName[] = {"raw", "delta"};
+
+static RAW_FRAME_OBJ raw;
+static DELTA_FRAME_OBJ delta;
+static HEATMAP_FRAME_OBJ decoded;
+static HEATMAP_OBJ encoder[2];
+static HEATMAP_OBJ decoder[2];
+static uint8_t buffer[HEATMAP_BUFFER_SIZE];
+static uint32_t frameHash[2][HEATMAP_MAX_CHECK];
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+
+static int8_t HeatmapCheck(HEATMAP_KIND kind, const uint16_t *data, uint16_t len, HEATMAP_RUN_OBJ *run)
+{
+    uint16_t used, n;
+    int8_t error = 0;
+
+    error = DRV_CAPTOUCH_I2C_HEATMAP_Decode(&decoder[kind], buffer, len, &decoded, &used);
+    if(error || used != len)
+        return ERR_FORMAT;
+
+    n = decoded.rows * decoded.cols;
+    for(uint16_t i = 0; i < n; i++){
+        int32_t a = (kind == HEATMAP_DELTA) ? (int16_t)data[i] : data[i];
+        int32_t b = (kind == HEATMAP_DELTA) ? (int16_t)decoded.data[i] : decoded.data[i];
+        int32_t e = (a > b) ? a - b : b - a;
+
+        if(e > run->max_error)
+            run->max_error = e;
+    }
+
+    run->frames++;
+    run->bytes += len;
+    run->plain += HEATMAP_PLAIN_HEADER + 2 * n;
+
+    return error;
+}
+
+static uint32_t HeatmapHash(const HEATMAP_FRAME_OBJ *f)
+{
+    uint32_t hash = 2166136261U ^ f->timestamp;
+
+    for(uint16_t i = 0; i < f->rows * f->cols; i++)
+        hash = (hash ^ f->data[i]) * 16777619U;
+
+    return hash;
+}
+
+static uint8_t *HeatmapLoad(const char *path, long *size)
+{
+    FILE *in = fopen(path, "rb");
+    uint8_t *stream;
+
+    if(in == NULL){
+        perror(path);
+        return NULL;
+    }
+    fseek(in, 0, SEEK_END);
+    *size = ftell(in);
+    fseek(in, 0, SEEK_SET);
+    stream = malloc(*size ? *size : 1);
+    if(stream != NULL && fread(stream, 1, *size, in) != (size_t)*size){
+        free(stream);
+        stream = NULL;
+    }
+    fclose(in);
+
+    return stream;
+}
+
+// Decodes stream from offset on; frames go to sink unless it is NULL, and are hashed (store) or checked
+static int8_t HeatmapRead(const uint8_t *stream, long size, long offset, bool store, HEATMAP_READ_OBJ *read,
+                          int8_t (*sink)(const HEATMAP_FRAME_OBJ *f, void *arg), void *arg)
+{
+    long pos = offset;
+    int8_t error = 0;
+
+    memset(read, 0, sizeof(*read));
+    DRV_CAPTOUCH_I2C_HEATMAP_Init(&decoder[HEATMAP_RAW], HEATMAP_RAW, 0, 0);
+    DRV_CAPTOUCH_I2C_HEATMAP_Init(&decoder[HEATMAP_DELTA], HEATMAP_DELTA, 0, 0);
+
+    while(pos < size){
+        uint16_t len = (size - pos > 0xFFFF) ? 0xFFFF : (uint16_t)(size - pos);
+        HEATMAP_KIND kind = HEATMAP_RAW;
+        uint16_t used = 0, skip;
+        uint32_t index;
+
+        error = DRV_CAPTOUCH_I2C_HEATMAP_Peek(&stream[pos], len, &kind);
+        if(!error)
+            error = DRV_CAPTOUCH_I2C_HEATMAP_Decode(&decoder[kind], &stream[pos], len, &decoded, &used);
+        if(error == ERR_BUSY){
+            read->waiting++;
+            pos += used;
+            continue;
+        }
+        if(error){
+            // Frames of either stream may have been dropped, both start again at a keyframe
+            skip = DRV_CAPTOUCH_I2C_HEATMAP_Resync(&stream[pos], len);
+            read->resyncs++;
+            read->skipped += skip;
+            pos += skip;
+            DRV_CAPTOUCH_I2C_HEATMAP_Init(&decoder[HEATMAP_RAW], HEATMAP_RAW, 0, 0);
+            DRV_CAPTOUCH_I2C_HEATMAP_Init(&decoder[HEATMAP_DELTA], HEATMAP_DELTA, 0, 0);
+            continue;
+        }
+        pos += used;
+
+        if(read->frames[kind]++ == 0)
+            read->first[kind] = decoded.sequence;
+        read->last[kind] = decoded.sequence;
+
+        index = decoded.sequence % HEATMAP_MAX_CHECK;
+        if(store)
+            frameHash[kind][index] = HeatmapHash(&decoded);
+        else if(frameHash[kind][index] != HeatmapHash(&decoded))
+            read->mismatches++;
+
+        if(sink != NULL){
+            error = sink(&decoded, arg);
+            if(error){
+                return error;
+            }
+        }
+    }
+
+    return ERR_NONE;
+}
+
+// A joined receiver decodes every frame from its first one to the end, as the full read did
+static bool HeatmapJoin(const char *name, const uint8_t *stream, long size, long offset,
+                        const HEATMAP_READ_OBJ *full)
+{
+    HEATMAP_READ_OBJ read;
+    bool ok = true;
+
+    HeatmapRead(stream, size, offset, false, &read, NULL, NULL);
+    for(uint8_t k = 0; k < 2; k++)
+        ok = ok && read.frames[k] && read.last[k] == full->last[k]
+                && read.frames[k] == read.last[k] - read.first[k] + 1;
+    ok = ok && !read.mismatches;
+
+    printf("{\"check\":\"heatmap_join\",\"at\":\"%s\",\"offset\":%ld,\"raw_frames\":%u,\"delta_frames\":%u,"
+           "\"waiting\":%u,\"resyncs\":%u,\"skipped_bytes\":%u,\"mismatches\":%u,\"ok\":%s}\n",
+           name, offset, read.frames[HEATMAP_RAW], read.frames[HEATMAP_DELTA], read.waiting, read.resyncs,
+           read.skipped, read.mismatches, ok ? "true" : "false");
+
+    return ok;
+}
+
+static int8_t HeatmapPhase(const char *name, FILE *out, uint32_t frames, bool touch, long *join)
+{
+    HEATMAP_RUN_OBJ run[2];
+    uint16_t len;
+    int8_t error = 0;
+
+    memset(run, 0, sizeof(run));
+
+    for(uint32_t f = 0; f < frames; f++){
+        SIM_TOUCH_OBJ finger = { EVENT_HOLD, (uint16_t)(100 + (f * 9) % (MAX_X_PIXEL - 200)), 240, 0, 40, 3 };
+
+        DRV_CAPTOUCH_I2C_SIM_SetTouches(&finger, touch ? 1 : 0);
+
+        error = DRV_CAPTOUCH_I2C_RAW_Capture(&raw);
+        if(!error)
+            error = DRV_CAPTOUCH_I2C_BASELINE_Process(&raw, &delta);
+        if(error){
+            return error;
+        }
+
+        error = DRV_CAPTOUCH_I2C_HEATMAP_EncodeRaw(&encoder[HEATMAP_RAW], &raw, buffer, sizeof(buffer), &len);
+        if(!error)
+            error = HeatmapCheck(HEATMAP_RAW, raw.data, len, &run[HEATMAP_RAW]);
+        if(error){
+            return error;
+        }
+        if(f == HEATMAP_JOIN_FRAME && join != NULL)
+            *join = ftell(out);
+        fwrite(buffer, 1, len, out);
+
+        error = DRV_CAPTOUCH_I2C_HEATMAP_EncodeDelta(&encoder[HEATMAP_DELTA], &delta, buffer, sizeof(buffer), &len);
+        if(!error)
+            error = HeatmapCheck(HEATMAP_DELTA, (const uint16_t *)delta.data, len, &run[HEATMAP_DELTA]);
+        if(error){
+            return error;
+        }
+        fwrite(buffer, 1, len, out);
+    }
+
+    for(uint8_t k = 0; k < 2; k++){
+        uint64_t bpf = run[k].frames ? run[k].bytes / run[k].frames : 0;
+        uint64_t ratio = run[k].bytes ? run[k].plain * 100 / run[k].bytes : 0;
+
+        printf("{\"bench\":\"heatmap\",\"phase\":\"%s\",\"kind\":\"%s\",\"frames\":%u,\"nodes\":%u,"
+               "\"bytes_per_frame\":%llu,\"plain_per_frame\":%u,\"ratio\":%llu.%02llu,\"max_error\":%d}\n",
+               name, kindName[k], run[k].frames, raw.rows * raw.cols, (unsigned long long)bpf,
+               HEATMAP_PLAIN_HEADER + 2 * raw.rows * raw.cols,
+               (unsigned long long)(ratio / 100), (unsigned long long)(ratio % 100), run[k].max_error);
+    }
+
+    return error;
+}
+
+static int HeatmapRecord(const char *path, uint32_t frames, uint16_t dead_zone)
+{
+    FILE *out = fopen(path, "wb");
+    HEATMAP_READ_OBJ full;
+    uint8_t *stream;
+    long size, join = 0;
+    bool ok;
+    int8_t error = 0;
+
+    if(out == NULL){
+        perror(path);
+        return 1;
+    }
+
+    DRV_CAPTOUCH_I2C_SIM_Init();
+    I2C_SimSetBusClock(I2C3, 400000);
+    error = DRV_CAPTOUCH_I2C_Init();
+    if(!error)
+        error = DRV_CAPTOUCH_I2C_RAW_Start();
+    if(error){
+        fprintf(stderr, "raw start failed: %d\n", error);
+        fclose(out);
+        return 1;
+    }
+
+    DRV_CAPTOUCH_I2C_BASELINE_Init(NULL);
+    DRV_CAPTOUCH_I2C_HEATMAP_Init(&encoder[HEATMAP_RAW], HEATMAP_RAW, HEATMAP_KEYFRAME_INTERVAL, 0);
+    DRV_CAPTOUCH_I2C_HEATMAP_Init(&encoder[HEATMAP_DELTA], HEATMAP_DELTA, HEATMAP_KEYFRAME_INTERVAL, dead_zone);
+    DRV_CAPTOUCH_I2C_HEATMAP_Init(&decoder[HEATMAP_RAW], HEATMAP_RAW, 0, 0);
+    DRV_CAPTOUCH_I2C_HEATMAP_Init(&decoder[HEATMAP_DELTA], HEATMAP_DELTA, 0, 0);
+
+    error = HeatmapPhase("idle", out, frames / 2, false, &join);
+    if(!error)
+        error = HeatmapPhase("touch", out, frames - frames / 2, true, NULL);
+
+    DRV_CAPTOUCH_I2C_RAW_Stop();
+    fclose(out);
+
+    if(error){
+        fprintf(stderr, "record failed: %d\n", error);
+        return 1;
+    }
+
+    stream = HeatmapLoad(path, &size);
+    if(stream == NULL)
+        return 1;
+
+    HeatmapRead(stream, size, 0, true, &full, NULL, NULL);
+    ok = !full.waiting && !full.resyncs && full.frames[HEATMAP_RAW] == frames && full.frames[HEATMAP_DELTA] == frames;
+    if(join){
+        ok = HeatmapJoin("frame", stream, size, join, &full) && ok;
+        ok = HeatmapJoin("mid_frame", stream, size, join + 7, &full) && ok;
+    }
+    free(stream);
+
+    return ok ? 0 : 1;
+}
+
+// Fixed size header, rewritten with the final frame count when the file is closed
+static void NpyHeader(HEATMAP_NPY_OBJ *npy, HEATMAP_KIND kind)
+{
+    char header[HEATMAP_NPY_HEADER];
+    int len;
+
+    memset(header, ' ', sizeof(header));
+    memcpy(header, "\x93NUMPY\x01\x00", 8);
+    header[8] = HEATMAP_NPY_HEADER - 10;
+    header[9] = 0;
+    len = snprintf(&header[10], sizeof(header) - 10,
+                   "{'descr': '%s', 'fortran_order': False, 'shape': (%10u, %u, %u), }",
+                   (kind == HEATMAP_DELTA) ? "<i2" : "<u2", npy->frames, npy->rows, npy->cols);
+    header[10 + len] = ' ';
+    header[sizeof(header) - 1] = '\n';
+
+    fseek(npy->file, 0, SEEK_SET);
+    fwrite(header, 1, sizeof(header), npy->file);
+    fseek(npy->file, 0, SEEK_END);
+}
+
+static int8_t NpyAppend(HEATMAP_NPY_OBJ *npy, const char *prefix, const HEATMAP_FRAME_OBJ *f)
+{
+    uint16_t n = f->rows * f->cols;
+    char path[256];
+
+    if(npy->file == NULL){
+        snprintf(path, sizeof(path), "%s_%s.npy", prefix, kindName[f->kind]);
+        npy->file = fopen(path, "wb");
+        if(npy->file == NULL)
+            return ERR_ARGUMENT;
+        npy->rows = f->rows;
+        npy->cols = f->cols;
+        NpyHeader(npy, f->kind);
+    }
+
+    // A fixed shape array cannot take another panel size
+    if(f->rows != npy->rows || f->cols != npy->cols)
+        return ERR_FORMAT;
+
+    for(uint16_t i = 0; i < n; i++){
+        uint8_t le[2] = { (uint8_t)f->data[i], (uint8_t)(f->data[i] >> 8) };
+
+        fwrite(le, 1, 2, npy->file);
+    }
+    npy->frames++;
+
+    return ERR_NONE;
+}
+
+static int8_t HeatmapOutput(const HEATMAP_FRAME_OBJ *f, void *arg)
+{
+    HEATMAP_OUTPUT_OBJ *out = arg;
+
+    fprintf(out->csv, "%s,%u,%u,%u,%u", kindName[f->kind], f->sequence, f->timestamp, f->rows, f->cols);
+    for(uint16_t i = 0; i < f->rows * f->cols; i++)
+        fprintf(out->csv, ",%d", (f->kind == HEATMAP_DELTA) ? (int16_t)f->data[i] : f->data[i]);
+    fprintf(out->csv, "\n");
+
+    return NpyAppend(&out->npy[f->kind], out->prefix, f);
+}
+
+static int HeatmapDecode(const char *path, const char *prefix, long offset)
+{
+    HEATMAP_OUTPUT_OBJ out;
+    HEATMAP_READ_OBJ read;
+    uint8_t *stream;
+    long size;
+    char csvPath[256];
+    int8_t error = 0;
+
+    stream = HeatmapLoad(path, &size);
+    if(stream == NULL)
+        return 1;
+
+    snprintf(csvPath, sizeof(csvPath), "%s.csv", prefix);
+    memset(&out, 0, sizeof(out));
+    out.prefix = prefix;
+    out.csv = fopen(csvPath, "w");
+    if(out.csv == NULL){
+        perror(csvPath);
+        free(stream);
+        return 1;
+    }
+
+    error = HeatmapRead(stream, size, (offset < size) ? offset : size, true, &read, HeatmapOutput, &out);
+    if(error)
+        fprintf(stderr, "cannot write %s output: %d\n", prefix, error);
+
+    for(uint8_t k = 0; k < 2; k++){
+        if(out.npy[k].file != NULL){
+            NpyHeader(&out.npy[k], (HEATMAP_KIND)k);
+            fclose(out.npy[k].file);
+        }
+    }
+    fclose(out.csv);
+    free(stream);
+
+    printf("{\"decode\":\"%s\",\"bytes\":%ld,\"offset\":%ld,\"raw_frames\":%u,\"delta_frames\":%u,"
+           "\"waiting\":%u,\"resyncs\":%u,\"skipped_bytes\":%u}\n",
+           path, size, offset, out.npy[HEATMAP_RAW].frames, out.npy[HEATMAP_DELTA].frames,
+           read.waiting, read.resyncs, read.skipped);
+
+    return error ? 1 : 0;
+}
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Main
+
+int main(int argc, char **argv)
+{
+    if(argc >= 3 && strcmp(argv[1], "record") == 0)
+        return HeatmapRecord(argv[2], (argc > 3) ? (uint32_t)atoi(argv[3]) : HEATMAP_FRAMES_DEFAULT,
+                             (argc > 4) ? (uint16_t)atoi(argv[4]) : 0);
+
+    if(argc >= 4 && strcmp(argv[1], "decode") == 0)
+        return HeatmapDecode(argv[2], argv[3], (argc > 4) ? atol(argv[4]) : 0);
+
+    fprintf(stderr, "usage: %s record <stream.bin> [frames] [dead_zone]\n"
+                    "       %s decode <stream.bin> <prefix> [offset]\n", argv[0], argv[0]);
+
+    return 2;
+}
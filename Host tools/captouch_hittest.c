@@ -0,0 +1,286 @@
+/****************************************************************************************
+  I2C Capacitive Touch Driver: Hit-Test Benchmark
+
+  File Name:
+    captouch_hittest.c
+
+  Summary:
+    Compares the hit-test grid with a linear scan over all widgets.
+
+  Description:
+    Usage: captouch_hittest [widgets] [frames]
+    A screen of buttons on a background with overlapping dialogs is registered
+    in the index and in a flat widget list. Mixed workload frames are read from
+    the simulator through DRV_CAPTOUCH_I2C_HITTEST_GetFrame; every tenth frame
+    widgets are moved, removed and inserted again. Each tagged contact must
+    match the topmost widget the linear scan finds. Random points then time
+    both lookups, and inserting past the node pool must fail without changing
+    the answers. One JSON line each reports the timing and the check; the exit
+    status is 1 on any mismatch.
+ ***************************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "drv_captouch_i2c.h"
+#include "drv_captouch_i2c_bench.h"
+#include "drv_captouch_i2c_hittest.h"
+#include "drv_captouch_i2c_sim.h"
+#include "drv_captouch_i2c_variant.h"
+#include "drv_captouch_i2c_workload.h"
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Defines
+
+#define WIDGET_SIZE                 36
+#define WIDGET_PITCH                40
+#define WIDGET_DIALOGS              4
+#define HITTEST_POINTS              200000
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Types
+
+/* Reference Widget, the newest of the highest z wins */
+typedef struct
+{
+    HITTEST_RECT_OBJ    rect;
+    uint32_t            sequence;
+    uint16_t            handle;
+    uint8_t             z;
+    bool                live;
+} WIDGET_OBJ;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Variables
+
+static WIDGET_OBJ widget[HITTEST_REGIONS_MAX];
+static uint16_t widgets = 0;
+static uint32_t sequence = 0;
+static uint32_t seed = 1;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+
+static uint32_t Random(void)
+{
+    seed = seed * 1664525U + 1013904223U;
+
+    return seed >> 8;
+}
+
+static uint16_t LinearLookup(uint16_t x, uint16_t y)
+{
+    const WIDGET_OBJ *best = NULL;
+
+    for(uint16_t i = 0; i < widgets; i++){
+        const WIDGET_OBJ *w = &widget[i];
+
+        if(!w->live || x < w->rect.x || y < w->rect.y
+           || x >= (uint32_t)w->rect.x + w->rect.w || y >= (uint32_t)w->rect.y + w->rect.h)
+            continue;
+        if(best == NULL || w->z > best->z || (w->z == best->z && w->sequence > best->sequence))
+            best = w;
+    }
+
+    return best ? (uint16_t)(best - widget) : HITTEST_NONE;
+}
+
+static int8_t Add(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint8_t z)
+{
+    WIDGET_OBJ *wd = &widget[widgets];
+    int8_t error;
+
+    wd->rect = (HITTEST_RECT_OBJ){ x, y, w, h };
+    wd->z = z;
+
+    error = DRV_CAPTOUCH_I2C_HITTEST_Insert(&wd->rect, z, widgets, &wd->handle);
+    if(error)
+        return error;
+
+    wd->sequence = sequence++;
+    wd->live = true;
+    widgets++;
+
+    return error;
+}
+
+// Moves one widget, takes another one off the screen or puts it back
+static uint32_t Churn(void)
+{
+    WIDGET_OBJ *w = &widget[1 + Random() % (widgets - 1)];
+    HITTEST_RECT_OBJ rect = w->rect;
+    uint32_t errors = 0;
+
+    if(w->live){
+        rect.x = (uint16_t)(Random() % (HITTEST_WIDTH - rect.w));
+        rect.y = (uint16_t)(Random() % (HITTEST_HEIGHT - rect.h));
+        if(DRV_CAPTOUCH_I2C_HITTEST_Move(w->handle, &rect))
+            errors++;
+        w->rect = rect;
+        w->sequence = sequence++;
+    }
+
+    w = &widget[1 + Random() % (widgets - 1)];
+    if(w->live){
+        if(DRV_CAPTOUCH_I2C_HITTEST_Remove(w->handle))
+            errors++;
+        w->live = false;
+    }
+    else{
+        if(DRV_CAPTOUCH_I2C_HITTEST_Insert(&w->rect, w->z, (uint16_t)(w - widget), &w->handle))
+            errors++;
+        w->sequence = sequence++;
+        w->live = true;
+    }
+
+    return errors;
+}
+
+static uint32_t RandomCheck(uint32_t points)
+{
+    uint32_t mismatches = 0;
+
+    for(uint32_t i = 0; i < points; i++){
+        uint16_t x = (uint16_t)(Random() % (HITTEST_WIDTH + 1));
+        uint16_t y = (uint16_t)(Random() % (HITTEST_HEIGHT + 1));
+
+        if(DRV_CAPTOUCH_I2C_HITTEST_Lookup(x, y) != LinearLookup(x, y))
+            mismatches++;
+    }
+
+    return mismatches;
+}
+
+static void Timing(uint32_t points, double *grid, double *linear)
+{
+    static uint16_t px[HITTEST_POINTS], py[HITTEST_POINTS];
+    volatile uint16_t sink = 0;
+    uint32_t start;
+    uint32_t cycles;
+
+    for(uint32_t i = 0; i < points; i++){
+        px[i] = (uint16_t)(Random() % (HITTEST_WIDTH + 1));
+        py[i] = (uint16_t)(Random() % (HITTEST_HEIGHT + 1));
+    }
+
+    start = DRV_CAPTOUCH_I2C_BENCH_CYCLES();
+    for(uint32_t i = 0; i < points; i++)
+        sink ^= DRV_CAPTOUCH_I2C_HITTEST_Lookup(px[i], py[i]);
+    cycles = DRV_CAPTOUCH_I2C_BENCH_CYCLES() - start;
+    *grid = (double)cycles / points;
+
+    start = DRV_CAPTOUCH_I2C_BENCH_CYCLES();
+    for(uint32_t i = 0; i < points; i++)
+        sink ^= LinearLookup(px[i], py[i]);
+    cycles = DRV_CAPTOUCH_I2C_BENCH_CYCLES() - start;
+    *linear = (double)cycles / points;
+
+    (void)sink;
+}
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Main
+
+int main(int argc, char **argv)
+{
+    uint32_t count = 200, frames = 3000;
+    uint32_t contacts = 0, mismatches = 0, errors = 0, churns = 0, refused = 0;
+    POINT_OBJ point[MAX_TOUCHES];
+    uint16_t region[MAX_TOUCHES];
+    HITTEST_STATS_OBJ stats;
+    HITTEST_RECT_OBJ full = { 0, 0, HITTEST_WIDTH, HITTEST_HEIGHT };
+    uint16_t handle;
+    WORKLOAD_OBJ w;
+    double grid, linear;
+    int8_t error;
+    uint8_t n;
+
+    if(argc > 1)
+        count = (uint32_t)atoi(argv[1]);
+    if(argc > 2)
+        frames = (uint32_t)atoi(argv[2]);
+    if(count < WIDGET_DIALOGS + 2 || count > HITTEST_REGIONS_MAX - 8)
+        count = HITTEST_REGIONS_MAX - 8;
+
+    DRV_CAPTOUCH_I2C_SIM_Init();
+    DRV_CAPTOUCH_I2C_Init();
+    DRV_CAPTOUCH_I2C_VARIANT_Detect();
+    DRV_CAPTOUCH_I2C_WORKLOAD_Init(&w, WORKLOAD_MIXED, MAX_TOUCHES, 100, 11);
+    DRV_CAPTOUCH_I2C_HITTEST_Init();
+
+    // Background, buttons in rows, dialogs on top
+    errors += Add(0, 0, HITTEST_WIDTH, HITTEST_HEIGHT, 0) != 0;
+    for(uint32_t i = 0; widgets < count - WIDGET_DIALOGS; i++){
+        uint16_t x = (uint16_t)(4 + (i % (HITTEST_WIDTH / WIDGET_PITCH)) * WIDGET_PITCH);
+        uint16_t y = (uint16_t)(4 + (i / (HITTEST_WIDTH / WIDGET_PITCH)) % (HITTEST_HEIGHT / WIDGET_PITCH) * WIDGET_PITCH);
+
+        if(Add(x, y, WIDGET_SIZE, WIDGET_SIZE, 1)){
+            errors++;
+            break;
+        }
+    }
+    for(uint8_t d = 0; d < WIDGET_DIALOGS; d++)
+        errors += Add(100 + 90 * d, 60 + 50 * d, 300, 200, 2 + (d & 1)) != 0;
+
+    for(uint32_t f = 0; f < frames; f++){
+        DRV_CAPTOUCH_I2C_WORKLOAD_Step(&w);
+
+        if(DRV_CAPTOUCH_I2C_HITTEST_GetFrame(point, region, &n)){
+            errors++;
+            continue;
+        }
+
+        for(uint8_t i = 0; i < n; i++)
+            if(region[i] != LinearLookup(point[i].x, point[i].y))
+                mismatches++;
+        contacts += n;
+
+        if(f % 10 == 9){
+            errors += Churn();
+            churns++;
+        }
+    }
+
+    mismatches += RandomCheck(HITTEST_POINTS / 4);
+    Timing(HITTEST_POINTS, &grid, &linear);
+    DRV_CAPTOUCH_I2C_HITTEST_GetStats(&stats);
+
+    printf("{\"bench\":\"hittest\",\"regions\":%u,\"cells\":%u,\"nodes\":%u,\"longest\":%u,"
+           "\"probes_per_lookup\":%.2f,\"grid_cycles\":%.1f,\"linear_cycles\":%.1f,\"speedup\":%.1f}\n",
+           stats.regions, HITTEST_COLS * HITTEST_ROWS, stats.nodes, stats.longest,
+           stats.lookups ? (double)stats.probes / stats.lookups : 0.0, grid, linear, grid > 0 ? linear / grid : 0.0);
+
+    // Full screen regions until the node pool runs out; the failed one must leave no trace
+    while(widgets < HITTEST_REGIONS_MAX){
+        error = Add(full.x, full.y, full.w, full.h, 1);
+        if(error == ERR_OVERFLOW){
+            refused++;
+            break;
+        }
+        errors += error != 0;
+    }
+    if(DRV_CAPTOUCH_I2C_HITTEST_Insert(NULL, 0, 0, &handle) != ERR_ARGUMENT)
+        errors++;
+    if(DRV_CAPTOUCH_I2C_HITTEST_Remove(HITTEST_NONE) != ERR_ARGUMENT)
+        errors++;
+    mismatches += RandomCheck(HITTEST_POINTS / 4);
+
+    printf("{\"check\":\"hittest\",\"frames\":%u,\"contacts\":%u,\"churns\":%u,\"mismatches\":%u,"
+           "\"errors\":%u,\"overflow_refused\":%u}\n", frames, contacts, churns, mismatches, errors, refused);
+
+    return (mismatches || errors || refused != 1) ? 1 : 0;
+}
@@ -0,0 +1,196 @@
+/****************************************************************************************
+  I2C Capacitive Touch Driver: i2c-dev Tool
+
+  File Name:
+    captouch_i2cdev.c
+
+  Summary:
+    Runs the decode pipeline over the Linux i2c-dev transport.
+
+  Description:
+    Built with I2CDEV_EN: captouch_i2cdev [/dev/i2c-N] [frames]
+      polls the controller at 100 Hz and prints every contact.
+    Built with I2CDEV_EN and I2CDEV_LOOPBACK: captouch_i2cdev [--smbus] [frames]
+      drives a mixed synthetic workload through the loopback bus (--smbus emulates
+      i2c-stub) and prints key=value results including ioctls per frame. Frames
+      are read with DRV_CAPTOUCH_I2C_GetFrame; with plain I2C a frame with the
+      contact count of the previous one must take exactly one ioctl. A
+      TD_STATUS of 0x0F or 0xFF (controller not ready) must be refused without
+      changing the burst the next frame is read with. The exit status is 1 on
+      any failed check.
+ ***************************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "drv_captouch_i2c.h"
+#include "drv_captouch_i2c_i2cdev.h"
+#ifdef I2CDEV_LOOPBACK
+#include "drv_captouch_i2c_loopback.h"
+#include "drv_captouch_i2c_sim.h"
+#include "drv_captouch_i2c_workload.h"
+#include "fsl_i2c_sim.h"
+#endif
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Variables
+
+static POINT_OBJ points[MAX_TOUCHES];
+
+
+#ifdef I2CDEV_LOOPBACK
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+
+static uint64_t BusTime(void)
+{
+    uint64_t busy;
+    uint32_t transfers;
+
+    I2C_SimGetStatistics(&busy, &transfers);
+
+    return busy;
+}
+
+// One contact, then not-ready reports: the next one-contact frame must take the same bus time
+static bool NotReadyRefused(void)
+{
+    static const uint8_t notReady[] = { 0x0F, 0xFF };
+    uint64_t steady, after;
+    uint8_t n;
+    bool ok = true;
+
+    DRV_CAPTOUCH_I2C_SIM_SetRegister(OP_REG_TDSTATUS, 1);
+    ok = !DRV_CAPTOUCH_I2C_GetFrame(points, &n) && ok;
+    steady = BusTime();
+    ok = !DRV_CAPTOUCH_I2C_GetFrame(points, &n) && n == 1 && ok;
+    steady = BusTime() - steady;
+
+    for(uint8_t i = 0; i < sizeof(notReady); i++){
+        DRV_CAPTOUCH_I2C_SIM_SetRegister(OP_REG_TDSTATUS, notReady[i]);
+        ok = DRV_CAPTOUCH_I2C_GetFrame(points, &n) == ERR_FORMAT && ok;
+    }
+
+    DRV_CAPTOUCH_I2C_SIM_SetRegister(OP_REG_TDSTATUS, 1);
+    after = BusTime();
+    ok = !DRV_CAPTOUCH_I2C_GetFrame(points, &n) && n == 1 && ok;
+    after = BusTime() - after;
+
+    return ok && after == steady;
+}
+#endif
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Main
+
+int main(int argc, char **argv)
+{
+    const char *path = NULL;
+    uint32_t frames = 0, contacts = 0, errors = 0;
+    uint32_t checksum = 0, calls, steadyFrames = 0, steadyCalls = 0, loopCalls = 0;
+    uint8_t last = 0xFF;
+    int8_t error;
+
+    for(int a = 1; a < argc; a++){
+#ifdef I2CDEV_LOOPBACK
+        if(strcmp(argv[a], "--smbus") == 0){
+            DRV_CAPTOUCH_I2C_LOOPBACK_SetSmbusOnly(true);
+            continue;
+        }
+#endif
+        if(argv[a][0] == '/')
+            path = argv[a];
+        else
+            frames = (uint32_t)atoi(argv[a]);
+    }
+
+#ifdef I2CDEV_LOOPBACK
+    WORKLOAD_OBJ w;
+
+    if(frames == 0)
+        frames = 10000;
+
+    DRV_CAPTOUCH_I2C_SIM_Init();
+    DRV_CAPTOUCH_I2C_WORKLOAD_Init(&w, WORKLOAD_MIXED, MAX_TOUCHES, 100, 1);
+#endif
+
+    DRV_CAPTOUCH_I2C_I2CDEV_SetDevice(path, 0);
+    error = DRV_CAPTOUCH_I2C_Init();
+    if(error){
+        fprintf(stderr, "cannot open %s (%d)\n", path ? path : I2CDEV_PATH, error);
+        return 1;
+    }
+
+    for(uint32_t f = 0; frames == 0 || f < frames; f++){
+        uint8_t n;
+
+#ifdef I2CDEV_LOOPBACK
+        DRV_CAPTOUCH_I2C_WORKLOAD_Step(&w);
+#else
+        usleep(10000);
+#endif
+
+        calls = DRV_CAPTOUCH_I2C_I2CDEV_GetCalls();
+        error = DRV_CAPTOUCH_I2C_GetFrame(points, &n);
+        calls = DRV_CAPTOUCH_I2C_I2CDEV_GetCalls() - calls;
+        loopCalls += calls;
+        if(error){
+            errors++;
+            last = 0xFF;
+            continue;
+        }
+
+        // The speculative read covers the whole frame when the count did not change
+        if(n == last){
+            steadyFrames++;
+            steadyCalls += calls;
+        }
+        last = n;
+
+        for(uint8_t i = 0; i < n; i++){
+            checksum = checksum * 31 + (points[i].x ^ (points[i].y << 12) ^ (points[i].id << 24));
+#ifndef I2CDEV_LOOPBACK
+            printf("id=%u event=%u x=%u y=%u\n", points[i].id, points[i].event_flag, points[i].x, points[i].y);
+#endif
+        }
+        contacts += n;
+    }
+
+    printf("frames=%u contacts=%u errors=%u smbus=%u ioctls_per_frame=%.2f steady_frames=%u "
+           "ioctls_per_steady_frame=%.2f checksum=%08x",
+           frames, contacts, errors, DRV_CAPTOUCH_I2C_I2CDEV_IsSmbus(), frames ? (double)loopCalls / frames : 0.0,
+           steadyFrames, steadyFrames ? (double)steadyCalls / steadyFrames : 0.0, checksum);
+#ifdef I2CDEV_LOOPBACK
+    uint64_t busy;
+    uint32_t transfers;
+
+    I2C_SimGetStatistics(&busy, &transfers);
+    printf(" bus_us_per_frame=%.1f", busy / 1e3 / frames);
+#endif
+#ifdef I2CDEV_LOOPBACK
+    bool refused = NotReadyRefused();
+
+    printf(" not_ready_refused=%u", refused);
+    if(!refused)
+        errors++;
+#endif
+    printf("\n");
+
+    DRV_CAPTOUCH_I2C_I2CDEV_Close();
+
+    if(!DRV_CAPTOUCH_I2C_I2CDEV_IsSmbus() && steadyCalls != steadyFrames)
+        return 1;
+
+    return errors ? 1 : 0;
+}
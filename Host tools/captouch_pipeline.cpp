@@ -0,0 +1,218 @@
+/****************************************************************************************
+  I2C Capacitive Touch Driver: Pipeline Benchmark
+
+  File Name:
+    captouch_pipeline.cpp
+
+  Summary:
+    Per-stage cycle counts of processing pipelines with different stage sets.
+
+  Description:
+    Usage: captouch_pipeline [frames] [repeat]
+    Build the driver sources as C and this file as C++17; BENCH_EN is defined
+    here unless the build already does, so the pipeline stages are timed. Mixed workload register images run
+    through the full chain, a kiosk chain (clamp and filter), decode only and
+    decode, clamp and filter once on PipelineFrame (filter_aos) and once on
+    SoaFrame (filter_soa). For each one the harness prints its JSON lines
+    (bench = composition name, frame = the whole run), followed by a summary
+    with the object size. The decode-only pipeline is then compared with
+    DRV_CAPTOUCH_I2C_DecodeRecords, the two layouts with each other through
+    SoaFrame::to_points, and the full chain must report swipes for single
+    finger flicks and zooms for two finger pinches; the exit status is 1
+    otherwise.
+ ***************************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#ifndef BENCH_EN
+#define BENCH_EN
+#endif
+
+#include <cstdio>
+#include <cstdlib>
+#include "drv_captouch_i2c_pipeline.hpp"
+
+extern "C" {
+#include "drv_captouch_i2c_workload.h"
+}
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Defines
+
+#define PIPELINE_FRAMES_MAX         4000
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Types
+
+using namespace captouch;
+
+using Full = Pipeline<Decode<>, Clamp<>, Calibrate<>, Smooth<>, Track<>, Gesture<>>;
+using Kiosk = Pipeline<Decode<>, Clamp<>, Smooth<>>;
+using DecodeOnly = Pipeline<Decode<>>;
+using FilterAos = Pipeline<Decode<>, Clamp<>, Smooth<>>;
+using FilterSoa = Pipeline<DecodeSoa<>, Clamp<>, Smooth<>>;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Variables
+
+static uint8_t image[PIPELINE_FRAMES_MAX][WORKLOAD_IMAGE_SIZE];
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+
+static void Output(const char *line)
+{
+    std::puts(line);
+}
+
+template<typename P>
+static void Run(const char *name, P &pipeline, uint32_t frames, uint32_t repeat)
+{
+    typename P::Frame frame;
+
+    DRV_CAPTOUCH_I2C_BENCH_Reset();
+
+    for(uint32_t r = 0; r < repeat; r++){
+        for(uint32_t f = 0; f < frames; f++){
+            DRV_CAPTOUCH_I2C_BENCH_Begin(BENCH_STAGE_FRAME);
+            pipeline.run(image[f], frame);
+            DRV_CAPTOUCH_I2C_BENCH_End(BENCH_STAGE_FRAME);
+        }
+    }
+
+    DRV_CAPTOUCH_I2C_BENCH_Report(name, NULL, Output);
+    std::printf("{\"bench\":\"%s\",\"bytes\":%zu}\n", name, sizeof(P));
+}
+
+static uint32_t DecodeCheck(uint32_t frames)
+{
+    DecodeOnly pipeline;
+    DecodeOnly::Frame frame;
+    POINT_OBJ point[MAX_TOUCHES];
+    uint32_t mismatches = 0;
+
+    for(uint32_t f = 0; f < frames; f++){
+        pipeline.run(image[f], frame);
+        DRV_CAPTOUCH_I2C_DecodeRecords(&image[f][1], point, image[f][0]);
+
+        if(frame.count != image[f][0])
+            mismatches++;
+        for(uint8_t i = 0; i < frame.count; i++)
+            if(frame.point[i].x != point[i].x || frame.point[i].y != point[i].y || frame.point[i].id != point[i].id)
+                mismatches++;
+    }
+
+    return mismatches;
+}
+
+// Both layouts through the filter must give the same points
+static uint32_t LayoutCheck(uint32_t frames)
+{
+    FilterAos aos;
+    FilterSoa soa;
+    FilterAos::Frame a;
+    FilterSoa::Frame b;
+    POINT_OBJ point[MAX_TOUCHES];
+    uint32_t mismatches = 0;
+
+    for(uint32_t f = 0; f < frames; f++){
+        aos.run(image[f], a);
+        soa.run(image[f], b);
+        b.to_points(point);
+
+        if(a.count != b.count)
+            mismatches++;
+        for(uint8_t i = 0; i < a.count; i++)
+            if(a.point[i].x != point[i].x || a.point[i].y != point[i].y || a.point[i].id != point[i].id
+               || a.point[i].event_flag != point[i].event_flag)
+                mismatches++;
+    }
+
+    return mismatches;
+}
+
+// Single finger flicks must give swipes, two finger pinches zooms
+static uint32_t GestureCheck(WORKLOAD_SCENARIO scenario, uint8_t fingers, uint32_t frames)
+{
+    Full pipeline;
+    Full::Frame frame;
+    SIM_TOUCH_OBJ touch[MAX_TOUCHES];
+    uint8_t report[WORKLOAD_IMAGE_SIZE];
+    WORKLOAD_OBJ w;
+    uint32_t swipes = 0, zooms = 0;
+
+    DRV_CAPTOUCH_I2C_WORKLOAD_Init(&w, scenario, fingers, 100, 9);
+    for(uint32_t f = 0; f < frames; f++){
+        DRV_CAPTOUCH_I2C_WORKLOAD_Image(touch, DRV_CAPTOUCH_I2C_WORKLOAD_Next(&w, touch), report);
+        pipeline.run(report, frame);
+
+        if(frame.gesture == GESTURE_ZOOM_IN || frame.gesture == GESTURE_ZOOM_OUT)
+            zooms++;
+        else if(frame.gesture != GESTURE_NO)
+            swipes++;
+    }
+
+    std::printf("{\"check\":\"gesture\",\"fingers\":%u,\"frames\":%u,\"swipes\":%u,\"zooms\":%u}\n",
+                fingers, frames, swipes, zooms);
+
+    return (fingers == 1) ? (swipes == 0) : (zooms == 0);
+}
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Main
+
+int main(int argc, char **argv)
+{
+    uint32_t frames = 3000, repeat = 20;
+    SIM_TOUCH_OBJ touch[MAX_TOUCHES];
+    WORKLOAD_OBJ w;
+    static Full full;
+    static Kiosk kiosk;
+    static DecodeOnly decode;
+    static FilterAos filterAos;
+    static FilterSoa filterSoa;
+    uint32_t mismatches, layout;
+
+    if(argc > 1)
+        frames = (uint32_t)std::atoi(argv[1]);
+    if(argc > 2)
+        repeat = (uint32_t)std::atoi(argv[2]);
+    if(frames < 1 || frames > PIPELINE_FRAMES_MAX)
+        frames = PIPELINE_FRAMES_MAX;
+
+    DRV_CAPTOUCH_I2C_WORKLOAD_Init(&w, WORKLOAD_MIXED, MAX_TOUCHES, 100, 3);
+    for(uint32_t f = 0; f < frames; f++)
+        DRV_CAPTOUCH_I2C_WORKLOAD_Image(touch, DRV_CAPTOUCH_I2C_WORKLOAD_Next(&w, touch), image[f]);
+
+    // A slight scale and offset, as a three point calibration would give
+    full.stage<Calibrate<>>().set(66191, 0, -3 * 65536, 0, 65208, 2 * 65536);
+
+    Run("full", full, frames, repeat);
+    Run("kiosk", kiosk, frames, repeat);
+    Run("decode", decode, frames, repeat);
+    Run("filter_aos", filterAos, frames, repeat);
+    Run("filter_soa", filterSoa, frames, repeat);
+
+    mismatches = DecodeCheck(frames);
+    std::printf("{\"check\":\"decode\",\"frames\":%u,\"mismatches\":%u}\n", frames, mismatches);
+    layout = LayoutCheck(frames);
+    std::printf("{\"check\":\"layout\",\"frames\":%u,\"mismatches\":%u}\n", frames, layout);
+    mismatches += layout;
+    mismatches += GestureCheck(WORKLOAD_FLICK, 1, frames);
+    mismatches += GestureCheck(WORKLOAD_PINCH, 2, frames);
+
+    return mismatches ? 1 : 0;
+}
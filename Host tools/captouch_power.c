@@ -0,0 +1,262 @@
+/****************************************************************************************
+  I2C Capacitive Touch Driver: Power Management Check
+
+  File Name:
+    captouch_power.c
+
+  Summary:
+    Wake-to-first-frame latency of the monitor and the hibernate wake.
+
+  Description:
+    Usage: captouch_power [cycles]
+    The acquisition loop runs on the simulator in 1 ms steps: INT is sampled,
+    the frame is read one step later and DRV_CAPTOUCH_I2C_POWER_Service runs
+    every step. Each cycle touches the panel, stays idle past the monitor
+    timeout, touches again (monitor wake), then stays idle until the driver
+    hibernates the controller and wakes it with DRV_CAPTOUCH_I2C_POWER_Wake,
+    with a finger already on the panel. The board wake callback alternates
+    between the INT pin, which keeps the registers, and a RST pulse, which
+    brings back the power-on defaults. Every cycle starts with a profile switch
+    through DRV_CAPTOUCH_I2C_PROFILE_Service while monitor mode is on; the
+    power settings must survive it, and after each wake the power settings and
+    the profile must be in the controller again. One JSON line per wake kind
+    reports the latencies, the exit status is 1 on any failed check.
+ ***************************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "drv_captouch_i2c.h"
+#include "drv_captouch_i2c_power.h"
+#include "drv_captouch_i2c_profile.h"
+#include "drv_captouch_i2c_sim.h"
+#include "fsl_i2c_sim.h"
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Defines
+
+#define POWER_STEP_NS               1000000ULL      // 1 ms per loop iteration
+#define POWER_TOUCH_MS              200
+#define POWER_MONITOR_IDLE_S        2               // TIMMONITOR, not the power-on default
+#define POWER_MONITOR_PERIOD        0x14            // PERIODMONITOR, not the power-on default
+#define POWER_HIBERNATE_MS          5000
+#define POWER_RESET_MS              5               // RST pulse and controller start-up
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Types
+
+typedef enum {
+    WAKE_MONITOR        = 0x00,
+    WAKE_INT,
+    WAKE_RST,
+    WAKE_KINDS
+} WAKE_KIND;
+
+/* Latency per wake kind, in microseconds */
+typedef struct
+{
+    uint32_t    wakes;
+    uint32_t    max;
+    uint64_t    total;
+} WAKE_RESULT_OBJ;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Variables
+
+static const char *const wakeName[WAKE_KINDS] = { "monitor", "int", "rst" };
+static const PROFILE_ID switchTo[PROFILES] = { PROFILE_GLOVE, PROFILE_WET, PROFILE_LOW_POWER, PROFILE_NORMAL };
+static WAKE_RESULT_OBJ result[WAKE_KINDS];
+
+static bool wakeByReset = false;
+static bool framePending = false;
+static uint32_t errors = 0;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+
+static void BoardWake(void)
+{
+    if(wakeByReset){
+        DRV_CAPTOUCH_I2C_SIM_Reset();
+        I2C_SimAdvanceTime(POWER_RESET_MS * POWER_STEP_NS);
+    }
+    else{
+        DRV_CAPTOUCH_I2C_SIM_Wake();
+    }
+}
+
+// One millisecond of the acquisition loop, touch is NULL while nothing changes on the panel
+static void Step(const SIM_TOUCH_OBJ *touch)
+{
+    POINT_OBJ point[MAX_TOUCHES];
+    uint8_t n;
+
+    I2C_SimAdvanceTime(POWER_STEP_NS);
+
+    if(framePending){
+        framePending = false;
+        if(DRV_CAPTOUCH_I2C_GetFrame(point, &n))
+            errors++;
+        else
+            DRV_CAPTOUCH_I2C_POWER_Frame(DRV_CAPTOUCH_I2C_TIMESTAMP(), n);
+        if(DRV_CAPTOUCH_I2C_PROFILE_Service())
+            errors++;
+    }
+
+    if(touch != NULL)
+        DRV_CAPTOUCH_I2C_SIM_SetTouches(touch, 1);
+
+    if(DRV_CAPTOUCH_I2C_SIM_GetInt()){
+        DRV_CAPTOUCH_I2C_POWER_Interrupt(DRV_CAPTOUCH_I2C_TIMESTAMP());
+        framePending = true;
+    }
+
+    if(DRV_CAPTOUCH_I2C_POWER_Service(DRV_CAPTOUCH_I2C_TIMESTAMP()))
+        errors++;
+}
+
+static void Touch(uint32_t ms)
+{
+    SIM_TOUCH_OBJ finger = { EVENT_DOWN, 400, 240, 0, 40, 3 };
+
+    for(uint32_t i = 0; i < ms; i++){
+        finger.event_flag = (i == 0) ? EVENT_DOWN : (i + 1 == ms) ? EVENT_UP : EVENT_HOLD;
+        finger.x = (uint16_t)(400 + i);
+        Step(&finger);
+    }
+    Step(NULL);
+}
+
+static void Idle(uint32_t ms)
+{
+    for(uint32_t i = 0; i < ms; i++)
+        Step(NULL);
+}
+
+// The latency is recorded with the first frame with contacts after the wake
+static void Measure(WAKE_KIND kind, uint32_t wakes)
+{
+    POWER_STATS_OBJ stats;
+    uint32_t us;
+
+    DRV_CAPTOUCH_I2C_POWER_GetStats(&stats);
+    if(stats.wakes != wakes + 1){
+        errors++;
+        return;
+    }
+
+    us = (uint32_t)((uint64_t)stats.last * 1000000 / DRV_CAPTOUCH_I2C_TIMESTAMP_HZ);
+    result[kind].wakes++;
+    result[kind].total += us;
+    if(us > result[kind].max)
+        result[kind].max = us;
+}
+
+static uint32_t PowerKept(void)
+{
+    uint32_t mismatches = 0;
+
+    mismatches += DRV_CAPTOUCH_I2C_SIM_GetRegister(OP_REG_CTRL) != POWER_CTRL_AUTO_MONITOR;
+    mismatches += DRV_CAPTOUCH_I2C_SIM_GetRegister(OP_REG_TIMMONITOR) != POWER_MONITOR_IDLE_S;
+    mismatches += DRV_CAPTOUCH_I2C_SIM_GetRegister(OP_REG_PERIODMONITOR) != POWER_MONITOR_PERIOD;
+
+    return mismatches;
+}
+
+static uint32_t Restored(uint8_t thgroup)
+{
+    uint32_t mismatches = PowerKept();
+
+    mismatches += DRV_CAPTOUCH_I2C_SIM_GetRegister(OP_REG_PMODE) != PMODE_ACTIVE;
+    mismatches += DRV_CAPTOUCH_I2C_SIM_GetRegister(OP_REG_THGROUP) != thgroup;
+
+    return mismatches;
+}
+
+static uint32_t Cycle(bool reset, PROFILE_ID profile, uint32_t *switchMismatches)
+{
+    POWER_STATS_OBJ stats;
+    uint32_t mismatches = 0;
+    uint8_t thgroup;
+
+    // The switch lands after the first frame, with monitor mode enabled
+    DRV_CAPTOUCH_I2C_PROFILE_Request(profile);
+    Touch(POWER_TOUCH_MS);
+    if(DRV_CAPTOUCH_I2C_PROFILE_GetActive() != profile)
+        errors++;
+    *switchMismatches += PowerKept();
+    thgroup = DRV_CAPTOUCH_I2C_SIM_GetRegister(OP_REG_THGROUP);
+
+    // Monitor: the controller left active mode by itself, the touch wakes it
+    Idle(POWER_MONITOR_IDLE_S * 1000 + 500);
+    if(DRV_CAPTOUCH_I2C_POWER_GetState() != POWER_MONITOR)
+        errors++;
+    DRV_CAPTOUCH_I2C_POWER_GetStats(&stats);
+    Touch(POWER_TOUCH_MS);
+    Measure(WAKE_MONITOR, stats.wakes);
+
+    // Hibernate: the host wakes it, a finger is already on the panel
+    Idle(POWER_HIBERNATE_MS + 100);
+    if(!DRV_CAPTOUCH_I2C_SIM_IsHibernating() || DRV_CAPTOUCH_I2C_POWER_GetState() != POWER_HIBERNATE)
+        errors++;
+
+    DRV_CAPTOUCH_I2C_POWER_GetStats(&stats);
+    wakeByReset = reset;
+    if(DRV_CAPTOUCH_I2C_POWER_Wake())
+        errors++;
+    mismatches += Restored(thgroup);
+    Touch(POWER_TOUCH_MS);
+    Measure(reset ? WAKE_RST : WAKE_INT, stats.wakes);
+
+    return mismatches;
+}
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Main
+
+int main(int argc, char **argv)
+{
+    POWER_CONFIG_OBJ cfg = { POWER_MONITOR_IDLE_S, POWER_MONITOR_PERIOD, POWER_HIBERNATE_MS, BoardWake };
+    POWER_STATS_OBJ stats;
+    uint32_t cycles = 2 * PROFILES, mismatches = 0, switchMismatches = 0;
+
+    if(argc > 1)
+        cycles = (uint32_t)atoi(argv[1]);
+    if(cycles < PROFILES)
+        cycles = PROFILES;
+
+    DRV_CAPTOUCH_I2C_SIM_Init();
+    DRV_CAPTOUCH_I2C_Init();
+    if(DRV_CAPTOUCH_I2C_PROFILE_Apply(PROFILE_NORMAL))
+        errors++;
+    if(DRV_CAPTOUCH_I2C_POWER_Init(&cfg, DRV_CAPTOUCH_I2C_TIMESTAMP()))
+        errors++;
+
+    for(uint32_t c = 0; c < cycles; c++)
+        mismatches += Cycle(c & 1, switchTo[c % PROFILES], &switchMismatches);
+
+    for(uint8_t k = 0; k < WAKE_KINDS; k++)
+        printf("{\"bench\":\"power\",\"wake\":\"%s\",\"wakes\":%u,\"mean_us\":%.1f,\"max_us\":%u}\n",
+               wakeName[k], result[k].wakes, result[k].wakes ? (double)result[k].total / result[k].wakes : 0.0,
+               result[k].max);
+
+    DRV_CAPTOUCH_I2C_POWER_GetStats(&stats);
+    printf("{\"check\":\"power\",\"cycles\":%u,\"wakes\":%u,\"changed_by_switch\":%u,\"not_restored\":%u,"
+           "\"errors\":%u}\n", cycles, stats.wakes, switchMismatches, mismatches, errors);
+
+    return (stats.wakes != 2 * cycles || switchMismatches || mismatches || errors) ? 1 : 0;
+}
@@ -0,0 +1,127 @@
+/****************************************************************************************
+  I2C Capacitive Touch Driver: Profile Switching Check
+
+  File Name:
+    captouch_profile.c
+
+  Summary:
+    Acquisition with the water heuristic switching profiles between frames.
+
+  Description:
+    Usage: captouch_profile [dry_frames] [wet_frames]
+    One finger flicks over the simulated panel; during the wet phase droplets
+    touch down and lift again on every other frame. Each frame is read with
+    DRV_CAPTOUCH_I2C_GetFrame, fed to DRV_CAPTOUCH_I2C_PROFILE_WetDetect and
+    followed by DRV_CAPTOUCH_I2C_PROFILE_Service, as an acquisition loop does.
+    The controller's threshold register is sampled around every read: it may
+    only change in Service, between two frames. The dry phase after the wet one
+    is long enough for PROFILE_WET_EXIT. One JSON line per profile switch gives
+    the frame it landed after; the exit status is 1 unless the wet profile was
+    entered and left again with no change during a frame read.
+ ***************************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "drv_captouch_i2c.h"
+#include "drv_captouch_i2c_profile.h"
+#include "drv_captouch_i2c_sim.h"
+#include "drv_captouch_i2c_workload.h"
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Defines
+
+#define DROPLET_ID0                 14      // clear of the IDs the flick uses
+#define DROPLET_ID1                 15
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+
+// Two droplets alternate: one touches down while the other lifts
+static uint8_t Droplets(uint32_t f, SIM_TOUCH_OBJ *touch, uint8_t n)
+{
+    const uint16_t x = 100 + (f * 37) % 600, y = 80 + (f * 53) % 320;
+
+    touch[n++] = (SIM_TOUCH_OBJ){ (f & 1) ? EVENT_UP : EVENT_DOWN, x, y, DROPLET_ID0, 8, 1 };
+    if(f > 0)
+        touch[n++] = (SIM_TOUCH_OBJ){ (f & 1) ? EVENT_DOWN : EVENT_UP, y, x, DROPLET_ID1, 8, 1 };
+
+    return n;
+}
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Main
+
+int main(int argc, char **argv)
+{
+    uint32_t dry = 200, wet = 200, frames, wetStart, wetEnd;
+    uint32_t errors = 0, duringRead = 0, switches = 0, entered = 0, left = 0;
+    SIM_TOUCH_OBJ touch[MAX_TOUCHES];
+    POINT_OBJ point[MAX_TOUCHES];
+    PROFILE_ID active;
+    WORKLOAD_OBJ w;
+    uint8_t before, n;
+
+    if(argc > 1)
+        dry = (uint32_t)atoi(argv[1]);
+    if(argc > 2)
+        wet = (uint32_t)atoi(argv[2]);
+
+    wetStart = dry;
+    wetEnd = dry + wet;
+    frames = wetEnd + PROFILE_WET_EXIT + dry;
+
+    DRV_CAPTOUCH_I2C_SIM_Init();
+    DRV_CAPTOUCH_I2C_Init();
+    DRV_CAPTOUCH_I2C_WORKLOAD_Init(&w, WORKLOAD_FLICK, 1, 100, 23);
+    if(DRV_CAPTOUCH_I2C_PROFILE_Apply(PROFILE_NORMAL))
+        errors++;
+    active = DRV_CAPTOUCH_I2C_PROFILE_GetActive();
+
+    for(uint32_t f = 0; f < frames; f++){
+        n = DRV_CAPTOUCH_I2C_WORKLOAD_Next(&w, touch);
+        if(f >= wetStart && f < wetEnd)
+            n = Droplets(f - wetStart, touch, n);
+        DRV_CAPTOUCH_I2C_SIM_SetTouches(touch, n);
+
+        before = DRV_CAPTOUCH_I2C_SIM_GetRegister(OP_REG_THGROUP);
+        if(DRV_CAPTOUCH_I2C_GetFrame(point, &n))
+            errors++;
+        if(DRV_CAPTOUCH_I2C_SIM_GetRegister(OP_REG_THGROUP) != before)
+            duringRead++;
+
+        DRV_CAPTOUCH_I2C_PROFILE_WetDetect(point, n);
+        if(DRV_CAPTOUCH_I2C_PROFILE_Service())
+            errors++;
+
+        if(DRV_CAPTOUCH_I2C_PROFILE_GetActive() != active){
+            PROFILE_ID next = DRV_CAPTOUCH_I2C_PROFILE_GetActive();
+
+            printf("{\"switch\":\"%s\",\"to\":\"%s\",\"after_frame\":%u,\"phase\":\"%s\",\"thgroup\":%u}\n",
+                   DRV_CAPTOUCH_I2C_PROFILE_GetName(active), DRV_CAPTOUCH_I2C_PROFILE_GetName(next), f,
+                   (f >= wetStart && f < wetEnd) ? "wet" : "dry", DRV_CAPTOUCH_I2C_SIM_GetRegister(OP_REG_THGROUP));
+
+            if(next == PROFILE_WET && f >= wetStart && f < wetEnd)
+                entered++;
+            if(active == PROFILE_WET && f >= wetEnd)
+                left++;
+            active = next;
+            switches++;
+        }
+    }
+
+    printf("{\"check\":\"profile\",\"frames\":%u,\"switches\":%u,\"entered\":%u,\"left\":%u,"
+           "\"changed_during_read\":%u,\"errors\":%u}\n", frames, switches, entered, left, duringRead, errors);
+
+    return (entered != 1 || left != 1 || switches != 2 || duringRead || errors) ? 1 : 0;
+}
@@ -0,0 +1,201 @@
+/****************************************************************************************
+  I2C Capacitive Touch Driver: Report Rate Lock Check
+
+  File Name:
+    captouch_rate.c
+
+  Summary:
+    Phase lock of the INT cadence to a drifting, jittering display refresh.
+
+  Description:
+    Usage: captouch_rate [display_hz] [drift_ppm] [jitter_us] [frames]
+    The controller reports at the PERIODACTIVE step read back from the
+    simulator, off by drift_ppm from the nominal rate and with up to jitter_us
+    of random INT jitter; vsync comes at display_hz with a fifth of that
+    jitter. Every INT edge goes to DRV_CAPTOUCH_I2C_RATE_Interrupt followed by
+    DRV_CAPTOUCH_I2C_RATE_Service, every vsync to DRV_CAPTOUCH_I2C_RATE_Vsync.
+    Once two vsyncs gave the refresh period, the phase error must come inside
+    the lock window within RATE_CONVERGE_FRAMES reports and then stay within the
+    window plus the slip of one report and the jitter, and the step must stay
+    within one of the nominal step. At RATE_STEP_MAX a slow controller has no
+    step left to catch up with. One JSON line reports the result, the exit
+    status is 1 on any failed check.
+ ***************************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "drv_captouch_i2c.h"
+#include "drv_captouch_i2c_rate.h"
+#include "drv_captouch_i2c_sim.h"
+#include "fsl_i2c_sim.h"
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Defines
+
+#define RATE_LEAD_US                4000
+#define RATE_CONVERGE_FRAMES        120
+#define RATE_NS_PER_S               1000000000ULL
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Variables
+
+static uint32_t seed = 1;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+
+// Uniform in -range..range
+static int64_t Jitter(uint32_t range)
+{
+    seed = seed * 1664525U + 1013904223U;
+
+    return range ? (int64_t)((seed >> 8) % (2 * range + 1)) - range : 0;
+}
+
+static void AdvanceTo(uint64_t ns)
+{
+    uint64_t now = I2C_SimGetTime();
+
+    if(ns > now)
+        I2C_SimAdvanceTime(ns - now);
+}
+
+static uint64_t ReportPeriod(uint8_t step, int32_t drift_ppm)
+{
+    uint64_t nominal = RATE_NS_PER_S / ((uint64_t)step * RATE_HZ_PER_STEP);
+
+    return (uint64_t)((int64_t)nominal + (int64_t)nominal * drift_ppm / 1000000);
+}
+
+static uint32_t TicksToUs(int64_t ticks)
+{
+    return (uint32_t)((ticks < 0 ? -ticks : ticks) * 1000000 / DRV_CAPTOUCH_I2C_TIMESTAMP_HZ);
+}
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Main
+
+int main(int argc, char **argv)
+{
+    uint32_t display_hz = 60, jitter_us = 200, frames = 2000;
+    int32_t drift_ppm = 20000;
+    uint64_t vsync_ns, next_int, next_vsync, slip_ns;
+    uint32_t window, bound, reports = 0, measured = 0, vsyncs = 0, converged = 0, unlocked = 0, outside = 0;
+    uint32_t steps = 0;
+    uint32_t error_us, max_error_us = 0, errors = 0;
+    uint8_t nominal, step, step_min, step_max, last_step;
+    int32_t phase;
+
+    if(argc > 1)
+        display_hz = (uint32_t)atoi(argv[1]);
+    if(argc > 2)
+        drift_ppm = atoi(argv[2]);
+    if(argc > 3)
+        jitter_us = (uint32_t)atoi(argv[3]);
+    if(argc > 4)
+        frames = (uint32_t)atoi(argv[4]);
+    if(display_hz < RATE_STEP_MIN * RATE_HZ_PER_STEP || display_hz > RATE_STEP_MAX * RATE_HZ_PER_STEP)
+        display_hz = 60;
+    if(frames <= RATE_CONVERGE_FRAMES)
+        frames = RATE_CONVERGE_FRAMES + 1;
+
+    DRV_CAPTOUCH_I2C_SIM_Init();
+    DRV_CAPTOUCH_I2C_Init();
+    if(DRV_CAPTOUCH_I2C_RATE_Sync((uint16_t)display_hz,
+                                  (uint32_t)((uint64_t)RATE_LEAD_US * DRV_CAPTOUCH_I2C_TIMESTAMP_HZ / 1000000)))
+        errors++;
+
+    nominal = DRV_CAPTOUCH_I2C_SIM_GetRegister(OP_REG_PERIODACTIVE);
+    step_min = step_max = last_step = nominal;
+    vsync_ns = RATE_NS_PER_S / display_hz;
+
+    // Worst phase change between two reports once one step off nominal
+    slip_ns = 0;
+    for(int8_t d = -1; d <= 1; d += 2){
+        uint8_t s = (uint8_t)(nominal + d);
+        int64_t diff;
+
+        if(s < RATE_STEP_MIN || s > RATE_STEP_MAX)
+            continue;
+        diff = (int64_t)ReportPeriod(s, drift_ppm) - (int64_t)vsync_ns;
+        if((uint64_t)(diff < 0 ? -diff : diff) > slip_ns)
+            slip_ns = (uint64_t)(diff < 0 ? -diff : diff);
+    }
+    window = (uint32_t)((vsync_ns >> RATE_PHASE_WINDOW_SHIFT) / 1000);
+    bound = window + (uint32_t)((slip_ns + 2 * jitter_us * 1000ULL) / 1000);
+
+    // Start half a refresh out of phase
+    next_vsync = I2C_SimGetTime() + vsync_ns;
+    next_int = next_vsync + vsync_ns / 2;
+
+    while(reports < frames){
+        if(next_vsync <= next_int){
+            AdvanceTo(next_vsync);
+            DRV_CAPTOUCH_I2C_RATE_Vsync(DRV_CAPTOUCH_I2C_TIMESTAMP());
+            next_vsync += (uint64_t)((int64_t)vsync_ns + Jitter(jitter_us * 200));
+            vsyncs++;
+            continue;
+        }
+
+        AdvanceTo(next_int);
+        DRV_CAPTOUCH_I2C_RATE_Interrupt(DRV_CAPTOUCH_I2C_TIMESTAMP());
+        if(DRV_CAPTOUCH_I2C_RATE_Service())
+            errors++;
+        reports++;
+
+        // The controller scans the next report at the step now in its register
+        step = DRV_CAPTOUCH_I2C_SIM_GetRegister(OP_REG_PERIODACTIVE);
+        if(step != last_step)
+            steps++;
+        last_step = step;
+        if(step < step_min)
+            step_min = step;
+        if(step > step_max)
+            step_max = step;
+        next_int += (uint64_t)((int64_t)ReportPeriod(step, drift_ppm) + Jitter(jitter_us * 1000));
+
+        // The phase is known once two vsyncs gave the refresh period
+        if(vsyncs < 2)
+            continue;
+        measured++;
+
+        phase = DRV_CAPTOUCH_I2C_RATE_GetPhaseError();
+        error_us = TicksToUs(phase);
+        if(!converged){
+            if(error_us <= window)
+                converged = measured;
+            continue;
+        }
+
+        if(error_us > window)
+            unlocked++;
+        if(error_us > bound)
+            outside++;
+        if(error_us > max_error_us)
+            max_error_us = error_us;
+    }
+
+    printf("{\"check\":\"rate\",\"display_hz\":%u,\"drift_ppm\":%d,\"jitter_us\":%u,\"reports\":%u,"
+           "\"nominal_hz\":%u,\"step_min\":%u,\"step_max\":%u,\"step_changes\":%u,\"interval_us\":%u,"
+           "\"converged_after\":%u,\"window_us\":%u,\"bound_us\":%u,\"max_error_us\":%u,"
+           "\"outside_window\":%u,\"outside_bound\":%u,\"errors\":%u}\n",
+           display_hz, drift_ppm, jitter_us, reports, nominal * RATE_HZ_PER_STEP, step_min, step_max, steps,
+           TicksToUs(DRV_CAPTOUCH_I2C_RATE_GetInterval()), converged, window, bound, max_error_us,
+           unlocked, outside, errors);
+
+    return (converged == 0 || converged > RATE_CONVERGE_FRAMES || outside
+            || step_min + 1 < nominal || step_max > nominal + 1 || errors) ? 1 : 0;
+}
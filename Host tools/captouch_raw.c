@@ -0,0 +1,136 @@
+/****************************************************************************************
+  I2C Capacitive Touch Driver: Raw Capture Benchmark
+
+  File Name:
+    captouch_raw.c
+
+  Summary:
+    Raw capacitance frame rate in TEST_MODE on the simulated bus.
+
+  Description:
+    Usage: captouch_raw [frames] [bus_hz] [--dump]
+    Build with TEST_MODE_EN. A synthetic finger moves across the simulated panel
+    while frames are captured back to back. One JSON line reports the frame
+    rate, the scan and readout times of the last frame and the bus time per
+    frame; --dump prints the last frame as rows of counts. Then the simulated
+    controller stops clearing the STARTSCAN busy bit: the capture must give up
+    with ERR_TIMEOUT and the next one must succeed once the scan completes
+    again. The exit status is 1 on any failed check.
+ ***************************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "drv_captouch_i2c.h"
+#include "drv_captouch_i2c_raw.h"
+#include "drv_captouch_i2c_sim.h"
+#include "fsl_i2c_sim.h"
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Defines
+
+#define RAW_FRAMES_DEFAULT          100
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Variables
+
+static RAW_FRAME_OBJ frame;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+
+static uint32_t RawUs(uint32_t ticks)
+{
+    return (uint32_t)((uint64_t)ticks * 1000000 / DRV_CAPTOUCH_I2C_TIMESTAMP_HZ);
+}
+
+static void RawDump(const RAW_FRAME_OBJ *f)
+{
+    for(uint8_t r = 0; r < f->rows; r++){
+        for(uint8_t c = 0; c < f->cols; c++)
+            printf("%s%u", c ? "," : "", f->data[r * f->cols + c]);
+        printf("\n");
+    }
+}
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Main
+
+int main(int argc, char **argv)
+{
+    uint32_t frames = RAW_FRAMES_DEFAULT;
+    RAW_STATS_OBJ stats;
+    uint64_t busy, stuckNs;
+    uint32_t xfers;
+    bool dump = false;
+    int8_t error = 0, stuckError, recoverError;
+
+    for(int i = 1, pos = 0; i < argc; i++){
+        if(strcmp(argv[i], "--dump") == 0)
+            dump = true;
+        else if(pos++ == 0)
+            frames = (uint32_t)atoi(argv[i]);
+        else
+            I2C_SimSetBusClock(I2C3, (uint32_t)atoi(argv[i]));
+    }
+
+    DRV_CAPTOUCH_I2C_SIM_Init();
+    error = DRV_CAPTOUCH_I2C_Init();
+    if(!error)
+        error = DRV_CAPTOUCH_I2C_RAW_Start();
+    if(error){
+        fprintf(stderr, "raw start failed: %d\n", error);
+        return 1;
+    }
+
+    I2C_SimResetStatistics();
+    for(uint32_t i = 0; i < frames; i++){
+        SIM_TOUCH_OBJ finger = { EVENT_HOLD, (uint16_t)(40 + (i * 7) % (MAX_X_PIXEL - 80)), 240, 0, 40, 3 };
+
+        DRV_CAPTOUCH_I2C_SIM_SetTouches(&finger, 1);
+        error = DRV_CAPTOUCH_I2C_RAW_Capture(&frame);
+        if(error){
+            fprintf(stderr, "raw capture failed: %d\n", error);
+            return 1;
+        }
+    }
+
+    DRV_CAPTOUCH_I2C_RAW_GetStats(&stats);
+    I2C_SimGetStatistics(&busy, &xfers);
+
+    // A scan that never completes must not hang the capture
+    DRV_CAPTOUCH_I2C_SIM_SetScanStuck(true);
+    stuckNs = I2C_SimGetTime();
+    stuckError = DRV_CAPTOUCH_I2C_RAW_Capture(&frame);
+    stuckNs = I2C_SimGetTime() - stuckNs;
+    DRV_CAPTOUCH_I2C_SIM_SetScanStuck(false);
+    recoverError = DRV_CAPTOUCH_I2C_RAW_Capture(&frame);
+    DRV_CAPTOUCH_I2C_RAW_Stop();
+
+    printf("{\"bench\":\"raw\",\"rows\":%u,\"cols\":%u,\"frames\":%u,\"fps\":%u.%03u,\"scan_us\":%u,"
+           "\"scan_polls\":%u,\"readout_us\":%u,\"bus_us_per_frame\":%llu,\"xfers_per_frame\":%u}\n",
+           frame.rows, frame.cols, stats.frames, stats.fps_milli / 1000, stats.fps_milli % 1000,
+           RawUs(stats.scan), stats.scan_polls, RawUs(stats.readout),
+           (unsigned long long)(busy / 1000 / frames), xfers / frames);
+
+    printf("{\"check\":\"raw_stuck_scan\",\"error\":%d,\"gave_up_after_us\":%llu,\"recovered\":%s}\n",
+           stuckError, (unsigned long long)(stuckNs / 1000), recoverError ? "false" : "true");
+
+    if(dump)
+        RawDump(&frame);
+
+    return (stuckError != ERR_TIMEOUT || recoverError) ? 1 : 0;
+}
@@ -0,0 +1,206 @@
+/****************************************************************************************
+  I2C Capacitive Touch Driver: Register Map Check
+
+  File Name:
+    captouch_regmap.cpp
+
+  Summary:
+    Prints the compile-time burst plans and checks them against the C getters.
+
+  Description:
+    Usage: captouch_regmap [frames]
+    Build the driver sources as C and this file as C++17. One JSON line per
+    plan lists its bursts. The first contact is then read from the simulator
+    through a Snapshot and through DRV_CAPTOUCH_I2C_ReadWord with the masks of
+    GetSinglePixelPoint, the identity registers through a Snapshot and through
+    the individual getters, comparing values and bus transfers. Finally three
+    configuration fields, two of them around THPEAK, are written through a
+    Snapshot whose read bridges THPEAK. THPEAK is changed on the controller in
+    between and must keep that value; the fields are read back with
+    DRV_CAPTOUCH_I2C_CONFIG_Read. The exit status is 1 on any mismatch.
+ ***************************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include <cstdio>
+#include <cstdlib>
+#include "drv_captouch_i2c.hpp"
+
+extern "C" {
+#include "drv_captouch_i2c_sim.h"
+#include "drv_captouch_i2c_workload.h"
+#include "fsl_i2c_sim.h"
+}
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Types
+
+namespace reg = captouch::reg;
+
+using Contact = reg::ReadPlan<reg::TouchCount, reg::Touch<1>::Event, reg::Touch<1>::X,
+                              reg::Touch<1>::Id, reg::Touch<1>::Y>;
+using Identity = reg::ReadPlan<reg::ThGroup, reg::ThPeak, reg::LibVersion, reg::Cipher, reg::FirmwareId>;
+using Tune = reg::ReadPlan<reg::ThGroup, reg::ThCal, reg::PeriodActive>;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+
+template<typename P>
+static void PrintPlan(const char *name)
+{
+    std::printf("{\"plan\":\"%s\",\"fields\":%u,\"bursts\":[", name, (unsigned)P::fields);
+    for(uint8_t i = 0; i < P::bursts.n; i++)
+        std::printf("%s{\"reg\":%u,\"len\":%u}", i ? "," : "", P::bursts.burst[i].reg, P::bursts.burst[i].len);
+    std::printf("],\"bytes\":%u}\n", P::bursts.size);
+}
+
+static uint32_t Transfers(void)
+{
+    uint64_t busy;
+    uint32_t transfers;
+
+    I2C_SimGetStatistics(&busy, &transfers);
+
+    return transfers;
+}
+
+static uint32_t ContactCheck(uint32_t frames)
+{
+    reg::Snapshot<Contact> snap;
+    WORKLOAD_OBJ w;
+    uint32_t mismatches = 0, c_xfers = 0, cpp_xfers = 0;
+
+    DRV_CAPTOUCH_I2C_WORKLOAD_Init(&w, WORKLOAD_MIXED, MAX_TOUCHES, 100, 11);
+
+    for(uint32_t f = 0; f < frames; f++){
+        uint32_t data, start;
+        uint8_t n;
+        int8_t error;
+
+        DRV_CAPTOUCH_I2C_WORKLOAD_Step(&w);
+
+        start = Transfers();
+        error = DRV_CAPTOUCH_I2C_GetNumberOfTouch(&n);
+        error |= DRV_CAPTOUCH_I2C_ReadWord(OP_REG_TOUCHX1H, &data);
+        c_xfers += Transfers() - start;
+
+        start = Transfers();
+        error |= snap.read<captouch::DriverTransport>();
+        cpp_xfers += Transfers() - start;
+
+        if(error
+           || snap.get<reg::TouchCount>() != n
+           || snap.get<reg::Touch<1>::Event>() != (data & 0xC0000000) >> 30
+           || snap.get<reg::Touch<1>::Id>() != (data & 0x0000F000) >> 12
+           || snap.get<reg::Touch<1>::X>() != (data & 0x0FFF0000) >> 16
+           || snap.get<reg::Touch<1>::Y>() != (data & 0x00000FFF))
+            mismatches++;
+    }
+
+    std::printf("{\"check\":\"contact\",\"frames\":%u,\"c_xfers\":%u,\"cpp_xfers\":%u,\"mismatches\":%u}\n",
+                frames, c_xfers, cpp_xfers, mismatches);
+
+    return mismatches;
+}
+
+static uint32_t IdentityCheck(void)
+{
+    reg::Snapshot<Identity> snap;
+    THRESHOLD_OBJ th;
+    uint16_t lib;
+    uint8_t cipher, firmware;
+    uint32_t start, c_xfers, cpp_xfers, mismatches = 0;
+    int8_t error;
+
+    start = Transfers();
+    error = DRV_CAPTOUCH_I2C_GetThresholdObject(&th);
+    error |= DRV_CAPTOUCH_I2C_GetLibVersion(&lib);
+    error |= DRV_CAPTOUCH_I2C_GetCipher(&cipher);
+    error |= DRV_CAPTOUCH_I2C_GetFirmwareID(&firmware);
+    c_xfers = Transfers() - start;
+
+    start = Transfers();
+    error |= snap.read<captouch::DriverTransport>();
+    cpp_xfers = Transfers() - start;
+
+    if(error
+       || snap.get<reg::ThGroup>() != (uint8_t)(th.threshold / 4)
+       || snap.get<reg::ThPeak>() != th.peak
+       || snap.get<reg::LibVersion>() != lib
+       || snap.get<reg::Cipher>() != cipher
+       || snap.get<reg::FirmwareId>() != firmware)
+        mismatches++;
+
+    std::printf("{\"check\":\"identity\",\"c_xfers\":%u,\"cpp_xfers\":%u,\"mismatches\":%u}\n",
+                c_xfers, cpp_xfers, mismatches);
+
+    return mismatches;
+}
+
+static uint32_t WriteCheck(void)
+{
+    reg::Snapshot<Tune> snap;
+    CONFIG_OBJ cfg;
+    uint32_t start, xfers, mismatches = 0;
+    uint8_t peak;
+    int8_t error;
+
+    error = snap.read<captouch::DriverTransport>();
+
+    // Someone else changes the bridged register after the read
+    peak = (uint8_t)(DRV_CAPTOUCH_I2C_SIM_GetRegister(OP_REG_THPEAK) + 7);
+    DRV_CAPTOUCH_I2C_SIM_SetRegister(OP_REG_THPEAK, peak);
+
+    snap.set<reg::ThGroup>(snap.get<reg::ThGroup>() + 1);
+    snap.set<reg::ThCal>(snap.get<reg::ThCal>() + 1);
+    snap.set<reg::PeriodActive>(snap.get<reg::PeriodActive>() + 1);
+    start = Transfers();
+    error |= snap.write<captouch::DriverTransport>();
+    xfers = Transfers() - start;
+    error |= DRV_CAPTOUCH_I2C_CONFIG_Read(&cfg);
+
+    if(error || xfers != Tune::writes.n
+       || cfg.threshold != 4 * snap.get<reg::ThGroup>() || cfg.focus != snap.get<reg::ThCal>() || cfg.period_active != snap.get<reg::PeriodActive>()
+       || DRV_CAPTOUCH_I2C_SIM_GetRegister(OP_REG_THPEAK) != peak)
+        mismatches++;
+
+    std::printf("{\"check\":\"write\",\"read_bursts\":%u,\"write_bursts\":%u,\"xfers\":%u,\"peak_kept\":%s,"
+                "\"mismatches\":%u}\n", Tune::bursts.n, Tune::writes.n, xfers,
+                DRV_CAPTOUCH_I2C_SIM_GetRegister(OP_REG_THPEAK) == peak ? "true" : "false", mismatches);
+
+    return mismatches;
+}
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Main
+
+int main(int argc, char **argv)
+{
+    uint32_t frames = 1000;
+    uint32_t failures = 0;
+
+    if(argc > 1)
+        frames = (uint32_t)std::atoi(argv[1]);
+
+    PrintPlan<Contact>("contact");
+    PrintPlan<Identity>("identity");
+    PrintPlan<Tune>("tune");
+
+    DRV_CAPTOUCH_I2C_SIM_Init();
+    DRV_CAPTOUCH_I2C_Init();
+
+    failures += ContactCheck(frames);
+    failures += IdentityCheck();
+    failures += WriteCheck();
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,277 @@
+/****************************************************************************************
+  I2C Capacitive Touch Driver: Trace Replay Tool
+
+  File Name:
+    captouch_replay.c
+
+  Summary:
+    Replays a captured I2C trace through the driver on the host.
+
+  Description:
+    Usage: captouch_replay <trace.bin> [--realtime]
+           captouch_replay --roundtrip [frames] [prefix]
+    Every recorded touch report is decoded with DRV_CAPTOUCH_I2C_GetNumberOfTouch
+    and DRV_CAPTOUCH_I2C_GetMultiPixelPoint against the simulator. Results are
+    printed as key=value pairs for regression scripts.
+    --roundtrip needs the driver sources built with TRACE_EN. Workload frames
+    (mixed with 10 fingers, flicks with 1) are read with DRV_CAPTOUCH_I2C_GetFrame
+    while the trace is captured, then the trace is replayed and every frame
+    must be delivered once and decode to the same points. A final burst longer
+    than a trace record (ROUNDTRIP_BURST_LENGTH bytes) must come back into the
+    register file byte for byte. With a prefix each
+    trace is also written to <prefix>-<scenario>.bin. The exit status is 1 on
+    any mismatch.
+ ***************************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "drv_captouch_i2c.h"
+#include "drv_captouch_i2c_replay.h"
+#include "drv_captouch_i2c_sim.h"
+#include "drv_captouch_i2c_trace.h"
+#include "drv_captouch_i2c_variant.h"
+#include "drv_captouch_i2c_workload.h"
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Defines
+
+#define ROUNDTRIP_FRAMES_MAX        20000
+#define ROUNDTRIP_CHUNK_SIZE        4096
+#define ROUNDTRIP_BURST_REG         0x60    // past the touch records, up to the end of the page
+#define ROUNDTRIP_BURST_LENGTH      160     // split into two trace records
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Types
+
+/* Frame as the driver read it while the trace was captured */
+typedef struct
+{
+    uint8_t     n;
+    POINT_OBJ   point[MAX_TOUCHES];
+} ROUNDTRIP_FRAME_OBJ;
+
+/* Replay Check */
+typedef struct
+{
+    const ROUNDTRIP_FRAME_OBJ   *reference;
+    uint32_t                    frames;
+    uint32_t                    delivered;
+    uint32_t                    mismatches;
+} ROUNDTRIP_OBJ;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Variables
+
+static POINT_OBJ points[MAX_TOUCHES];
+static uint32_t contacts = 0;
+static uint32_t errors = 0;
+
+static ROUNDTRIP_FRAME_OBJ reference[ROUNDTRIP_FRAMES_MAX];
+static uint8_t chunk[ROUNDTRIP_CHUNK_SIZE];
+static uint8_t *recorded = NULL;
+static uint32_t recordedLen = 0;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+
+static void ReplayFrame(uint32_t timestamp, void *ctx)
+{
+    uint8_t n;
+
+    (void)timestamp;
+    (void)ctx;
+
+    if(DRV_CAPTOUCH_I2C_GetNumberOfTouch(&n) || DRV_CAPTOUCH_I2C_GetMultiPixelPoint(points, n)){
+        errors++;
+        return;
+    }
+
+    contacts += n;
+}
+
+static void RecordFlush(const uint8_t *data, uint32_t len)
+{
+    uint8_t *grown = realloc(recorded, recordedLen + len);
+
+    if(grown == NULL){
+        errors++;
+        return;
+    }
+
+    memcpy(&grown[recordedLen], data, len);
+    recorded = grown;
+    recordedLen += len;
+}
+
+static void RoundtripFrame(uint32_t timestamp, void *ctx)
+{
+    ROUNDTRIP_OBJ *rt = ctx;
+    const ROUNDTRIP_FRAME_OBJ *ref;
+    uint8_t n;
+
+    (void)timestamp;
+
+    if(rt->delivered >= rt->frames){
+        rt->mismatches++;
+        return;
+    }
+    ref = &rt->reference[rt->delivered++];
+
+    if(DRV_CAPTOUCH_I2C_GetNumberOfTouch(&n) || DRV_CAPTOUCH_I2C_GetMultiPixelPoint(points, n)){
+        errors++;
+        return;
+    }
+
+    if((n & 0x0F) != ref->n){
+        rt->mismatches++;
+        return;
+    }
+
+    for(uint8_t i = 0; i < ref->n; i++){
+        if(points[i].x != ref->point[i].x || points[i].y != ref->point[i].y ||
+           points[i].id != ref->point[i].id || points[i].event_flag != ref->point[i].event_flag){
+            rt->mismatches++;
+            return;
+        }
+    }
+}
+
+static uint32_t Roundtrip(const char *name, WORKLOAD_SCENARIO scenario, uint8_t fingers,
+                          uint32_t frames, const char *prefix)
+{
+    ROUNDTRIP_OBJ rt = { reference, frames, 0, 0 };
+    REPLAY_STATS_OBJ stats;
+    WORKLOAD_OBJ w;
+    uint8_t burst[ROUNDTRIP_BURST_LENGTH];
+    uint32_t burstErrors = 0;
+    int8_t error;
+
+    recordedLen = 0;
+
+    DRV_CAPTOUCH_I2C_SIM_Init();
+    DRV_CAPTOUCH_I2C_Init();
+    DRV_CAPTOUCH_I2C_WORKLOAD_Init(&w, scenario, fingers, 100, 17);
+
+    DRV_CAPTOUCH_I2C_TRACE_Start(chunk, sizeof(chunk), RecordFlush);
+    for(uint32_t f = 0; f < frames; f++){
+        DRV_CAPTOUCH_I2C_WORKLOAD_Step(&w);
+        if(DRV_CAPTOUCH_I2C_GetFrame(reference[f].point, &reference[f].n))
+            errors++;
+    }
+
+    for(uint8_t i = 0; i < ROUNDTRIP_BURST_LENGTH; i++)
+        DRV_CAPTOUCH_I2C_SIM_SetRegister(ROUNDTRIP_BURST_REG + i, (uint8_t)(i * 7 + 1));
+    if(DRV_CAPTOUCH_I2C_ReadArray(ROUNDTRIP_BURST_REG, burst, ROUNDTRIP_BURST_LENGTH))
+        errors++;
+    DRV_CAPTOUCH_I2C_TRACE_Stop();
+
+    if(recordedLen <= TRACE_HEADER_SIZE){
+        fprintf(stderr, "nothing recorded, build the driver with TRACE_EN\n");
+        errors++;
+        return 1;
+    }
+
+    if(prefix != NULL){
+        char path[256];
+        FILE *f;
+
+        snprintf(path, sizeof(path), "%s-%s.bin", prefix, name);
+        f = fopen(path, "wb");
+        if(f == NULL || fwrite(recorded, 1, recordedLen, f) != recordedLen)
+            errors++;
+        if(f != NULL)
+            fclose(f);
+    }
+
+    // Replay into a freshly reset controller
+    DRV_CAPTOUCH_I2C_SIM_Init();
+    DRV_CAPTOUCH_I2C_Init();
+    for(uint8_t i = 0; i < ROUNDTRIP_BURST_LENGTH; i++)
+        DRV_CAPTOUCH_I2C_SIM_SetRegister(ROUNDTRIP_BURST_REG + i, 0);
+    error = DRV_CAPTOUCH_I2C_REPLAY_Run(recorded, recordedLen, REPLAY_FAST, RoundtripFrame, &rt, &stats);
+
+    for(uint8_t i = 0; i < ROUNDTRIP_BURST_LENGTH; i++)
+        if(DRV_CAPTOUCH_I2C_SIM_GetRegister(ROUNDTRIP_BURST_REG + i) != burst[i])
+            burstErrors++;
+
+    if(rt.delivered != frames)
+        rt.mismatches += (rt.delivered > frames) ? rt.delivered - frames : frames - rt.delivered;
+
+    printf("roundtrip=%s status=%d bytes=%u records=%u frames=%u delivered=%u mismatches=%u "
+           "burst_errors=%u dropped=%u\n", name, error, recordedLen, stats.records, frames, rt.delivered,
+           rt.mismatches, burstErrors, DRV_CAPTOUCH_I2C_TRACE_GetDropped());
+
+    return rt.mismatches + burstErrors + (error != 0);
+}
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Main
+
+int main(int argc, char **argv)
+{
+    REPLAY_STATS_OBJ stats;
+    REPLAY_MODE mode = REPLAY_FAST;
+    uint8_t *trace;
+    uint32_t len;
+    int8_t error;
+
+    if(argc < 2){
+        fprintf(stderr, "usage: %s <trace.bin> [--realtime]\n"
+                        "       %s --roundtrip [frames] [prefix]\n", argv[0], argv[0]);
+        return 2;
+    }
+
+    if(strcmp(argv[1], "--roundtrip") == 0){
+        uint32_t frames = 2000, mismatches = 0;
+        const char *prefix = (argc > 3) ? argv[3] : NULL;
+
+        if(argc > 2)
+            frames = (uint32_t)atoi(argv[2]);
+        if(frames < 1 || frames > ROUNDTRIP_FRAMES_MAX)
+            frames = ROUNDTRIP_FRAMES_MAX;
+
+        mismatches += Roundtrip("mixed", WORKLOAD_MIXED, MAX_TOUCHES, frames, prefix);
+        mismatches += Roundtrip("flick", WORKLOAD_FLICK, 1, frames, prefix);
+        free(recorded);
+
+        return (mismatches || errors) ? 1 : 0;
+    }
+
+    if(argc > 2 && strcmp(argv[2], "--realtime") == 0)
+        mode = REPLAY_REALTIME;
+
+    error = DRV_CAPTOUCH_I2C_REPLAY_LoadFile(argv[1], &trace, &len);
+    if(error){
+        fprintf(stderr, "cannot load %s (%d)\n", argv[1], error);
+        return 1;
+    }
+
+    DRV_CAPTOUCH_I2C_SIM_Init();
+    DRV_CAPTOUCH_I2C_Init();
+
+    error = DRV_CAPTOUCH_I2C_REPLAY_Run(trace, len, mode, ReplayFrame, NULL, &stats);
+    free(trace);
+
+    printf("status=%d records=%u frames=%u contacts=%u errors=%u trace_ms=%.3f wall_ms=%.3f fps=%.1f\n",
+           error, stats.records, stats.frames, contacts, errors,
+           stats.trace_ns / 1e6, stats.wall_ns / 1e6,
+           stats.wall_ns ? stats.frames * 1e9 / stats.wall_ns : 0.0);
+
+    return (error || errors) ? 1 : 0;
+}
@@ -0,0 +1,145 @@
+/****************************************************************************************
+  I2C Capacitive Touch Driver: Self-Test Benchmark
+
+  File Name:
+    captouch_selftest.c
+
+  Summary:
+    Runs the end-of-line self-test on a good and on a faulty simulated panel.
+
+  Description:
+    Usage: captouch_selftest [bus_hz] [--map]
+    Build with TEST_MODE_EN. The faulty panel has a row with a low CAC value, a
+    column with a high offset, one open and one shorted node, 39 failing nodes
+    in total on the default 24 x 14 panel. The next run gets a budget shorter
+    than the scan, the last one a scan that never completes; both must stop the
+    raw scan wait when the budget is spent and return ERR_TIMEOUT. One JSON line
+    per run reports the per-phase times, the failing phases and nodes; --map
+    also prints the node bitmap. The exit status is 1 on any failed check.
+ ***************************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "drv_captouch_i2c.h"
+#include "drv_captouch_i2c_selftest.h"
+#include "drv_captouch_i2c_sim.h"
+#include "fsl_i2c_sim.h"
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Defines
+
+#define SELFTEST_FAULT_ROW          5
+#define SELFTEST_FAULT_COL          3
+#define SELFTEST_OPEN_NODE          (10 * SIM_DEFAULT_COLS + 7)
+#define SELFTEST_SHORT_NODE         (20 * SIM_DEFAULT_COLS + 12)
+#define SELFTEST_OVERRUN_US         1000            // last poll and leaving TEST_MODE after the budget
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Variables
+
+static uint16_t rawFrame[SIM_DEFAULT_ROWS * SIM_DEFAULT_COLS];
+static uint32_t lastTotalUs;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+
+static uint32_t SelftestUs(uint32_t ticks)
+{
+    return (uint32_t)((uint64_t)ticks * 1000000 / DRV_CAPTOUCH_I2C_TIMESTAMP_HZ);
+}
+
+static int8_t SelftestRun(const char *name, const SELFTEST_LIMIT_OBJ *limit, bool map)
+{
+    SELFTEST_RESULT_OBJ result;
+    int8_t error = 0;
+
+    error = DRV_CAPTOUCH_I2C_SELFTEST_Run(limit, &result);
+
+    printf("{\"bench\":\"selftest\",\"panel\":\"%s\",\"error\":%d,\"rows\":%u,\"cols\":%u,\"completed\":%u,"
+           "\"failed_phases\":%u,\"failed_nodes\":%u",
+           name, error, result.rows, result.cols, result.completed, result.failed, result.failed_nodes);
+    for(uint8_t p = 0; p < SELFTEST_PHASES; p++)
+        printf(",\"%s_us\":%u", DRV_CAPTOUCH_I2C_SELFTEST_GetPhaseName((SELFTEST_PHASE)p),
+               SelftestUs(result.phase_time[p]));
+    lastTotalUs = SelftestUs(result.total_time);
+    printf(",\"total_us\":%u}\n", lastTotalUs);
+
+    if(map){
+        for(uint8_t r = 0; r < result.rows; r++){
+            for(uint8_t c = 0; c < result.cols; c++)
+                putchar(DRV_CAPTOUCH_I2C_SELFTEST_NodeFailed(&result, r, c) ? 'X' : '.');
+            putchar('\n');
+        }
+    }
+
+    return error;
+}
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Main
+
+int main(int argc, char **argv)
+{
+    SELFTEST_LIMIT_OBJ limit = {
+        .raw_min = 0x1000, .raw_max = 0x2400, .cac_min = 0x10, .cac_max = 0x70,
+        .offset_min = 2, .offset_max = 14, .budget = SELFTEST_BUDGET_DEFAULT
+    };
+    uint32_t bus_hz = 400000;
+    bool map = false;
+    int status = 0;
+
+    for(int i = 1; i < argc; i++){
+        if(strcmp(argv[i], "--map") == 0)
+            map = true;
+        else
+            bus_hz = (uint32_t)atoi(argv[i]);
+    }
+
+    DRV_CAPTOUCH_I2C_SIM_Init();
+    I2C_SimSetBusClock(I2C3, bus_hz);
+    if(DRV_CAPTOUCH_I2C_Init())
+        return 1;
+
+    if(SelftestRun("good", &limit, map) != ERR_NONE)
+        status = 1;
+
+    // Faults: a low CAC row, a high offset column (odd, low nibble), an open and a shorted node
+    DRV_CAPTOUCH_I2C_SIM_SetTestRegister(TE_REG_ROW0CAC + SELFTEST_FAULT_ROW, 0x05);
+    DRV_CAPTOUCH_I2C_SIM_SetTestRegister(TE_REG_COL01OFF + SELFTEST_FAULT_COL / 2, 0x8F);
+    for(uint16_t n = 0; n < SIM_DEFAULT_ROWS * SIM_DEFAULT_COLS; n++)
+        rawFrame[n] = SIM_RAW_BASELINE;
+    rawFrame[SELFTEST_OPEN_NODE] = 0x0100;
+    rawFrame[SELFTEST_SHORT_NODE] = 0x3000;
+    DRV_CAPTOUCH_I2C_SIM_SetRawFrame(rawFrame, SIM_DEFAULT_ROWS, SIM_DEFAULT_COLS);
+
+    if(SelftestRun("faulty", &limit, map) != ERR_NONE)
+        status = 1;
+
+    // Shorter than the 8 ms scan
+    limit.budget = 5;
+    if(SelftestRun("budget", &limit, false) != ERR_TIMEOUT || lastTotalUs > limit.budget * 1000 + SELFTEST_OVERRUN_US)
+        status = 1;
+
+    // Shorter than RAW_SCAN_TIMEOUT_MS, the budget must end the wait
+    limit.budget = 20;
+    DRV_CAPTOUCH_I2C_SIM_SetScanStuck(true);
+    if(SelftestRun("stuck", &limit, false) != ERR_TIMEOUT || lastTotalUs > limit.budget * 1000 + SELFTEST_OVERRUN_US)
+        status = 1;
+    DRV_CAPTOUCH_I2C_SIM_SetScanStuck(false);
+
+    return status;
+}
@@ -0,0 +1,333 @@
+/****************************************************************************************
+  I2C Capacitive Touch Driver: uinput Daemon
+
+  File Name:
+    captouch_uinput.c
+
+  Summary:
+    Publishes decoded touches as a Linux multitouch input device.
+
+  Description:
+    Build with I2CDEV_EN (and I2CDEV_LOOPBACK to run against the simulator).
+    Usage: captouch_uinput [--i2c [/dev/i2c-N]] [--int /dev/gpiochipN:line]
+                           [--shm /name] [--frames N] [--latency] [--dry-run]
+      --i2c      read the controller through the i2c-dev transport (default)
+      --int      wait for the falling INT edge instead of polling at 100 Hz
+      --shm      consume the shared memory frame ring instead of the bus
+      --latency  read every frame back from the evdev node and report the delay
+                 between the INT (or frame) timestamp and the SYN_REPORT time
+      --dry-run  print the events instead of creating the device
+ ***************************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/gpio.h>
+#include "drv_captouch_i2c.h"
+#include "drv_captouch_i2c_channel.h"
+#include "drv_captouch_i2c_i2cdev.h"
+#include "drv_captouch_i2c_shm.h"
+#include "drv_captouch_i2c_uinput.h"
+#ifdef I2CDEV_LOOPBACK
+#include "drv_captouch_i2c_sim.h"
+#include "drv_captouch_i2c_workload.h"
+#endif
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Defines
+
+#define DAEMON_INT_DEFAULT          "/dev/gpiochip4:4"      // GPIO5 pin 4, see INT_GPIO/INT_PIN
+#define DAEMON_POLL_US              10000
+#define DAEMON_TIMEOUT_MS           100
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Variables
+
+static volatile sig_atomic_t stop = 0;
+
+static UINPUT_OBJ uinput;
+static bool dryRun = false;
+static bool latency = false;
+
+static uint32_t latencyCount = 0;
+static uint64_t latencyTotal = 0;
+static uint32_t latencyMax = 0;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+
+static void DaemonSignal(int sig)
+{
+    (void)sig;
+    stop = 1;
+}
+
+static uint64_t DaemonNow(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static int DaemonIntOpen(const char *spec)
+{
+    struct gpio_v2_line_request req;
+    char path[64];
+    const char *colon = strrchr(spec, ':');
+    int chip;
+
+    if(colon == NULL || (size_t)(colon - spec) >= sizeof(path))
+        return -1;
+
+    memcpy(path, spec, colon - spec);
+    path[colon - spec] = '\0';
+
+    chip = open(path, O_RDONLY);
+    if(chip < 0)
+        return -1;
+
+    // INT is active low, the report is ready on the falling edge
+    memset(&req, 0, sizeof(req));
+    req.offsets[0] = (uint32_t)atoi(colon + 1);
+    req.num_lines = 1;
+    req.config.flags = GPIO_V2_LINE_FLAG_INPUT | GPIO_V2_LINE_FLAG_EDGE_FALLING;
+    snprintf(req.consumer, sizeof(req.consumer), "captouch");
+
+    if(ioctl(chip, GPIO_V2_GET_LINE_IOCTL, &req) < 0)
+        req.fd = -1;
+    close(chip);
+
+    return req.fd;
+}
+
+static int8_t DaemonIntWait(int fd, uint64_t *timestamp_ns)
+{
+    struct gpio_v2_line_event ev;
+    struct pollfd pfd = { .fd = fd, .events = POLLIN };
+
+    if(poll(&pfd, 1, DAEMON_TIMEOUT_MS) <= 0)
+        return ERR_TIMEOUT;
+
+    if(read(fd, &ev, sizeof(ev)) != sizeof(ev))
+        return ERR_NODEVICE;
+
+    // Kernel edge timestamp, CLOCK_MONOTONIC by default
+    *timestamp_ns = ev.timestamp_ns;
+
+    return ERR_NONE;
+}
+
+static void DaemonPrint(const POINT_OBJ *point, uint8_t n)
+{
+    struct input_event ev[UINPUT_MAX_EVENTS];
+    uint32_t count = DRV_CAPTOUCH_I2C_UINPUT_Encode(&uinput, point, n, ev);
+
+    uinput.frames += count ? 1 : 0;
+    uinput.events += count;
+
+    for(uint32_t i = 0; i < count; i++)
+        printf("type=%u code=%u value=%d\n", ev[i].type, ev[i].code, ev[i].value);
+}
+
+static void DaemonDeliver(const POINT_OBJ *point, uint8_t n, uint64_t int_ns)
+{
+    uint32_t frames = uinput.frames;
+    uint64_t syn_ns;
+
+    if(dryRun){
+        DaemonPrint(point, n);
+        return;
+    }
+
+    if(DRV_CAPTOUCH_I2C_UINPUT_Frame(&uinput, point, n))
+        return;
+
+    // Nothing was written for a frame without changes
+    if(latency && uinput.frames != frames && !DRV_CAPTOUCH_I2C_UINPUT_ReadSyn(&uinput, &syn_ns)){
+        uint32_t delay = (uint32_t)((syn_ns - int_ns) / 1000);
+
+        latencyCount++;
+        latencyTotal += delay;
+        if(delay > latencyMax)
+            latencyMax = delay;
+    }
+}
+
+static void DaemonShm(const char *name, uint32_t frames)
+{
+    SHM_CHANNEL_OBJ shm;
+    const CHANNEL_FRAME_OBJ *frame;
+    uint32_t done = 0;
+    int8_t error;
+
+    error = DRV_CAPTOUCH_I2C_SHM_Open(&shm, name);
+    if(error){
+        fprintf(stderr, "cannot open channel %s (%d)\n", name, error);
+        stop = 1;
+        return;
+    }
+
+    while(!stop && (frames == 0 || done < frames)){
+        if(DRV_CAPTOUCH_I2C_SHM_Wait(&shm, DAEMON_TIMEOUT_MS))
+            continue;
+
+        while((frame = DRV_CAPTOUCH_I2C_CHANNEL_Peek(&shm.ch)) != NULL){
+            // Frame timestamps are CLOCK_MONOTONIC microseconds on Linux producers
+            uint64_t now = DaemonNow();
+            uint64_t int_ns = now - (uint64_t)(uint32_t)((uint32_t)(now / 1000) - frame->timestamp) * 1000ULL;
+
+            DaemonDeliver(frame->point, frame->n, int_ns);
+            DRV_CAPTOUCH_I2C_CHANNEL_Release(&shm.ch);
+            done++;
+        }
+    }
+
+    DRV_CAPTOUCH_I2C_SHM_Close(&shm);
+}
+
+static void DaemonI2c(const char *path, const char *int_spec, uint32_t frames)
+{
+    POINT_OBJ point[MAX_TOUCHES];
+    int int_fd = -1;
+    int8_t error;
+
+#ifdef I2CDEV_LOOPBACK
+    WORKLOAD_OBJ w;
+
+    DRV_CAPTOUCH_I2C_SIM_Init();
+    DRV_CAPTOUCH_I2C_WORKLOAD_Init(&w, WORKLOAD_MIXED, MAX_TOUCHES, 100, 1);
+    if(frames == 0)
+        frames = 1000;
+#endif
+
+    DRV_CAPTOUCH_I2C_I2CDEV_SetDevice(path, 0);
+    error = DRV_CAPTOUCH_I2C_Init();
+    if(error){
+        fprintf(stderr, "cannot open %s (%d)\n", path ? path : I2CDEV_PATH, error);
+        stop = 1;
+        return;
+    }
+
+    if(int_spec != NULL){
+        int_fd = DaemonIntOpen(int_spec);
+        if(int_fd < 0){
+            fprintf(stderr, "cannot request INT line %s\n", int_spec);
+            stop = 1;
+            return;
+        }
+    }
+
+    for(uint32_t done = 0; !stop && (frames == 0 || done < frames); done++){
+        uint64_t int_ns;
+        uint8_t n;
+
+#ifdef I2CDEV_LOOPBACK
+        DRV_CAPTOUCH_I2C_WORKLOAD_Step(&w);
+#endif
+        if(int_fd >= 0){
+            if(DaemonIntWait(int_fd, &int_ns))
+                continue;
+        }else{
+#ifndef I2CDEV_LOOPBACK
+            usleep(DAEMON_POLL_US);
+#endif
+            int_ns = DaemonNow();
+        }
+
+        if(DRV_CAPTOUCH_I2C_GetFrame(point, &n))
+            continue;
+
+        DaemonDeliver(point, n, int_ns);
+    }
+
+    if(int_fd >= 0)
+        close(int_fd);
+    DRV_CAPTOUCH_I2C_I2CDEV_Close();
+}
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Main
+
+int main(int argc, char **argv)
+{
+    const char *i2c = NULL, *shm = NULL, *int_spec = NULL;
+    uint32_t frames = 0;
+    int8_t error;
+
+    for(int a = 1; a < argc; a++){
+        if(strcmp(argv[a], "--i2c") == 0 && a + 1 < argc && argv[a + 1][0] == '/')
+            i2c = argv[++a];
+        else if(strcmp(argv[a], "--i2c") == 0)
+            continue;
+        else if(strcmp(argv[a], "--int") == 0)
+            int_spec = (a + 1 < argc && argv[a + 1][0] == '/') ? argv[++a] : DAEMON_INT_DEFAULT;
+        else if(strcmp(argv[a], "--shm") == 0 && a + 1 < argc)
+            shm = argv[++a];
+        else if(strcmp(argv[a], "--frames") == 0 && a + 1 < argc)
+            frames = (uint32_t)atoi(argv[++a]);
+        else if(strcmp(argv[a], "--latency") == 0)
+            latency = true;
+        else if(strcmp(argv[a], "--dry-run") == 0)
+            dryRun = true;
+        else{
+            fprintf(stderr, "usage: %s [--i2c [/dev/i2c-N]] [--int /dev/gpiochipN:line] [--shm /name]"
+                            " [--frames N] [--latency] [--dry-run]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    signal(SIGINT, DaemonSignal);
+    signal(SIGTERM, DaemonSignal);
+
+    if(dryRun){
+        DRV_CAPTOUCH_I2C_UINPUT_Reset(&uinput);
+    }else{
+        error = DRV_CAPTOUCH_I2C_UINPUT_Open(&uinput, NULL);
+        if(error){
+            fprintf(stderr, "cannot create uinput device (%d)\n", error);
+            return 1;
+        }
+        if(latency && DRV_CAPTOUCH_I2C_UINPUT_OpenEventNode(&uinput)){
+            fprintf(stderr, "cannot open the evdev node for --latency\n");
+            DRV_CAPTOUCH_I2C_UINPUT_Close(&uinput);
+            return 1;
+        }
+    }
+
+    if(shm != NULL)
+        DaemonShm(shm, frames);
+    else
+        DaemonI2c(i2c, int_spec, frames);
+
+    fprintf(stderr, "frames=%u events=%u events_per_frame=%.2f",
+            uinput.frames, uinput.events, uinput.frames ? (double)uinput.events / uinput.frames : 0.0);
+    if(latency)
+        fprintf(stderr, " latency_us=%.1f latency_max_us=%u",
+                latencyCount ? (double)latencyTotal / latencyCount : 0.0, latencyMax);
+    fprintf(stderr, "\n");
+
+    DRV_CAPTOUCH_I2C_UINPUT_Close(&uinput);
+
+    return 0;
+}
@@ -0,0 +1,185 @@
+/****************************************************************************************
+  I2C Capacitive Touch Driver: Wire Format Benchmark
+
+  File Name:
+    captouch_wire.c
+
+  Summary:
+    Bytes per frame and round-trip check of the compact wire format.
+
+  Description:
+    Usage: captouch_wire [frames] [trace.bin]...
+    Every synthetic scenario (1, 2, 5 and 10 fingers) and every recorded trace
+    is decoded by the driver on the simulator, encoded, decoded again and
+    compared with the original frame. One JSON line per run reports the wire
+    size against POINT_OBJ arrays and the raw register image. The exit status
+    is 1 on any round-trip mismatch.
+ ***************************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "drv_captouch_i2c.h"
+#include "drv_captouch_i2c_replay.h"
+#include "drv_captouch_i2c_sim.h"
+#include "drv_captouch_i2c_trace.h"
+#include "drv_captouch_i2c_wire.h"
+#include "drv_captouch_i2c_workload.h"
+#include "fsl_i2c_sim.h"
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Types
+
+typedef struct
+{
+    WIRE_OBJ    encoder;
+    WIRE_OBJ    decoder;
+    uint32_t    frames;
+    uint32_t    contacts;
+    uint64_t    wire_bytes;
+    uint32_t    max_bytes;
+    uint32_t    mismatches;
+    uint32_t    tick_hz;            // timestamp source, converted to microseconds
+} WIRE_RUN_OBJ;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Variables
+
+static const char *scenarioName[] = {"flick", "pinch", "palm", "jitter", "idreuse", "mixed"};
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+
+static void WireRunInit(WIRE_RUN_OBJ *run, uint32_t tick_hz)
+{
+    memset(run, 0, sizeof(*run));
+    DRV_CAPTOUCH_I2C_WIRE_Init(&run->encoder, WIRE_KEYFRAME_INTERVAL);
+    DRV_CAPTOUCH_I2C_WIRE_Init(&run->decoder, WIRE_KEYFRAME_INTERVAL);
+    run->tick_hz = tick_hz;
+}
+
+static void WireFrame(WIRE_RUN_OBJ *run, uint32_t ticks)
+{
+    POINT_OBJ point[MAX_TOUCHES], check[MAX_TOUCHES];
+    uint8_t buf[WIRE_MAX_FRAME_SIZE];
+    uint32_t timestamp = (uint32_t)((uint64_t)ticks * 1000000U / run->tick_hz), decoded_ts;
+    uint16_t len, used;
+    uint8_t n, m;
+
+    if(DRV_CAPTOUCH_I2C_GetNumberOfTouch(&n))
+        return;
+    if(n > MAX_TOUCHES)
+        n = MAX_TOUCHES;
+    if(DRV_CAPTOUCH_I2C_GetMultiPixelPoint(point, n))
+        return;
+
+    if(DRV_CAPTOUCH_I2C_WIRE_Encode(&run->encoder, timestamp, point, n, buf, sizeof(buf), &len)
+       || DRV_CAPTOUCH_I2C_WIRE_Decode(&run->decoder, buf, len, &decoded_ts, check, &m, &used)
+       || used != len || m != n || decoded_ts != timestamp){
+        run->mismatches++;
+    }else{
+        for(uint8_t i = 0; i < n; i++)
+            if(check[i].x != point[i].x || check[i].y != point[i].y
+               || check[i].id != point[i].id || check[i].event_flag != point[i].event_flag){
+                run->mismatches++;
+                break;
+            }
+    }
+
+    run->frames++;
+    run->contacts += n;
+    run->wire_bytes += len;
+    if(len > run->max_bytes)
+        run->max_bytes = len;
+}
+
+static void WireReplayFrame(uint32_t timestamp, void *ctx)
+{
+    WireFrame((WIRE_RUN_OBJ *)ctx, timestamp);
+}
+
+static void WireReport(const char *name, uint8_t fingers, const WIRE_RUN_OBJ *run)
+{
+    // POINT_OBJ array with a count byte, and TD_STATUS plus 6 byte records
+    double frames = run->frames ? run->frames : 1;
+    double point_bytes = (run->frames + (double)run->contacts * sizeof(POINT_OBJ)) / frames;
+    double image_bytes = (run->frames + (double)run->contacts * 6) / frames;
+    double wire_bytes = run->wire_bytes / frames;
+
+    printf("{\"bench\":\"%s\",\"fingers\":%u,\"frames\":%u,\"contacts_per_frame\":%.2f,"
+           "\"wire_bytes_per_frame\":%.2f,\"wire_max_bytes\":%u,\"point_bytes_per_frame\":%.2f,"
+           "\"image_bytes_per_frame\":%.2f,\"ratio_vs_point\":%.3f,\"mismatches\":%u}\n",
+           name, fingers, run->frames, run->contacts / frames, wire_bytes, run->max_bytes,
+           point_bytes, image_bytes, point_bytes ? wire_bytes / point_bytes : 0.0, run->mismatches);
+}
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Main
+
+int main(int argc, char **argv)
+{
+    static const uint8_t fingerSet[] = {1, 2, 5, 10};
+    WIRE_RUN_OBJ run;
+    uint32_t frames = 10000;
+    uint32_t mismatches = 0;
+    int a = 1;
+
+    if(argc > 1 && argv[1][0] >= '0' && argv[1][0] <= '9'){
+        frames = (uint32_t)atoi(argv[1]);
+        a = 2;
+    }
+
+    DRV_CAPTOUCH_I2C_SIM_Init();
+    DRV_CAPTOUCH_I2C_Init();
+
+    for(int s = 0; s <= WORKLOAD_MIXED; s++){
+        for(uint8_t f = 0; f < sizeof(fingerSet); f++){
+            WORKLOAD_OBJ w;
+
+            DRV_CAPTOUCH_I2C_WORKLOAD_Init(&w, (WORKLOAD_SCENARIO)s, fingerSet[f], 100, 1);
+            WireRunInit(&run, 1000000);
+
+            for(uint32_t i = 0; i < frames; i++){
+                DRV_CAPTOUCH_I2C_WORKLOAD_Step(&w);
+                WireFrame(&run, (uint32_t)(I2C_SimGetTime() / 1000));
+            }
+
+            WireReport(scenarioName[s], fingerSet[f], &run);
+            mismatches += run.mismatches;
+        }
+    }
+
+    for(; a < argc; a++){
+        REPLAY_STATS_OBJ stats;
+        uint8_t *trace;
+        uint32_t len;
+
+        if(DRV_CAPTOUCH_I2C_REPLAY_LoadFile(argv[a], &trace, &len) || len < TRACE_HEADER_SIZE){
+            fprintf(stderr, "cannot load %s\n", argv[a]);
+            return 2;
+        }
+
+        // tick_hz from the trace header
+        WireRunInit(&run, trace[8] | (trace[9] << 8) | (trace[10] << 16) | ((uint32_t)trace[11] << 24));
+        DRV_CAPTOUCH_I2C_REPLAY_Run(trace, len, REPLAY_FAST, WireReplayFrame, &run, &stats);
+        free(trace);
+
+        WireReport(argv[a], 0, &run);
+        mismatches += run.mismatches;
+    }
+
+    return mismatches ? 1 : 0;
+}
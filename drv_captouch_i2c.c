@@ -16,9 +16,15 @@
 // *****************************************************************************
 // Section: Included Files
 
+#include <string.h>
 #include "drv_captouch_i2c.h"
-#include "fsl_gpio.h"
-#include "fsl_i2c.h"
+#include "drv_captouch_i2c_bench.h"
+#include "drv_captouch_i2c_config.h"
+#include "drv_captouch_i2c_profile.h"
+#include "drv_captouch_i2c_shadow.h"
+#include "drv_captouch_i2c_trace.h"
+#include "drv_captouch_i2c_transport.h"
+#include "drv_captouch_i2c_variant.h"
 
 
 // *****************************************************************************
@@ -31,353 +37,235 @@ uint8_t i2cRx[I2C_BUFFER_LENGTH];
 //! I2C Transmit buffer
 uint8_t i2cTx[I2C_BUFFER_LENGTH];
 
-//! ISR
-i2c_master_handle_t g_m_handle;
-volatile bool g_MasterCompletionFlag = false;
-
-
-// *****************************************************************************
-// *****************************************************************************
-// Section: Init Function
-
-void i2c_master_callback(I2C_Type *base, i2c_master_handle_t *handle, status_t status, void *userData)
-{
-    /* Signal transfer success when received success status. */
-    if (status == kStatus_Success)
-    {
-        g_MasterCompletionFlag = true;
-    }
-}
-
-void DRV_CAPTOUCH_I2C_Init(void)
-{
-    i2c_master_config_t masterConfig;
-
-    CLOCK_SetRootMux(kCLOCK_RootI2c3, kCLOCK_I2cRootmuxSysPll1Div5); /* Set I2C source to SysPLL1 Div5 160MHZ */
-    CLOCK_SetRootDivider(kCLOCK_RootI2c3, 1U, 10U);                  /* Set root clock to 160MHZ / 10 = 16MHZ */
-
-    I2C_MasterGetDefaultConfig(&masterConfig);
-    
-    /*
-     * masterConfig->baudRate_Bps = I2C_BAUDRATE;
-     * masterConfig->enableHighDrive = false;
-     * masterConfig->enableStopHold = false;
-     * masterConfig->glitchFilterWidth = 0U;
-     * masterConfig->enableMaster = true;
-     */
-    masterConfig.baudRate_Bps = I2C_BAUDRATE;
-
-    I2C_MasterInit(I2C_BASEADDR, &masterConfig, I2C_CLK_FREQ);
-
-    memset(&g_m_handle, 0, sizeof(g_m_handle));
-    memset(&i2cRx, 0, sizeof(i2cRx));
+//! Register transport
+#ifdef I2CDEV_EN
+static const TRANSPORT_OBJ *transport = &DRV_CAPTOUCH_I2C_I2CDEV_Transport;
+#else
+static const TRANSPORT_OBJ *transport = &DRV_CAPTOUCH_I2C_FSL_Transport;
+#endif
 
-    I2C_MasterTransferCreateHandle(I2C_BASEADDR, &g_m_handle, i2c_master_callback, NULL);
-}
+//! Contacts of the last frame, the length of the next speculative burst
+static uint8_t frameTouches = 0;
 
 
 // *****************************************************************************
 // *****************************************************************************
-// Section: I2C Access Functions
+// Section: Local Functions
 
-int8_t DRV_CAPTOUCH_I2C_ReadByte(uint8_t reg, uint8_t *rxd)
+// Register read, served by the shadow when it holds every requested byte
+static int8_t CAPTOUCH_Read(uint8_t reg, uint8_t *rxd, uint8_t len)
 {
-    i2c_master_transfer_t masterXfer;
     int8_t error = 0;
 
-    masterXfer.slaveAddress   = I2C_SLAVE_ADDR;
-    masterXfer.direction      = kI2C_Write;
-    masterXfer.subaddress     = (uint32_t)NULL;
-    masterXfer.subaddressSize = 0;
-    masterXfer.data           = &reg;
-    masterXfer.dataSize       = BYTE;
-    masterXfer.flags          = kI2C_TransferDefaultFlag;
+    if(DRV_CAPTOUCH_I2C_SHADOW_Lookup(reg, rxd, len))
+        return ERR_NONE;
 
-    error = I2C_MasterTransferNonBlocking(I2C_BASEADDR, &g_m_handle, &masterXfer);
+    error = transport->read(transport->ctx, reg, rxd, len);
     if(error){
         return error;
     }
 
-    /*  Wait for transfer completed. */
-    while (!g_MasterCompletionFlag){}
-    g_MasterCompletionFlag = false;
+    DRV_CAPTOUCH_I2C_TRACE(TRACE_DIR_READ, reg, rxd, len);
+    DRV_CAPTOUCH_I2C_SHADOW_Update(reg, rxd, len);
 
-    masterXfer.slaveAddress   = I2C_SLAVE_ADDR;
-    masterXfer.direction      = kI2C_Read;
-    masterXfer.subaddress     = (uint32_t)NULL;
-    masterXfer.subaddressSize = 0;
-    masterXfer.data           = i2cRx;
-    masterXfer.dataSize       = BYTE;
+    return error;
+}
+
+// Register write, the shadow is written through once the bus transfer succeeded
+static int8_t CAPTOUCH_Write(uint8_t reg, const uint8_t *txd, uint8_t len)
+{
+    int8_t error = 0;
+
+    if(DRV_CAPTOUCH_I2C_SHADOW_Match(reg, txd, len))
+        return ERR_NONE;
 
-    error = I2C_MasterTransferNonBlocking(I2C_BASEADDR, &g_m_handle, &masterXfer);
+    error = transport->write(transport->ctx, reg, txd, len);
     if(error){
         return error;
     }
 
-    /*  Wait for transfer completed. */
-    while (!g_MasterCompletionFlag){}
-    g_MasterCompletionFlag = false;
-
-    // Update data
-    *rxd = i2cRx[0];
+    DRV_CAPTOUCH_I2C_TRACE(0, reg, txd, len);
+    DRV_CAPTOUCH_I2C_SHADOW_Update(reg, txd, len);
 
     return error;
 }
 
-int8_t DRV_CAPTOUCH_I2C_ReadHalfWord(uint8_t start_reg, uint16_t *rxd)
+// TD_STATUS and the records of k contacts, the WEIGHT and MISC bytes of the last one are skipped
+static uint8_t CAPTOUCH_FrameLength(uint8_t k)
 {
-    i2c_master_transfer_t masterXfer;
-    int8_t error = 0;
+    return k ? 1 + TOUCH_RECORD_SIZE * (k - 1) + TOUCH_RECORD_USED : 1;
+}
 
-    masterXfer.slaveAddress   = I2C_SLAVE_ADDR;
-    masterXfer.direction      = kI2C_Write;
-    masterXfer.subaddress     = (uint32_t)NULL;
-    masterXfer.subaddressSize = 0;
-    masterXfer.data           = &start_reg;
-    masterXfer.dataSize       = BYTE;
-    masterXfer.flags          = kI2C_TransferDefaultFlag;
+// Decodes n touch records laid out TOUCH_RECORD_SIZE apart and applies the orientation
+static void CAPTOUCH_Decode(const uint8_t *array, POINT_OBJ *point, uint8_t n)
+{
+    uint16_t x, y;
 
-    error = (int8_t)I2C_MasterTransferNonBlocking(I2C_BASEADDR, &g_m_handle, &masterXfer);
-    if(error){
-        return error;
+    DRV_CAPTOUCH_I2C_BENCH_BEGIN(BENCH_STAGE_DECODE);
+    for(uint8_t i = 0; i < n; i++){
+        point[i].event_flag = (array[i*6] & 0xC0) >> 6;
+        point[i].id = (array[i*6+2] & 0xF0) >> 4;
+        point[i].x = ((array[i*6+0] & 0x0F) << 8) + array[i*6+1];
+        point[i].y = ((array[i*6+2] & 0x0F) << 8) + array[i*6+3];
     }
+    DRV_CAPTOUCH_I2C_BENCH_END(BENCH_STAGE_DECODE);
 
-    /*  Wait for transfer completed. */
-    while (!g_MasterCompletionFlag){}
-    g_MasterCompletionFlag = false;
-
-    masterXfer.slaveAddress   = I2C_SLAVE_ADDR;
-    masterXfer.direction      = kI2C_Read;
-    masterXfer.subaddress     = (uint32_t)NULL;
-    masterXfer.subaddressSize = 0;
-    masterXfer.data           = i2cRx;
-    masterXfer.dataSize       = HALFWORD;
-
-    error = (int8_t)I2C_MasterTransferNonBlocking(I2C_BASEADDR, &g_m_handle, &masterXfer);
-    if(error){
-        return error;
+    DRV_CAPTOUCH_I2C_BENCH_BEGIN(BENCH_STAGE_TRANSFORM);
+    for(uint8_t i = 0; i < n; i++){
+        x = point[i].x;
+        y = point[i].y;
+        
+        switch(ORIENTATION){
+          case 90:
+            point[i].x = MAX_Y_PIXEL - y;
+            point[i].y = MAX_X_PIXEL - x;
+            break;
+          case 180:
+            point[i].x = x;
+            point[i].y = MAX_Y_PIXEL - y;
+            break;
+          case 270:
+            point[i].x = y;
+            point[i].y = x;
+            break;
+          default: // 0�
+            point[i].x = MAX_X_PIXEL - x;
+            point[i].y = y;
+            break;
+        }    
     }
+    DRV_CAPTOUCH_I2C_BENCH_END(BENCH_STAGE_TRANSFORM);
+}
 
-    /*  Wait for transfer completed. */
-    while (!g_MasterCompletionFlag){}
-    g_MasterCompletionFlag = false;
 
-    // Update data
-    *rxd = (i2cRx[0] << 8) + i2cRx[1];
+// *****************************************************************************
+// *****************************************************************************
+// Section: Init Function
 
-    return error;
+void DRV_CAPTOUCH_I2C_SetTransport(const TRANSPORT_OBJ *t)
+{
+    if(t != NULL)
+        transport = t;
 }
 
-int8_t DRV_CAPTOUCH_I2C_ReadWord(uint8_t start_reg, uint32_t *rxd)
+const TRANSPORT_OBJ *DRV_CAPTOUCH_I2C_GetTransport(void)
 {
-    i2c_master_transfer_t masterXfer;
-    int8_t error = 0;
-
-    masterXfer.slaveAddress   = I2C_SLAVE_ADDR;
-    masterXfer.direction      = kI2C_Write;
-    masterXfer.subaddress     = (uint32_t)NULL;
-    masterXfer.subaddressSize = 0;
-    masterXfer.data           = &start_reg;
-    masterXfer.dataSize       = BYTE;
-    masterXfer.flags          = kI2C_TransferDefaultFlag;
+    return transport;
+}
 
-    error = (int8_t)I2C_MasterTransferNonBlocking(I2C_BASEADDR, &g_m_handle, &masterXfer);
-    if(error){
-        return error;
-    }
+int8_t DRV_CAPTOUCH_I2C_Init(void)
+{
+    int8_t error = 0;
+    uint8_t md;
 
-    /*  Wait for transfer completed. */
-    while (!g_MasterCompletionFlag){}
-    g_MasterCompletionFlag = false;
+    memset(&i2cRx, 0, sizeof(i2cRx));
 
-    masterXfer.slaveAddress   = I2C_SLAVE_ADDR;
-    masterXfer.direction      = kI2C_Read;
-    masterXfer.subaddress     = (uint32_t)NULL;
-    masterXfer.subaddressSize = 0;
-    masterXfer.data           = i2cRx;
-    masterXfer.dataSize       = WORD;
+    // Nothing is known about a controller that may just have been powered
+    DRV_CAPTOUCH_I2C_SHADOW_Invalidate(SHADOW_ALL);
 
-    error = (int8_t)I2C_MasterTransferNonBlocking(I2C_BASEADDR, &g_m_handle, &masterXfer);
+    error = transport->init(transport->ctx);
     if(error){
         return error;
     }
 
-    /*  Wait for transfer completed. */
-    while (!g_MasterCompletionFlag){}
-    g_MasterCompletionFlag = false;
+    // Seeds the register page of the shadow, a missing panel is reported by the first access
+    (void) DRV_CAPTOUCH_I2C_ReadByte(OP_REG_DEVICEMODE, &md);
 
-    // Update data
-    *rxd = (i2cRx[0] << 24) + (i2cRx[1] << 16) + (i2cRx[2] << 8) + i2cRx[3];
+    // Sets the number of contact records GetFrame reads
+    if(DRV_CAPTOUCH_I2C_VARIANT_Detect())
+        DRV_CAPTOUCH_I2C_VARIANT_Select(VARIANT_GENERIC);
 
     return error;
 }
 
-int8_t DRV_CAPTOUCH_I2C_ReadArray(uint8_t start_reg, uint8_t *rxd, uint8_t len)
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: I2C Access Functions
+
+int8_t DRV_CAPTOUCH_I2C_ReadByte(uint8_t reg, uint8_t *rxd)
 {
-    i2c_master_transfer_t masterXfer;
     int8_t error = 0;
 
-    masterXfer.slaveAddress   = I2C_SLAVE_ADDR;
-    masterXfer.direction      = kI2C_Write;
-    masterXfer.subaddress     = (uint32_t)NULL;
-    masterXfer.subaddressSize = 0;
-    masterXfer.data           = &start_reg;
-    masterXfer.dataSize       = BYTE;
-    masterXfer.flags          = kI2C_TransferDefaultFlag;
-
-    error = (int8_t)I2C_MasterTransferNonBlocking(I2C_BASEADDR, &g_m_handle, &masterXfer);
+    error = CAPTOUCH_Read(reg, i2cRx, BYTE);
     if(error){
         return error;
     }
 
-    /*  Wait for transfer completed. */
-    while (!g_MasterCompletionFlag){}
-    g_MasterCompletionFlag = false;
+    // Update data
+    *rxd = i2cRx[0];
+
+    return error;
+}
 
-    masterXfer.slaveAddress   = I2C_SLAVE_ADDR;
-    masterXfer.direction      = kI2C_Read;
-    masterXfer.subaddress     = (uint32_t)NULL;
-    masterXfer.subaddressSize = 0;
-    masterXfer.data           = i2cRx;
-    masterXfer.dataSize       = len;
+int8_t DRV_CAPTOUCH_I2C_ReadHalfWord(uint8_t start_reg, uint16_t *rxd)
+{
+    int8_t error = 0;
 
-    error = (int8_t)I2C_MasterTransferNonBlocking(I2C_BASEADDR, &g_m_handle, &masterXfer);
+    error = CAPTOUCH_Read(start_reg, i2cRx, HALFWORD);
     if(error){
         return error;
     }
 
-
-    /*  Wait for transfer completed. */
-    while (!g_MasterCompletionFlag){}
-    g_MasterCompletionFlag = false;
-    
     // Update data
-    for (uint8_t i = 0; i < len; i++) {
-        rxd[i] = i2cRx[i];
-    }
+    *rxd = (i2cRx[0] << 8) + i2cRx[1];
 
     return error;
 }
 
-int8_t DRV_CAPTOUCH_I2C_WriteByte(uint8_t reg, uint8_t data)
+int8_t DRV_CAPTOUCH_I2C_ReadWord(uint8_t start_reg, uint32_t *rxd)
 {
-    i2c_master_transfer_t masterXfer;
     int8_t error = 0;
-    
-    i2cTx[0] = reg;
-    i2cTx[1] = data;
-    
-    masterXfer.slaveAddress   = I2C_SLAVE_ADDR;
-    masterXfer.direction      = kI2C_Write;
-    masterXfer.subaddress     = (uint32_t)NULL;
-    masterXfer.subaddressSize = 0;
-    masterXfer.data           = i2cTx;
-    masterXfer.dataSize       = HALFWORD;
-    masterXfer.flags          = kI2C_TransferDefaultFlag;
-
-    error = I2C_MasterTransferNonBlocking(I2C_BASEADDR, &g_m_handle, &masterXfer);
+
+    error = CAPTOUCH_Read(start_reg, i2cRx, WORD);
     if(error){
         return error;
     }
 
-    /*  Wait for transfer completed. */
-    while (!g_MasterCompletionFlag){}
-    g_MasterCompletionFlag = false;
-    
+    // Update data
+    *rxd = (i2cRx[0] << 24) + (i2cRx[1] << 16) + (i2cRx[2] << 8) + i2cRx[3];
+
     return error;
 }
 
-int8_t DRV_CAPTOUCH_I2C_WriteHalfWord(uint8_t start_reg, uint16_t data)
+int8_t DRV_CAPTOUCH_I2C_ReadArray(uint8_t start_reg, uint8_t *rxd, uint8_t len)
 {
-    i2c_master_transfer_t masterXfer;
-    int8_t error = 0;
-    
-    i2cTx[0] = start_reg;
-    i2cTx[1] = (data & 0xFF00) >> 8;
-    i2cTx[2] = data & 0x00FF;
-    
-    masterXfer.slaveAddress   = I2C_SLAVE_ADDR;
-    masterXfer.direction      = kI2C_Write;
-    masterXfer.subaddress     = (uint32_t)NULL;
-    masterXfer.subaddressSize = 0;
-    masterXfer.data           = i2cTx;
-    masterXfer.dataSize       = HALFWORD + 1;
-    masterXfer.flags          = kI2C_TransferDefaultFlag;
-
-    error = I2C_MasterTransferNonBlocking(I2C_BASEADDR, &g_m_handle, &masterXfer);
-    if(error){
-        return error;
-    }
+    // Data is received straight into the caller's buffer
+    return CAPTOUCH_Read(start_reg, rxd, len);
+}
 
-    /*  Wait for transfer completed. */
-    while (!g_MasterCompletionFlag){}
-    g_MasterCompletionFlag = false;
+int8_t DRV_CAPTOUCH_I2C_WriteByte(uint8_t reg, uint8_t data)
+{
+    i2cTx[0] = data;
     
-    return error;
+    return CAPTOUCH_Write(reg, i2cTx, BYTE);
 }
 
-int8_t DRV_CAPTOUCH_I2C_WriteWord(uint8_t start_reg, uint32_t data)
+int8_t DRV_CAPTOUCH_I2C_WriteHalfWord(uint8_t start_reg, uint16_t data)
 {
-    i2c_master_transfer_t masterXfer;
-    int8_t error = 0;
-   
-    i2cTx[0] = start_reg;
-    i2cTx[1] = (data & 0xFF000000) >> 24;
-    i2cTx[2] = (data & 0x00FF0000) >> 16;
-    i2cTx[3] = (data & 0x0000FF00) >> 8;
-    i2cTx[4] = data & 0x000000FF;
+    i2cTx[0] = (data & 0xFF00) >> 8;
+    i2cTx[1] = data & 0x00FF;
     
-    masterXfer.slaveAddress   = I2C_SLAVE_ADDR;
-    masterXfer.direction      = kI2C_Write;
-    masterXfer.subaddress     = (uint32_t)NULL;
-    masterXfer.subaddressSize = 0;
-    masterXfer.data           = i2cTx;
-    masterXfer.dataSize       = WORD + 1;
-    masterXfer.flags          = kI2C_TransferDefaultFlag;
-
-    error = I2C_MasterTransferNonBlocking(I2C_BASEADDR, &g_m_handle, &masterXfer);
-    if(error){
-        return error;
-    }
+    return CAPTOUCH_Write(start_reg, i2cTx, HALFWORD);
+}
 
-    /*  Wait for transfer completed. */
-    while (!g_MasterCompletionFlag){}
-    g_MasterCompletionFlag = false;
+int8_t DRV_CAPTOUCH_I2C_WriteWord(uint8_t start_reg, uint32_t data)
+{
+    i2cTx[0] = (data & 0xFF000000) >> 24;
+    i2cTx[1] = (data & 0x00FF0000) >> 16;
+    i2cTx[2] = (data & 0x0000FF00) >> 8;
+    i2cTx[3] = data & 0x000000FF;
     
-    return error;
+    return CAPTOUCH_Write(start_reg, i2cTx, WORD);
 }
 
 int8_t DRV_CAPTOUCH_I2C_WriteArray(uint8_t start_reg, uint8_t *data, uint8_t len)
 {
-    i2c_master_transfer_t masterXfer;
-    int8_t error = 0;
-
-    if(len > I2C_BUFFER_LENGTH);
-      len = I2C_BUFFER_LENGTH;
-    
-    i2cTx[0] = start_reg;
-    for(uint8_t i = 1; i < len; i++)
-      i2cTx[i] = data[i-1];
-    
-    
-    masterXfer.slaveAddress   = I2C_SLAVE_ADDR;
-    masterXfer.direction      = kI2C_Write;
-    masterXfer.subaddress     = (uint32_t)NULL;
-    masterXfer.subaddressSize = 0;
-    masterXfer.data           = i2cTx;
-    masterXfer.dataSize       = len + 1;
-    masterXfer.flags          = kI2C_TransferDefaultFlag;
-
-    error = I2C_MasterTransferNonBlocking(I2C_BASEADDR, &g_m_handle, &masterXfer);
-    if(error){
-        return error;
-    }
-
-    /*  Wait for transfer completed. */
-    while (!g_MasterCompletionFlag){}
-    g_MasterCompletionFlag = false;
+    // i2c-dev needs the register and the data in one message buffer
+    if(len > I2C_BUFFER_LENGTH - 1)
+      len = I2C_BUFFER_LENGTH - 1;
     
-    return error;
+    return CAPTOUCH_Write(start_reg, data, len);
 }
 
 
@@ -431,42 +319,64 @@ int8_t DRV_CAPTOUCH_I2C_GetMultiPixelPoint(POINT_OBJ* point, uint8_t n)
     
     uint8_t array[MAX_TOUCHES*6];
     int8_t error = 0;
-    uint16_t x, y;
 
     error = DRV_CAPTOUCH_I2C_ReadArray(OP_REG_TOUCHX1H, array, n*6);
     if(error){
         return error;
     }
 
-    for(uint8_t i = 0; i < n; i++){
-        point[i].event_flag = (array[i*6] & 0xC0) >> 6;
-        point[i].id = (array[i*6+2] & 0xF0) >> 4;
-        x = ((array[i*6+0] & 0x0F) << 8) + array[i*6+1];
-        y = ((array[i*6+2] & 0x0F) << 8) + array[i*6+3];
-        
-        switch(ORIENTATION){
-          case 90:
-            point[i].x = MAX_Y_PIXEL - y;
-            point[i].y = MAX_X_PIXEL - x;
-            break;
-          case 180:
-            point[i].x = x;
-            point[i].y = MAX_Y_PIXEL - y;
-            break;
-          case 270:
-            point[i].x = y;
-            point[i].y = x;
-            break;
-          default: // 0�
-            point[i].x = MAX_X_PIXEL - x;
-            point[i].y = y;
-            break;
-        }    
+    CAPTOUCH_Decode(array, point, n);
+
+    return error;
+}
+
+int8_t DRV_CAPTOUCH_I2C_GetFrame(POINT_OBJ *point, uint8_t *n)
+{
+    const VARIANT_OBJ *variant = DRV_CAPTOUCH_I2C_VARIANT_Get();
+    uint8_t array[1 + MAX_TOUCHES*TOUCH_RECORD_SIZE];
+    uint8_t spec = frameTouches;
+    uint8_t count, done;
+    int8_t error = 0;
+
+    if(spec > variant->max_touches)
+        spec = variant->max_touches;
+
+    // Speculate that the contact count did not change since the last frame
+    error = CAPTOUCH_Read(OP_REG_TDSTATUS, array, CAPTOUCH_FrameLength(spec));
+    if(error){
+        return error;
+    }
+
+    // TD_STATUS 0x0F or 0xFF: not ready, the speculation stays as it was
+    count = array[0] & 0x0F;
+    if(count > variant->max_touches)
+        return ERR_FORMAT;
+
+    // More contacts than speculated: fetch only the missing records
+    if(count > spec){
+        done = 1 + TOUCH_RECORD_SIZE * spec;
+        error = CAPTOUCH_Read(OP_REG_TDSTATUS + done, &array[done], CAPTOUCH_FrameLength(count) - done);
+        if(error){
+            return error;
+        }
     }
 
+    CAPTOUCH_Decode(&array[1], point, count);
+    frameTouches = count;
+    *n = count;
+
     return error;
 }
 
+// Decodes records already read, laid out as from OP_REG_TOUCHX1H
+void DRV_CAPTOUCH_I2C_DecodeRecords(const uint8_t *records, POINT_OBJ *point, uint8_t n)
+{
+    if(n > MAX_TOUCHES)
+        n = MAX_TOUCHES;
+
+    CAPTOUCH_Decode(records, point, n);
+}
+
 int8_t DRV_CAPTOUCH_I2C_GetTouch(bool *touch)
 {
     uint8_t res;
@@ -567,6 +477,22 @@ int8_t DRV_CAPTOUCH_I2C_GetThresholdObject(THRESHOLD_OBJ *th)
 }
 
 
+int8_t DRV_CAPTOUCH_I2C_GetLibVersion(uint16_t *rxd)
+{
+    return DRV_CAPTOUCH_I2C_ReadHalfWord(OP_REG_LIBVERSIONH, rxd);
+}
+
+int8_t DRV_CAPTOUCH_I2C_GetCipher(uint8_t *rxd)
+{
+    return DRV_CAPTOUCH_I2C_ReadByte(OP_REG_CIPHER, rxd);
+}
+
+int8_t DRV_CAPTOUCH_I2C_GetFirmwareID(uint8_t *rxd)
+{
+    return DRV_CAPTOUCH_I2C_ReadByte(OP_REG_FIRMID, rxd);
+}
+
+
 // *****************************************************************************
 // *****************************************************************************
 // Section: Set Functions
@@ -584,52 +510,29 @@ int8_t DRV_CAPTOUCH_I2C_SetDeviceMode(DEVICE_MODE mode)
     md &= 0xC0;
     md |= mode;
     
-    error = (int8_t) DRV_CAPTOUCH_I2C_WriteByte(OP_REG_DEVICEMODE, mode);
+    error = (int8_t) DRV_CAPTOUCH_I2C_WriteByte(OP_REG_DEVICEMODE, md);
     
     return error;
 }
 
 int8_t DRV_CAPTOUCH_I2C_SetThresholdObject(THRESHOLD_OBJ *th)
 {
-    uint8_t array[6];
-    int8_t error = 0;
+    CONFIG_OBJ cfg = { 0 };
 
-    array[0] = th->threshold / 4;
-    array[1] = th->peak;
-    array[2] = th->focus;
-    array[3] = th->water;
-    array[4] = th->temperature;
-    array[5] = th->difference;
-    
-    error = DRV_CAPTOUCH_I2C_WriteArray(OP_REG_THGROUP, array, 6);
+    // Only the thresholds that differ from the shadow go on the bus
+    DRV_CAPTOUCH_I2C_CONFIG_SetThreshold(&cfg, th);
 
-    return error;
+    return DRV_CAPTOUCH_I2C_CONFIG_Apply(&cfg);
 }
 
 int8_t DRV_CAPTOUCH_I2C_SetThresholdDefault(void)
 {
-    uint8_t array[6];
-    int8_t error = 0;
-    
-#ifdef FROMDATASHEET              // Default parameters defined in the Datasheet
-    array[0] = 280 / 4;
-    array[1] = 60;
-    array[2] = 16;
-    array[3] = 60;
-    array[4] = 10;
-    array[5] = 20;
-#elsif
-    array[0] = 240 / 4;
-    array[1] = 50;
-    array[2] = 17;
-    array[3] = 17;
-    array[4] = 17;
-    array[5] = 160;
-#endif
-    
-    error = DRV_CAPTOUCH_I2C_WriteArray(OP_REG_THGROUP, array, 6);
+    CONFIG_OBJ cfg = *DRV_CAPTOUCH_I2C_PROFILE_Get(PROFILE_NORMAL);
 
-    return error;
+    // Thresholds of the normal profile, FROMDATASHEET selects the datasheet defaults
+    cfg.set = CONFIG_THRESHOLDS;
+
+    return DRV_CAPTOUCH_I2C_CONFIG_Apply(&cfg);
 }
 
 
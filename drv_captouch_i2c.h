@@ -31,8 +31,6 @@
 // *****************************************************************************
 // Section: Defines
 
-#define TWOTOUCH
-
 #define I2C_BASEADDR                I2C3
 #define INT_GPIO                    GPIO5
 #define INT_PIN                     4
@@ -41,7 +39,7 @@
 #define I2C_SLAVE_ADDR              0x38U
 #define I2C_BAUDRATE                100000U // 100kHz
 #define I2C_BAUDRATE_MAX            400000U // 400kHz
-#define I2C_BUFFER_LENGTH           30
+#define I2C_BUFFER_LENGTH           64      // >= TD_STATUS + MAX_TOUCHES records
 
 #define MAX_X_PIXEL                 800
 #define MAX_Y_PIXEL                 480
@@ -49,11 +47,28 @@
 #define HEIGHT                      86      // 86.64 mm
 #define ORIENTATION                 0       // 0� also supported 90�, 180�, 270�
 
+#ifndef DRV_CAPTOUCH_I2C_TIMESTAMP
+#ifdef I2CDEV_EN
+#define DRV_CAPTOUCH_I2C_TIMESTAMP()    DRV_CAPTOUCH_I2C_I2CDEV_Timestamp()   // CLOCK_MONOTONIC in us
+#define DRV_CAPTOUCH_I2C_TIMESTAMP_HZ   1000000U
+#define DRV_CAPTOUCH_I2C_TIMESTAMP_ENABLE()
+uint32_t DRV_CAPTOUCH_I2C_I2CDEV_Timestamp(void);
+#else
+#define DRV_CAPTOUCH_I2C_TIMESTAMP()    (DWT->CYCCNT)       // requires the DWT cycle counter to be enabled
+#define DRV_CAPTOUCH_I2C_TIMESTAMP_HZ   (SystemCoreClock)
+#define DRV_CAPTOUCH_I2C_TIMESTAMP_ENABLE()                                     \
+    do{ CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk; DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk; }while(0)
+#endif
+#endif
+#ifndef DRV_CAPTOUCH_I2C_TIMESTAMP_ENABLE
+#define DRV_CAPTOUCH_I2C_TIMESTAMP_ENABLE()                                     // own time source, already running
+#endif
+
 // *****************************************************************************
 // *****************************************************************************
 // Section: Init Function
 
-void DRV_CAPTOUCH_I2C_Init(void);
+int8_t DRV_CAPTOUCH_I2C_Init(void);
 
 
 // *****************************************************************************
@@ -79,12 +94,17 @@ int8_t DRV_CAPTOUCH_I2C_WriteArray(uint8_t start_reg, uint8_t *txd, uint8_t len)
 
 int8_t DRV_CAPTOUCH_I2C_GetSinglePixelPoint(POINT_OBJ* point);
 int8_t DRV_CAPTOUCH_I2C_GetMultiPixelPoint(POINT_OBJ* point, uint8_t n);
+int8_t DRV_CAPTOUCH_I2C_GetFrame(POINT_OBJ *point, uint8_t *n);
+void DRV_CAPTOUCH_I2C_DecodeRecords(const uint8_t *records, POINT_OBJ *point, uint8_t n);
 int8_t DRV_CAPTOUCH_I2C_GetTouch(bool *touch);
 int8_t DRV_CAPTOUCH_I2C_GetNumberOfTouch(uint8_t *n);
 int8_t DRV_CAPTOUCH_I2C_GetDeviceMode(uint8_t *rxd);
 int8_t DRV_CAPTOUCH_I2C_GetGestureID(uint8_t *rxd);
 int8_t DRV_CAPTOUCH_I2C_GetState(uint8_t *rxd);
 int8_t DRV_CAPTOUCH_I2C_GetThresholdObject(THRESHOLD_OBJ *th);
+int8_t DRV_CAPTOUCH_I2C_GetLibVersion(uint16_t *rxd);
+int8_t DRV_CAPTOUCH_I2C_GetCipher(uint8_t *rxd);
+int8_t DRV_CAPTOUCH_I2C_GetFirmwareID(uint8_t *rxd);
 
 
 // *****************************************************************************
@@ -0,0 +1,231 @@
+/****************************************************************************************
+  I2C Capacitive Touch Driver: C++ Header File
+
+  File Name:
+    drv_captouch_i2c.hpp
+
+  Summary:
+    Header-only C++17 layer with the panel configuration as template parameters.
+
+  Description:
+    Ft5x46<Transport, Panel, Orientation, MaxTouches> reads a touch report with
+    the same speculative burst as DRV_CAPTOUCH_I2C_GetFrame, into a buffer sized
+    for MaxTouches, and decodes it with a loop specialized for the panel and
+    orientation. MAX_X_PIXEL, MAX_Y_PIXEL, ORIENTATION and MAX_TOUCHES only
+    provide the defaults, so one build can hold several configurations. Nothing
+    is allocated: frames and buffers live in the object.
+ ***************************************************************************************/
+
+
+#ifndef DRV_CAPTOUCH_I2C_HPP
+#define DRV_CAPTOUCH_I2C_HPP
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+extern "C" {
+#include "drv_captouch_i2c.h"
+#include "drv_captouch_i2c_transport.h"
+}
+#include "drv_captouch_i2c_regmap.hpp"
+
+
+namespace captouch {
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Types
+
+/* Rotation applied to controller coordinates, same conventions as ORIENTATION */
+enum class Orientation : uint16_t {
+    Deg0    = 0,
+    Deg90   = 90,
+    Deg180  = 180,
+    Deg270  = 270
+};
+
+/* Panel Resolution in pixels */
+template<uint16_t Width, uint16_t Height>
+struct PanelGeometry
+{
+    static constexpr uint16_t width = Width;
+    static constexpr uint16_t height = Height;
+};
+
+using DefaultPanel = PanelGeometry<MAX_X_PIXEL, MAX_Y_PIXEL>;
+constexpr Orientation DefaultOrientation = static_cast<Orientation>(ORIENTATION);
+
+/* Register access through the C driver: shadow, trace and the selected TRANSPORT_OBJ apply */
+struct DriverTransport
+{
+    static int8_t read(uint8_t reg, uint8_t *rxd, uint8_t len)
+    {
+        return DRV_CAPTOUCH_I2C_ReadArray(reg, rxd, len);
+    }
+
+    static int8_t write(uint8_t reg, uint8_t *txd, uint8_t len)
+    {
+        return DRV_CAPTOUCH_I2C_WriteArray(reg, txd, len);
+    }
+};
+
+/* Register access straight to a TRANSPORT_OBJ, e.g. a second controller on another bus */
+template<const TRANSPORT_OBJ *T>
+struct ObjectTransport
+{
+    static int8_t read(uint8_t reg, uint8_t *rxd, uint8_t len)
+    {
+        return T->read(T->ctx, reg, rxd, len);
+    }
+
+    static int8_t write(uint8_t reg, uint8_t *txd, uint8_t len)
+    {
+        return T->write(T->ctx, reg, txd, len);
+    }
+};
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Controller
+
+template<typename Transport = DriverTransport, typename Panel = DefaultPanel,
+         Orientation Orient = DefaultOrientation, uint8_t MaxTouches = MAX_TOUCHES>
+class Ft5x46
+{
+public:
+    static_assert(MaxTouches >= 1 && MaxTouches <= MAX_TOUCHES, "the register map holds MAX_TOUCHES records");
+    static_assert(Panel::width > 0 && Panel::height > 0, "empty panel");
+
+    static constexpr uint8_t max_touches = MaxTouches;
+    static constexpr std::size_t buffer_size = 1 + TOUCH_RECORD_SIZE * MaxTouches;
+
+    struct Frame
+    {
+        uint8_t                             count = 0;
+        std::array<POINT_OBJ, MaxTouches>   point{};
+    };
+
+    // Controller coordinates to the panel orientation
+    static void orient(uint16_t x, uint16_t y, uint16_t &ox, uint16_t &oy)
+    {
+        if constexpr(Orient == Orientation::Deg90){
+            ox = Panel::height - y;
+            oy = Panel::width - x;
+        }else if constexpr(Orient == Orientation::Deg180){
+            ox = x;
+            oy = Panel::height - y;
+        }else if constexpr(Orient == Orientation::Deg270){
+            ox = y;
+            oy = x;
+        }else{
+            ox = Panel::width - x;
+            oy = y;
+        }
+    }
+
+    // Decodes n records laid out as from OP_REG_TOUCHX1H
+    static void decode(const uint8_t *rec, POINT_OBJ *point, uint8_t n)
+    {
+        using R = reg::Touch<1>;
+
+        for(uint8_t i = 0; i < n; i++, rec += TOUCH_RECORD_SIZE){
+            const uint16_t x = R::X::decode(&rec[R::X::address - R::base]);
+            const uint16_t y = R::Y::decode(&rec[R::Y::address - R::base]);
+
+            point[i].event_flag = R::Event::decode(&rec[R::Event::address - R::base]);
+            point[i].id = R::Id::decode(&rec[R::Id::address - R::base]);
+            orient(x, y, point[i].x, point[i].y);
+        }
+    }
+
+    // Burst length for TD_STATUS and k records
+    static constexpr uint8_t burst_length(uint8_t k)
+    {
+        return plan_[k];
+    }
+
+    // One report: a burst sized for the previous contact count, a second one only if more came down
+    int8_t read_report()
+    {
+        const uint8_t spec = last_;
+        uint8_t count, done;
+        int8_t error = 0;
+
+        error = Transport::read(OP_REG_TDSTATUS, buffer_.data(), plan_[spec]);
+        if(error){
+            return error;
+        }
+
+        // TD_STATUS 0x0F or 0xFF: not ready, the speculation stays as it was
+        count = buffer_[0] & 0x0F;
+        if(count > MaxTouches)
+            return ERR_FORMAT;
+
+        if(count > spec){
+            done = 1 + TOUCH_RECORD_SIZE * spec;
+            error = Transport::read(OP_REG_TDSTATUS + done, &buffer_[done], plan_[count] - done);
+            if(error){
+                return error;
+            }
+        }
+
+        last_ = count;
+
+        return error;
+    }
+
+    // Registers from OP_REG_TDSTATUS as read by read_report, with contacts() records
+    const uint8_t *report() const
+    {
+        return buffer_.data();
+    }
+
+    uint8_t contacts() const
+    {
+        return last_;
+    }
+
+    int8_t read_frame(Frame &frame)
+    {
+        int8_t error = 0;
+
+        error = read_report();
+        if(error){
+            return error;
+        }
+
+        decode(&buffer_[1], frame.point.data(), last_);
+        frame.count = last_;
+
+        return error;
+    }
+
+private:
+    // Burst length for TD_STATUS and k records, the last record stops after YL
+    static constexpr std::array<uint8_t, MaxTouches + 1> make_plan()
+    {
+        std::array<uint8_t, MaxTouches + 1> plan{};
+
+        plan[0] = 1;
+        for(uint8_t k = 1; k <= MaxTouches; k++)
+            plan[k] = 1 + TOUCH_RECORD_SIZE * (k - 1) + TOUCH_RECORD_USED;
+
+        return plan;
+    }
+
+    static constexpr std::array<uint8_t, MaxTouches + 1> plan_ = make_plan();
+
+    std::array<uint8_t, buffer_size> buffer_{};
+    uint8_t last_ = 0;
+};
+
+} // namespace captouch
+
+#endif //DRV_CAPTOUCH_I2C_HPP
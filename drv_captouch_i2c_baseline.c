@@ -0,0 +1,268 @@
+/****************************************************************************************
+  I2C Capacitive Touch Driver: Baseline
+
+  File Name:
+    drv_captouch_i2c_baseline.c
+
+  Summary:
+    Per-node baseline and noise tracking of raw frames with 16 bit SIMD kernels.
+
+  Description:
+    Two nodes are handled per 32 bit word: QSUB16 forms both saturated deltas,
+    SMULBB/SMULTT their squares and SMLAD accumulates the frame energy. On
+    cores with the DSP extension (Cortex-M4/M7) QSUB16 and SMLAD are the CMSIS
+    intrinsics, elsewhere bit exact C versions below, so host and target
+    produce the same frames. Raw counts are taken as signed 16 bit values, controllers report
+    them in 15 bits.
+
+    Baseline and variance are EMAs in fixed point: baseline in 1/2^BASELINE_FRAC
+    counts, variance in 1/2^BASELINE_NOISE_FRAC counts squared. The integer
+    baseline the deltas are formed against is kept next to it so the delta
+    kernel reads 16 bit pairs only.
+ ***************************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include <string.h>
+#include "drv_captouch_i2c.h"
+#include "drv_captouch_i2c_baseline.h"
+#ifndef I2CDEV_EN
+#include "fsl_common.h"
+#endif
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Defines
+
+// Halfword products, compiled to SMULBB/SMULTT on the M4
+#define BASELINE_SMULBB(a, b)       ((int32_t)(int16_t)(a) * (int16_t)(b))
+#define BASELINE_SMULTT(a, b)       ((int32_t)(int16_t)((a) >> 16) * (int16_t)((b) >> 16))
+
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+#define BASELINE_QSUB16(a, b)       __QSUB16(a, b)
+#define BASELINE_SMLAD(a, b, acc)   __SMLAD(a, b, acc)
+#else
+#define BASELINE_QSUB16(a, b)       BASELINE_Qsub16(a, b)
+#define BASELINE_SMLAD(a, b, acc)   ((uint32_t)BASELINE_SMULBB(a, b) + (uint32_t)BASELINE_SMULTT(a, b) + (acc))
+#endif
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Variables
+
+static BASELINE_CONFIG_OBJ baselineConfig = {
+    BASELINE_SHIFT_DEFAULT, BASELINE_NOISE_SHIFT_DEFAULT, BASELINE_GATE_DEFAULT
+};
+
+//! Integer baseline for the delta kernel
+static uint16_t baselineLevel[BASELINE_NODES];
+static int32_t baselineValue[BASELINE_NODES];
+static uint32_t baselineVariance[BASELINE_NODES];
+
+static uint8_t baselineRows = 0;
+static uint8_t baselineCols = 0;
+static BASELINE_STATS_OBJ baselineStats;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+
+#if !(defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1))
+static int16_t BASELINE_Saturate(int32_t v)
+{
+    if(v > INT16_MAX)
+        return INT16_MAX;
+    if(v < INT16_MIN)
+        return INT16_MIN;
+    return (int16_t)v;
+}
+
+static uint32_t BASELINE_Qsub16(uint32_t a, uint32_t b)
+{
+    uint16_t lo = (uint16_t)BASELINE_Saturate((int32_t)(int16_t)a - (int16_t)b);
+    uint16_t hi = (uint16_t)BASELINE_Saturate((int32_t)(int16_t)(a >> 16) - (int16_t)(b >> 16));
+
+    return ((uint32_t)hi << 16) | lo;
+}
+#endif
+
+// Raw frames need not be word aligned, a single LDR handles that on the M4
+static uint32_t BASELINE_Load32(const void *src)
+{
+    uint32_t v;
+
+    memcpy(&v, src, sizeof(v));
+
+    return v;
+}
+
+static void BASELINE_Store32(void *dst, uint32_t v)
+{
+    memcpy(dst, &v, sizeof(v));
+}
+
+static void BASELINE_Seed(const RAW_FRAME_OBJ *raw)
+{
+    uint16_t n = raw->rows * raw->cols;
+
+    for(uint16_t i = 0; i < n; i++){
+        baselineLevel[i] = raw->data[i];
+        baselineValue[i] = (int32_t)raw->data[i] << BASELINE_FRAC;
+        baselineVariance[i] = 0;
+    }
+
+    baselineRows = raw->rows;
+    baselineCols = raw->cols;
+    baselineStats.frames = 0;
+}
+
+// EMA update of one node that is not touched, sq is the square of its delta
+static void BASELINE_Track(uint16_t i, uint16_t raw, int32_t sq)
+{
+    int32_t value = baselineValue[i];
+    uint32_t var = baselineVariance[i];
+
+    value += (((int32_t)raw << BASELINE_FRAC) - value) >> baselineConfig.baseline_shift;
+    baselineValue[i] = value;
+    baselineLevel[i] = (uint16_t)((value + (1 << (BASELINE_FRAC - 1))) >> BASELINE_FRAC);
+
+    if(sq > BASELINE_SQUARE_MAX)
+        sq = BASELINE_SQUARE_MAX;
+    var += (((sq << BASELINE_NOISE_FRAC) - (int32_t)var) >> baselineConfig.noise_shift);
+    baselineVariance[i] = var;
+}
+
+static uint32_t BASELINE_Sqrt(uint32_t v)
+{
+    uint32_t r = 0, bit = 1u << 30;
+
+    while(bit > v)
+        bit >>= 2;
+
+    while(bit){
+        if(v >= r + bit){
+            v -= r + bit;
+            r = (r >> 1) + bit;
+        }else{
+            r >>= 1;
+        }
+        bit >>= 2;
+    }
+
+    return r;
+}
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Baseline Functions
+
+void DRV_CAPTOUCH_I2C_BASELINE_Init(const BASELINE_CONFIG_OBJ *cfg)
+{
+    if(cfg != NULL)
+        baselineConfig = *cfg;
+
+    baselineRows = 0;
+    baselineCols = 0;
+    memset(&baselineStats, 0, sizeof(baselineStats));
+}
+
+int8_t DRV_CAPTOUCH_I2C_BASELINE_Process(const RAW_FRAME_OBJ *raw, DELTA_FRAME_OBJ *delta)
+{
+    const int16_t gate = baselineConfig.touch_gate;
+    uint16_t n = raw->rows * raw->cols;
+    uint16_t touched = 0;
+    int16_t peak = 0;
+    uint32_t energy = 0, acc;
+    uint16_t i;
+
+    if(n == 0 || raw->rows > RAW_MAX_ROWS || raw->cols > RAW_MAX_COLS)
+        return ERR_FORMAT;
+
+    // The first frame, or one of another panel size, becomes the baseline
+    if(raw->rows != baselineRows || raw->cols != baselineCols)
+        BASELINE_Seed(raw);
+
+    delta->sequence = raw->sequence;
+    delta->timestamp = raw->timestamp;
+    delta->rows = raw->rows;
+    delta->cols = raw->cols;
+
+    for(i = 0; i + 1 < n; i += 2){
+        uint32_t r = BASELINE_Load32(&raw->data[i]);
+        uint32_t d = BASELINE_QSUB16(BASELINE_Load32(&baselineLevel[i]), r);
+        int16_t d0 = (int16_t)d;
+        int16_t d1 = (int16_t)(d >> 16);
+
+        BASELINE_Store32(&delta->data[i], d);
+
+        acc = BASELINE_SMLAD(d, d, energy);
+        energy = (acc < energy) ? UINT32_MAX : acc;
+
+        if(d0 < gate)
+            BASELINE_Track(i, (uint16_t)r, BASELINE_SMULBB(d, d));
+        else
+            touched++;
+        if(d1 < gate)
+            BASELINE_Track(i + 1, (uint16_t)(r >> 16), BASELINE_SMULTT(d, d));
+        else
+            touched++;
+
+        if(d0 > peak)
+            peak = d0;
+        if(d1 > peak)
+            peak = d1;
+    }
+
+    // Odd node count
+    if(i < n){
+        uint32_t d = BASELINE_QSUB16(baselineLevel[i], raw->data[i]);
+        int16_t d0 = (int16_t)d;
+
+        delta->data[i] = d0;
+        acc = energy + (uint32_t)BASELINE_SMULBB(d, d);
+        energy = (acc < energy) ? UINT32_MAX : acc;
+
+        if(d0 < gate)
+            BASELINE_Track(i, raw->data[i], BASELINE_SMULBB(d, d));
+        else
+            touched++;
+
+        if(d0 > peak)
+            peak = d0;
+    }
+
+    baselineStats.frames++;
+    baselineStats.touched = touched;
+    baselineStats.peak = peak;
+    baselineStats.energy = energy;
+
+    return ERR_NONE;
+}
+
+void DRV_CAPTOUCH_I2C_BASELINE_GetNoise(uint16_t *rms, uint16_t n)
+{
+    if(n > baselineRows * baselineCols)
+        n = baselineRows * baselineCols;
+
+    for(uint16_t i = 0; i < n; i++)
+        rms[i] = (uint16_t)BASELINE_Sqrt(baselineVariance[i]);
+}
+
+void DRV_CAPTOUCH_I2C_BASELINE_GetStats(BASELINE_STATS_OBJ *stats)
+{
+    uint16_t n = baselineRows * baselineCols;
+    uint64_t sum = 0;
+
+    for(uint16_t i = 0; i < n; i++)
+        sum += baselineVariance[i];
+
+    *stats = baselineStats;
+    stats->noise = n ? (uint16_t)BASELINE_Sqrt((uint32_t)(sum / n)) : 0;
+}
@@ -0,0 +1,88 @@
+/****************************************************************************************
+  I2C Capacitive Touch Driver: Baseline Header File
+
+  File Name:
+    drv_captouch_i2c_baseline.h
+
+  Summary:
+    This header file provides the baseline tracking and delta frames of raw data.
+
+  Description:
+    Every raw frame of drv_captouch_i2c_raw.c updates a per-node running baseline
+    and noise variance (fixed-point EMAs) and yields a delta frame of baseline
+    minus raw counts, positive under a finger. Nodes above the touch gate keep
+    their baseline and noise estimate until the finger is gone.
+ ***************************************************************************************/
+
+
+#ifndef DRV_CAPTOUCH_I2C_BASELINE_H
+#define DRV_CAPTOUCH_I2C_BASELINE_H
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "drv_captouch_i2c_defines.h"
+#include "drv_captouch_i2c_raw.h"
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Defines
+
+#define BASELINE_NODES              (RAW_MAX_ROWS * RAW_MAX_COLS)
+#define BASELINE_FRAC               8       // baseline fraction bits
+#define BASELINE_NOISE_FRAC         4       // variance fraction bits, RMS values carry half of them
+#define BASELINE_SQUARE_MAX         0x00FFFFFF
+
+#define BASELINE_SHIFT_DEFAULT      5       // 32 frame time constant
+#define BASELINE_NOISE_SHIFT_DEFAULT 4
+#define BASELINE_GATE_DEFAULT       32      // counts, about 7 sigma of the panel noise
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Types
+
+/* Tracking Configuration */
+typedef struct
+{
+    uint8_t     baseline_shift;             // EMA weight 2^-shift of a new frame
+    uint8_t     noise_shift;
+    int16_t     touch_gate;                 // delta at which a node counts as touched and freezes
+} BASELINE_CONFIG_OBJ;
+
+/* Delta Frame, row major with a stride of cols */
+typedef struct
+{
+    uint32_t    sequence;                   // of the raw frame
+    uint32_t    timestamp;
+    uint8_t     rows;
+    uint8_t     cols;
+    int16_t     data[BASELINE_NODES];
+} DELTA_FRAME_OBJ;
+
+/* Tracking Statistics */
+typedef struct
+{
+    uint32_t    frames;
+    uint16_t    touched;                    // nodes above the gate, last frame
+    int16_t     peak;                       // largest delta, last frame
+    uint16_t    noise;                      // RMS of all nodes, BASELINE_NOISE_FRAC / 2 fraction bits
+    uint32_t    energy;                     // sum of squared deltas, last frame, saturating
+} BASELINE_STATS_OBJ;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Baseline Functions
+
+void DRV_CAPTOUCH_I2C_BASELINE_Init(const BASELINE_CONFIG_OBJ *cfg);
+int8_t DRV_CAPTOUCH_I2C_BASELINE_Process(const RAW_FRAME_OBJ *raw, DELTA_FRAME_OBJ *delta);
+void DRV_CAPTOUCH_I2C_BASELINE_GetNoise(uint16_t *rms, uint16_t n);
+void DRV_CAPTOUCH_I2C_BASELINE_GetStats(BASELINE_STATS_OBJ *stats);
+
+#endif //DRV_CAPTOUCH_I2C_BASELINE_H
@@ -0,0 +1,164 @@
+/****************************************************************************************
+  I2C Capacitive Touch Driver: Benchmark
+
+  File Name:
+    drv_captouch_i2c_bench.c
+
+  Summary:
+    Per-stage cycle statistics of the acquisition pipeline.
+
+  Description:
+    Stage boundaries are marked in the driver with DRV_CAPTOUCH_I2C_BENCH_BEGIN/END,
+    which compile to nothing unless BENCH_EN is defined. Only the unsigned 32 bit
+    difference of the counter is used, so a wrapping counter is fine as long as a
+    single stage stays below 2^32 cycles.
+ ***************************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include <stdio.h>
+#include "drv_captouch_i2c.h"
+#include "drv_captouch_i2c_bench.h"
+#include "fsl_common.h"
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Variables
+
+static BENCH_STAT_OBJ benchStat[BENCH_STAGES];
+static uint32_t benchStart[BENCH_STAGES];
+
+static const char *const benchStageName[BENCH_STAGES] = {
+    "setup", "xfer", "decode", "transform", "delivery", "frame",
+    "clamp", "calibrate", "filter", "track", "gesture",
+    "hittest"
+};
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Benchmark Functions
+
+#if defined(__aarch64__)
+uint32_t DRV_CAPTOUCH_I2C_BENCH_Cntvct(void)
+{
+    uint64_t cnt;
+
+    __asm__ volatile("isb; mrs %0, cntvct_el0" : "=r"(cnt));
+
+    return (uint32_t)cnt;
+}
+#endif
+
+void DRV_CAPTOUCH_I2C_BENCH_Reset(void)
+{
+#if !defined(__x86_64__) && !defined(__i386__) && !defined(__aarch64__)
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+
+    for(uint8_t s = 0; s < BENCH_STAGES; s++){
+        benchStat[s].count = 0;
+        benchStat[s].total = 0;
+        benchStat[s].min = UINT32_MAX;
+        benchStat[s].max = 0;
+    }
+}
+
+void DRV_CAPTOUCH_I2C_BENCH_Begin(BENCH_STAGE stage)
+{
+    benchStart[stage] = DRV_CAPTOUCH_I2C_BENCH_CYCLES();
+}
+
+void DRV_CAPTOUCH_I2C_BENCH_End(BENCH_STAGE stage)
+{
+    uint32_t cycles = DRV_CAPTOUCH_I2C_BENCH_CYCLES() - benchStart[stage];
+    BENCH_STAT_OBJ *st = &benchStat[stage];
+
+    st->count++;
+    st->total += cycles;
+    if(cycles < st->min)
+        st->min = cycles;
+    if(cycles > st->max)
+        st->max = cycles;
+}
+
+void DRV_CAPTOUCH_I2C_BENCH_GetStat(BENCH_STAGE stage, BENCH_STAT_OBJ *stat)
+{
+    *stat = benchStat[stage];
+}
+
+const char *DRV_CAPTOUCH_I2C_BENCH_GetStageName(BENCH_STAGE stage)
+{
+    return (stage < BENCH_STAGES) ? benchStageName[stage] : "";
+}
+
+int8_t DRV_CAPTOUCH_I2C_BENCH_RunFrame(POINT_OBJ *point, uint8_t *n, BENCH_DELIVERY_CALLBACK deliver)
+{
+    int8_t error = 0;
+
+    DRV_CAPTOUCH_I2C_BENCH_Begin(BENCH_STAGE_FRAME);
+
+    error = DRV_CAPTOUCH_I2C_GetNumberOfTouch(n);
+    if(error){
+        DRV_CAPTOUCH_I2C_BENCH_End(BENCH_STAGE_FRAME);
+        return error;
+    }
+
+    if(*n > MAX_TOUCHES)
+        *n = MAX_TOUCHES;
+
+    error = DRV_CAPTOUCH_I2C_GetMultiPixelPoint(point, *n);
+    if(error){
+        DRV_CAPTOUCH_I2C_BENCH_End(BENCH_STAGE_FRAME);
+        return error;
+    }
+
+    if(deliver != NULL){
+        DRV_CAPTOUCH_I2C_BENCH_Begin(BENCH_STAGE_DELIVERY);
+        deliver(point, *n);
+        DRV_CAPTOUCH_I2C_BENCH_End(BENCH_STAGE_DELIVERY);
+    }
+
+    DRV_CAPTOUCH_I2C_BENCH_End(BENCH_STAGE_FRAME);
+
+    return error;
+}
+
+uint8_t DRV_CAPTOUCH_I2C_BENCH_Report(const char *name, const BENCH_LIMIT_OBJ *limit, BENCH_OUTPUT_CALLBACK output)
+{
+    char line[BENCH_LINE_LENGTH];
+    uint8_t regressions = 0;
+
+    for(uint8_t s = 0; s < BENCH_STAGES; s++){
+        const BENCH_STAT_OBJ *st = &benchStat[s];
+        uint32_t mean, max = 0;
+        bool pass;
+
+        if(st->count == 0)
+            continue;
+
+        mean = (uint32_t)(st->total / st->count);
+        if(limit != NULL)
+            max = limit->mean_max[s];
+        pass = (max == 0) || (mean <= max);
+        if(!pass)
+            regressions++;
+
+        snprintf(line, sizeof(line),
+                 "{\"bench\":\"%s\",\"stage\":\"%s\",\"count\":%lu,\"mean\":%lu,\"min\":%lu,\"max\":%lu,"
+                 "\"limit\":%lu,\"pass\":%s}",
+                 name, benchStageName[s], (unsigned long)st->count, (unsigned long)mean,
+                 (unsigned long)st->min, (unsigned long)st->max, (unsigned long)max, pass ? "true" : "false");
+
+        if(output != NULL)
+            output(line);
+    }
+
+    return regressions;
+}
@@ -0,0 +1,114 @@
+/****************************************************************************************
+  I2C Capacitive Touch Driver: Benchmark Header File
+
+  File Name:
+    drv_captouch_i2c_bench.h
+
+  Summary:
+    This header file provides the per-stage benchmark API of the acquisition pipeline.
+
+  Description:
+    With BENCH_EN the driver times each stage of a touch read with the cycle
+    counter of the core it runs on (DWT on the M4, TSC/CNTVCT on hosts). The
+    report is emitted as JSON lines and compared against regression limits.
+ ***************************************************************************************/
+
+
+#ifndef DRV_CAPTOUCH_I2C_BENCH_H
+#define DRV_CAPTOUCH_I2C_BENCH_H
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "drv_captouch_i2c_defines.h"
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Defines
+
+#ifndef DRV_CAPTOUCH_I2C_BENCH_CYCLES
+#if defined(__x86_64__) || defined(__i386__)
+#define DRV_CAPTOUCH_I2C_BENCH_CYCLES()     ((uint32_t)__builtin_ia32_rdtsc())
+#elif defined(__aarch64__)
+#define DRV_CAPTOUCH_I2C_BENCH_CYCLES()     DRV_CAPTOUCH_I2C_BENCH_Cntvct()
+#else
+#define DRV_CAPTOUCH_I2C_BENCH_CYCLES()     (DWT->CYCCNT)
+#endif
+#endif
+
+#ifdef BENCH_EN
+#define DRV_CAPTOUCH_I2C_BENCH_BEGIN(stage)     DRV_CAPTOUCH_I2C_BENCH_Begin(stage)
+#define DRV_CAPTOUCH_I2C_BENCH_END(stage)       DRV_CAPTOUCH_I2C_BENCH_End(stage)
+#else
+#define DRV_CAPTOUCH_I2C_BENCH_BEGIN(stage)
+#define DRV_CAPTOUCH_I2C_BENCH_END(stage)
+#endif
+
+#define BENCH_LINE_LENGTH           160
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Types
+
+/* Pipeline Stages */
+typedef enum {
+    BENCH_STAGE_SETUP   = 0x00,     // filling and starting an i2c_master_transfer_t
+    BENCH_STAGE_XFER,               // fsl_i2c byte state machine until the completion callback,
+                                    // on target this includes the time on the bus
+    BENCH_STAGE_DECODE,             // record decode in GetMultiPixelPoint
+    BENCH_STAGE_TRANSFORM,          // orientation transform
+    BENCH_STAGE_DELIVERY,           // consumer callback
+    BENCH_STAGE_FRAME,              // complete acquisition of one touch report
+    BENCH_STAGE_CLAMP,              // processing pipeline stages, drv_captouch_i2c_pipeline.hpp
+    BENCH_STAGE_CALIBRATE,
+    BENCH_STAGE_FILTER,
+    BENCH_STAGE_TRACK,
+    BENCH_STAGE_GESTURE,
+    BENCH_STAGE_HITTEST,            // region lookup of the contacts, drv_captouch_i2c_hittest.c
+    BENCH_STAGES
+} BENCH_STAGE;
+
+/* Stage Statistics, in cycles */
+typedef struct
+{
+    uint32_t    count;
+    uint64_t    total;
+    uint32_t    min;
+    uint32_t    max;
+} BENCH_STAT_OBJ;
+
+/* Regression Limits: maximum mean cycles per stage, 0 leaves the stage unchecked */
+typedef struct
+{
+    uint32_t    mean_max[BENCH_STAGES];
+} BENCH_LIMIT_OBJ;
+
+/* Receives one decoded frame */
+typedef void (*BENCH_DELIVERY_CALLBACK)(const POINT_OBJ *point, uint8_t n);
+
+/* Receives one report line, without trailing newline */
+typedef void (*BENCH_OUTPUT_CALLBACK)(const char *line);
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Benchmark Functions
+
+void DRV_CAPTOUCH_I2C_BENCH_Reset(void);
+void DRV_CAPTOUCH_I2C_BENCH_Begin(BENCH_STAGE stage);
+void DRV_CAPTOUCH_I2C_BENCH_End(BENCH_STAGE stage);
+void DRV_CAPTOUCH_I2C_BENCH_GetStat(BENCH_STAGE stage, BENCH_STAT_OBJ *stat);
+const char *DRV_CAPTOUCH_I2C_BENCH_GetStageName(BENCH_STAGE stage);
+int8_t DRV_CAPTOUCH_I2C_BENCH_RunFrame(POINT_OBJ *point, uint8_t *n, BENCH_DELIVERY_CALLBACK deliver);
+uint8_t DRV_CAPTOUCH_I2C_BENCH_Report(const char *name, const BENCH_LIMIT_OBJ *limit, BENCH_OUTPUT_CALLBACK output);
+#if defined(__aarch64__)
+uint32_t DRV_CAPTOUCH_I2C_BENCH_Cntvct(void);
+#endif
+
+#endif //DRV_CAPTOUCH_I2C_BENCH_H
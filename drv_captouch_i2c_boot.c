@@ -0,0 +1,262 @@
+/****************************************************************************************
+  I2C Capacitive Touch Driver: Boot
+
+  File Name:
+    drv_captouch_i2c_boot.c
+
+  Summary:
+    Asynchronous probe, identification and configuration of the controller.
+
+  Description:
+    Each call of DRV_CAPTOUCH_I2C_BOOT_Task either polls the transfer in flight or
+    submits the next one, it never waits for the bus. An absent or still booting
+    controller NAKs its address (kStatus_I2C_Addr_Nak), which is retried every
+    BOOT_PROBE_INTERVAL_MS until BOOT_PROBE_TIMEOUT_MS. Transports without submit
+    and poll run each transfer inside the task call instead. Completed transfers
+    are traced and written through the register shadow like driver accesses.
+ ***************************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include <string.h>
+#include "drv_captouch_i2c.h"
+#include "drv_captouch_i2c_boot.h"
+#include "drv_captouch_i2c_config.h"
+#include "drv_captouch_i2c_shadow.h"
+#include "drv_captouch_i2c_trace.h"
+#include "drv_captouch_i2c_transport.h"
+#include "drv_captouch_i2c_variant.h"
+#ifndef I2CDEV_EN
+#include "fsl_common.h"
+#endif
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Defines
+
+#define BOOT_TICKS_PER_MS           (DRV_CAPTOUCH_I2C_TIMESTAMP_HZ / 1000)
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Variables
+
+static BOOT_STATE bootState = BOOT_IDLE;
+static BOOT_INFO_OBJ bootInfo;
+static BOOT_READY_CALLBACK bootReady = NULL;
+static PROFILE_ID bootProfile = PROFILE_NORMAL;
+static uint32_t bootStart = 0;
+static uint32_t bootNextProbe = 0;
+
+static CONFIG_PLAN_OBJ bootPlan;
+static uint8_t bootBurst = 0;
+
+//! Next transfer, queued until submitted and then in flight until it completes
+static bool bootQueued = false;
+static bool bootInFlight = false;
+static bool bootRead = false;
+static uint8_t bootReg = 0;
+static uint8_t *bootData = NULL;
+static uint8_t bootLen = 0;
+static uint8_t bootBuffer[BOOT_IDENTIFY_LENGTH];
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+
+static void BOOT_Finish(BOOT_STATE state, int8_t error, uint32_t now)
+{
+    bootState = state;
+    bootInfo.ready_time = now - bootStart;
+
+    if(state == BOOT_READY){
+        // The configure bursts left the shadow equal to the profile: Apply writes
+        // nothing and records it as active
+        (void) DRV_CAPTOUCH_I2C_PROFILE_Apply(bootProfile);
+    }
+
+    if(bootReady != NULL)
+        bootReady(error, &bootInfo);
+}
+
+static void BOOT_Submit(bool read, uint8_t reg, uint8_t *data, uint8_t len)
+{
+    bootRead = read;
+    bootReg = reg;
+    bootData = data;
+    bootLen = len;
+    bootQueued = true;
+}
+
+// ERR_BUSY while the transfer is on the bus, or the bus is taken and it is submitted again on the next call
+static int8_t BOOT_Transfer(void)
+{
+    const TRANSPORT_OBJ *t = DRV_CAPTOUCH_I2C_GetTransport();
+    int8_t error = 0;
+
+    if(bootInFlight){
+        error = t->poll(t->ctx);
+    }else if(t->submit == NULL || t->poll == NULL){
+        error = bootRead ? t->read(t->ctx, bootReg, bootData, bootLen)
+                         : t->write(t->ctx, bootReg, bootData, bootLen);
+    }else{
+        error = t->submit(t->ctx, bootRead, bootReg, bootData, bootLen);
+        if(!error){
+            bootInFlight = true;
+            error = t->poll(t->ctx);
+        }
+    }
+
+    if(error == ERR_BUSY)
+        return error;
+
+    bootQueued = false;
+    bootInFlight = false;
+    if(error){
+        return error;
+    }
+
+    DRV_CAPTOUCH_I2C_TRACE(bootRead ? TRACE_DIR_READ : 0, bootReg, bootData, bootLen);
+    DRV_CAPTOUCH_I2C_SHADOW_Update(bootReg, bootData, bootLen);
+
+    return error;
+}
+
+static void BOOT_NextBurst(uint32_t now)
+{
+    CONFIG_BURST_OBJ *b;
+
+    if(bootBurst >= bootPlan.n){
+        BOOT_Finish(BOOT_READY, ERR_NONE, now);
+        return;
+    }
+
+    b = &bootPlan.burst[bootBurst++];
+    BOOT_Submit(false, b->reg, b->data, b->len);
+}
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Boot Functions
+
+int8_t DRV_CAPTOUCH_I2C_BOOT_Start(PROFILE_ID profile, BOOT_READY_CALLBACK ready, uint32_t now)
+{
+    const TRANSPORT_OBJ *t = DRV_CAPTOUCH_I2C_GetTransport();
+    int8_t error = 0;
+
+    if(profile >= PROFILES)
+        return ERR_ARGUMENT;
+
+    memset(&bootInfo, 0, sizeof(bootInfo));
+    bootProfile = profile;
+    bootReady = ready;
+    bootStart = now;
+    bootNextProbe = now;
+    bootQueued = false;
+    bootInFlight = false;
+
+    // Clocks and handle only, nothing on the bus yet
+    DRV_CAPTOUCH_I2C_SHADOW_Invalidate(SHADOW_ALL);
+    error = t->init(t->ctx);
+    if(error){
+        bootState = BOOT_FAILED;
+        return error;
+    }
+
+    bootState = BOOT_PROBE;
+
+    return error;
+}
+
+BOOT_STATE DRV_CAPTOUCH_I2C_BOOT_Task(uint32_t now)
+{
+    int8_t error = 0;
+
+    switch(bootState){
+      case BOOT_PROBE:
+        if(!bootQueued){
+            if((int32_t)(now - bootNextProbe) < 0)
+                break;
+            bootInfo.probes++;
+            BOOT_Submit(true, OP_REG_DEVICEMODE, bootBuffer, BYTE);
+        }
+
+        error = BOOT_Transfer();
+        if(error == ERR_BUSY)
+            break;
+        if(error){
+            if((now - bootStart) >= BOOT_PROBE_TIMEOUT_MS * BOOT_TICKS_PER_MS){
+                BOOT_Finish(BOOT_FAILED, error, now);
+                break;
+            }
+            bootNextProbe = now + BOOT_PROBE_INTERVAL_MS * BOOT_TICKS_PER_MS;
+            break;
+        }
+
+        // DEVICEMODE is in the shadow, so the burst below lands on the operating page
+        bootState = BOOT_IDENTIFY;
+        BOOT_Submit(true, BOOT_IDENTIFY_REG, bootBuffer, BOOT_IDENTIFY_LENGTH);
+        break;
+
+      case BOOT_IDENTIFY:
+        error = BOOT_Transfer();
+        if(error == ERR_BUSY)
+            break;
+        if(error){
+            BOOT_Finish(BOOT_FAILED, error, now);
+            break;
+        }
+
+        bootInfo.lib_version = (bootBuffer[OP_REG_LIBVERSIONH - BOOT_IDENTIFY_REG] << 8)
+                             + bootBuffer[OP_REG_LIBVERSIONL - BOOT_IDENTIFY_REG];
+        bootInfo.cipher = bootBuffer[OP_REG_CIPHER - BOOT_IDENTIFY_REG];
+        bootInfo.firmware_id = bootBuffer[OP_REG_FIRMID - BOOT_IDENTIFY_REG];
+        DRV_CAPTOUCH_I2C_VARIANT_Identify(bootInfo.cipher, bootInfo.firmware_id, bootInfo.lib_version);
+
+        // The shadow now holds both banks, only the differences are written
+        DRV_CAPTOUCH_I2C_CONFIG_PlanCoalesced(DRV_CAPTOUCH_I2C_PROFILE_Get(bootProfile), &bootPlan);
+        bootBurst = 0;
+        bootState = BOOT_CONFIGURE;
+        BOOT_NextBurst(now);
+        break;
+
+      case BOOT_CONFIGURE:
+        error = BOOT_Transfer();
+        if(error == ERR_BUSY)
+            break;
+        if(error){
+            BOOT_Finish(BOOT_FAILED, error, now);
+            break;
+        }
+
+        BOOT_NextBurst(now);
+        break;
+
+      default:
+        break;
+    }
+
+    return bootState;
+}
+
+BOOT_STATE DRV_CAPTOUCH_I2C_BOOT_GetState(void)
+{
+    return bootState;
+}
+
+const BOOT_INFO_OBJ *DRV_CAPTOUCH_I2C_BOOT_GetInfo(void)
+{
+    return &bootInfo;
+}
+
+void DRV_CAPTOUCH_I2C_BOOT_Touch(uint32_t timestamp)
+{
+    if(bootState == BOOT_READY && bootInfo.first_touch_time == 0)
+        bootInfo.first_touch_time = timestamp - bootStart;
+}
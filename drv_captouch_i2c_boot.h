@@ -0,0 +1,82 @@
+/****************************************************************************************
+  I2C Capacitive Touch Driver: Boot Header File
+
+  File Name:
+    drv_captouch_i2c_boot.h
+
+  Summary:
+    This header file provides the asynchronous bring-up of the controller.
+
+  Description:
+    DRV_CAPTOUCH_I2C_BOOT_Start begins the sequence and DRV_CAPTOUCH_I2C_BOOT_Task
+    advances it without waiting on the bus, so display and other peripheral init
+    can run in between. The controller is probed until it acknowledges its
+    address, identity and configuration are read in one burst, the selected
+    profile is written and the ready callback reports the outcome.
+ ***************************************************************************************/
+
+
+#ifndef DRV_CAPTOUCH_I2C_BOOT_H
+#define DRV_CAPTOUCH_I2C_BOOT_H
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "drv_captouch_i2c_defines.h"
+#include "drv_captouch_i2c_profile.h"
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Defines
+
+#define BOOT_PROBE_INTERVAL_MS      5       // between address probes while the controller starts
+#define BOOT_PROBE_TIMEOUT_MS       500     // power-on to first acknowledge, datasheet 200 ms plus margin
+#define BOOT_IDENTIFY_REG           OP_REG_THGROUP
+#define BOOT_IDENTIFY_LENGTH        (OP_REG_FIRMID - OP_REG_THGROUP + 1)
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Types
+
+/* Boot State */
+typedef enum {
+    BOOT_IDLE           = 0x00,
+    BOOT_PROBE,
+    BOOT_IDENTIFY,
+    BOOT_CONFIGURE,
+    BOOT_READY,
+    BOOT_FAILED
+} BOOT_STATE;
+
+/* Controller Identity and Boot Timing, times in timestamp ticks from BOOT_Start */
+typedef struct
+{
+    uint16_t    lib_version;
+    uint8_t     cipher;
+    uint8_t     firmware_id;
+    uint16_t    probes;
+    uint32_t    ready_time;
+    uint32_t    first_touch_time;   // 0 until DRV_CAPTOUCH_I2C_BOOT_Touch
+} BOOT_INFO_OBJ;
+
+/* Readiness, error is ERR_NONE once the profile has been written */
+typedef void (*BOOT_READY_CALLBACK)(int8_t error, const BOOT_INFO_OBJ *info);
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Boot Functions
+
+int8_t DRV_CAPTOUCH_I2C_BOOT_Start(PROFILE_ID profile, BOOT_READY_CALLBACK ready, uint32_t now);
+BOOT_STATE DRV_CAPTOUCH_I2C_BOOT_Task(uint32_t now);
+BOOT_STATE DRV_CAPTOUCH_I2C_BOOT_GetState(void);
+const BOOT_INFO_OBJ *DRV_CAPTOUCH_I2C_BOOT_GetInfo(void);
+void DRV_CAPTOUCH_I2C_BOOT_Touch(uint32_t timestamp);
+
+#endif //DRV_CAPTOUCH_I2C_BOOT_H
@@ -0,0 +1,195 @@
+/****************************************************************************************
+  I2C Capacitive Touch Driver: Frame Channel
+
+  File Name:
+    drv_captouch_i2c_channel.c
+
+  Summary:
+    Lock-free single producer, single consumer touch frame ring.
+
+  Description:
+    The producer publishes a frame by storing head with release ordering after
+    the slot contents, the consumer frees it by storing tail with release
+    ordering after it is done reading. Each side only writes its own header
+    cache line. A consumer woken by the doorbell has to drain until Peek
+    returns NULL, frames committed while it is still draining do not ring.
+ ***************************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include <string.h>
+#include "drv_captouch_i2c.h"
+#include "drv_captouch_i2c_channel.h"
+#ifndef I2CDEV_EN
+#include "fsl_common.h"
+#endif
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+
+_Static_assert(sizeof(CHANNEL_HEADER_OBJ) == CHANNEL_HEADER_SIZE, "channel header layout");
+_Static_assert(sizeof(CHANNEL_FRAME_OBJ) <= CHANNEL_SLOT_SIZE, "touch frame exceeds the slot size");
+
+static CHANNEL_FRAME_OBJ *CHANNEL_Slot(const CHANNEL_OBJ *ch, uint32_t index)
+{
+    return (CHANNEL_FRAME_OBJ *)&ch->slots[(index & ch->mask) * CHANNEL_SLOT_SIZE];
+}
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Channel Functions
+
+int8_t DRV_CAPTOUCH_I2C_CHANNEL_Init(CHANNEL_OBJ *ch, void *shm, uint32_t slots,
+                                     CHANNEL_DOORBELL_CALLBACK doorbell, void *ctx)
+{
+    CHANNEL_HEADER_OBJ *header = shm;
+
+    if(shm == NULL || ((uintptr_t)shm & (CHANNEL_CACHE_LINE - 1)))
+        return ERR_ARGUMENT;
+
+    // Power of two so free running indices wrap cleanly
+    if(slots < 2 || (slots & (slots - 1)))
+        return ERR_ARGUMENT;
+
+    memset(header, 0, CHANNEL_HEADER_SIZE);
+    header->version = CHANNEL_VERSION;
+    header->slots = slots;
+    header->slot_size = CHANNEL_SLOT_SIZE;
+
+    // The magic goes last, a consumer attaching early sees an invalid channel
+    __atomic_store_n(&header->magic, CHANNEL_MAGIC, __ATOMIC_RELEASE);
+    CHANNEL_CACHE_CLEAN(header, CHANNEL_HEADER_SIZE);
+
+    ch->header = header;
+    ch->slots = (uint8_t *)shm + CHANNEL_HEADER_SIZE;
+    ch->mask = slots - 1;
+    ch->head = 0;
+    ch->tail = 0;
+    ch->doorbell = doorbell;
+    ch->ctx = ctx;
+    ch->doorbells = 0;
+
+    return ERR_NONE;
+}
+
+int8_t DRV_CAPTOUCH_I2C_CHANNEL_Attach(CHANNEL_OBJ *ch, void *shm, uint32_t size)
+{
+    CHANNEL_HEADER_OBJ *header = shm;
+
+    if(shm == NULL || size < CHANNEL_HEADER_SIZE)
+        return ERR_ARGUMENT;
+
+    CHANNEL_CACHE_INVALIDATE(header, CHANNEL_HEADER_SIZE);
+    if(__atomic_load_n(&header->magic, __ATOMIC_ACQUIRE) != CHANNEL_MAGIC)
+        return ERR_NODEVICE;
+
+    if(header->version != CHANNEL_VERSION || header->slot_size != CHANNEL_SLOT_SIZE
+       || header->slots < 2 || (header->slots & (header->slots - 1))
+       || CHANNEL_SIZE(header->slots) > size)
+        return ERR_FORMAT;
+
+    memset(ch, 0, sizeof(*ch));
+    ch->header = header;
+    ch->slots = (uint8_t *)shm + CHANNEL_HEADER_SIZE;
+    ch->mask = header->slots - 1;
+    ch->tail = header->tail;
+
+    return ERR_NONE;
+}
+
+CHANNEL_FRAME_OBJ *DRV_CAPTOUCH_I2C_CHANNEL_Reserve(CHANNEL_OBJ *ch)
+{
+    uint32_t tail;
+
+    CHANNEL_CACHE_INVALIDATE(&ch->header->tail, CHANNEL_CACHE_LINE);
+    tail = __atomic_load_n(&ch->header->tail, __ATOMIC_ACQUIRE);
+
+    if(ch->head - tail > ch->mask){
+        ch->header->overflow++;
+        CHANNEL_CACHE_CLEAN(&ch->header->head, CHANNEL_CACHE_LINE);
+        return NULL;
+    }
+
+    return CHANNEL_Slot(ch, ch->head);
+}
+
+void DRV_CAPTOUCH_I2C_CHANNEL_Commit(CHANNEL_OBJ *ch)
+{
+    uint32_t head = ch->head;
+
+    CHANNEL_CACHE_CLEAN(CHANNEL_Slot(ch, head), CHANNEL_SLOT_SIZE);
+
+    ch->head = head + 1;
+    __atomic_store_n(&ch->header->head, ch->head, __ATOMIC_RELEASE);
+    CHANNEL_CACHE_CLEAN(&ch->header->head, CHANNEL_CACHE_LINE);
+
+    // Tail only reaches the old head once the consumer has drained everything
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    CHANNEL_CACHE_INVALIDATE(&ch->header->tail, CHANNEL_CACHE_LINE);
+    if(__atomic_load_n(&ch->header->tail, __ATOMIC_ACQUIRE) == head && ch->doorbell != NULL){
+        ch->doorbells++;
+        ch->doorbell(ch->ctx);
+    }
+}
+
+int8_t DRV_CAPTOUCH_I2C_CHANNEL_Publish(CHANNEL_OBJ *ch)
+{
+    CHANNEL_FRAME_OBJ *frame;
+    uint8_t n;
+    int8_t error = 0;
+
+    frame = DRV_CAPTOUCH_I2C_CHANNEL_Reserve(ch);
+    if(frame == NULL)
+        return ERR_OVERFLOW;
+
+    // Decoded in place, the slot is the only copy of the frame
+    error = DRV_CAPTOUCH_I2C_GetFrame(frame->point, &n);
+    if(error){
+        return error;
+    }
+
+    frame->sequence = ch->head;
+    frame->timestamp = DRV_CAPTOUCH_I2C_TIMESTAMP();
+    frame->n = n;
+    frame->gesture = GESTURE_NO;
+
+    DRV_CAPTOUCH_I2C_CHANNEL_Commit(ch);
+
+    return error;
+}
+
+const CHANNEL_FRAME_OBJ *DRV_CAPTOUCH_I2C_CHANNEL_Peek(CHANNEL_OBJ *ch)
+{
+    CHANNEL_FRAME_OBJ *frame;
+
+    CHANNEL_CACHE_INVALIDATE(&ch->header->head, CHANNEL_CACHE_LINE);
+    if(__atomic_load_n(&ch->header->head, __ATOMIC_ACQUIRE) == ch->tail)
+        return NULL;
+
+    frame = CHANNEL_Slot(ch, ch->tail);
+    CHANNEL_CACHE_INVALIDATE(frame, CHANNEL_SLOT_SIZE);
+
+    return frame;
+}
+
+void DRV_CAPTOUCH_I2C_CHANNEL_Release(CHANNEL_OBJ *ch)
+{
+    ch->tail++;
+    __atomic_store_n(&ch->header->tail, ch->tail, __ATOMIC_RELEASE);
+    CHANNEL_CACHE_CLEAN(&ch->header->tail, CHANNEL_CACHE_LINE);
+
+    // Pairs with the fence in Commit: the next Peek must not read head before
+    // this tail is visible, or a frame committed in between rings nobody
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+uint32_t DRV_CAPTOUCH_I2C_CHANNEL_GetOverflow(const CHANNEL_OBJ *ch)
+{
+    return ch->header->overflow;
+}
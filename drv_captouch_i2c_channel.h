@@ -0,0 +1,126 @@
+/****************************************************************************************
+  I2C Capacitive Touch Driver: Frame Channel Header File
+
+  File Name:
+    drv_captouch_i2c_channel.h
+
+  Summary:
+    This header file provides the shared memory frame channel from the M4 to the A53.
+
+  Description:
+    Single producer, single consumer ring of fixed-size touch frames placed in
+    memory both cores can see. The producer writes frames in place and the
+    consumer reads them in place, nothing is copied through a mailbox. The
+    doorbell is only raised when the ring goes from empty to non-empty.
+ ***************************************************************************************/
+
+
+#ifndef DRV_CAPTOUCH_I2C_CHANNEL_H
+#define DRV_CAPTOUCH_I2C_CHANNEL_H
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "drv_captouch_i2c_defines.h"
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Defines
+
+/*
+ * Shared memory layout:
+ *   line 0  | magic | version | slots | slot_size |       written once by the producer
+ *   line 1  | head  | overflow |                          written by the producer only
+ *   line 2  | tail  |                                     written by the consumer only
+ *   slots   | CHANNEL_FRAME_OBJ padded to CHANNEL_SLOT_SIZE | x slots
+ * head and tail are free running, slot = index & (slots - 1).
+ */
+#define CHANNEL_MAGIC               0x48435446      // 'F' 'T' 'C' 'H'
+#define CHANNEL_VERSION             1
+#define CHANNEL_CACHE_LINE          64
+#define CHANNEL_SLOT_SIZE           128
+#define CHANNEL_HEADER_SIZE         (3 * CHANNEL_CACHE_LINE)
+#define CHANNEL_SIZE(slots)         (CHANNEL_HEADER_SIZE + (uint32_t)(slots) * CHANNEL_SLOT_SIZE)
+
+// Cache maintenance of the shared region, empty where it is mapped non-cacheable
+#ifndef CHANNEL_CACHE_CLEAN
+#define CHANNEL_CACHE_CLEAN(addr, len)
+#endif
+#ifndef CHANNEL_CACHE_INVALIDATE
+#define CHANNEL_CACHE_INVALIDATE(addr, len)
+#endif
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Types
+
+/* Touch Frame, as stored in a slot */
+typedef struct
+{
+    uint32_t    sequence;           // producer frame counter
+    uint32_t    timestamp;          // DRV_CAPTOUCH_I2C_TIMESTAMP() at acquisition
+    uint8_t     n;                  // valid entries in point
+    uint8_t     gesture;
+    uint8_t     reserved[2];
+    POINT_OBJ   point[MAX_TOUCHES];
+} CHANNEL_FRAME_OBJ;
+
+/* Shared Header, one field group per cache line so the cores never write the same line */
+typedef struct
+{
+    uint32_t            magic;
+    uint32_t            version;
+    uint32_t            slots;
+    uint32_t            slot_size;
+    uint8_t             pad0[CHANNEL_CACHE_LINE - 16];
+
+    volatile uint32_t   head;
+    volatile uint32_t   overflow;       // frames dropped because the ring was full
+    uint8_t             pad1[CHANNEL_CACHE_LINE - 8];
+
+    volatile uint32_t   tail;
+    uint8_t             pad2[CHANNEL_CACHE_LINE - 4];
+} CHANNEL_HEADER_OBJ;
+
+/* Raised by the producer on the empty to non-empty transition */
+typedef void (*CHANNEL_DOORBELL_CALLBACK)(void *ctx);
+
+/* Local view of a channel, one per core */
+typedef struct
+{
+    CHANNEL_HEADER_OBJ          *header;
+    uint8_t                     *slots;
+    uint32_t                    mask;
+    uint32_t                    head;           // producer: local copy of header->head
+    uint32_t                    tail;           // consumer: local copy of header->tail
+    CHANNEL_DOORBELL_CALLBACK   doorbell;
+    void                        *ctx;
+    uint32_t                    doorbells;
+} CHANNEL_OBJ;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Channel Functions
+
+int8_t DRV_CAPTOUCH_I2C_CHANNEL_Init(CHANNEL_OBJ *ch, void *shm, uint32_t slots,
+                                     CHANNEL_DOORBELL_CALLBACK doorbell, void *ctx);
+int8_t DRV_CAPTOUCH_I2C_CHANNEL_Attach(CHANNEL_OBJ *ch, void *shm, uint32_t size);
+
+// Producer
+CHANNEL_FRAME_OBJ *DRV_CAPTOUCH_I2C_CHANNEL_Reserve(CHANNEL_OBJ *ch);
+void DRV_CAPTOUCH_I2C_CHANNEL_Commit(CHANNEL_OBJ *ch);
+int8_t DRV_CAPTOUCH_I2C_CHANNEL_Publish(CHANNEL_OBJ *ch);
+
+// Consumer
+const CHANNEL_FRAME_OBJ *DRV_CAPTOUCH_I2C_CHANNEL_Peek(CHANNEL_OBJ *ch);
+void DRV_CAPTOUCH_I2C_CHANNEL_Release(CHANNEL_OBJ *ch);
+uint32_t DRV_CAPTOUCH_I2C_CHANNEL_GetOverflow(const CHANNEL_OBJ *ch);
+
+#endif //DRV_CAPTOUCH_I2C_CHANNEL_H
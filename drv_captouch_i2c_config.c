@@ -0,0 +1,234 @@
+/****************************************************************************************
+  I2C Capacitive Touch Driver: Configuration
+
+  File Name:
+    drv_captouch_i2c_config.c
+
+  Summary:
+    Diff of a declarative configuration against the register shadow.
+
+  Description:
+    A register write costs START, address and register pointer bytes and STOP on
+    top of its data, about two and a half bytes on the bus. Dirty runs separated by
+    at most CONFIG_BRIDGE_MAX known registers are therefore merged, rewriting the
+    unchanged values in between, and runs never cross the read-only LIBVERSION and
+    CIPHER registers.
+ ***************************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include <string.h>
+#include "drv_captouch_i2c.h"
+#include "drv_captouch_i2c_config.h"
+#include "drv_captouch_i2c_shadow.h"
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+
+static uint8_t CONFIG_Reg(uint8_t slot)
+{
+    if(slot < CONFIG_BANK0_LENGTH)
+        return CONFIG_BANK0_REG + slot;
+
+    return CONFIG_BANK1_REG + slot - CONFIG_BANK0_LENGTH;
+}
+
+// Register image of the fields, in slot order
+static void CONFIG_Image(const CONFIG_OBJ *cfg, uint8_t *image)
+{
+    memset(image, 0, CONFIG_SLOTS);
+
+    image[0]  = cfg->threshold / 4;
+    image[1]  = cfg->peak;
+    image[2]  = cfg->focus;
+    image[3]  = cfg->water;
+    image[4]  = cfg->temperature;
+    image[5]  = cfg->difference;
+    image[6]  = cfg->ctrl;
+    image[7]  = cfg->timer_monitor;
+    image[8]  = cfg->period_active;
+    image[9]  = cfg->period_monitor;
+    image[10] = cfg->auto_calibration;
+    image[14] = cfg->int_mode;
+    image[15] = cfg->power_mode;
+}
+
+// Value the register will hold if it is rewritten as part of a bridge
+static bool CONFIG_Known(const CONFIG_OBJ *cfg, const uint8_t *image, uint8_t slot, uint8_t *value)
+{
+    if(!(CONFIG_WRITABLE & (1u << slot)))
+        return false;
+
+    if(cfg->set & (1u << slot)){
+        *value = image[slot];
+        return true;
+    }
+
+    return DRV_CAPTOUCH_I2C_SHADOW_Peek(CONFIG_Reg(slot), value);
+}
+
+static void CONFIG_PlanBank(const CONFIG_OBJ *cfg, const uint8_t *image, uint16_t dirty, uint8_t bridge_max,
+                            uint8_t first, uint8_t last, CONFIG_PLAN_OBJ *plan)
+{
+    uint8_t slot = first;
+
+    while(slot < last){
+        CONFIG_BURST_OBJ *b;
+        uint8_t end;
+
+        if(!(dirty & (1u << slot))){
+            slot++;
+            continue;
+        }
+
+        b = &plan->burst[plan->n++];
+        b->reg = CONFIG_Reg(slot);
+        b->len = 0;
+
+        // Extend over dirty registers and short gaps of known ones
+        end = slot;
+        while(end < last){
+            uint8_t gap = 0;
+            uint8_t next = end + 1;
+            uint8_t fill[CONFIG_BANK0_LENGTH];
+            bool bridge = true;
+
+            b->data[b->len++] = image[end];
+
+            while(next < last && !(dirty & (1u << next)) && gap < bridge_max){
+                if(!CONFIG_Known(cfg, image, next, &fill[gap])){
+                    bridge = false;
+                    break;
+                }
+                gap++;
+                next++;
+            }
+
+            if(!bridge || next >= last || !(dirty & (1u << next)))
+                break;
+
+            for(uint8_t i = 0; i < gap; i++)
+                b->data[b->len++] = fill[i];
+            end = next;
+        }
+
+        slot = end + 1;
+    }
+}
+
+
+static uint8_t CONFIG_PlanBridged(const CONFIG_OBJ *cfg, CONFIG_PLAN_OBJ *plan, uint8_t bridge_max)
+{
+    uint8_t image[CONFIG_SLOTS];
+    uint16_t dirty = 0;
+
+    plan->n = 0;
+    CONFIG_Image(cfg, image);
+
+    for(uint8_t slot = 0; slot < CONFIG_SLOTS; slot++){
+        uint8_t value;
+
+        if(!(cfg->set & CONFIG_WRITABLE & (1u << slot)))
+            continue;
+        if(DRV_CAPTOUCH_I2C_SHADOW_Peek(CONFIG_Reg(slot), &value) && value == image[slot])
+            continue;
+
+        dirty |= 1u << slot;
+    }
+
+    CONFIG_PlanBank(cfg, image, dirty, bridge_max, 0, CONFIG_BANK0_LENGTH, plan);
+    CONFIG_PlanBank(cfg, image, dirty, bridge_max, CONFIG_BANK0_LENGTH, CONFIG_SLOTS, plan);
+
+    return plan->n;
+}
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Configuration Functions
+
+void DRV_CAPTOUCH_I2C_CONFIG_SetThreshold(CONFIG_OBJ *cfg, const THRESHOLD_OBJ *th)
+{
+    cfg->threshold      = th->threshold;
+    cfg->peak           = th->peak;
+    cfg->focus          = th->focus;
+    cfg->water          = th->water;
+    cfg->temperature    = th->temperature;
+    cfg->difference     = th->difference;
+    cfg->set           |= CONFIG_THRESHOLDS;
+}
+
+uint8_t DRV_CAPTOUCH_I2C_CONFIG_Plan(const CONFIG_OBJ *cfg, CONFIG_PLAN_OBJ *plan)
+{
+    return CONFIG_PlanBridged(cfg, plan, CONFIG_BRIDGE_MAX);
+}
+
+uint8_t DRV_CAPTOUCH_I2C_CONFIG_PlanCoalesced(const CONFIG_OBJ *cfg, CONFIG_PLAN_OBJ *plan)
+{
+    // Any known gap is bridged, a fully specified bank becomes a single burst
+    return CONFIG_PlanBridged(cfg, plan, CONFIG_BANK0_LENGTH);
+}
+
+int8_t DRV_CAPTOUCH_I2C_CONFIG_Write(const CONFIG_PLAN_OBJ *plan)
+{
+    int8_t error = 0;
+
+    for(uint8_t i = 0; i < plan->n; i++){
+        const CONFIG_BURST_OBJ *b = &plan->burst[i];
+
+        error = DRV_CAPTOUCH_I2C_WriteArray(b->reg, (uint8_t *)b->data, b->len);
+        if(error){
+            return error;
+        }
+    }
+
+    return error;
+}
+
+int8_t DRV_CAPTOUCH_I2C_CONFIG_Apply(const CONFIG_OBJ *cfg)
+{
+    CONFIG_PLAN_OBJ plan;
+
+    DRV_CAPTOUCH_I2C_CONFIG_Plan(cfg, &plan);
+
+    return DRV_CAPTOUCH_I2C_CONFIG_Write(&plan);
+}
+
+int8_t DRV_CAPTOUCH_I2C_CONFIG_Read(CONFIG_OBJ *cfg)
+{
+    uint8_t bank0[CONFIG_BANK0_LENGTH];
+    uint8_t bank1[CONFIG_BANK1_LENGTH];
+    int8_t error = 0;
+
+    error = DRV_CAPTOUCH_I2C_ReadArray(CONFIG_BANK0_REG, bank0, CONFIG_BANK0_LENGTH);
+    if(error){
+        return error;
+    }
+
+    error = DRV_CAPTOUCH_I2C_ReadArray(CONFIG_BANK1_REG, bank1, CONFIG_BANK1_LENGTH);
+    if(error){
+        return error;
+    }
+
+    cfg->set                = CONFIG_WRITABLE;
+    cfg->threshold          = bank0[0] * 4;
+    cfg->peak               = bank0[1];
+    cfg->focus              = bank0[2];
+    cfg->water              = bank0[3];
+    cfg->temperature        = bank0[4];
+    cfg->difference         = bank0[5];
+    cfg->ctrl               = bank0[6];
+    cfg->timer_monitor      = bank0[7];
+    cfg->period_active      = bank0[8];
+    cfg->period_monitor     = bank0[9];
+    cfg->auto_calibration   = bank1[0];
+    cfg->int_mode           = bank1[4];
+    cfg->power_mode         = bank1[5];
+
+    return error;
+}
@@ -0,0 +1,115 @@
+/****************************************************************************************
+  I2C Capacitive Touch Driver: Configuration Header File
+
+  File Name:
+    drv_captouch_i2c_config.h
+
+  Summary:
+    This header file provides the declarative configuration of the register banks.
+
+  Description:
+    A CONFIG_OBJ describes the wanted values of the OP_REG_THGROUP..OP_REG_PERIODMONITOR
+    and OP_REG_AUTOCLBMONITOR..OP_REG_PMODE banks. Applying it compares the fields
+    against the register shadow and writes only what differs, in as few bursts as
+    the bus timing allows.
+ ***************************************************************************************/
+
+
+#ifndef DRV_CAPTOUCH_I2C_CONFIG_H
+#define DRV_CAPTOUCH_I2C_CONFIG_H
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "drv_captouch_i2c_defines.h"
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Defines
+
+#define CONFIG_BANK0_REG            OP_REG_THGROUP
+#define CONFIG_BANK0_LENGTH         10      // OP_REG_THGROUP..OP_REG_PERIODMONITOR
+#define CONFIG_BANK1_REG            OP_REG_AUTOCLBMONITOR
+#define CONFIG_BANK1_LENGTH         6       // OP_REG_AUTOCLBMONITOR..OP_REG_PMODE
+#define CONFIG_SLOTS                (CONFIG_BANK0_LENGTH + CONFIG_BANK1_LENGTH)
+#define CONFIG_BURSTS_MAX           8
+#define CONFIG_BRIDGE_MAX           2       // unchanged registers rewritten rather than opening a new burst
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Types
+
+/* Configuration Fields, bit n is slot n of the two banks */
+typedef enum {
+    CONFIG_THGROUP          = 1u << 0,
+    CONFIG_THPEAK           = 1u << 1,
+    CONFIG_THCAL            = 1u << 2,
+    CONFIG_THWATER          = 1u << 3,
+    CONFIG_THTEMP           = 1u << 4,
+    CONFIG_THTDIFF          = 1u << 5,
+    CONFIG_CTRL             = 1u << 6,
+    CONFIG_TIMMONITOR       = 1u << 7,
+    CONFIG_PERIODACTIVE     = 1u << 8,
+    CONFIG_PERIODMONITOR    = 1u << 9,
+    CONFIG_AUTOCLBMONITOR   = 1u << 10,
+    CONFIG_MODE             = 1u << 14,
+    CONFIG_PMODE            = 1u << 15
+} CONFIG_FIELD;
+
+#define CONFIG_THRESHOLDS           (CONFIG_THGROUP | CONFIG_THPEAK | CONFIG_THCAL | \
+                                     CONFIG_THWATER | CONFIG_THTEMP | CONFIG_THTDIFF)
+#define CONFIG_WRITABLE             (0x07FFu | CONFIG_MODE | CONFIG_PMODE)
+
+/* Configuration, only the fields flagged in set are applied */
+typedef struct
+{
+    uint16_t    set;                // CONFIG_FIELD bits
+    uint16_t    threshold;          // OP_REG_THGROUP, same units as THRESHOLD_OBJ
+    uint8_t     peak;               // OP_REG_THPEAK
+    uint8_t     focus;              // OP_REG_THCAL
+    uint8_t     water;              // OP_REG_THWATER
+    uint8_t     temperature;        // OP_REG_THTEMP
+    uint8_t     difference;         // OP_REG_THTDIFF
+    uint8_t     ctrl;               // OP_REG_CTRL
+    uint8_t     timer_monitor;      // OP_REG_TIMMONITOR
+    uint8_t     period_active;      // OP_REG_PERIODACTIVE
+    uint8_t     period_monitor;     // OP_REG_PERIODMONITOR
+    uint8_t     auto_calibration;   // OP_REG_AUTOCLBMONITOR
+    uint8_t     int_mode;           // OP_REG_MODE
+    uint8_t     power_mode;         // OP_REG_PMODE
+} CONFIG_OBJ;
+
+/* One multi-byte register write */
+typedef struct
+{
+    uint8_t     reg;
+    uint8_t     len;
+    uint8_t     data[CONFIG_BANK0_LENGTH];
+} CONFIG_BURST_OBJ;
+
+/* Writes that bring the controller to a configuration */
+typedef struct
+{
+    uint8_t             n;
+    CONFIG_BURST_OBJ    burst[CONFIG_BURSTS_MAX];
+} CONFIG_PLAN_OBJ;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Configuration Functions
+
+void DRV_CAPTOUCH_I2C_CONFIG_SetThreshold(CONFIG_OBJ *cfg, const THRESHOLD_OBJ *th);
+uint8_t DRV_CAPTOUCH_I2C_CONFIG_Plan(const CONFIG_OBJ *cfg, CONFIG_PLAN_OBJ *plan);
+uint8_t DRV_CAPTOUCH_I2C_CONFIG_PlanCoalesced(const CONFIG_OBJ *cfg, CONFIG_PLAN_OBJ *plan);
+int8_t DRV_CAPTOUCH_I2C_CONFIG_Write(const CONFIG_PLAN_OBJ *plan);
+int8_t DRV_CAPTOUCH_I2C_CONFIG_Apply(const CONFIG_OBJ *cfg);
+int8_t DRV_CAPTOUCH_I2C_CONFIG_Read(CONFIG_OBJ *cfg);
+
+#endif //DRV_CAPTOUCH_I2C_CONFIG_H
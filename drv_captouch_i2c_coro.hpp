@@ -0,0 +1,622 @@
+/****************************************************************************************
+  I2C Capacitive Touch Driver: C++ Coroutine Header File
+
+  File Name:
+    drv_captouch_i2c_coro.hpp
+
+  Summary:
+    C++20 awaitable frame reads and configuration writes on the submit/poll path.
+
+  Description:
+    A Scheduler owns the bus: awaiting AsyncFt5x46::read_frame() or
+    write_config(cfg) queues an Operation that lives in the awaiting coroutine
+    frame, the scheduler submits the transfers one at a time and the transport's
+    completion interrupt (i2c_master_callback on fsl_i2c) only flags the result.
+    Scheduler::run_once(), called from the main loop, then finishes the
+    operation and resumes its coroutine, so no application code runs in the
+    interrupt. Task frames come from a fixed pool of CORO_FRAMES_MAX slots of
+    CORO_FRAME_SIZE bytes; a spawn that does not fit fails instead of using the
+    heap.
+ ***************************************************************************************/
+
+
+#ifndef DRV_CAPTOUCH_I2C_CORO_HPP
+#define DRV_CAPTOUCH_I2C_CORO_HPP
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include "drv_captouch_i2c.hpp"
+
+extern "C" {
+#include "drv_captouch_i2c_config.h"
+#include "drv_captouch_i2c_shadow.h"
+#include "drv_captouch_i2c_trace.h"
+}
+
+#ifndef __cpp_impl_coroutine
+#error "drv_captouch_i2c_coro.hpp needs C++20 coroutines"
+#endif
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Defines
+
+#ifndef CORO_FRAMES_MAX
+#define CORO_FRAMES_MAX             16      // tasks alive at the same time
+#endif
+
+#ifndef CORO_FRAME_SIZE
+#define CORO_FRAME_SIZE             768     // bytes per task frame, awaiters included
+#endif
+
+
+namespace captouch {
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Frame Pool
+
+template<std::size_t Slots, std::size_t Size>
+class FramePool
+{
+public:
+    void *allocate(std::size_t size) noexcept
+    {
+        void *p = nullptr;
+
+        if(size > largest_)
+            largest_ = size;
+
+        if(size <= Size){
+            if(free_ != nullptr){
+                p = free_;
+                free_ = free_->next;
+            }else if(fresh_ < Slots){
+                p = slot_[fresh_++].bytes;
+            }
+        }
+
+        if(p == nullptr){
+            failures_++;
+            return p;
+        }
+
+        if(++used_ > peak_)
+            peak_ = used_;
+
+        return p;
+    }
+
+    void release(void *p) noexcept
+    {
+        Free *f = static_cast<Free *>(p);
+
+        f->next = free_;
+        free_ = f;
+        used_--;
+    }
+
+    std::size_t used() const { return used_; }
+    std::size_t peak() const { return peak_; }
+    std::size_t largest() const { return largest_; }
+    uint32_t failures() const { return failures_; }
+
+private:
+    struct Free
+    {
+        Free    *next;
+    };
+
+    struct alignas(std::max_align_t) Slot
+    {
+        unsigned char   bytes[Size];
+    };
+
+    static_assert(Size >= sizeof(Free), "slot too small");
+
+    Slot        slot_[Slots];
+    Free        *free_ = nullptr;
+    std::size_t fresh_ = 0;         // slots never handed out yet
+    std::size_t used_ = 0;
+    std::size_t peak_ = 0;
+    std::size_t largest_ = 0;
+    uint32_t    failures_ = 0;
+};
+
+inline FramePool<CORO_FRAMES_MAX, CORO_FRAME_SIZE> framePool;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Tasks
+
+class Scheduler;
+
+/* Detached coroutine, started by Scheduler::spawn and freed when it returns */
+class Task
+{
+public:
+    struct promise_type
+    {
+        Scheduler       *scheduler = nullptr;
+        promise_type    *next = nullptr;
+
+        ~promise_type();
+
+        Task get_return_object() noexcept
+        {
+            return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        static Task get_return_object_on_allocation_failure() noexcept
+        {
+            return Task();
+        }
+
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); }
+
+        static void *operator new(std::size_t size) noexcept
+        {
+            return framePool.allocate(size);
+        }
+
+        static void operator delete(void *p) noexcept
+        {
+            framePool.release(p);
+        }
+    };
+
+    Task() = default;
+    Task(const Task &) = delete;
+    Task &operator=(const Task &) = delete;
+
+    Task(Task &&other) noexcept : handle_(other.handle_)
+    {
+        other.handle_ = nullptr;
+    }
+
+    ~Task()
+    {
+        if(handle_)
+            handle_.destroy();
+    }
+
+    // False when the frame did not fit in the pool
+    explicit operator bool() const { return static_cast<bool>(handle_); }
+
+private:
+    friend class Scheduler;
+
+    explicit Task(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+
+    std::coroutine_handle<promise_type> release()
+    {
+        std::coroutine_handle<promise_type> handle = handle_;
+
+        handle_ = nullptr;
+
+        return handle;
+    }
+
+    std::coroutine_handle<promise_type> handle_;
+};
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Scheduler
+
+/* One bus operation of one or more transfers, embedded in the awaiter */
+struct Operation
+{
+    Operation               *next = nullptr;
+    std::coroutine_handle<> waiter;
+    bool                    (*start)(Operation *op) = nullptr;                  // false when nothing is transferred
+    bool                    (*step)(Operation *op, int8_t error) = nullptr;     // after each transfer, true when done
+
+    bool                    read = true;
+    uint8_t                 reg = 0;
+    uint8_t                 *data = nullptr;
+    uint8_t                 len = 0;
+};
+
+class Scheduler
+{
+public:
+    explicit Scheduler(const TRANSPORT_OBJ *transport = DRV_CAPTOUCH_I2C_GetTransport()) : transport_(transport)
+    {
+        if(transport_->notify != nullptr)
+            transport_->notify(transport_->ctx, done, this);
+    }
+
+    ~Scheduler()
+    {
+        if(transport_->notify != nullptr)
+            transport_->notify(transport_->ctx, nullptr, nullptr);
+    }
+
+    Scheduler(const Scheduler &) = delete;
+    Scheduler &operator=(const Scheduler &) = delete;
+
+    // Queues the task, it runs up to its first co_await on the next run_once
+    bool spawn(Task &&task)
+    {
+        std::coroutine_handle<Task::promise_type> handle = task.release();
+
+        if(!handle)
+            return false;
+
+        handle.promise().scheduler = this;
+        push(handle.promise());
+        tasks_++;
+
+        return true;
+    }
+
+    // Called by awaiters from await_suspend
+    void enqueue(Operation *op)
+    {
+        op->next = nullptr;
+        if(pending_tail_ != nullptr)
+            pending_tail_->next = op;
+        else
+            pending_ = op;
+        pending_tail_ = op;
+    }
+
+    // One scheduling step, false once every task has returned and the bus is idle
+    bool run_once()
+    {
+        if(current_ == nullptr && pending_ != nullptr){
+            current_ = pending_;
+            pending_ = pending_->next;
+            if(pending_ == nullptr)
+                pending_tail_ = nullptr;
+
+            if(current_->start(current_))
+                submit();
+            else
+                resume_current();
+        }
+
+        if(current_ != nullptr && complete()){
+            const int8_t error = status_;
+
+            transfers_++;
+            if(current_->step(current_, error))
+                resume_current();
+            else
+                submit();
+        }
+
+        if(ready_ != nullptr){
+            promise_type *p = ready_;
+
+            ready_ = p->next;
+            if(ready_ == nullptr)
+                ready_tail_ = nullptr;
+            std::coroutine_handle<promise_type>::from_promise(*p).resume();
+        }
+
+        return tasks_ > 0 || current_ != nullptr || pending_ != nullptr;
+    }
+
+    void run()
+    {
+        while(run_once()){}
+    }
+
+    uint32_t tasks() const { return tasks_; }
+    uint32_t transfers() const { return transfers_; }
+    uint32_t resumes() const { return resumes_; }
+
+private:
+    using promise_type = Task::promise_type;
+    friend struct Task::promise_type;
+
+    // Completion interrupt
+    static void done(void *arg, int8_t error)
+    {
+        Scheduler *s = static_cast<Scheduler *>(arg);
+
+        if(!s->inflight_)
+            return;
+
+        s->status_ = error;
+        s->complete_ = true;
+    }
+
+    void push(promise_type &p)
+    {
+        p.next = nullptr;
+        if(ready_tail_ != nullptr)
+            ready_tail_->next = &p;
+        else
+            ready_ = &p;
+        ready_tail_ = &p;
+    }
+
+    void submit()
+    {
+        const TRANSPORT_OBJ *t = transport_;
+        Operation *op = current_;
+        int8_t error = 0;
+
+        complete_ = false;
+        inflight_ = true;
+
+        if(t->submit == nullptr || t->poll == nullptr){
+            error = op->read ? t->read(t->ctx, op->reg, op->data, op->len)
+                             : t->write(t->ctx, op->reg, op->data, op->len);
+        }else{
+            error = t->submit(t->ctx, op->read, op->reg, op->data, op->len);
+            if(!error){
+                return;
+            }
+        }
+
+        status_ = error;
+        complete_ = true;
+    }
+
+    bool complete()
+    {
+        if(!complete_ && transport_->notify == nullptr){
+            const int8_t error = transport_->poll(transport_->ctx);
+
+            if(error != ERR_BUSY){
+                status_ = error;
+                complete_ = true;
+            }
+        }
+
+        if(!complete_)
+            return false;
+
+        inflight_ = false;
+
+        return true;
+    }
+
+    void resume_current()
+    {
+        Operation *op = current_;
+
+        current_ = nullptr;
+        resumes_++;
+        op->waiter.resume();
+    }
+
+    void finished()
+    {
+        tasks_--;
+    }
+
+    const TRANSPORT_OBJ     *transport_;
+
+    Operation               *pending_ = nullptr;
+    Operation               *pending_tail_ = nullptr;
+    Operation               *current_ = nullptr;
+    promise_type            *ready_ = nullptr;
+    promise_type            *ready_tail_ = nullptr;
+
+    volatile bool           inflight_ = false;
+    volatile bool           complete_ = false;
+    volatile int8_t         status_ = 0;
+
+    uint32_t                tasks_ = 0;
+    uint32_t                transfers_ = 0;
+    uint32_t                resumes_ = 0;
+};
+
+inline Task::promise_type::~promise_type()
+{
+    if(scheduler != nullptr)
+        scheduler->finished();
+}
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Controller
+
+template<typename Panel = DefaultPanel, Orientation Orient = DefaultOrientation, uint8_t MaxTouches = MAX_TOUCHES>
+class AsyncFt5x46
+{
+    using Sync = Ft5x46<DriverTransport, Panel, Orient, MaxTouches>;
+
+public:
+    using Frame = typename Sync::Frame;
+
+    struct FrameResult
+    {
+        int8_t      error;
+        Frame       frame;
+    };
+
+    // Same two burst plan as Ft5x46::read_frame, sized when the operation reaches the bus
+    class ReadFrame : private Operation
+    {
+    public:
+        explicit ReadFrame(AsyncFt5x46 &owner) : owner_(owner)
+        {
+            start = begin;
+            step = next;
+        }
+
+        ReadFrame(const ReadFrame &) = delete;
+        ReadFrame &operator=(const ReadFrame &) = delete;
+
+        bool await_ready() const noexcept { return false; }
+
+        void await_suspend(std::coroutine_handle<> h) noexcept
+        {
+            waiter = h;
+            owner_.scheduler_.enqueue(this);
+        }
+
+        FrameResult await_resume() const noexcept
+        {
+            return FrameResult{error_, frame_};
+        }
+
+    private:
+        static bool begin(Operation *op)
+        {
+            ReadFrame *self = static_cast<ReadFrame *>(op);
+
+            self->spec_ = self->owner_.last_;
+            op->read = true;
+            op->reg = OP_REG_TDSTATUS;
+            op->data = self->buffer_.data();
+            op->len = Sync::burst_length(self->spec_);
+
+            return true;
+        }
+
+        static bool next(Operation *op, int8_t error)
+        {
+            ReadFrame *self = static_cast<ReadFrame *>(op);
+
+            if(error){
+                self->error_ = error;
+                return true;
+            }
+
+            DRV_CAPTOUCH_I2C_TRACE(TRACE_DIR_READ, op->reg, op->data, op->len);
+            DRV_CAPTOUCH_I2C_SHADOW_Update(op->reg, op->data, op->len);
+
+            if(op->reg == OP_REG_TDSTATUS){
+                // TD_STATUS 0x0F or 0xFF: not ready, the speculation stays as it was
+                self->count_ = self->buffer_[0] & 0x0F;
+                if(self->count_ > MaxTouches){
+                    self->error_ = ERR_FORMAT;
+                    return true;
+                }
+
+                if(self->count_ > self->spec_){
+                    const uint8_t done = 1 + TOUCH_RECORD_SIZE * self->spec_;
+
+                    op->reg = OP_REG_TDSTATUS + done;
+                    op->data = &self->buffer_[done];
+                    op->len = Sync::burst_length(self->count_) - done;
+                    return false;
+                }
+            }
+
+            Sync::decode(&self->buffer_[1], self->frame_.point.data(), self->count_);
+            self->frame_.count = self->count_;
+            self->owner_.last_ = self->count_;
+
+            return true;
+        }
+
+        AsyncFt5x46                             &owner_;
+        std::array<uint8_t, Sync::buffer_size>  buffer_{};
+        Frame                                   frame_{};
+        uint8_t                                 spec_ = 0;
+        uint8_t                                 count_ = 0;
+        int8_t                                  error_ = 0;
+    };
+
+    // Bursts from DRV_CAPTOUCH_I2C_CONFIG_Plan against the shadow as it is when the operation reaches the bus
+    class WriteConfig : private Operation
+    {
+    public:
+        WriteConfig(AsyncFt5x46 &owner, const CONFIG_OBJ &cfg) : owner_(owner), cfg_(cfg)
+        {
+            start = begin;
+            step = next;
+        }
+
+        WriteConfig(const WriteConfig &) = delete;
+        WriteConfig &operator=(const WriteConfig &) = delete;
+
+        bool await_ready() const noexcept { return false; }
+
+        void await_suspend(std::coroutine_handle<> h) noexcept
+        {
+            waiter = h;
+            owner_.scheduler_.enqueue(this);
+        }
+
+        int8_t await_resume() const noexcept
+        {
+            return error_;
+        }
+
+    private:
+        void burst()
+        {
+            CONFIG_BURST_OBJ *b = &plan_.burst[burst_++];
+
+            read = false;
+            reg = b->reg;
+            data = b->data;
+            len = b->len;
+        }
+
+        static bool begin(Operation *op)
+        {
+            WriteConfig *self = static_cast<WriteConfig *>(op);
+
+            DRV_CAPTOUCH_I2C_CONFIG_Plan(&self->cfg_, &self->plan_);
+            if(self->plan_.n == 0)
+                return false;
+
+            self->burst();
+
+            return true;
+        }
+
+        static bool next(Operation *op, int8_t error)
+        {
+            WriteConfig *self = static_cast<WriteConfig *>(op);
+
+            if(error){
+                self->error_ = error;
+                return true;
+            }
+
+            DRV_CAPTOUCH_I2C_TRACE(0, op->reg, op->data, op->len);
+            DRV_CAPTOUCH_I2C_SHADOW_Update(op->reg, op->data, op->len);
+
+            if(self->burst_ >= self->plan_.n)
+                return true;
+
+            self->burst();
+
+            return false;
+        }
+
+        AsyncFt5x46         &owner_;
+        CONFIG_OBJ          cfg_;
+        CONFIG_PLAN_OBJ     plan_{};
+        uint8_t             burst_ = 0;
+        int8_t              error_ = 0;
+    };
+
+    explicit AsyncFt5x46(Scheduler &scheduler) : scheduler_(scheduler) {}
+
+    ReadFrame read_frame() { return ReadFrame(*this); }
+    WriteConfig write_config(const CONFIG_OBJ &cfg) { return WriteConfig(*this, cfg); }
+
+private:
+    Scheduler   &scheduler_;
+    uint8_t     last_ = 0;
+};
+
+} // namespace captouch
+
+#endif //DRV_CAPTOUCH_I2C_CORO_HPP
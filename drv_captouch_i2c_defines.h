@@ -27,6 +27,8 @@
 #define HALFWORD                0x02
 #define WORD                    0x04
 #define MAX_TOUCHES             10
+#define TOUCH_RECORD_SIZE       6       // XH, XL, YH, YL, WEIGHT, MISC
+#define TOUCH_RECORD_USED       4       // XH..YL, all the decoder needs
 
 /* Register Addresses in Operating Mode */
 #define OP_REG_DEVICEMODE       0x00
@@ -40,7 +42,6 @@
 #define OP_REG_TOUCHX2L         0x0A
 #define OP_REG_TOUCHY2H         0x0B // | Touch ID (4bit) | touchY2H |
 #define OP_REG_TOUCHY2L         0x0C
-#ifndef TWOTOUCH
 #define OP_REG_TOUCHX3H         0x0F // | event flag (2bit) | none (2bit) | touchX3H |
 #define OP_REG_TOUCHX3L         0x10
 #define OP_REG_TOUCHY3H         0x11 // | Touch ID (4bit) | touchY3H |
@@ -53,8 +54,26 @@
 #define OP_REG_TOUCHX5L         0x1C
 #define OP_REG_TOUCHY5H         0x1D // | Touch ID (4bit) | touchY5H |
 #define OP_REG_TOUCHY5L         0x1E
-// ... till 10
-#endif
+#define OP_REG_TOUCHX6H         0x21 // | event flag (2bit) | none (2bit) | touchX6H |
+#define OP_REG_TOUCHX6L         0x22
+#define OP_REG_TOUCHY6H         0x23 // | Touch ID (4bit) | touchY6H |
+#define OP_REG_TOUCHY6L         0x24
+#define OP_REG_TOUCHX7H         0x27 // | event flag (2bit) | none (2bit) | touchX7H |
+#define OP_REG_TOUCHX7L         0x28
+#define OP_REG_TOUCHY7H         0x29 // | Touch ID (4bit) | touchY7H |
+#define OP_REG_TOUCHY7L         0x2A
+#define OP_REG_TOUCHX8H         0x2D // | event flag (2bit) | none (2bit) | touchX8H |
+#define OP_REG_TOUCHX8L         0x2E
+#define OP_REG_TOUCHY8H         0x2F // | Touch ID (4bit) | touchY8H |
+#define OP_REG_TOUCHY8L         0x30
+#define OP_REG_TOUCHX9H         0x33 // | event flag (2bit) | none (2bit) | touchX9H |
+#define OP_REG_TOUCHX9L         0x34
+#define OP_REG_TOUCHY9H         0x35 // | Touch ID (4bit) | touchY9H |
+#define OP_REG_TOUCHY9L         0x36
+#define OP_REG_TOUCHX10H        0x39 // | event flag (2bit) | none (2bit) | touchX10H |
+#define OP_REG_TOUCHX10L        0x3A
+#define OP_REG_TOUCHY10H        0x3B // | Touch ID (4bit) | touchY10H |
+#define OP_REG_TOUCHY10L        0x3C
 #define OP_REG_THGROUP          0x80 // valid touching detect threshold
 #define OP_REG_THPEAK           0x81 // valid touching peak detect threshold
 #define OP_REG_THCAL            0x82 // the threshold when calculating the focus of touching
@@ -115,6 +134,18 @@
 // *****************************************************************************
 // Section: Types
 
+/* Driver Error Codes (fsl status codes are passed through as returned by the SDK) */
+typedef enum {
+    ERR_NONE            = 0,
+    ERR_ARGUMENT        = -1,
+    ERR_FORMAT          = -2,
+    ERR_OVERFLOW        = -3,
+    ERR_TIMEOUT         = -4,
+    ERR_BUSY            = -5,
+    ERR_NODEVICE        = -6,
+    ERR_ARBITRATION     = -7
+} ERROR_CODE;
+
 /* Modality */
 typedef enum {
     NORMAL_MODE         = 0X00,
@@ -140,6 +171,13 @@ typedef enum {
     GESTURE_ZOOM_OUT    = 0x49
 } GESTURE_ID;
 
+/* Power Consume Mode */
+typedef enum {
+    PMODE_ACTIVE        = 0x00,
+    PMODE_MONITOR       = 0x01,
+    PMODE_HIBERNATE     = 0x03      // no I2C until woken by the INT or RST pin
+} POWER_MODE;
+
 /* Running State */
 typedef enum {
     CONFIGURE           = 0x00,
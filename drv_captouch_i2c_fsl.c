@@ -0,0 +1,210 @@
+/****************************************************************************************
+  I2C Capacitive Touch Driver: fsl_i2c Transport
+
+  File Name:
+    drv_captouch_i2c_fsl.c
+
+  Summary:
+    Register transport over the MCUXpresso fsl_i2c master driver.
+
+  Description:
+    The register pointer is sent as the fsl_i2c subaddress, so a register read is
+    a single transfer with a repeated start and the data lands directly in the
+    caller's buffer. I2CDEV_EN builds leave this transport out.
+ ***************************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#ifndef I2CDEV_EN
+
+#include "drv_captouch_i2c.h"
+#include "drv_captouch_i2c_bench.h"
+#include "drv_captouch_i2c_transport.h"
+#include "fsl_i2c.h"
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Variables
+
+//! ISR
+i2c_master_handle_t g_m_handle;
+volatile bool g_MasterCompletionFlag = false;
+volatile status_t g_MasterStatus = kStatus_Success;
+
+// Written by FSL_Notify, read by the completion interrupt: volatile keeps the
+// stores in the order FSL_Notify makes them
+static volatile TRANSPORT_DONE_CALLBACK fslDone = NULL;
+static void *volatile fslDoneArg = NULL;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+
+// Status of a start, ERR_BUSY when the handle or the bus is taken and the start may be retried
+static int8_t FSL_Error(status_t status)
+{
+    switch(status){
+      case kStatus_Success:
+        return ERR_NONE;
+      case kStatus_I2C_Nak:
+      case kStatus_I2C_Addr_Nak:
+        return ERR_NODEVICE;
+      case kStatus_I2C_Busy:
+      case kStatus_I2C_ArbitrationLost:
+        return ERR_BUSY;
+      case kStatus_I2C_Timeout:
+        return ERR_TIMEOUT;
+      default:
+        return ERR_FORMAT;
+    }
+}
+
+// Status of a finished transfer, never ERR_BUSY: pollers take that for a transfer still in flight
+static int8_t FSL_Completed(status_t status)
+{
+    switch(status){
+      case kStatus_I2C_Busy:
+      case kStatus_I2C_ArbitrationLost:
+        return ERR_ARBITRATION;
+      default:
+        return FSL_Error(status);
+    }
+}
+
+void i2c_master_callback(I2C_Type *base, i2c_master_handle_t *handle, status_t status, void *userData)
+{
+    // The callback before its argument, see FSL_Notify
+    TRANSPORT_DONE_CALLBACK done = fslDone;
+
+    /* Signal completion with any status, a NAK must not leave the waiter spinning. */
+    g_MasterStatus = status;
+    g_MasterCompletionFlag = true;
+    DRV_CAPTOUCH_I2C_BENCH_END(BENCH_STAGE_XFER);
+
+    if(done != NULL)
+        done(fslDoneArg, FSL_Completed(status));
+}
+
+static int8_t FSL_Start(i2c_direction_t direction, uint8_t reg, uint8_t *data, uint8_t len)
+{
+    i2c_master_transfer_t masterXfer;
+    int8_t error = 0;
+
+    DRV_CAPTOUCH_I2C_BENCH_BEGIN(BENCH_STAGE_SETUP);
+    masterXfer.slaveAddress   = I2C_SLAVE_ADDR;
+    masterXfer.direction      = direction;
+    masterXfer.subaddress     = reg;
+    masterXfer.subaddressSize = BYTE;
+    masterXfer.data           = data;
+    masterXfer.dataSize       = len;
+    masterXfer.flags          = kI2C_TransferDefaultFlag;
+
+    g_MasterCompletionFlag = false;
+    DRV_CAPTOUCH_I2C_BENCH_END(BENCH_STAGE_SETUP);
+    DRV_CAPTOUCH_I2C_BENCH_BEGIN(BENCH_STAGE_XFER);
+
+    // The stage ends in the callback, which does not come for a transfer that never started
+    error = FSL_Error(I2C_MasterTransferNonBlocking(I2C_BASEADDR, &g_m_handle, &masterXfer));
+    if(error){
+        DRV_CAPTOUCH_I2C_BENCH_END(BENCH_STAGE_XFER);
+    }
+
+    return error;
+}
+
+static int8_t FSL_Transfer(i2c_direction_t direction, uint8_t reg, uint8_t *data, uint8_t len)
+{
+    int8_t error = 0;
+
+    error = FSL_Start(direction, reg, data, len);
+    if(error){
+        return error;
+    }
+
+    /*  Wait for transfer completed. */
+    while (!g_MasterCompletionFlag){}
+    g_MasterCompletionFlag = false;
+
+    return FSL_Completed(g_MasterStatus);
+}
+
+static int8_t FSL_Init(void *ctx)
+{
+    i2c_master_config_t masterConfig;
+
+    CLOCK_SetRootMux(kCLOCK_RootI2c3, kCLOCK_I2cRootmuxSysPll1Div5); /* Set I2C source to SysPLL1 Div5 160MHZ */
+    CLOCK_SetRootDivider(kCLOCK_RootI2c3, 1U, 10U);                  /* Set root clock to 160MHZ / 10 = 16MHZ */
+
+    I2C_MasterGetDefaultConfig(&masterConfig);
+    
+    /*
+     * masterConfig->baudRate_Bps = I2C_BAUDRATE;
+     * masterConfig->enableHighDrive = false;
+     * masterConfig->enableStopHold = false;
+     * masterConfig->glitchFilterWidth = 0U;
+     * masterConfig->enableMaster = true;
+     */
+    masterConfig.baudRate_Bps = I2C_BAUDRATE;
+
+    I2C_MasterInit(I2C_BASEADDR, &masterConfig, I2C_CLK_FREQ);
+
+    memset(&g_m_handle, 0, sizeof(g_m_handle));
+
+    I2C_MasterTransferCreateHandle(I2C_BASEADDR, &g_m_handle, i2c_master_callback, NULL);
+
+    return ERR_NONE;
+}
+
+static int8_t FSL_Read(void *ctx, uint8_t reg, uint8_t *rxd, uint8_t len)
+{
+    return FSL_Transfer(kI2C_Read, reg, rxd, len);
+}
+
+static int8_t FSL_Write(void *ctx, uint8_t reg, const uint8_t *txd, uint8_t len)
+{
+    // fsl_i2c only reads from data in the write direction
+    return FSL_Transfer(kI2C_Write, reg, (uint8_t *)txd, len);
+}
+
+static int8_t FSL_Submit(void *ctx, bool read, uint8_t reg, uint8_t *data, uint8_t len)
+{
+    return FSL_Start(read ? kI2C_Read : kI2C_Write, reg, data, len);
+}
+
+static int8_t FSL_Poll(void *ctx)
+{
+    if(!g_MasterCompletionFlag)
+        return ERR_BUSY;
+
+    return FSL_Completed(g_MasterStatus);
+}
+
+static void FSL_Notify(void *ctx, TRANSPORT_DONE_CALLBACK done, void *arg)
+{
+    // Detach first, the interrupt must never see a new callback with the old argument
+    fslDone = NULL;
+    fslDoneArg = arg;
+    fslDone = done;
+}
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Transport
+
+const TRANSPORT_OBJ DRV_CAPTOUCH_I2C_FSL_Transport = {
+    .init   = FSL_Init,
+    .read   = FSL_Read,
+    .write  = FSL_Write,
+    .submit = FSL_Submit,
+    .poll   = FSL_Poll,
+    .notify = FSL_Notify,
+    .ctx    = NULL
+};
+
+#endif //I2CDEV_EN
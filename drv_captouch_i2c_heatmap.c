@@ -0,0 +1,295 @@
+/****************************************************************************************
+  I2C Capacitive Touch Driver: Heatmap Export
+
+  File Name:
+    drv_captouch_i2c_heatmap.c
+
+  Summary:
+    Encoder and decoder of the compressed raw and delta frame stream.
+
+  Description:
+    A node whose residual is within the dead zone costs nothing beyond its share
+    of a run token, a noisy node one byte and a node under a finger typically
+    two. The encoder updates its reference with exactly the values the decoder
+    will rebuild, so lossy dead zones do not accumulate error over frames.
+    Until the decoder has seen a keyframe, Decode skips residual frames by their
+    body length and returns ERR_BUSY with *used set. On ERR_FORMAT nothing is
+    consumed; the stream position is lost and the caller continues at the
+    offset DRV_CAPTOUCH_I2C_HEATMAP_Resync returns.
+ ***************************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include <string.h>
+#include "drv_captouch_i2c.h"
+#include "drv_captouch_i2c_heatmap.h"
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+
+static uint32_t HEATMAP_ZigZag(int32_t v)
+{
+    return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+static int32_t HEATMAP_UnZigZag(uint32_t v)
+{
+    return (int32_t)(v >> 1) ^ -(int32_t)(v & 1);
+}
+
+static uint8_t *HEATMAP_PutVarint(uint8_t *dst, uint32_t v)
+{
+    while(v >= 0x80){
+        *dst++ = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    *dst++ = (uint8_t)v;
+
+    return dst;
+}
+
+static bool HEATMAP_GetVarint(const uint8_t **src, const uint8_t *end, uint32_t *v)
+{
+    uint32_t value = 0;
+
+    for(uint8_t shift = 0; shift < 35; shift += 7){
+        uint8_t b;
+
+        if(*src >= end)
+            return false;
+
+        b = *(*src)++;
+        value |= (uint32_t)(b & 0x7F) << shift;
+        if(!(b & 0x80)){
+            *v = value;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Node value of either kind as a signed number
+static int32_t HEATMAP_Value(HEATMAP_KIND kind, uint16_t v)
+{
+    return (kind == HEATMAP_DELTA) ? (int32_t)(int16_t)v : (int32_t)v;
+}
+
+static uint8_t *HEATMAP_PutRun(uint8_t *dst, uint16_t run)
+{
+    return HEATMAP_PutVarint(dst, ((uint32_t)(run - 1) << 1) | 1);
+}
+
+static int8_t HEATMAP_Encode(HEATMAP_OBJ *h, uint32_t sequence, uint32_t timestamp, uint8_t rows, uint8_t cols,
+                             const uint16_t *data, uint8_t *buf, uint16_t size, uint16_t *len)
+{
+    uint16_t n = rows * cols;
+    int32_t dz = h->dead_zone;
+    uint8_t *dst = buf;
+    uint8_t *length;
+    uint16_t run = 0;
+    bool key;
+
+    if(n == 0 || rows > RAW_MAX_ROWS || cols > RAW_MAX_COLS)
+        return ERR_ARGUMENT;
+
+    // Worst case, checked once instead of per byte
+    if(size < HEATMAP_MAX_FRAME_SIZE(n))
+        return ERR_OVERFLOW;
+
+    key = h->force_key || rows != h->rows || cols != h->cols
+       || (h->keyframe_interval && h->since_key >= h->keyframe_interval);
+    if(key){
+        memset(h->ref, 0, sizeof(h->ref));
+        h->force_key = false;
+        h->since_key = 0;
+        h->rows = rows;
+        h->cols = cols;
+    }
+
+    *dst++ = HEATMAP_SYNC;
+    *dst++ = (HEATMAP_VERSION << 5) | (key ? HEATMAP_HEADER_KEY : 0) | (h->kind & HEATMAP_HEADER_KIND);
+    dst = HEATMAP_PutVarint(dst, key ? sequence : sequence - h->sequence);
+    dst = HEATMAP_PutVarint(dst, key ? timestamp : timestamp - h->timestamp);
+    *dst++ = rows;
+    *dst++ = cols;
+    length = dst;
+    dst += 2;
+    h->sequence = sequence;
+    h->timestamp = timestamp;
+
+    for(uint16_t i = 0; i < n; i++){
+        int32_t res = HEATMAP_Value(h->kind, data[i]) - HEATMAP_Value(h->kind, h->ref[i]);
+
+        if(res <= dz && res >= -dz){
+            run++;
+            continue;
+        }
+
+        if(run){
+            dst = HEATMAP_PutRun(dst, run);
+            run = 0;
+        }
+        dst = HEATMAP_PutVarint(dst, HEATMAP_ZigZag(res) << 1);
+        h->ref[i] = data[i];
+    }
+
+    if(run)
+        dst = HEATMAP_PutRun(dst, run);
+
+    // At most 3 bytes per node, within 16 bits for any panel size
+    length[0] = (uint8_t)(dst - length - 2);
+    length[1] = (uint8_t)((dst - length - 2) >> 8);
+
+    h->since_key++;
+    *len = (uint16_t)(dst - buf);
+
+    return ERR_NONE;
+}
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Heatmap Functions
+
+void DRV_CAPTOUCH_I2C_HEATMAP_Init(HEATMAP_OBJ *h, HEATMAP_KIND kind, uint16_t keyframe_interval, uint16_t dead_zone)
+{
+    memset(h, 0, sizeof(*h));
+    h->kind = kind;
+    h->force_key = true;
+    h->keyframe_interval = keyframe_interval;
+    h->dead_zone = dead_zone;
+}
+
+void DRV_CAPTOUCH_I2C_HEATMAP_ForceKeyframe(HEATMAP_OBJ *h)
+{
+    h->force_key = true;
+}
+
+int8_t DRV_CAPTOUCH_I2C_HEATMAP_EncodeRaw(HEATMAP_OBJ *h, const RAW_FRAME_OBJ *frame,
+                                          uint8_t *buf, uint16_t size, uint16_t *len)
+{
+    if(h->kind != HEATMAP_RAW)
+        return ERR_ARGUMENT;
+
+    return HEATMAP_Encode(h, frame->sequence, frame->timestamp, frame->rows, frame->cols,
+                          frame->data, buf, size, len);
+}
+
+int8_t DRV_CAPTOUCH_I2C_HEATMAP_EncodeDelta(HEATMAP_OBJ *h, const DELTA_FRAME_OBJ *frame,
+                                            uint8_t *buf, uint16_t size, uint16_t *len)
+{
+    if(h->kind != HEATMAP_DELTA)
+        return ERR_ARGUMENT;
+
+    return HEATMAP_Encode(h, frame->sequence, frame->timestamp, frame->rows, frame->cols,
+                          (const uint16_t *)frame->data, buf, size, len);
+}
+
+int8_t DRV_CAPTOUCH_I2C_HEATMAP_Peek(const uint8_t *buf, uint16_t len, HEATMAP_KIND *kind)
+{
+    if(len < 2 || buf[0] != HEATMAP_SYNC || (buf[1] >> 5) != HEATMAP_VERSION)
+        return ERR_FORMAT;
+
+    *kind = (HEATMAP_KIND)(buf[1] & HEATMAP_HEADER_KIND);
+
+    return ERR_NONE;
+}
+
+int8_t DRV_CAPTOUCH_I2C_HEATMAP_Decode(HEATMAP_OBJ *h, const uint8_t *buf, uint16_t len,
+                                       HEATMAP_FRAME_OBJ *frame, uint16_t *used)
+{
+    const uint8_t *src = buf;
+    const uint8_t *end = buf + len;
+    HEATMAP_KIND kind;
+    uint32_t sequence, timestamp, v;
+    uint8_t header, rows, cols;
+    uint16_t n, length, i = 0;
+
+    *used = 0;
+
+    if(DRV_CAPTOUCH_I2C_HEATMAP_Peek(buf, len, &kind) || kind != h->kind)
+        return ERR_FORMAT;
+
+    src += 2;
+    header = buf[1];
+    if(!HEATMAP_GetVarint(&src, end, &sequence) || !HEATMAP_GetVarint(&src, end, &timestamp) || end - src < 4)
+        goto corrupt;
+    rows = *src++;
+    cols = *src++;
+    length = src[0] | ((uint16_t)src[1] << 8);
+    src += 2;
+    n = rows * cols;
+    if(n == 0 || rows > RAW_MAX_ROWS || cols > RAW_MAX_COLS || length > end - src)
+        goto corrupt;
+    end = src + length;
+
+    if(!(header & HEATMAP_HEADER_KEY) && !h->valid){
+        // Residuals without a reference, wait for the next keyframe
+        *used = (uint16_t)(end - buf);
+        return ERR_BUSY;
+    }
+
+    if(header & HEATMAP_HEADER_KEY){
+        memset(h->ref, 0, sizeof(h->ref));
+        h->valid = true;
+        h->sequence = sequence;
+        h->timestamp = timestamp;
+        h->rows = rows;
+        h->cols = cols;
+    }else{
+        if(rows != h->rows || cols != h->cols)
+            goto corrupt;
+        h->sequence += sequence;
+        h->timestamp += timestamp;
+    }
+
+    while(i < n){
+        if(!HEATMAP_GetVarint(&src, end, &v))
+            goto corrupt;
+
+        if(v & 1){
+            if((v >> 1) >= (uint32_t)(n - i))
+                goto corrupt;
+            i += (v >> 1) + 1;
+            continue;
+        }
+
+        h->ref[i] = (uint16_t)(HEATMAP_Value(kind, h->ref[i]) + HEATMAP_UnZigZag(v >> 1));
+        i++;
+    }
+
+    if(src != end)
+        goto corrupt;
+
+    frame->kind = kind;
+    frame->sequence = h->sequence;
+    frame->timestamp = h->timestamp;
+    frame->rows = rows;
+    frame->cols = cols;
+    memcpy(frame->data, h->ref, n * sizeof(h->ref[0]));
+    *used = (uint16_t)(src - buf);
+
+    return ERR_NONE;
+
+corrupt:
+    // The reference may be half updated, resynchronize on the next keyframe
+    h->valid = false;
+
+    return ERR_FORMAT;
+}
+
+// Offset of the next keyframe header after the start of buf, len if there is none
+uint16_t DRV_CAPTOUCH_I2C_HEATMAP_Resync(const uint8_t *buf, uint16_t len)
+{
+    for(uint16_t i = 1; i + 1 < len; i++)
+        if(buf[i] == HEATMAP_SYNC && (buf[i + 1] >> 5) == HEATMAP_VERSION && (buf[i + 1] & HEATMAP_HEADER_KEY))
+            return i;
+
+    return len;
+}
@@ -0,0 +1,116 @@
+/****************************************************************************************
+  I2C Capacitive Touch Driver: Heatmap Export Header File
+
+  File Name:
+    drv_captouch_i2c_heatmap.h
+
+  Summary:
+    This header file provides the compressed streaming of raw and delta frames.
+
+  Description:
+    Raw frames of drv_captouch_i2c_raw.c and delta frames of
+    drv_captouch_i2c_baseline.c are encoded as residuals against the previous
+    frame of the same stream, with runs of zero residuals collapsed into one
+    token. Encoder and decoder keep the same reference frame, a keyframe resets
+    it so a receiver can join a stream at any keyframe. The body length in the
+    header lets a decoder without a reference skip residual frames, and after a
+    corrupt frame DRV_CAPTOUCH_I2C_HEATMAP_Resync finds the next keyframe.
+ ***************************************************************************************/
+
+
+#ifndef DRV_CAPTOUCH_I2C_HEATMAP_H
+#define DRV_CAPTOUCH_I2C_HEATMAP_H
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "drv_captouch_i2c_defines.h"
+#include "drv_captouch_i2c_baseline.h"
+#include "drv_captouch_i2c_raw.h"
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Defines
+
+/*
+ * Frame layout:
+ *   header   | sync 0xA5 | version:3 key:1 reserved:3 kind:1 |
+ *            | varint sequence | varint timestamp | rows (1) | cols (1) |
+ *            | body length (2, little endian) |
+ *   body     | varint token, until rows x cols nodes are covered |
+ * Sequence and timestamp are absolute on keyframes, else deltas to the previous
+ * frame. A token with bit 0 set skips (token >> 1) + 1 nodes whose residual is
+ * zero, otherwise token >> 1 is the zigzag coded residual of one node. The
+ * residual is taken against the previous frame as the decoder rebuilt it, 0 on
+ * keyframes. With a dead zone, residuals within +-dead_zone are sent as zero;
+ * the rebuilt frame never drifts more than dead_zone from the source.
+ */
+#define HEATMAP_SYNC                0xA5
+#define HEATMAP_VERSION             2
+#define HEATMAP_HEADER_KEY          0x10
+#define HEATMAP_HEADER_KIND         0x01
+#define HEATMAP_NODES               (RAW_MAX_ROWS * RAW_MAX_COLS)
+#define HEATMAP_MAX_HEADER_SIZE     (2 + 5 + 5 + 2 + 2)
+#define HEATMAP_MAX_FRAME_SIZE(nodes)   (HEATMAP_MAX_HEADER_SIZE + 3 * (nodes))
+#define HEATMAP_KEYFRAME_INTERVAL   32      // frames between keyframes, 0 only the first
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Types
+
+/* Frame Content */
+typedef enum {
+    HEATMAP_RAW         = 0x00,     // uint16 counts
+    HEATMAP_DELTA       = 0x01      // int16 baseline minus raw
+} HEATMAP_KIND;
+
+/* Decoded Frame, values are int16 for HEATMAP_DELTA */
+typedef struct
+{
+    HEATMAP_KIND    kind;
+    uint32_t        sequence;
+    uint32_t        timestamp;
+    uint8_t         rows;
+    uint8_t         cols;
+    uint16_t        data[HEATMAP_NODES];
+} HEATMAP_FRAME_OBJ;
+
+/* Encoder or Decoder State of one stream */
+typedef struct
+{
+    HEATMAP_KIND    kind;
+    bool            valid;              // decoder: a keyframe was seen
+    bool            force_key;          // encoder: next frame is a keyframe
+    uint16_t        keyframe_interval;
+    uint16_t        since_key;
+    uint16_t        dead_zone;          // encoder only, 0 is lossless
+    uint32_t        sequence;
+    uint32_t        timestamp;
+    uint8_t         rows;
+    uint8_t         cols;
+    uint16_t        ref[HEATMAP_NODES];
+} HEATMAP_OBJ;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Heatmap Functions
+
+void DRV_CAPTOUCH_I2C_HEATMAP_Init(HEATMAP_OBJ *h, HEATMAP_KIND kind, uint16_t keyframe_interval, uint16_t dead_zone);
+void DRV_CAPTOUCH_I2C_HEATMAP_ForceKeyframe(HEATMAP_OBJ *h);
+int8_t DRV_CAPTOUCH_I2C_HEATMAP_EncodeRaw(HEATMAP_OBJ *h, const RAW_FRAME_OBJ *frame,
+                                          uint8_t *buf, uint16_t size, uint16_t *len);
+int8_t DRV_CAPTOUCH_I2C_HEATMAP_EncodeDelta(HEATMAP_OBJ *h, const DELTA_FRAME_OBJ *frame,
+                                            uint8_t *buf, uint16_t size, uint16_t *len);
+int8_t DRV_CAPTOUCH_I2C_HEATMAP_Peek(const uint8_t *buf, uint16_t len, HEATMAP_KIND *kind);
+int8_t DRV_CAPTOUCH_I2C_HEATMAP_Decode(HEATMAP_OBJ *h, const uint8_t *buf, uint16_t len,
+                                       HEATMAP_FRAME_OBJ *frame, uint16_t *used);
+uint16_t DRV_CAPTOUCH_I2C_HEATMAP_Resync(const uint8_t *buf, uint16_t len);
+
+#endif //DRV_CAPTOUCH_I2C_HEATMAP_H
@@ -0,0 +1,339 @@
+/****************************************************************************************
+  I2C Capacitive Touch Driver: Hit-Test Index
+
+  File Name:
+    drv_captouch_i2c_hittest.c
+
+  Summary:
+    Uniform grid of UI regions, resolves contacts to region IDs.
+
+  Description:
+    Every cell keeps a singly linked list of the regions overlapping it, taken
+    from a fixed node pool and ordered by z, a newer region before an older one
+    of the same z. A lookup walks the list of one cell and returns the first
+    region containing the point, which is the topmost one. Insert, Move and
+    Remove only relink the cells the rectangle covers, the rest of the grid is
+    left alone. Nothing is allocated, a full pool fails the call and leaves the
+    index as it was.
+ ***************************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include "drv_captouch_i2c.h"
+#include "drv_captouch_i2c_hittest.h"
+#include "drv_captouch_i2c_bench.h"
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Types
+
+/* Registered Region, bounds are exclusive and clipped to the grid */
+typedef struct
+{
+    uint16_t    x0;
+    uint16_t    y0;
+    uint16_t    x1;
+    uint16_t    y1;
+    uint16_t    id;
+    uint16_t    next;               // free list link
+    uint8_t     z;
+    bool        used;
+} HITTEST_REGION_OBJ;
+
+/* Cell Entry */
+typedef struct
+{
+    uint16_t    next;
+    uint16_t    region;
+} HITTEST_NODE_OBJ;
+
+/* Covered Cells */
+typedef struct
+{
+    uint8_t     c0;
+    uint8_t     c1;
+    uint8_t     r0;
+    uint8_t     r1;
+} HITTEST_SPAN_OBJ;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Variables
+
+_Static_assert(HITTEST_COLS <= 256 && HITTEST_ROWS <= 256, "grid too fine for HITTEST_SPAN_OBJ");
+_Static_assert(HITTEST_REGIONS_MAX < HITTEST_NONE && HITTEST_NODES_MAX < HITTEST_NONE, "pool too large for 16 bit links");
+
+static HITTEST_REGION_OBJ hittestRegion[HITTEST_REGIONS_MAX];
+static HITTEST_NODE_OBJ hittestNode[HITTEST_NODES_MAX];
+static uint16_t hittestCell[HITTEST_ROWS * HITTEST_COLS];
+static uint16_t hittestFreeRegion, hittestFreeNode;
+static uint16_t hittestRegions, hittestNodes;
+static uint32_t hittestLookups, hittestProbes;
+static bool hittestInitialized = false;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+
+static int8_t HITTEST_Clip(const HITTEST_RECT_OBJ *rect, HITTEST_REGION_OBJ *r)
+{
+    uint32_t x1, y1;
+
+    if(rect == NULL || rect->w == 0 || rect->h == 0)
+        return ERR_ARGUMENT;
+    if(rect->x > HITTEST_WIDTH || rect->y > HITTEST_HEIGHT)
+        return ERR_ARGUMENT;
+
+    x1 = (uint32_t)rect->x + rect->w;
+    y1 = (uint32_t)rect->y + rect->h;
+
+    r->x0 = rect->x;
+    r->y0 = rect->y;
+    r->x1 = (x1 > HITTEST_WIDTH + 1) ? HITTEST_WIDTH + 1 : (uint16_t)x1;
+    r->y1 = (y1 > HITTEST_HEIGHT + 1) ? HITTEST_HEIGHT + 1 : (uint16_t)y1;
+
+    return ERR_NONE;
+}
+
+static uint16_t HITTEST_Span(const HITTEST_REGION_OBJ *r, HITTEST_SPAN_OBJ *span)
+{
+    span->c0 = r->x0 >> HITTEST_CELL_SHIFT;
+    span->c1 = (r->x1 - 1) >> HITTEST_CELL_SHIFT;
+    span->r0 = r->y0 >> HITTEST_CELL_SHIFT;
+    span->r1 = (r->y1 - 1) >> HITTEST_CELL_SHIFT;
+
+    return (uint16_t)((span->c1 - span->c0 + 1) * (span->r1 - span->r0 + 1));
+}
+
+// Before the first entry of lower z, or of the same z: the newest region is on top
+static void HITTEST_Link(uint16_t handle)
+{
+    const HITTEST_REGION_OBJ *r = &hittestRegion[handle];
+    HITTEST_SPAN_OBJ span;
+    uint16_t *link, node;
+
+    HITTEST_Span(r, &span);
+
+    for(uint16_t row = span.r0; row <= span.r1; row++){
+        for(uint16_t col = span.c0; col <= span.c1; col++){
+            link = &hittestCell[row * HITTEST_COLS + col];
+            while(*link != HITTEST_NONE && hittestRegion[hittestNode[*link].region].z > r->z)
+                link = &hittestNode[*link].next;
+
+            node = hittestFreeNode;
+            hittestFreeNode = hittestNode[node].next;
+            hittestNode[node].region = handle;
+            hittestNode[node].next = *link;
+            *link = node;
+            hittestNodes++;
+        }
+    }
+}
+
+static void HITTEST_Unlink(uint16_t handle)
+{
+    HITTEST_SPAN_OBJ span;
+    uint16_t *link, node;
+
+    HITTEST_Span(&hittestRegion[handle], &span);
+
+    for(uint16_t row = span.r0; row <= span.r1; row++){
+        for(uint16_t col = span.c0; col <= span.c1; col++){
+            link = &hittestCell[row * HITTEST_COLS + col];
+            while(*link != HITTEST_NONE && hittestNode[*link].region != handle)
+                link = &hittestNode[*link].next;
+            if(*link == HITTEST_NONE)
+                continue;
+
+            node = *link;
+            *link = hittestNode[node].next;
+            hittestNode[node].next = hittestFreeNode;
+            hittestFreeNode = node;
+            hittestNodes--;
+        }
+    }
+}
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Hit-Test Functions
+
+void DRV_CAPTOUCH_I2C_HITTEST_Init(void)
+{
+    for(uint16_t i = 0; i < HITTEST_ROWS * HITTEST_COLS; i++)
+        hittestCell[i] = HITTEST_NONE;
+
+    for(uint16_t i = 0; i < HITTEST_REGIONS_MAX; i++){
+        hittestRegion[i].used = false;
+        hittestRegion[i].next = (i + 1 < HITTEST_REGIONS_MAX) ? i + 1 : HITTEST_NONE;
+    }
+
+    for(uint16_t i = 0; i < HITTEST_NODES_MAX; i++)
+        hittestNode[i].next = (i + 1 < HITTEST_NODES_MAX) ? i + 1 : HITTEST_NONE;
+
+    hittestFreeRegion = 0;
+    hittestFreeNode = 0;
+    hittestRegions = 0;
+    hittestNodes = 0;
+    hittestLookups = 0;
+    hittestProbes = 0;
+    hittestInitialized = true;
+}
+
+int8_t DRV_CAPTOUCH_I2C_HITTEST_Insert(const HITTEST_RECT_OBJ *rect, uint8_t z, uint16_t id, uint16_t *handle)
+{
+    HITTEST_REGION_OBJ clipped;
+    HITTEST_SPAN_OBJ span;
+    uint16_t h;
+    int8_t error = 0;
+
+    if(!hittestInitialized)
+        DRV_CAPTOUCH_I2C_HITTEST_Init();
+
+    if(handle == NULL || id == HITTEST_NONE)
+        return ERR_ARGUMENT;
+
+    error = HITTEST_Clip(rect, &clipped);
+    if(error){
+        return error;
+    }
+
+    if(hittestFreeRegion == HITTEST_NONE || HITTEST_Span(&clipped, &span) > HITTEST_NODES_MAX - hittestNodes)
+        return ERR_OVERFLOW;
+
+    h = hittestFreeRegion;
+    hittestFreeRegion = hittestRegion[h].next;
+
+    clipped.id = id;
+    clipped.z = z;
+    clipped.used = true;
+    clipped.next = HITTEST_NONE;
+    hittestRegion[h] = clipped;
+    hittestRegions++;
+
+    HITTEST_Link(h);
+    *handle = h;
+
+    return error;
+}
+
+int8_t DRV_CAPTOUCH_I2C_HITTEST_Remove(uint16_t handle)
+{
+    if(handle >= HITTEST_REGIONS_MAX || !hittestRegion[handle].used)
+        return ERR_ARGUMENT;
+
+    HITTEST_Unlink(handle);
+
+    hittestRegion[handle].used = false;
+    hittestRegion[handle].next = hittestFreeRegion;
+    hittestFreeRegion = handle;
+    hittestRegions--;
+
+    return ERR_NONE;
+}
+
+// The moved region ends up on top of the others of its z, as if inserted again
+int8_t DRV_CAPTOUCH_I2C_HITTEST_Move(uint16_t handle, const HITTEST_RECT_OBJ *rect)
+{
+    HITTEST_REGION_OBJ *r;
+    HITTEST_REGION_OBJ clipped;
+    HITTEST_SPAN_OBJ span;
+    uint16_t released;
+    int8_t error = 0;
+
+    if(handle >= HITTEST_REGIONS_MAX || !hittestRegion[handle].used)
+        return ERR_ARGUMENT;
+
+    error = HITTEST_Clip(rect, &clipped);
+    if(error){
+        return error;
+    }
+
+    r = &hittestRegion[handle];
+    released = HITTEST_Span(r, &span);
+    if(HITTEST_Span(&clipped, &span) > HITTEST_NODES_MAX - hittestNodes + released)
+        return ERR_OVERFLOW;
+
+    HITTEST_Unlink(handle);
+    r->x0 = clipped.x0;
+    r->y0 = clipped.y0;
+    r->x1 = clipped.x1;
+    r->y1 = clipped.y1;
+    HITTEST_Link(handle);
+
+    return error;
+}
+
+uint16_t DRV_CAPTOUCH_I2C_HITTEST_Lookup(uint16_t x, uint16_t y)
+{
+    const HITTEST_REGION_OBJ *r;
+    uint16_t node;
+
+    if(!hittestInitialized || x > HITTEST_WIDTH || y > HITTEST_HEIGHT)
+        return HITTEST_NONE;
+
+    hittestLookups++;
+
+    node = hittestCell[(y >> HITTEST_CELL_SHIFT) * HITTEST_COLS + (x >> HITTEST_CELL_SHIFT)];
+    for(; node != HITTEST_NONE; node = hittestNode[node].next){
+        hittestProbes++;
+        r = &hittestRegion[hittestNode[node].region];
+        if(x >= r->x0 && x < r->x1 && y >= r->y0 && y < r->y1)
+            return r->id;
+    }
+
+    return HITTEST_NONE;
+}
+
+void DRV_CAPTOUCH_I2C_HITTEST_Tag(const POINT_OBJ *point, uint8_t n, uint16_t *region)
+{
+    DRV_CAPTOUCH_I2C_BENCH_BEGIN(BENCH_STAGE_HITTEST);
+
+    for(uint8_t i = 0; i < n; i++)
+        region[i] = DRV_CAPTOUCH_I2C_HITTEST_Lookup(point[i].x, point[i].y);
+
+    DRV_CAPTOUCH_I2C_BENCH_END(BENCH_STAGE_HITTEST);
+}
+
+int8_t DRV_CAPTOUCH_I2C_HITTEST_GetFrame(POINT_OBJ *point, uint16_t *region, uint8_t *n)
+{
+    int8_t error = 0;
+
+    error = DRV_CAPTOUCH_I2C_GetFrame(point, n);
+    if(error){
+        return error;
+    }
+
+    DRV_CAPTOUCH_I2C_HITTEST_Tag(point, *n, region);
+
+    return error;
+}
+
+void DRV_CAPTOUCH_I2C_HITTEST_GetStats(HITTEST_STATS_OBJ *stats)
+{
+    uint16_t length, node;
+
+    stats->regions = hittestRegions;
+    stats->nodes = hittestNodes;
+    stats->longest = 0;
+    stats->lookups = hittestLookups;
+    stats->probes = hittestProbes;
+
+    if(!hittestInitialized)
+        return;
+
+    for(uint16_t i = 0; i < HITTEST_ROWS * HITTEST_COLS; i++){
+        length = 0;
+        for(node = hittestCell[i]; node != HITTEST_NONE; node = hittestNode[node].next)
+            length++;
+        if(length > stats->longest)
+            stats->longest = length;
+    }
+}
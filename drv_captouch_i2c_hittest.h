@@ -0,0 +1,101 @@
+/****************************************************************************************
+  I2C Capacitive Touch Driver: Hit-Test Header File
+
+  File Name:
+    drv_captouch_i2c_hittest.h
+
+  Summary:
+    This header file provides the spatial index of UI regions touches are tagged with.
+
+  Description:
+    The application registers the rectangles of its widgets once and moves or
+    removes them as the layout changes; the index is a uniform grid over the
+    panel with one list of regions per cell. A contact is resolved by testing
+    the few regions of the cell it falls into, topmost first, instead of every
+    widget on the screen. DRV_CAPTOUCH_I2C_HITTEST_GetFrame tags each decoded
+    contact with the ID of the region under it in the completion path.
+ ***************************************************************************************/
+
+
+#ifndef DRV_CAPTOUCH_I2C_HITTEST_H
+#define DRV_CAPTOUCH_I2C_HITTEST_H
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "drv_captouch_i2c.h"
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Defines
+
+#ifndef HITTEST_REGIONS_MAX
+#define HITTEST_REGIONS_MAX         256
+#endif
+
+#ifndef HITTEST_NODES_MAX
+#define HITTEST_NODES_MAX           2048    // one per region and covered cell, a full screen takes 416
+#endif
+
+#ifndef HITTEST_CELL_SHIFT
+#define HITTEST_CELL_SHIFT          5       // 32 x 32 pixel cells
+#endif
+
+#if (ORIENTATION == 90) || (ORIENTATION == 270)
+#define HITTEST_WIDTH               MAX_Y_PIXEL
+#define HITTEST_HEIGHT              MAX_X_PIXEL
+#else
+#define HITTEST_WIDTH               MAX_X_PIXEL
+#define HITTEST_HEIGHT              MAX_Y_PIXEL
+#endif
+
+// Decoded coordinates reach the panel size itself, the last cell includes it
+#define HITTEST_COLS                ((HITTEST_WIDTH >> HITTEST_CELL_SHIFT) + 1)
+#define HITTEST_ROWS                ((HITTEST_HEIGHT >> HITTEST_CELL_SHIFT) + 1)
+
+#define HITTEST_NONE                0xFFFF  // no region under the contact, also an invalid handle
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Types
+
+/* Region Rectangle in panel coordinates, x + w and y + h are outside */
+typedef struct
+{
+    uint16_t    x;
+    uint16_t    y;
+    uint16_t    w;
+    uint16_t    h;
+} HITTEST_RECT_OBJ;
+
+/* Index Statistics */
+typedef struct
+{
+    uint16_t    regions;            // regions registered
+    uint16_t    nodes;              // cell entries in use
+    uint16_t    longest;            // regions in the fullest cell
+    uint32_t    lookups;            // points resolved since Init
+    uint32_t    probes;             // region tests of those lookups
+} HITTEST_STATS_OBJ;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Hit-Test Functions
+
+void DRV_CAPTOUCH_I2C_HITTEST_Init(void);
+int8_t DRV_CAPTOUCH_I2C_HITTEST_Insert(const HITTEST_RECT_OBJ *rect, uint8_t z, uint16_t id, uint16_t *handle);
+int8_t DRV_CAPTOUCH_I2C_HITTEST_Remove(uint16_t handle);
+int8_t DRV_CAPTOUCH_I2C_HITTEST_Move(uint16_t handle, const HITTEST_RECT_OBJ *rect);
+uint16_t DRV_CAPTOUCH_I2C_HITTEST_Lookup(uint16_t x, uint16_t y);
+void DRV_CAPTOUCH_I2C_HITTEST_Tag(const POINT_OBJ *point, uint8_t n, uint16_t *region);
+int8_t DRV_CAPTOUCH_I2C_HITTEST_GetFrame(POINT_OBJ *point, uint16_t *region, uint8_t *n);
+void DRV_CAPTOUCH_I2C_HITTEST_GetStats(HITTEST_STATS_OBJ *stats);
+
+#endif //DRV_CAPTOUCH_I2C_HITTEST_H
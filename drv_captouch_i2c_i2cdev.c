@@ -0,0 +1,293 @@
+/****************************************************************************************
+  I2C Capacitive Touch Driver: i2c-dev Transport
+
+  File Name:
+    drv_captouch_i2c_i2cdev.c
+
+  Summary:
+    Register transport over the Linux i2c-dev interface.
+
+  Description:
+    One ioctl per register access. With I2CDEV_LOOPBACK the open/ioctl/close
+    calls are routed to the host bus model instead of the kernel, so the same
+    decode pipeline can be exercised without hardware. The file is only compiled
+    with I2CDEV_EN, so Cortex-M4 builds never see the Linux headers.
+ ***************************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#ifdef I2CDEV_EN
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+#include "drv_captouch_i2c.h"
+#include "drv_captouch_i2c_bench.h"
+#include "drv_captouch_i2c_i2cdev.h"
+
+#ifdef I2CDEV_LOOPBACK
+#include "drv_captouch_i2c_loopback.h"
+#else
+#define I2CDEV_OPEN(path)               open(path, O_RDWR)
+#define I2CDEV_IOCTL(fd, request, arg)  ioctl(fd, request, arg)
+#define I2CDEV_CLOSE(fd)                close(fd)
+#endif
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Types
+
+typedef struct
+{
+    const char  *path;
+    uint8_t     address;
+    int         fd;
+    bool        smbus;          // adapter only supports SMBus I2C block transfers
+    uint32_t    calls;          // ioctls issued for register accesses
+} I2CDEV_OBJ;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Variables
+
+static I2CDEV_OBJ i2cdev = {
+    .path       = I2CDEV_PATH,
+    .address    = I2C_SLAVE_ADDR,
+    .fd         = -1,
+    .smbus      = false,
+    .calls      = 0
+};
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+
+static int8_t I2CDEV_Error(int err)
+{
+    switch(err){
+      case ENXIO:
+      case EREMOTEIO:
+      case ENODEV:
+      case ENOENT:
+        return ERR_NODEVICE;
+      case ETIMEDOUT:
+        return ERR_TIMEOUT;
+      case EBUSY:
+      case EAGAIN:
+        return ERR_BUSY;
+      case EMSGSIZE:
+        return ERR_OVERFLOW;
+      default:
+        return ERR_ARGUMENT;
+    }
+}
+
+static int8_t I2CDEV_Init(void *ctx)
+{
+    I2CDEV_OBJ *dev = ctx;
+    unsigned long funcs = 0;
+    int err;
+
+    if(dev->fd >= 0)
+        I2CDEV_CLOSE(dev->fd);
+
+    dev->fd = I2CDEV_OPEN(dev->path);
+    if(dev->fd < 0)
+        return I2CDEV_Error(errno);
+
+    if(I2CDEV_IOCTL(dev->fd, I2C_FUNCS, &funcs) < 0)
+        goto fail;
+
+    if(funcs & I2C_FUNC_I2C){
+        dev->smbus = false;
+    }else if((funcs & I2C_FUNC_SMBUS_I2C_BLOCK) == I2C_FUNC_SMBUS_I2C_BLOCK){
+        // SMBus transfers go to the address bound with I2C_SLAVE
+        dev->smbus = true;
+        if(I2CDEV_IOCTL(dev->fd, I2C_SLAVE, dev->address) < 0)
+            goto fail;
+    }else{
+        errno = ENODEV;
+        goto fail;
+    }
+
+    return ERR_NONE;
+
+fail:
+    err = errno;
+    I2CDEV_CLOSE(dev->fd);
+    dev->fd = -1;
+
+    return I2CDEV_Error(err);
+}
+
+static int8_t I2CDEV_SmbusBlock(I2CDEV_OBJ *dev, uint8_t read_write, uint8_t reg, uint8_t *data, uint8_t len)
+{
+    union i2c_smbus_data block;
+    struct i2c_smbus_ioctl_data args;
+
+    // SMBus caps a transfer at 32 bytes, longer accesses continue at reg + offset
+    // which matches the auto incrementing operating registers
+    for(uint8_t off = 0; off < len; ){
+        uint8_t chunk = (len - off > I2C_SMBUS_BLOCK_MAX) ? I2C_SMBUS_BLOCK_MAX : len - off;
+
+        block.block[0] = chunk;
+        if(read_write == I2C_SMBUS_WRITE)
+            memcpy(&block.block[1], &data[off], chunk);
+
+        args.read_write = read_write;
+        args.command    = reg + off;
+        args.size       = I2C_SMBUS_I2C_BLOCK_DATA;
+        args.data       = &block;
+
+        dev->calls++;
+        if(I2CDEV_IOCTL(dev->fd, I2C_SMBUS, &args) < 0)
+            return I2CDEV_Error(errno);
+
+        if(read_write == I2C_SMBUS_READ)
+            memcpy(&data[off], &block.block[1], chunk);
+
+        off += chunk;
+    }
+
+    return ERR_NONE;
+}
+
+static int8_t I2CDEV_Read(void *ctx, uint8_t reg, uint8_t *rxd, uint8_t len)
+{
+    I2CDEV_OBJ *dev = ctx;
+    struct i2c_msg msgs[2];
+    struct i2c_rdwr_ioctl_data xfer;
+    int8_t error = 0;
+
+    if(dev->fd < 0)
+        return ERR_NODEVICE;
+
+    if(dev->smbus)
+        return I2CDEV_SmbusBlock(dev, I2C_SMBUS_READ, reg, rxd, len);
+
+    DRV_CAPTOUCH_I2C_BENCH_BEGIN(BENCH_STAGE_SETUP);
+    msgs[0].addr  = dev->address;
+    msgs[0].flags = 0;
+    msgs[0].len   = BYTE;
+    msgs[0].buf   = &reg;
+    msgs[1].addr  = dev->address;
+    msgs[1].flags = I2C_M_RD;
+    msgs[1].len   = len;
+    msgs[1].buf   = rxd;
+
+    xfer.msgs  = msgs;
+    xfer.nmsgs = 2;
+
+    DRV_CAPTOUCH_I2C_BENCH_END(BENCH_STAGE_SETUP);
+    DRV_CAPTOUCH_I2C_BENCH_BEGIN(BENCH_STAGE_XFER);
+    dev->calls++;
+    if(I2CDEV_IOCTL(dev->fd, I2C_RDWR, &xfer) < 0)
+        error = I2CDEV_Error(errno);
+    DRV_CAPTOUCH_I2C_BENCH_END(BENCH_STAGE_XFER);
+
+    return error;
+}
+
+static int8_t I2CDEV_Write(void *ctx, uint8_t reg, const uint8_t *txd, uint8_t len)
+{
+    I2CDEV_OBJ *dev = ctx;
+    uint8_t buffer[I2C_BUFFER_LENGTH];
+    struct i2c_msg msg;
+    struct i2c_rdwr_ioctl_data xfer;
+    int8_t error = 0;
+
+    if(dev->fd < 0)
+        return ERR_NODEVICE;
+
+    if(len > I2C_BUFFER_LENGTH - 1)
+        return ERR_OVERFLOW;
+
+    if(dev->smbus)
+        return I2CDEV_SmbusBlock(dev, I2C_SMBUS_WRITE, reg, (uint8_t *)txd, len);
+
+    DRV_CAPTOUCH_I2C_BENCH_BEGIN(BENCH_STAGE_SETUP);
+    buffer[0] = reg;
+    memcpy(&buffer[1], txd, len);
+
+    msg.addr  = dev->address;
+    msg.flags = 0;
+    msg.len   = len + 1;
+    msg.buf   = buffer;
+
+    xfer.msgs  = &msg;
+    xfer.nmsgs = 1;
+
+    DRV_CAPTOUCH_I2C_BENCH_END(BENCH_STAGE_SETUP);
+    DRV_CAPTOUCH_I2C_BENCH_BEGIN(BENCH_STAGE_XFER);
+    dev->calls++;
+    if(I2CDEV_IOCTL(dev->fd, I2C_RDWR, &xfer) < 0)
+        error = I2CDEV_Error(errno);
+    DRV_CAPTOUCH_I2C_BENCH_END(BENCH_STAGE_XFER);
+
+    return error;
+}
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: i2c-dev Functions
+
+void DRV_CAPTOUCH_I2C_I2CDEV_SetDevice(const char *path, uint8_t address)
+{
+    if(path != NULL)
+        i2cdev.path = path;
+    if(address != 0)
+        i2cdev.address = address;
+}
+
+void DRV_CAPTOUCH_I2C_I2CDEV_Close(void)
+{
+    if(i2cdev.fd >= 0)
+        I2CDEV_CLOSE(i2cdev.fd);
+
+    i2cdev.fd = -1;
+}
+
+bool DRV_CAPTOUCH_I2C_I2CDEV_IsSmbus(void)
+{
+    return i2cdev.smbus;
+}
+
+uint32_t DRV_CAPTOUCH_I2C_I2CDEV_GetCalls(void)
+{
+    return i2cdev.calls;
+}
+
+uint32_t DRV_CAPTOUCH_I2C_I2CDEV_Timestamp(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint32_t)ts.tv_sec * 1000000U + (uint32_t)(ts.tv_nsec / 1000);
+}
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Transport
+
+const TRANSPORT_OBJ DRV_CAPTOUCH_I2C_I2CDEV_Transport = {
+    .init   = I2CDEV_Init,
+    .read   = I2CDEV_Read,
+    .write  = I2CDEV_Write,
+    .ctx    = &i2cdev
+};
+
+#endif //I2CDEV_EN
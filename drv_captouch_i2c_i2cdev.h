@@ -0,0 +1,50 @@
+/****************************************************************************************
+  I2C Capacitive Touch Driver: i2c-dev Transport Header File
+
+  File Name:
+    drv_captouch_i2c_i2cdev.h
+
+  Summary:
+    This header file provides the Linux userspace transport over /dev/i2c-N.
+
+  Description:
+    Build the driver with I2CDEV_EN to make this the default transport on the
+    A53 Linux side. Register reads are one I2C_RDWR ioctl with a pointer write
+    and a read message; adapters without plain I2C support (e.g. i2c-stub) fall
+    back to SMBus I2C block transfers.
+ ***************************************************************************************/
+
+
+#ifndef DRV_CAPTOUCH_I2C_I2CDEV_H
+#define DRV_CAPTOUCH_I2C_I2CDEV_H
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "drv_captouch_i2c_transport.h"
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Defines
+
+#ifndef I2CDEV_PATH
+#define I2CDEV_PATH                 "/dev/i2c-2"    // I2C3 of the i.MX8M mini
+#endif
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: i2c-dev Functions
+
+void DRV_CAPTOUCH_I2C_I2CDEV_SetDevice(const char *path, uint8_t address);
+void DRV_CAPTOUCH_I2C_I2CDEV_Close(void);
+bool DRV_CAPTOUCH_I2C_I2CDEV_IsSmbus(void);
+uint32_t DRV_CAPTOUCH_I2C_I2CDEV_GetCalls(void);
+uint32_t DRV_CAPTOUCH_I2C_I2CDEV_Timestamp(void);
+
+#endif //DRV_CAPTOUCH_I2C_I2CDEV_H
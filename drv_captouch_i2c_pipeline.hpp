@@ -0,0 +1,420 @@
+/****************************************************************************************
+  I2C Capacitive Touch Driver: C++ Processing Pipeline
+
+  File Name:
+    drv_captouch_i2c_pipeline.hpp
+
+  Summary:
+    Post-processing stages composed at compile time.
+
+  Description:
+    Pipeline<Decoder, Stages...> decodes a touch report (registers from
+    OP_REG_TDSTATUS) into a PipelineFrame, or a SoaFrame with DecodeSoa, and
+    hands it to each stage in order.
+    Stages are plain types with a process(frame) member and their state as data
+    members, held in a tuple and called through a fold expression: a product
+    lists the stages it needs (Clamp, Calibrate, Smooth, Track, Gesture) and an
+    omitted stage is neither stored nor called. Each stage is bracketed with
+    DRV_CAPTOUCH_I2C_BENCH_BEGIN/END of its BENCH_STAGE, so BENCH_EN builds get
+    per-stage cycle counts from the benchmark harness and other builds nothing.
+ ***************************************************************************************/
+
+
+#ifndef DRV_CAPTOUCH_I2C_PIPELINE_HPP
+#define DRV_CAPTOUCH_I2C_PIPELINE_HPP
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include <array>
+#include <cstdint>
+#include <tuple>
+#include "drv_captouch_i2c.hpp"
+
+extern "C" {
+#include "drv_captouch_i2c_bench.h"
+}
+
+
+namespace captouch {
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Defines
+
+#ifndef PIPELINE_CACHE_LINE
+#define PIPELINE_CACHE_LINE         64      // A53 and M7 D-cache lines are 64 and 32 bytes
+#endif
+
+/* Contact IDs are 4 bit, 0x0F marks an empty record */
+constexpr uint8_t PIPELINE_IDS = 16;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Frames
+
+/*
+ * Stages only use count, gesture and the per-contact accessors x(i), y(i),
+ * id(i), event(i), vx(i) and vy(i), so they run unchanged on both layouts.
+ */
+
+/* Array of POINT_OBJ, 8 bytes per contact for 6 of data */
+template<uint8_t MaxTouches>
+struct PipelineFrame
+{
+    static constexpr uint8_t max_touches = MaxTouches;
+
+    uint8_t                             count = 0;
+    std::array<POINT_OBJ, MaxTouches>   point{};
+    std::array<int16_t, MaxTouches>     velocity_x{};   // px per frame in Q4, from Track
+    std::array<int16_t, MaxTouches>     velocity_y{};
+    GESTURE_ID                          gesture = GESTURE_NO;   // from Gesture, for this frame only
+
+    uint16_t &x(uint8_t i) { return point[i].x; }
+    uint16_t &y(uint8_t i) { return point[i].y; }
+    uint8_t &id(uint8_t i) { return point[i].id; }
+    uint8_t &event(uint8_t i) { return point[i].event_flag; }
+    int16_t &vx(uint8_t i) { return velocity_x[i]; }
+    int16_t &vy(uint8_t i) { return velocity_y[i]; }
+};
+
+/* One array per field, for consumers that scan all x or all y */
+template<uint8_t MaxTouches>
+struct alignas(PIPELINE_CACHE_LINE) SoaFrame
+{
+    static constexpr uint8_t max_touches = MaxTouches;
+
+    std::array<uint16_t, MaxTouches>    xs{};
+    std::array<uint16_t, MaxTouches>    ys{};
+    std::array<int16_t, MaxTouches>     vxs{};
+    std::array<int16_t, MaxTouches>     vys{};
+    std::array<uint8_t, MaxTouches>     ids{};
+    std::array<uint8_t, MaxTouches>     flags{};        // EVENT_VALUE
+    std::array<uint8_t, MaxTouches>     weight{};
+    uint8_t                             count = 0;
+    GESTURE_ID                          gesture = GESTURE_NO;
+
+    uint16_t &x(uint8_t i) { return xs[i]; }
+    uint16_t &y(uint8_t i) { return ys[i]; }
+    uint8_t &id(uint8_t i) { return ids[i]; }
+    uint8_t &event(uint8_t i) { return flags[i]; }
+    int16_t &vx(uint8_t i) { return vxs[i]; }
+    int16_t &vy(uint8_t i) { return vys[i]; }
+
+    // For POINT_OBJ consumers, point holds count entries
+    void to_points(POINT_OBJ *point) const
+    {
+        for(uint8_t i = 0; i < count; i++){
+            point[i].event_flag = flags[i];
+            point[i].x = xs[i];
+            point[i].y = ys[i];
+            point[i].id = ids[i];
+        }
+    }
+};
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Stages
+
+/* Records and orientation into a PipelineFrame, as Ft5x46::decode */
+template<typename Panel = DefaultPanel, Orientation Orient = DefaultOrientation, uint8_t MaxTouches = MAX_TOUCHES>
+struct Decode
+{
+    using Frame = PipelineFrame<MaxTouches>;
+
+    void process(const uint8_t *report, Frame &frame)
+    {
+        uint8_t count = report[0] & 0x0F;
+
+        if(count > MaxTouches)
+            count = MaxTouches;
+
+        Ft5x46<DriverTransport, Panel, Orient, MaxTouches>::decode(&report[1], frame.point.data(), count);
+        frame.count = count;
+        frame.gesture = GESTURE_NO;
+    }
+};
+
+/* Records and orientation straight into a SoaFrame, weight included */
+template<typename Panel = DefaultPanel, Orientation Orient = DefaultOrientation, uint8_t MaxTouches = MAX_TOUCHES>
+struct DecodeSoa
+{
+    using Frame = SoaFrame<MaxTouches>;
+
+    void process(const uint8_t *report, Frame &frame)
+    {
+        using R = reg::Touch<1>;
+        const uint8_t *rec = &report[1];
+        uint8_t count = report[0] & 0x0F;
+
+        if(count > MaxTouches)
+            count = MaxTouches;
+
+        for(uint8_t i = 0; i < count; i++, rec += TOUCH_RECORD_SIZE){
+            const uint16_t x = R::X::decode(&rec[R::X::address - R::base]);
+            const uint16_t y = R::Y::decode(&rec[R::Y::address - R::base]);
+
+            frame.flags[i] = R::Event::decode(&rec[R::Event::address - R::base]);
+            frame.ids[i] = R::Id::decode(&rec[R::Id::address - R::base]);
+            frame.weight[i] = R::Weight::decode(&rec[R::Weight::address - R::base]);
+            Ft5x46<DriverTransport, Panel, Orient, MaxTouches>::orient(x, y, frame.xs[i], frame.ys[i]);
+        }
+
+        frame.count = count;
+        frame.gesture = GESTURE_NO;
+    }
+};
+
+/* Coordinates into 0..width-1 and 0..height-1 of the reported orientation */
+template<typename Panel = DefaultPanel, Orientation Orient = DefaultOrientation>
+struct Clamp
+{
+    static constexpr BENCH_STAGE bench_stage = BENCH_STAGE_CLAMP;
+    static constexpr bool swap = (Orient == Orientation::Deg90 || Orient == Orientation::Deg270);
+    static constexpr uint16_t x_max = (swap ? Panel::height : Panel::width) - 1;
+    static constexpr uint16_t y_max = (swap ? Panel::width : Panel::height) - 1;
+
+    template<typename Frame>
+    void process(Frame &frame)
+    {
+        for(uint8_t i = 0; i < frame.count; i++){
+            // Records beyond the panel wrap in the orientation transform and land high too
+            if(frame.x(i) > x_max)
+                frame.x(i) = x_max;
+            if(frame.y(i) > y_max)
+                frame.y(i) = y_max;
+        }
+    }
+};
+
+/* Affine correction x' = a x + b y + c, y' = d x + e y + f with Q16 coefficients, identity by default */
+template<typename Panel = DefaultPanel>
+struct Calibrate
+{
+    static constexpr BENCH_STAGE bench_stage = BENCH_STAGE_CALIBRATE;
+
+    int32_t     a = 1 << 16, b = 0, c = 0;
+    int32_t     d = 0, e = 1 << 16, f = 0;
+
+    void set(int32_t ca, int32_t cb, int32_t cc, int32_t cd, int32_t ce, int32_t cf)
+    {
+        a = ca; b = cb; c = cc;
+        d = cd; e = ce; f = cf;
+    }
+
+    template<typename Frame>
+    void process(Frame &frame)
+    {
+        for(uint8_t i = 0; i < frame.count; i++){
+            const int32_t x = frame.x(i);
+            const int32_t y = frame.y(i);
+
+            frame.x(i) = limit((int32_t)(((int64_t)a * x + (int64_t)b * y + c) >> 16), Panel::width);
+            frame.y(i) = limit((int32_t)(((int64_t)d * x + (int64_t)e * y + f) >> 16), Panel::height);
+        }
+    }
+
+private:
+    static uint16_t limit(int32_t v, uint16_t max)
+    {
+        return (v < 0) ? 0 : (v >= max) ? max - 1 : (uint16_t)v;
+    }
+};
+
+/* Per-contact exponential smoothing with weight 2^-Shift, restarted on EVENT_DOWN */
+template<uint8_t Shift = 2>
+struct Smooth
+{
+    static constexpr BENCH_STAGE bench_stage = BENCH_STAGE_FILTER;
+    static constexpr uint8_t frac = 4;
+
+    std::array<uint16_t, PIPELINE_IDS>  x{};    // Q4
+    std::array<uint16_t, PIPELINE_IDS>  y{};
+    uint16_t                            valid = 0;
+
+    template<typename Frame>
+    void process(Frame &frame)
+    {
+        for(uint8_t i = 0; i < frame.count; i++){
+            const uint8_t id = frame.id(i) & 0x0F;
+            const uint8_t event = frame.event(i);
+            const uint16_t px = frame.x(i) << frac, py = frame.y(i) << frac;
+
+            if(event == EVENT_DOWN || !(valid & (1u << id))){
+                x[id] = px;
+                y[id] = py;
+                valid |= 1u << id;
+            }else{
+                x[id] += ((int32_t)px - x[id]) >> Shift;
+                y[id] += ((int32_t)py - y[id]) >> Shift;
+            }
+
+            frame.x(i) = (x[id] + (1 << (frac - 1))) >> frac;
+            frame.y(i) = (y[id] + (1 << (frac - 1))) >> frac;
+
+            if(event == EVENT_UP)
+                valid &= ~(1u << id);
+        }
+    }
+};
+
+/* Velocity per contact ID, averaged over about 2^Shift frames */
+template<uint8_t Shift = 1>
+struct Track
+{
+    static constexpr BENCH_STAGE bench_stage = BENCH_STAGE_TRACK;
+
+    std::array<uint16_t, PIPELINE_IDS>  x{};
+    std::array<uint16_t, PIPELINE_IDS>  y{};
+    std::array<int16_t, PIPELINE_IDS>   vx{};   // Q4
+    std::array<int16_t, PIPELINE_IDS>   vy{};
+    uint16_t                            active = 0;
+
+    template<typename Frame>
+    void process(Frame &frame)
+    {
+        uint16_t seen = 0;
+
+        for(uint8_t i = 0; i < frame.count; i++){
+            const uint8_t id = frame.id(i) & 0x0F;
+            const uint8_t event = frame.event(i);
+            const uint16_t px = frame.x(i), py = frame.y(i);
+
+            if(event == EVENT_DOWN || !(active & (1u << id))){
+                vx[id] = 0;
+                vy[id] = 0;
+            }else{
+                vx[id] += ((px - x[id]) * 16 - vx[id]) >> Shift;
+                vy[id] += ((py - y[id]) * 16 - vy[id]) >> Shift;
+            }
+
+            x[id] = px;
+            y[id] = py;
+            frame.vx(i) = vx[id];
+            frame.vy(i) = vy[id];
+
+            if(event != EVENT_UP)
+                seen |= 1u << id;
+        }
+
+        // A contact missing from the report without EVENT_UP was lost
+        active = seen;
+    }
+};
+
+/* Swipes of a single contact longer than Swipe px, zoom when two contacts change distance by 1/4 */
+template<uint16_t Swipe = 80>
+struct Gesture
+{
+    static constexpr BENCH_STAGE bench_stage = BENCH_STAGE_GESTURE;
+
+    std::array<uint16_t, PIPELINE_IDS>  x0{};
+    std::array<uint16_t, PIPELINE_IDS>  y0{};
+    uint8_t                             most = 0;       // largest contact count of the touch
+    uint32_t                            span0 = 0;      // squared distance when the second contact came down
+    bool                                zoomed = false;
+
+    template<typename Frame>
+    void process(Frame &frame)
+    {
+        if(frame.count == 0){
+            most = 0;
+            return;
+        }
+
+        for(uint8_t i = 0; i < frame.count; i++){
+            if(frame.event(i) == EVENT_DOWN){
+                x0[frame.id(i) & 0x0F] = frame.x(i);
+                y0[frame.id(i) & 0x0F] = frame.y(i);
+            }
+        }
+
+        if(frame.count > most){
+            most = frame.count;
+            span0 = (most == 2) ? span(frame) : 0;
+            zoomed = false;
+        }
+
+        if(most == 1 && frame.event(0) == EVENT_UP){
+            const int32_t dx = frame.x(0) - x0[frame.id(0) & 0x0F];
+            const int32_t dy = frame.y(0) - y0[frame.id(0) & 0x0F];
+
+            if(dx * dx + dy * dy >= (int32_t)Swipe * Swipe){
+                if((dx < 0 ? -dx : dx) > (dy < 0 ? -dy : dy))
+                    frame.gesture = (dx > 0) ? GESTURE_SWIPE_RIGHT : GESTURE_SWIPE_LEFT;
+                else
+                    frame.gesture = (dy > 0) ? GESTURE_SWIPE_DOWN : GESTURE_SWIPE_UP;
+            }
+        }else if(most == 2 && frame.count == 2 && !zoomed && span0 > 0){
+            // Squared distances, a 1/4 change in distance is about 9/16 in square
+            const uint32_t now = span(frame);
+
+            if(16 * now >= 25 * span0){
+                frame.gesture = GESTURE_ZOOM_IN;
+                zoomed = true;
+            }else if(16 * now <= 9 * span0){
+                frame.gesture = GESTURE_ZOOM_OUT;
+                zoomed = true;
+            }
+        }
+    }
+
+private:
+    template<typename Frame>
+    static uint32_t span(Frame &frame)
+    {
+        const int32_t dx = frame.x(1) - frame.x(0);
+        const int32_t dy = frame.y(1) - frame.y(0);
+
+        return (uint32_t)(dx * dx + dy * dy);
+    }
+};
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Pipeline
+
+template<typename Decoder, typename... Stages>
+class Pipeline
+{
+public:
+    using Frame = typename Decoder::Frame;
+
+    // report holds OP_REG_TDSTATUS and the records, e.g. Ft5x46::report()
+    void run(const uint8_t *report, Frame &frame)
+    {
+        DRV_CAPTOUCH_I2C_BENCH_BEGIN(BENCH_STAGE_DECODE);
+        decoder_.process(report, frame);
+        DRV_CAPTOUCH_I2C_BENCH_END(BENCH_STAGE_DECODE);
+
+        std::apply([&frame](auto &... stage){ (run_stage(stage, frame), ...); }, stages_);
+    }
+
+    template<typename Stage>
+    Stage &stage()
+    {
+        return std::get<Stage>(stages_);
+    }
+
+private:
+    template<typename Stage>
+    static void run_stage(Stage &stage, Frame &frame)
+    {
+        DRV_CAPTOUCH_I2C_BENCH_BEGIN(Stage::bench_stage);
+        stage.process(frame);
+        DRV_CAPTOUCH_I2C_BENCH_END(Stage::bench_stage);
+    }
+
+    Decoder                 decoder_;
+    std::tuple<Stages...>   stages_;
+};
+
+} // namespace captouch
+
+#endif //DRV_CAPTOUCH_I2C_PIPELINE_HPP
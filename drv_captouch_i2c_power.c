@@ -0,0 +1,209 @@
+/****************************************************************************************
+  I2C Capacitive Touch Driver: Power Management
+
+  File Name:
+    drv_captouch_i2c_power.c
+
+  Summary:
+    Monitor and hibernate handling with wake-to-first-frame latency statistics.
+
+  Description:
+    Monitor mode costs no host work: the controller leaves it itself on a touch,
+    so the first report is late by at most one monitor scan period. Hibernate
+    stops the I2C interface, nothing may access the bus until
+    DRV_CAPTOUCH_I2C_POWER_Wake has returned. A wake by RST loses the
+    configuration, so Wake writes the power settings and the active profile
+    again; the latency is taken when the first frame with contacts is
+    delivered, as for a monitor wake. Timestamps are
+    DRV_CAPTOUCH_I2C_TIMESTAMP() ticks, idle time is accumulated in milliseconds
+    by DRV_CAPTOUCH_I2C_POWER_Service so it may exceed the counter wrap.
+ ***************************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include "drv_captouch_i2c.h"
+#include "drv_captouch_i2c_config.h"
+#include "drv_captouch_i2c_power.h"
+#include "drv_captouch_i2c_profile.h"
+#include "drv_captouch_i2c_shadow.h"
+#ifndef I2CDEV_EN
+#include "fsl_common.h"
+#endif
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Variables
+
+static POWER_CONFIG_OBJ powerConfig;
+static bool powerHibernating = false;
+static uint32_t powerLastService = 0;
+static uint32_t powerIdleMs = 0;            // time without touch, as of the last service
+
+static volatile bool powerWaking = false;
+static volatile uint32_t powerWakeStart = 0;
+static POWER_STATS_OBJ powerStats;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+
+static bool POWER_MonitorIdle(void)
+{
+    return powerConfig.monitor_idle != 0 && powerIdleMs >= (uint32_t)powerConfig.monitor_idle * 1000;
+}
+
+static int8_t POWER_Configure(void)
+{
+    CONFIG_OBJ reg = { 0 };
+
+    reg.set = CONFIG_CTRL | CONFIG_TIMMONITOR | CONFIG_PERIODMONITOR | CONFIG_PMODE;
+    reg.ctrl = powerConfig.monitor_idle ? POWER_CTRL_AUTO_MONITOR : 0x00;
+    reg.timer_monitor = powerConfig.monitor_idle;
+    reg.period_monitor = powerConfig.monitor_period;
+    reg.power_mode = PMODE_ACTIVE;
+
+    return DRV_CAPTOUCH_I2C_CONFIG_Apply(&reg);
+}
+
+static void POWER_Record(uint32_t latency)
+{
+    powerStats.wakes++;
+    powerStats.last = latency;
+    powerStats.total += latency;
+    if(latency > powerStats.max)
+        powerStats.max = latency;
+}
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Power Functions
+
+int8_t DRV_CAPTOUCH_I2C_POWER_Init(const POWER_CONFIG_OBJ *cfg, uint32_t now)
+{
+    if(cfg == NULL)
+        return ERR_ARGUMENT;
+
+    powerConfig = *cfg;
+    powerHibernating = false;
+    powerLastService = now;
+    powerIdleMs = 0;
+    powerWaking = false;
+    powerStats = (POWER_STATS_OBJ){ 0 };
+
+    return POWER_Configure();
+}
+
+void DRV_CAPTOUCH_I2C_POWER_Interrupt(uint32_t timestamp)
+{
+    // A report after the monitor timeout is the controller waking up
+    if(!powerWaking && POWER_MonitorIdle()){
+        powerWakeStart = timestamp;
+        powerWaking = true;
+    }
+}
+
+void DRV_CAPTOUCH_I2C_POWER_Frame(uint32_t timestamp, uint8_t n)
+{
+    if(n == 0)
+        return;
+
+    powerIdleMs = 0;
+
+    if(powerWaking){
+        powerWaking = false;
+        POWER_Record(timestamp - powerWakeStart);
+    }
+}
+
+int8_t DRV_CAPTOUCH_I2C_POWER_Service(uint32_t now)
+{
+    uint32_t tpm = DRV_CAPTOUCH_I2C_TIMESTAMP_HZ / 1000;
+    uint32_t ms = (now - powerLastService) / tpm;
+
+    // Called often enough that the timestamp cannot wrap in between, the remainder carries over
+    powerIdleMs += ms;
+    powerLastService += ms * tpm;
+
+    if(powerHibernating || powerConfig.hibernate_idle == 0 || powerIdleMs < powerConfig.hibernate_idle)
+        return ERR_NONE;
+
+    return DRV_CAPTOUCH_I2C_POWER_Hibernate();
+}
+
+int8_t DRV_CAPTOUCH_I2C_POWER_Hibernate(void)
+{
+    int8_t error = 0;
+
+    if(powerConfig.wake == NULL)
+        return ERR_ARGUMENT;
+
+    error = DRV_CAPTOUCH_I2C_WriteByte(OP_REG_PMODE, PMODE_HIBERNATE);
+    if(error){
+        return error;
+    }
+
+    powerHibernating = true;
+
+    return error;
+}
+
+int8_t DRV_CAPTOUCH_I2C_POWER_Wake(void)
+{
+    uint32_t start = DRV_CAPTOUCH_I2C_TIMESTAMP();
+    uint8_t md;
+    int8_t error = ERR_NODEVICE;
+
+    if(!powerHibernating)
+        return ERR_NONE;
+
+    powerConfig.wake();
+
+    // Configuration may be lost, the poll must reach the controller
+    DRV_CAPTOUCH_I2C_SHADOW_Invalidate(SHADOW_CONFIG);
+    for(uint8_t i = 0; i < POWER_WAKE_RETRIES && error; i++)
+        error = DRV_CAPTOUCH_I2C_ReadByte(OP_REG_DEVICEMODE, &md);
+    if(error){
+        return error;
+    }
+
+    powerHibernating = false;
+    powerIdleMs = 0;
+
+    // Profile and power settings are disjoint, both are lost with a reset
+    error = DRV_CAPTOUCH_I2C_PROFILE_Apply(DRV_CAPTOUCH_I2C_PROFILE_GetActive());
+    if(error){
+        return error;
+    }
+
+    error = POWER_Configure();
+    if(error){
+        return error;
+    }
+
+    // Measured up to the first frame with contacts, see DRV_CAPTOUCH_I2C_POWER_Frame
+    powerWakeStart = start;
+    powerWaking = true;
+
+    return error;
+}
+
+POWER_STATE DRV_CAPTOUCH_I2C_POWER_GetState(void)
+{
+    if(powerHibernating)
+        return POWER_HIBERNATE;
+    if(POWER_MonitorIdle())
+        return POWER_MONITOR;
+
+    return POWER_ACTIVE;
+}
+
+void DRV_CAPTOUCH_I2C_POWER_GetStats(POWER_STATS_OBJ *stats)
+{
+    *stats = powerStats;
+}
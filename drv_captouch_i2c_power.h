@@ -0,0 +1,87 @@
+/****************************************************************************************
+  I2C Capacitive Touch Driver: Power Management Header File
+
+  File Name:
+    drv_captouch_i2c_power.h
+
+  Summary:
+    This header file provides the activity-aware power management of the controller.
+
+  Description:
+    After TIMMONITOR seconds without a touch the controller drops into monitor mode
+    by itself (CTRL bit 0), scans at the PERIODMONITOR rate and raises INT on the
+    next touch. After a longer host-side idle time the driver puts it into
+    hibernate, from which the board wake callback brings it back and the driver
+    writes the configuration again. The time from the waking INT edge, or from
+    the wake call, to the first delivered frame with contacts is measured.
+ ***************************************************************************************/
+
+
+#ifndef DRV_CAPTOUCH_I2C_POWER_H
+#define DRV_CAPTOUCH_I2C_POWER_H
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "drv_captouch_i2c_defines.h"
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Defines
+
+#define POWER_CTRL_AUTO_MONITOR     0x01    // OP_REG_CTRL: enter monitor mode when idle
+#define POWER_WAKE_RETRIES          20      // DEVICEMODE polls after the wake callback
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Types
+
+/* Power State */
+typedef enum {
+    POWER_ACTIVE        = 0x00,
+    POWER_MONITOR,                  // estimated, the controller enters it on its own
+    POWER_HIBERNATE
+} POWER_STATE;
+
+/* Drives INT low (or pulses RST) to wake the controller from hibernate, then waits for it */
+typedef void (*POWER_WAKE_CALLBACK)(void);
+
+/* Power Configuration */
+typedef struct
+{
+    uint8_t                 monitor_idle;       // OP_REG_TIMMONITOR, seconds without touch, 0 stays active
+    uint8_t                 monitor_period;     // OP_REG_PERIODMONITOR
+    uint32_t                hibernate_idle;     // milliseconds without touch, 0 never hibernates
+    POWER_WAKE_CALLBACK     wake;
+} POWER_CONFIG_OBJ;
+
+/* Wake Latency, in timestamp ticks */
+typedef struct
+{
+    uint32_t    wakes;
+    uint32_t    last;
+    uint32_t    max;
+    uint64_t    total;
+} POWER_STATS_OBJ;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Power Functions
+
+int8_t DRV_CAPTOUCH_I2C_POWER_Init(const POWER_CONFIG_OBJ *cfg, uint32_t now);
+void DRV_CAPTOUCH_I2C_POWER_Interrupt(uint32_t timestamp);
+void DRV_CAPTOUCH_I2C_POWER_Frame(uint32_t timestamp, uint8_t n);
+int8_t DRV_CAPTOUCH_I2C_POWER_Service(uint32_t now);
+int8_t DRV_CAPTOUCH_I2C_POWER_Hibernate(void);
+int8_t DRV_CAPTOUCH_I2C_POWER_Wake(void);
+POWER_STATE DRV_CAPTOUCH_I2C_POWER_GetState(void);
+void DRV_CAPTOUCH_I2C_POWER_GetStats(POWER_STATS_OBJ *stats);
+
+#endif //DRV_CAPTOUCH_I2C_POWER_H
@@ -0,0 +1,177 @@
+/****************************************************************************************
+  I2C Capacitive Touch Driver: Profiles
+
+  File Name:
+    drv_captouch_i2c_profile.c
+
+  Summary:
+    Compile-time tuning profiles and their switching between touch frames.
+
+  Description:
+    DRV_CAPTOUCH_I2C_PROFILE_Request only stores the wanted profile, so it can be
+    called from a detector, another task or an interrupt. The acquisition loop calls
+    DRV_CAPTOUCH_I2C_PROFILE_Service after each frame has been read; every profile
+    defines the thresholds and the active scan period, so the switch is a single
+    write and the next frame is scanned with the new set only. CTRL, TIMMONITOR
+    and PERIODMONITOR belong to the power manager (drv_captouch_i2c_power.c), a
+    switch rewrites them at most with the values the controller already holds.
+ ***************************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include "drv_captouch_i2c.h"
+#include "drv_captouch_i2c_config.h"
+#include "drv_captouch_i2c_profile.h"
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Defines
+
+#define PROFILE_FIELDS              (CONFIG_THRESHOLDS | CONFIG_PERIODACTIVE)
+#define PROFILE_NONE                0xFF
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Variables
+
+static const CONFIG_OBJ profileTable[PROFILES] = {
+#ifdef FROMDATASHEET                // Default parameters defined in the Datasheet
+    [PROFILE_NORMAL]    = { .set = PROFILE_FIELDS, .threshold = 280, .peak = 60, .focus = 16, .water = 60,
+                            .temperature = 10, .difference = 20, .period_active = 0x0C },
+#else
+    [PROFILE_NORMAL]    = { .set = PROFILE_FIELDS, .threshold = 240, .peak = 50, .focus = 17, .water = 17,
+                            .temperature = 17, .difference = 160, .period_active = 0x0C },
+#endif
+    // Weaker signal through the glove
+    [PROFILE_GLOVE]     = { .set = PROFILE_FIELDS, .threshold = 160, .peak = 30, .focus = 12, .water = 17,
+                            .temperature = 17, .difference = 160, .period_active = 0x0C },
+    // Droplets must not reach the touch threshold
+    [PROFILE_WET]       = { .set = PROFILE_FIELDS, .threshold = 360, .peak = 80, .focus = 24, .water = 100,
+                            .temperature = 17, .difference = 160, .period_active = 0x0C },
+    // Slow active scan, monitor mode is up to the power manager
+    [PROFILE_LOW_POWER] = { .set = PROFILE_FIELDS, .threshold = 280, .peak = 60, .focus = 16, .water = 60,
+                            .temperature = 10, .difference = 20, .period_active = 0x14 },
+};
+
+static const char *const profileName[PROFILES] = {
+    "normal", "glove", "wet", "low-power"
+};
+
+static volatile uint8_t profilePending = PROFILE_NONE;
+static uint8_t profileActive = PROFILE_NONE;
+static uint8_t profileDry = PROFILE_NORMAL;
+
+static uint8_t wetAge[16];
+static uint16_t wetDown = 0;
+static uint16_t wetScore = 0;
+static uint16_t wetClean = 0;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Profile Functions
+
+const CONFIG_OBJ *DRV_CAPTOUCH_I2C_PROFILE_Get(PROFILE_ID id)
+{
+    return (id < PROFILES) ? &profileTable[id] : NULL;
+}
+
+const char *DRV_CAPTOUCH_I2C_PROFILE_GetName(PROFILE_ID id)
+{
+    return (id < PROFILES) ? profileName[id] : "";
+}
+
+PROFILE_ID DRV_CAPTOUCH_I2C_PROFILE_GetActive(void)
+{
+    return (profileActive < PROFILES) ? (PROFILE_ID)profileActive : PROFILE_NORMAL;
+}
+
+int8_t DRV_CAPTOUCH_I2C_PROFILE_Apply(PROFILE_ID id)
+{
+    CONFIG_PLAN_OBJ plan;
+    int8_t error = 0;
+
+    if(id >= PROFILES)
+        return ERR_ARGUMENT;
+
+    DRV_CAPTOUCH_I2C_CONFIG_PlanCoalesced(&profileTable[id], &plan);
+
+    error = DRV_CAPTOUCH_I2C_CONFIG_Write(&plan);
+    if(error){
+        return error;
+    }
+
+    profileActive = id;
+    if(id != PROFILE_WET)
+        profileDry = id;
+
+    return error;
+}
+
+void DRV_CAPTOUCH_I2C_PROFILE_Request(PROFILE_ID id)
+{
+    // A single byte store, safe against the acquisition loop
+    if(id < PROFILES)
+        profilePending = id;
+}
+
+int8_t DRV_CAPTOUCH_I2C_PROFILE_Service(void)
+{
+    uint8_t id = profilePending;
+    int8_t error = 0;
+
+    if(id == PROFILE_NONE)
+        return error;
+
+    if(id != profileActive){
+        // Kept pending on failure, the next frame retries
+        error = DRV_CAPTOUCH_I2C_PROFILE_Apply((PROFILE_ID)id);
+        if(error){
+            return error;
+        }
+    }
+
+    // Unless a newer request came in meanwhile; a plain read and store would lose one
+    // made by an interrupt between the two
+    __atomic_compare_exchange_n(&profilePending, &id, PROFILE_NONE, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+
+    return error;
+}
+
+void DRV_CAPTOUCH_I2C_PROFILE_WetDetect(const POINT_OBJ *point, uint8_t n)
+{
+    bool spurious = false;
+
+    for(uint8_t i = 0; i < n; i++){
+        uint8_t id = point[i].id & 0x0F;
+
+        if(point[i].event_flag == EVENT_DOWN){
+            wetAge[id] = 0;
+            wetDown |= 1u << id;
+        }else if(point[i].event_flag == EVENT_UP){
+            if((wetDown & (1u << id)) && wetAge[id] < PROFILE_WET_SHORT){
+                wetScore += PROFILE_WET_SCORE;
+                spurious = true;
+            }
+            wetDown &= ~(1u << id);
+        }else if(wetAge[id] < 0xFF){
+            wetAge[id]++;
+        }
+    }
+
+    if(wetScore > 2 * PROFILE_WET_ENTER)
+        wetScore = 2 * PROFILE_WET_ENTER;
+    if(wetScore > 0)
+        wetScore--;
+    wetClean = spurious ? 0 : ((wetClean < 0xFFFF) ? wetClean + 1 : wetClean);
+
+    if(profileActive != PROFILE_WET && wetScore >= PROFILE_WET_ENTER)
+        DRV_CAPTOUCH_I2C_PROFILE_Request(PROFILE_WET);
+    else if(profileActive == PROFILE_WET && wetClean >= PROFILE_WET_EXIT)
+        DRV_CAPTOUCH_I2C_PROFILE_Request((PROFILE_ID)profileDry);
+}
@@ -0,0 +1,68 @@
+/****************************************************************************************
+  I2C Capacitive Touch Driver: Profile Header File
+
+  File Name:
+    drv_captouch_i2c_profile.h
+
+  Summary:
+    This header file provides the switchable tuning profiles.
+
+  Description:
+    A profile is a compile-time CONFIG_OBJ of the thresholds and PERIODACTIVE; the
+    monitor mode registers are left to the power manager. Switches are requested from any context and
+    carried out by the acquisition loop between two touch frames, as one burst.
+ ***************************************************************************************/
+
+
+#ifndef DRV_CAPTOUCH_I2C_PROFILE_H
+#define DRV_CAPTOUCH_I2C_PROFILE_H
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "drv_captouch_i2c_defines.h"
+#include "drv_captouch_i2c_config.h"
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Defines
+
+/* Water Detection: droplets show up as contacts lifted shortly after touching down */
+#define PROFILE_WET_SHORT           3       // frames from EVENT_DOWN to EVENT_UP of a spurious contact
+#define PROFILE_WET_SCORE           4       // score added per spurious contact, one is removed per frame
+#define PROFILE_WET_ENTER           24      // score that switches to PROFILE_WET
+#define PROFILE_WET_EXIT            300     // frames without spurious contacts before switching back
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Types
+
+/* Profiles */
+typedef enum {
+    PROFILE_NORMAL      = 0x00,
+    PROFILE_GLOVE,
+    PROFILE_WET,
+    PROFILE_LOW_POWER,
+    PROFILES
+} PROFILE_ID;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Profile Functions
+
+const CONFIG_OBJ *DRV_CAPTOUCH_I2C_PROFILE_Get(PROFILE_ID id);
+const char *DRV_CAPTOUCH_I2C_PROFILE_GetName(PROFILE_ID id);
+PROFILE_ID DRV_CAPTOUCH_I2C_PROFILE_GetActive(void);
+int8_t DRV_CAPTOUCH_I2C_PROFILE_Apply(PROFILE_ID id);
+void DRV_CAPTOUCH_I2C_PROFILE_Request(PROFILE_ID id);
+int8_t DRV_CAPTOUCH_I2C_PROFILE_Service(void);
+void DRV_CAPTOUCH_I2C_PROFILE_WetDetect(const POINT_OBJ *point, uint8_t n);
+
+#endif //DRV_CAPTOUCH_I2C_PROFILE_H
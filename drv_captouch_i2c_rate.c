@@ -0,0 +1,218 @@
+/****************************************************************************************
+  I2C Capacitive Touch Driver: Report Rate
+
+  File Name:
+    drv_captouch_i2c_rate.c
+
+  Summary:
+    Report rate control, INT interval measurement and phase lock to the display.
+
+  Description:
+    Timestamps are DRV_CAPTOUCH_I2C_TIMESTAMP() ticks and only their unsigned 32
+    bit differences are used. DRV_CAPTOUCH_I2C_RATE_Interrupt and _Vsync only do
+    arithmetic and may run in interrupt context; the rate step they choose is
+    written by DRV_CAPTOUCH_I2C_RATE_Service from the acquisition loop, after the
+    frame has been read. Without a vsync the programmed rate is left as set.
+ ***************************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include "drv_captouch_i2c.h"
+#include "drv_captouch_i2c_config.h"
+#include "drv_captouch_i2c_rate.h"
+#ifndef I2CDEV_EN
+#include "fsl_common.h"
+#endif
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Variables
+
+static uint8_t rateStep = 0;                // PERIODACTIVE programmed
+static uint8_t rateNominal = 0;             // PERIODACTIVE chosen by Set or Sync
+static volatile uint8_t rateWanted = 0;     // PERIODACTIVE to program at the next service
+
+static uint32_t rateLastInt = 0;
+static uint32_t rateInterval = 0;
+static bool rateIntSeen = false;
+
+static bool rateSynced = false;
+static uint32_t rateLead = 0;
+static uint32_t rateLastVsync = 0;
+static uint32_t rateVsyncPeriod = 0;
+static bool rateVsyncSeen = false;
+static int32_t ratePhaseError = 0;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+
+static uint8_t RATE_Step(uint16_t hz)
+{
+    uint16_t step = (hz + RATE_HZ_PER_STEP / 2) / RATE_HZ_PER_STEP;
+
+    if(step < RATE_STEP_MIN)
+        step = RATE_STEP_MIN;
+    if(step > RATE_STEP_MAX)
+        step = RATE_STEP_MAX;
+
+    return (uint8_t)step;
+}
+
+static uint32_t RATE_Period(uint8_t step)
+{
+    return (uint32_t)(DRV_CAPTOUCH_I2C_TIMESTAMP_HZ / ((uint32_t)step * RATE_HZ_PER_STEP));
+}
+
+// Running average that drops samples outside half to one and a half of the expected period
+static void RATE_Average(uint32_t *average, uint32_t sample, uint32_t expected)
+{
+    if(expected != 0 && (sample < expected / 2 || sample > expected + expected / 2))
+        return;
+
+    if(*average == 0)
+        *average = sample;
+    else
+        *average = (uint32_t)((int32_t)*average + ((int32_t)(sample - *average)) / (1 << RATE_EMA_SHIFT));
+}
+
+static int8_t RATE_Program(uint8_t step)
+{
+    CONFIG_OBJ cfg = { 0 };
+    int8_t error = 0;
+
+    cfg.set = CONFIG_PERIODACTIVE;
+    cfg.period_active = step;
+
+    error = DRV_CAPTOUCH_I2C_CONFIG_Apply(&cfg);
+    if(error){
+        return error;
+    }
+
+    rateStep = step;
+
+    return error;
+}
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Rate Functions
+
+int8_t DRV_CAPTOUCH_I2C_RATE_Set(uint16_t hz)
+{
+    uint8_t step = RATE_Step(hz);
+
+    rateSynced = false;
+    rateNominal = step;
+    rateWanted = step;
+    rateInterval = 0;
+    rateIntSeen = false;
+
+    return RATE_Program(step);
+}
+
+uint16_t DRV_CAPTOUCH_I2C_RATE_Get(void)
+{
+    return (uint16_t)rateNominal * RATE_HZ_PER_STEP;
+}
+
+int8_t DRV_CAPTOUCH_I2C_RATE_Sync(uint16_t display_hz, uint32_t lead)
+{
+    int8_t error = 0;
+
+    // Same nominal rate as the display, the phase loop trims it one step at a time
+    error = DRV_CAPTOUCH_I2C_RATE_Set(display_hz);
+    if(error){
+        return error;
+    }
+
+    rateLead = lead;
+    rateVsyncPeriod = 0;
+    rateVsyncSeen = false;
+    rateSynced = true;
+
+    return error;
+}
+
+void DRV_CAPTOUCH_I2C_RATE_Interrupt(uint32_t timestamp)
+{
+    uint32_t since, to_vsync;
+    int32_t error, window;
+    uint8_t step = rateNominal;
+
+    if(rateIntSeen)
+        RATE_Average(&rateInterval, timestamp - rateLastInt, RATE_Period(rateStep));
+    rateLastInt = timestamp;
+    rateIntSeen = true;
+
+    if(!rateSynced || rateVsyncPeriod == 0)
+        return;
+
+    // Time left from this report to the vsync that will display it
+    if((int32_t)(timestamp - rateLastVsync) >= 0)
+        since = (timestamp - rateLastVsync) % rateVsyncPeriod;
+    else
+        since = rateVsyncPeriod - 1 - (rateLastVsync - timestamp - 1) % rateVsyncPeriod;
+    to_vsync = rateVsyncPeriod - since;
+
+    // Positive when the report is early and goes stale, negative when it is too late to be read
+    error = (int32_t)to_vsync - (int32_t)rateLead;
+    if(error > (int32_t)(rateVsyncPeriod / 2))
+        error -= (int32_t)rateVsyncPeriod;
+    ratePhaseError = error;
+
+    window = (int32_t)(rateVsyncPeriod >> RATE_PHASE_WINDOW_SHIFT);
+    if(error < -window && step < RATE_STEP_MAX)
+        step++;
+    else if(error > window && step > RATE_STEP_MIN)
+        step--;
+
+    rateWanted = step;
+}
+
+void DRV_CAPTOUCH_I2C_RATE_Vsync(uint32_t timestamp)
+{
+    if(rateVsyncSeen)
+        RATE_Average(&rateVsyncPeriod, timestamp - rateLastVsync, rateVsyncPeriod);
+    rateLastVsync = timestamp;
+    rateVsyncSeen = true;
+}
+
+int8_t DRV_CAPTOUCH_I2C_RATE_Service(void)
+{
+    uint8_t step = rateWanted;
+
+    if(step == 0 || step == rateStep)
+        return ERR_NONE;
+
+    return RATE_Program(step);
+}
+
+uint32_t DRV_CAPTOUCH_I2C_RATE_GetInterval(void)
+{
+    return rateInterval;
+}
+
+int32_t DRV_CAPTOUCH_I2C_RATE_GetPhaseError(void)
+{
+    return ratePhaseError;
+}
+
+uint32_t DRV_CAPTOUCH_I2C_RATE_GetReadTime(uint32_t now)
+{
+    uint32_t since;
+
+    if(!rateVsyncSeen || rateVsyncPeriod == 0)
+        return now;
+
+    // Next vsync after now, minus the lead
+    since = (now + rateLead - rateLastVsync) % rateVsyncPeriod;
+
+    return now + (rateVsyncPeriod - since) % rateVsyncPeriod;
+}
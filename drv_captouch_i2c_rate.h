@@ -0,0 +1,56 @@
+/****************************************************************************************
+  I2C Capacitive Touch Driver: Report Rate Header File
+
+  File Name:
+    drv_captouch_i2c_rate.h
+
+  Summary:
+    This header file provides the report rate control and the display synchronization.
+
+  Description:
+    The report rate is programmed through OP_REG_PERIODACTIVE. The INT interval is
+    measured from the timestamps of the falling edges and, once a display refresh
+    is known from vsync timestamps, the rate is nudged one step up or down so the
+    reports arrive a fixed lead time before each vsync.
+ ***************************************************************************************/
+
+
+#ifndef DRV_CAPTOUCH_I2C_RATE_H
+#define DRV_CAPTOUCH_I2C_RATE_H
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "drv_captouch_i2c_defines.h"
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Defines
+
+#define RATE_HZ_PER_STEP            10      // OP_REG_PERIODACTIVE is the active report rate in 10 Hz steps
+#define RATE_STEP_MIN               3
+#define RATE_STEP_MAX               14
+#define RATE_EMA_SHIFT              3       // interval averages over about 8 samples
+#define RATE_PHASE_WINDOW_SHIFT     3       // phase errors below period / 8 are left alone
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Rate Functions
+
+int8_t DRV_CAPTOUCH_I2C_RATE_Set(uint16_t hz);
+uint16_t DRV_CAPTOUCH_I2C_RATE_Get(void);
+int8_t DRV_CAPTOUCH_I2C_RATE_Sync(uint16_t display_hz, uint32_t lead);
+void DRV_CAPTOUCH_I2C_RATE_Interrupt(uint32_t timestamp);
+void DRV_CAPTOUCH_I2C_RATE_Vsync(uint32_t timestamp);
+int8_t DRV_CAPTOUCH_I2C_RATE_Service(void);
+uint32_t DRV_CAPTOUCH_I2C_RATE_GetInterval(void);
+int32_t DRV_CAPTOUCH_I2C_RATE_GetPhaseError(void);
+uint32_t DRV_CAPTOUCH_I2C_RATE_GetReadTime(uint32_t now);
+
+#endif //DRV_CAPTOUCH_I2C_RATE_H
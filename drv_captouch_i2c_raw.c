@@ -0,0 +1,270 @@
+/****************************************************************************************
+  I2C Capacitive Touch Driver: Raw Data
+
+  File Name:
+    drv_captouch_i2c_raw.c
+
+  Summary:
+    Pipelined raw capacitance frame capture in TEST_MODE.
+
+  Description:
+    The row to read is selected with TE_REG_ROWADD and its counts come from
+    TE_REG_RAWDATA0H.. as big endian pairs, so a frame costs one address write
+    and one 2 x cols byte burst per row. On transports with submit and poll the
+    address write of the next row is put on the bus before the row just read is
+    converted, the conversion runs while the write is in flight. The STARTSCAN
+    poll gives up after RAW_SCAN_TIMEOUT_MS, or the timeout passed to
+    DRV_CAPTOUCH_I2C_RAW_CaptureTimeout, and after RAW_SCAN_POLLS_PER_MS reads
+    per ms should the time source stand still.
+ ***************************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include "drv_captouch_i2c.h"
+#include "drv_captouch_i2c_raw.h"
+#include "drv_captouch_i2c_shadow.h"
+#include "drv_captouch_i2c_trace.h"
+#include "drv_captouch_i2c_transport.h"
+#ifndef I2CDEV_EN
+#include "fsl_common.h"
+#endif
+
+#ifdef TEST_MODE_EN
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Defines
+
+#define RAW_TICKS_PER_MS            (DRV_CAPTOUCH_I2C_TIMESTAMP_HZ / 1000)
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Variables
+
+static uint8_t rawRows = 0;
+static uint8_t rawCols = 0;
+static uint8_t rawBuffer[2 * RAW_MAX_COLS];
+static uint8_t rawAddress;
+static bool rawAddressInFlight = false;
+
+static RAW_STATS_OBJ rawStats;
+static uint32_t rawStart = 0;
+static uint32_t rawSequence = 0;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+
+// Puts the row address on the bus, without waiting for it where the transport allows
+static int8_t RAW_SelectRow(uint8_t row)
+{
+    const TRANSPORT_OBJ *t = DRV_CAPTOUCH_I2C_GetTransport();
+    int8_t error = 0;
+
+    rawAddress = row;
+
+    if(t->submit == NULL || t->poll == NULL)
+        return DRV_CAPTOUCH_I2C_WriteByte(TE_REG_ROWADD, rawAddress);
+
+    error = t->submit(t->ctx, false, TE_REG_ROWADD, &rawAddress, BYTE);
+    if(error){
+        return error;
+    }
+
+    rawAddressInFlight = true;
+
+    return error;
+}
+
+// Waits for the row address submitted by RAW_SelectRow
+static int8_t RAW_WaitRow(void)
+{
+    const TRANSPORT_OBJ *t = DRV_CAPTOUCH_I2C_GetTransport();
+    int8_t error = 0;
+
+    if(!rawAddressInFlight)
+        return ERR_NONE;
+
+    while((error = t->poll(t->ctx)) == ERR_BUSY){}
+    rawAddressInFlight = false;
+    if(error){
+        return error;
+    }
+
+    DRV_CAPTOUCH_I2C_TRACE(0, TE_REG_ROWADD, &rawAddress, BYTE);
+    DRV_CAPTOUCH_I2C_SHADOW_Update(TE_REG_ROWADD, &rawAddress, BYTE);
+
+    return error;
+}
+
+static void RAW_Convert(const uint8_t *src, uint16_t *dst, uint8_t cols)
+{
+    for(uint8_t c = 0; c < cols; c++)
+        dst[c] = ((uint16_t)src[2 * c] << 8) | src[2 * c + 1];
+}
+
+static int8_t RAW_Scan(uint32_t timeout_ms)
+{
+    uint32_t start = DRV_CAPTOUCH_I2C_TIMESTAMP();
+    uint8_t status;
+    int8_t error = 0;
+
+    error = DRV_CAPTOUCH_I2C_WriteByte(TE_REG_STARTSCAN, RAW_STARTSCAN_BUSY);
+    if(error){
+        return error;
+    }
+
+    rawStats.scan_polls = 0;
+    do{
+        if((DRV_CAPTOUCH_I2C_TIMESTAMP() - start) >= timeout_ms * RAW_TICKS_PER_MS
+           || rawStats.scan_polls >= timeout_ms * RAW_SCAN_POLLS_PER_MS)
+            return ERR_TIMEOUT;
+
+        error = DRV_CAPTOUCH_I2C_ReadByte(TE_REG_STARTSCAN, &status);
+        if(error){
+            return error;
+        }
+        rawStats.scan_polls++;
+    }while(status & RAW_STARTSCAN_BUSY);
+
+    rawStats.scan = DRV_CAPTOUCH_I2C_TIMESTAMP() - start;
+
+    return error;
+}
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Raw Data Functions
+
+int8_t DRV_CAPTOUCH_I2C_RAW_Start(void)
+{
+    int8_t error = 0;
+
+    // The scan timeout and the statistics need the time source running
+    DRV_CAPTOUCH_I2C_TIMESTAMP_ENABLE();
+
+    error = DRV_CAPTOUCH_I2C_SetDeviceMode(TEST_MODE);
+    if(error){
+        return error;
+    }
+
+    error = DRV_CAPTOUCH_I2C_ReadByte(TE_REG_ROWNUM, &rawRows);
+    if(error){
+        return error;
+    }
+
+    error = DRV_CAPTOUCH_I2C_ReadByte(TE_REG_COLNUM, &rawCols);
+    if(error){
+        return error;
+    }
+
+    if(rawRows == 0 || rawRows > RAW_MAX_ROWS || rawCols == 0 || rawCols > RAW_MAX_COLS)
+        return ERR_FORMAT;
+
+    rawStats.frames = 0;
+    rawStart = DRV_CAPTOUCH_I2C_TIMESTAMP();
+
+    return error;
+}
+
+int8_t DRV_CAPTOUCH_I2C_RAW_Capture(RAW_FRAME_OBJ *frame)
+{
+    return DRV_CAPTOUCH_I2C_RAW_CaptureTimeout(frame, RAW_SCAN_TIMEOUT_MS);
+}
+
+int8_t DRV_CAPTOUCH_I2C_RAW_CaptureTimeout(RAW_FRAME_OBJ *frame, uint32_t timeout_ms)
+{
+    uint32_t start;
+    int8_t error = 0;
+
+    if(rawRows == 0)
+        return ERR_ARGUMENT;
+
+    // A capture that failed mid-frame may have left an address write on the bus
+    error = RAW_WaitRow();
+    if(error){
+        return error;
+    }
+
+    error = RAW_Scan(timeout_ms);
+    if(error){
+        return error;
+    }
+
+    frame->timestamp = DRV_CAPTOUCH_I2C_TIMESTAMP();
+    frame->rows = rawRows;
+    frame->cols = rawCols;
+
+    start = DRV_CAPTOUCH_I2C_TIMESTAMP();
+    error = RAW_SelectRow(0);
+    if(error){
+        return error;
+    }
+
+    for(uint8_t r = 0; r < rawRows; r++){
+        error = RAW_WaitRow();
+        if(error){
+            return error;
+        }
+
+        error = DRV_CAPTOUCH_I2C_ReadArray(TE_REG_RAWDATA0H, rawBuffer, 2 * rawCols);
+        if(error){
+            return error;
+        }
+
+        // The next address goes out while this row is converted
+        if(r + 1 < rawRows){
+            error = RAW_SelectRow(r + 1);
+            if(error){
+                return error;
+            }
+        }
+
+        RAW_Convert(rawBuffer, &frame->data[r * rawCols], rawCols);
+    }
+
+    frame->sequence = rawSequence++;
+    rawStats.readout = DRV_CAPTOUCH_I2C_TIMESTAMP() - start;
+    rawStats.frames++;
+
+    return error;
+}
+
+int8_t DRV_CAPTOUCH_I2C_RAW_Stop(void)
+{
+    int8_t error = 0;
+
+    error = RAW_WaitRow();
+    rawRows = 0;
+    rawCols = 0;
+    if(error){
+        return error;
+    }
+
+    return DRV_CAPTOUCH_I2C_SetDeviceMode(NORMAL_MODE);
+}
+
+// 0 x 0 unless started
+void DRV_CAPTOUCH_I2C_RAW_GetSize(uint8_t *rows, uint8_t *cols)
+{
+    *rows = rawRows;
+    *cols = rawCols;
+}
+
+void DRV_CAPTOUCH_I2C_RAW_GetStats(RAW_STATS_OBJ *stats)
+{
+    *stats = rawStats;
+    stats->elapsed = DRV_CAPTOUCH_I2C_TIMESTAMP() - rawStart;
+    stats->fps_milli = 0;
+    if(stats->elapsed > 0)
+        stats->fps_milli = (uint32_t)((uint64_t)stats->frames * DRV_CAPTOUCH_I2C_TIMESTAMP_HZ * 1000 / stats->elapsed);
+}
+
+#endif //TEST_MODE_EN
@@ -0,0 +1,80 @@
+/****************************************************************************************
+  I2C Capacitive Touch Driver: Raw Data Header File
+
+  File Name:
+    drv_captouch_i2c_raw.h
+
+  Summary:
+    This header file provides the raw capacitance frame capture of TEST_MODE.
+
+  Description:
+    With TEST_MODE_EN the controller is switched to the test register page, a
+    panel scan is triggered through TE_REG_STARTSCAN and every row is read from
+    TE_REG_RAWDATA0H in one burst into a rows x cols frame of 16 bit counts.
+ ***************************************************************************************/
+
+
+#ifndef DRV_CAPTOUCH_I2C_RAW_H
+#define DRV_CAPTOUCH_I2C_RAW_H
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "drv_captouch_i2c_defines.h"
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Defines
+
+#define RAW_MAX_ROWS                40      // TE_REG_TXORDER0..39
+#define RAW_MAX_COLS                30      // TE_REG_RAWDATA0..29
+#define RAW_STARTSCAN_BUSY          0x80    // TE_REG_STARTSCAN: set to start, cleared when done
+#define RAW_SCAN_TIMEOUT_MS         100
+#define RAW_SCAN_POLLS_PER_MS       25      // a STARTSCAN read takes over 40 us even at 1 MHz
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Types
+
+/* Raw Frame, row major with a stride of cols */
+typedef struct
+{
+    uint32_t    sequence;
+    uint32_t    timestamp;                          // end of the scan, DRV_CAPTOUCH_I2C_TIMESTAMP() ticks
+    uint8_t     rows;
+    uint8_t     cols;
+    uint16_t    data[RAW_MAX_ROWS * RAW_MAX_COLS];
+} RAW_FRAME_OBJ;
+
+/* Capture Statistics, in timestamp ticks */
+typedef struct
+{
+    uint32_t    frames;
+    uint32_t    scan;                   // trigger to scan done, last frame
+    uint32_t    readout;                // first row address to last row converted, last frame
+    uint32_t    scan_polls;             // TE_REG_STARTSCAN reads, last frame
+    uint32_t    elapsed;                // since DRV_CAPTOUCH_I2C_RAW_Start
+    uint32_t    fps_milli;              // frames per 1000 seconds
+} RAW_STATS_OBJ;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Raw Data Functions
+
+#ifdef TEST_MODE_EN
+int8_t DRV_CAPTOUCH_I2C_RAW_Start(void);
+int8_t DRV_CAPTOUCH_I2C_RAW_Capture(RAW_FRAME_OBJ *frame);
+int8_t DRV_CAPTOUCH_I2C_RAW_CaptureTimeout(RAW_FRAME_OBJ *frame, uint32_t timeout_ms);
+int8_t DRV_CAPTOUCH_I2C_RAW_Stop(void);
+void DRV_CAPTOUCH_I2C_RAW_GetSize(uint8_t *rows, uint8_t *cols);
+void DRV_CAPTOUCH_I2C_RAW_GetStats(RAW_STATS_OBJ *stats);
+#endif
+
+#endif //DRV_CAPTOUCH_I2C_RAW_H
@@ -0,0 +1,405 @@
+/****************************************************************************************
+  I2C Capacitive Touch Driver: C++ Register Map
+
+  File Name:
+    drv_captouch_i2c_regmap.hpp
+
+  Summary:
+    constexpr description of the operating and test register pages with typed fields.
+
+  Description:
+    A Field names its first register, its length in registers (multi-register
+    fields are big endian) and the bit position and width of the value, so
+    decode() is a load, one shift and one mask. Plan<Fields...> sorts the
+    registers the fields occupy at compile time and merges them into the
+    fewest bursts, bridging gaps of up to Bridge unused registers; Snapshot
+    reads exactly those bursts and hands out the fields by type. Writing back
+    is limited to plans of writable fields and never bridges: registers between
+    the fields were only read and may have changed since, or be read-only.
+ ***************************************************************************************/
+
+
+#ifndef DRV_CAPTOUCH_I2C_REGMAP_HPP
+#define DRV_CAPTOUCH_I2C_REGMAP_HPP
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+extern "C" {
+#include "drv_captouch_i2c.h"
+#include "drv_captouch_i2c_config.h"
+}
+
+
+namespace captouch {
+namespace reg {
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Fields
+
+/* Register Page selected by DEVICEMODE */
+enum class Page : uint8_t {
+    Operating,
+    Test
+};
+
+template<Page P, uint8_t Address, uint8_t Registers, uint8_t Shift, uint8_t Width, typename T = uint8_t>
+struct Field
+{
+    static_assert(Registers >= 1 && Registers <= 2, "fields span one or two registers");
+    static_assert(Width >= 1 && Shift + Width <= 8 * Registers, "field outside its registers");
+
+    using value_type = T;
+
+    static constexpr Page page = P;
+    static constexpr uint8_t address = Address;
+    static constexpr uint8_t registers = Registers;
+    static constexpr uint8_t shift = Shift;
+    static constexpr uint16_t mask = (uint16_t)((1u << Width) - 1);
+
+    // p points at the field's first register
+    static constexpr T decode(const uint8_t *p)
+    {
+        if constexpr(Registers == 1)
+            return static_cast<T>((p[0] >> Shift) & mask);
+        else
+            return static_cast<T>((((uint16_t)p[0] << 8 | p[1]) >> Shift) & mask);
+    }
+
+    // Read-modify-write of the field's bits, the other bits of the registers are kept
+    static constexpr void encode(uint8_t *p, T value)
+    {
+        const uint16_t v = ((uint16_t)value & mask) << Shift;
+        const uint16_t keep = (uint16_t)~(mask << Shift);
+
+        if constexpr(Registers == 1){
+            p[0] = (uint8_t)((p[0] & keep) | v);
+        }else{
+            const uint16_t old = (uint16_t)p[0] << 8 | p[1];
+            const uint16_t now = (old & keep) | v;
+
+            p[0] = (uint8_t)(now >> 8);
+            p[1] = (uint8_t)now;
+        }
+    }
+};
+
+template<uint8_t Address, uint8_t Registers, uint8_t Shift, uint8_t Width, typename T = uint8_t>
+using OpField = Field<Page::Operating, Address, Registers, Shift, Width, T>;
+
+template<uint8_t Address, uint8_t Registers, uint8_t Shift, uint8_t Width, typename T = uint8_t>
+using TeField = Field<Page::Test, Address, Registers, Shift, Width, T>;
+
+/* Operating Page */
+using DeviceMode        = OpField<OP_REG_DEVICEMODE, 1, 0, 6>;     // as written by SetDeviceMode
+using GestureId         = OpField<OP_REG_GESTID, 1, 0, 8>;
+using TouchCount        = OpField<OP_REG_TDSTATUS, 1, 0, 4>;
+
+/* Touch Record n, 1 based */
+template<uint8_t N>
+struct Touch
+{
+    static_assert(N >= 1 && N <= MAX_TOUCHES, "no such touch record");
+
+    static constexpr uint8_t base = OP_REG_TOUCHX1H + TOUCH_RECORD_SIZE * (N - 1);
+
+    using Event         = OpField<base + 0, 1, 6, 2>;
+    using X             = OpField<base + 0, 2, 0, 12, uint16_t>;
+    using Id            = OpField<base + 2, 1, 4, 4>;
+    using Y             = OpField<base + 2, 2, 0, 12, uint16_t>;
+    using Weight        = OpField<base + 4, 1, 0, 8>;
+    using Area          = OpField<base + 5, 1, 4, 4>;
+};
+
+/* Configuration Banks */
+using ThGroup           = OpField<OP_REG_THGROUP, 1, 0, 8>;
+using ThPeak            = OpField<OP_REG_THPEAK, 1, 0, 8>;
+using ThCal             = OpField<OP_REG_THCAL, 1, 0, 8>;
+using ThWater           = OpField<OP_REG_THWATER, 1, 0, 8>;
+using ThTemp            = OpField<OP_REG_THTEMP, 1, 0, 8>;
+using ThDiff            = OpField<OP_REG_THTDIFF, 1, 0, 8>;
+using AutoMonitor       = OpField<OP_REG_CTRL, 1, 0, 1>;
+using TimeMonitor       = OpField<OP_REG_TIMMONITOR, 1, 0, 8>;
+using PeriodActive      = OpField<OP_REG_PERIODACTIVE, 1, 0, 8>;
+using PeriodMonitor     = OpField<OP_REG_PERIODMONITOR, 1, 0, 8>;
+using AutoCalibration   = OpField<OP_REG_AUTOCLBMONITOR, 1, 0, 8>;
+using LibVersion        = OpField<OP_REG_LIBVERSIONH, 2, 0, 16, uint16_t>;
+using Cipher            = OpField<OP_REG_CIPHER, 1, 0, 8>;
+using IntMode           = OpField<OP_REG_MODE, 1, 0, 8>;
+using PowerMode         = OpField<OP_REG_PMODE, 1, 0, 8>;
+using FirmwareId        = OpField<OP_REG_FIRMID, 1, 0, 8>;
+using State             = OpField<OP_REG_STATE, 1, 0, 8>;
+using Error             = OpField<OP_REG_ERR, 1, 0, 8>;
+
+/* Fields the host may write, the identity and status registers are read-only */
+template<typename F>
+struct writable : std::false_type {};
+
+template<> struct writable<DeviceMode> : std::true_type {};
+template<> struct writable<ThGroup> : std::true_type {};
+template<> struct writable<ThPeak> : std::true_type {};
+template<> struct writable<ThCal> : std::true_type {};
+template<> struct writable<ThWater> : std::true_type {};
+template<> struct writable<ThTemp> : std::true_type {};
+template<> struct writable<ThDiff> : std::true_type {};
+template<> struct writable<AutoMonitor> : std::true_type {};
+template<> struct writable<TimeMonitor> : std::true_type {};
+template<> struct writable<PeriodActive> : std::true_type {};
+template<> struct writable<PeriodMonitor> : std::true_type {};
+template<> struct writable<AutoCalibration> : std::true_type {};
+template<> struct writable<IntMode> : std::true_type {};
+template<> struct writable<PowerMode> : std::true_type {};
+
+#ifdef TEST_MODE_EN
+/* Test Page */
+namespace test {
+
+using RowAddress        = TeField<TE_REG_ROWADD, 1, 0, 8>;
+using ScanBusy          = TeField<TE_REG_STARTSCAN, 1, 7, 1>;
+using Rows              = TeField<TE_REG_ROWNUM, 1, 0, 8>;
+using Cols              = TeField<TE_REG_COLNUM, 1, 0, 8>;
+using DriverVoltage     = TeField<TE_REG_DRIVERVOL, 1, 0, 8>;
+using StartRx           = TeField<TE_REG_STARTRX, 1, 0, 8>;
+using Gain              = TeField<TE_REG_GAIN, 1, 0, 8>;
+using OriginX           = TeField<TE_REG_ORIGINXH, 2, 0, 16, uint16_t>;
+using OriginY           = TeField<TE_REG_ORIGINYH, 2, 0, 16, uint16_t>;
+using Width             = TeField<TE_REG_RESWH, 2, 0, 16, uint16_t>;
+using Height            = TeField<TE_REG_RESHH, 2, 0, 16, uint16_t>;
+
+template<uint8_t Col>
+struct RawData : TeField<TE_REG_RAWDATA0H + 2 * Col, 2, 0, 16, uint16_t>
+{
+    static_assert(Col < 30, "raw data holds one row of 30 columns");
+};
+
+template<uint8_t Row>
+struct RowCac : TeField<TE_REG_ROW0CAC + Row, 1, 0, 8>
+{
+    static_assert(Row < 40, "no such row");
+};
+
+template<uint8_t Col>
+struct ColCac : TeField<TE_REG_COL0CAC + Col, 1, 0, 8>
+{
+    static_assert(Col < 30, "no such column");
+};
+
+/* Offsets are packed two lines per register, the even line in the high nibble */
+template<uint8_t Row>
+struct RowOffset : TeField<TE_REG_ROW01OFF + Row / 2, 1, (Row & 1) ? 0 : 4, 4>
+{
+    static_assert(Row < 40, "no such row");
+};
+
+template<uint8_t Col>
+struct ColOffset : TeField<TE_REG_COL01OFF + Col / 2, 1, (Col & 1) ? 0 : 4, 4>
+{
+    static_assert(Col < 30, "no such column");
+};
+
+} // namespace test
+
+template<> struct writable<test::RowAddress> : std::true_type {};
+template<> struct writable<test::DriverVoltage> : std::true_type {};
+template<> struct writable<test::StartRx> : std::true_type {};
+template<> struct writable<test::Gain> : std::true_type {};
+#endif
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Burst Plans
+
+struct Burst
+{
+    uint8_t     reg;
+    uint8_t     len;
+    uint8_t     offset;         // in the snapshot buffer
+};
+
+template<uint8_t Bridge, typename... Fields>
+struct Plan
+{
+    static_assert(sizeof...(Fields) > 0, "empty plan");
+
+    static constexpr std::size_t fields = sizeof...(Fields);
+    static constexpr Page page = std::get<0>(std::array<Page, fields>{Fields::page...});
+    static constexpr bool writable = (reg::writable<Fields>::value && ...);
+
+    static_assert(((Fields::page == page) && ...), "one plan reads one register page");
+
+    struct Bursts
+    {
+        std::array<Burst, fields>   burst{};
+        uint8_t                     n = 0;
+        uint16_t                    size = 0;
+    };
+
+    static constexpr Bursts make(uint8_t bridge)
+    {
+        std::array<uint8_t, fields> first{Fields::address...};
+        std::array<uint8_t, fields> count{Fields::registers...};
+        Bursts b{};
+
+        // Insertion sort by address, a handful of fields
+        for(std::size_t i = 1; i < fields; i++){
+            for(std::size_t j = i; j > 0 && first[j - 1] > first[j]; j--){
+                uint8_t f = first[j], c = count[j];
+
+                first[j] = first[j - 1];
+                count[j] = count[j - 1];
+                first[j - 1] = f;
+                count[j - 1] = c;
+            }
+        }
+
+        for(std::size_t i = 0; i < fields; i++){
+            const unsigned end = first[i] + count[i];
+
+            if(b.n > 0){
+                Burst &last = b.burst[b.n - 1];
+                const unsigned last_end = last.reg + last.len;
+
+                if(first[i] <= last_end + bridge){
+                    if(end > last_end)
+                        last.len = (uint8_t)(end - last.reg);
+                    continue;
+                }
+            }
+            b.burst[b.n++] = Burst{first[i], count[i], 0};
+        }
+
+        for(uint8_t i = 0; i < b.n; i++){
+            b.burst[i].offset = (uint8_t)b.size;
+            b.size += b.burst[i].len;
+        }
+
+        return b;
+    }
+
+    static constexpr Bursts bursts = make(Bridge);
+
+    // Snapshot offset of a register covered by the plan
+    static constexpr uint8_t offset(uint8_t reg)
+    {
+        for(uint8_t i = 0; i < bursts.n; i++)
+            if(reg >= bursts.burst[i].reg && reg < bursts.burst[i].reg + bursts.burst[i].len)
+                return bursts.burst[i].offset + (reg - bursts.burst[i].reg);
+
+        return 0xFF;
+    }
+
+    // Only the registers of the fields, each burst at its place in the read snapshot
+    static constexpr Bursts make_writes()
+    {
+        Bursts b = make(0);
+
+        for(uint8_t i = 0; i < b.n; i++)
+            b.burst[i].offset = offset(b.burst[i].reg);
+
+        return b;
+    }
+
+    static constexpr Bursts writes = make_writes();
+
+    template<typename F>
+    static constexpr bool contains()
+    {
+        return ((std::is_same_v<F, Fields>) || ...);
+    }
+};
+
+/* Register values of one plan, read with Transport::read and written back with Transport::write */
+template<typename P>
+class Snapshot
+{
+public:
+    template<typename Transport>
+    int8_t read()
+    {
+        int8_t error = 0;
+
+        for(uint8_t i = 0; i < P::bursts.n && !error; i++)
+            error = Transport::read(P::bursts.burst[i].reg, &data_[P::bursts.burst[i].offset], P::bursts.burst[i].len);
+
+        return error;
+    }
+
+    template<typename Transport>
+    int8_t write()
+    {
+        static_assert(P::writable, "plan has read-only fields");
+
+        int8_t error = 0;
+
+        for(uint8_t i = 0; i < P::writes.n && !error; i++)
+            error = Transport::write(P::writes.burst[i].reg, &data_[P::writes.burst[i].offset], P::writes.burst[i].len);
+
+        return error;
+    }
+
+    template<typename F>
+    constexpr typename F::value_type get() const
+    {
+        static_assert(P::template contains<F>(), "field not in the plan");
+
+        return F::decode(&data_[P::offset(F::address)]);
+    }
+
+    template<typename F>
+    constexpr void set(typename F::value_type value)
+    {
+        static_assert(P::template contains<F>(), "field not in the plan");
+
+        F::encode(&data_[P::offset(F::address)], value);
+    }
+
+private:
+    std::array<uint8_t, P::bursts.size> data_{};
+};
+
+template<typename... Fields>
+using ReadPlan = Plan<CONFIG_BRIDGE_MAX, Fields...>;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Checks
+
+namespace detail {
+
+constexpr uint8_t record[TOUCH_RECORD_SIZE] = { 0x81, 0x23, 0x54, 0x56, 0x40, 0x30 };
+
+static_assert(Touch<1>::Event::decode(&record[0]) == 2);
+static_assert(Touch<1>::X::decode(&record[0]) == 0x123);
+static_assert(Touch<1>::Id::decode(&record[2]) == 5);
+static_assert(Touch<1>::Y::decode(&record[2]) == 0x456);
+static_assert(Touch<1>::Area::decode(&record[5]) == 3);
+static_assert(Touch<3>::base == OP_REG_TOUCHX3H && Touch<10>::base == OP_REG_TOUCHX10H);
+
+using FirstContact = ReadPlan<TouchCount, Touch<1>::X, Touch<1>::Y>;
+static_assert(FirstContact::bursts.n == 1 && FirstContact::bursts.size == 5);
+
+using Identity = ReadPlan<ThGroup, ThPeak, PeriodActive, Cipher, FirmwareId>;
+static_assert(Identity::bursts.n == 3 && Identity::bursts.size == 2 + 1 + 4);
+static_assert(!Identity::writable);
+
+// THPEAK is bridged for the read only
+using Tune = ReadPlan<ThGroup, ThCal, PeriodActive>;
+static_assert(Tune::writable && Tune::bursts.n == 2 && Tune::writes.n == 3);
+static_assert(Tune::writes.burst[1].reg == OP_REG_THCAL && Tune::writes.burst[1].offset == 2);
+
+} // namespace detail
+
+} // namespace reg
+} // namespace captouch
+
+#endif //DRV_CAPTOUCH_I2C_REGMAP_HPP
@@ -0,0 +1,261 @@
+/****************************************************************************************
+  I2C Capacitive Touch Driver: Self-Test
+
+  File Name:
+    drv_captouch_i2c_selftest.c
+
+  Summary:
+    Batched open, short, CAC and offset test of the panel for end-of-line testing.
+
+  Description:
+    The row and column banks of each kind are read together, in one burst when
+    the registers between them cost less than the START/address/pointer of a
+    second transfer (SELFTEST_BRIDGE_MAX). A failing row or column line fails
+    every node on it. The budget is checked before each phase and what is left
+    of it bounds the wait for the raw scan; once it is spent the remaining
+    phases are skipped, TEST_MODE is left in any case and ERR_TIMEOUT tells the
+    line the result is incomplete. Run enables the time source itself, the
+    budget does not rely on tracing or benchmarking having started it.
+ ***************************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include <string.h>
+#include "drv_captouch_i2c.h"
+#include "drv_captouch_i2c_raw.h"
+#include "drv_captouch_i2c_selftest.h"
+#ifndef I2CDEV_EN
+#include "fsl_common.h"
+#endif
+
+#ifdef TEST_MODE_EN
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Defines
+
+#define SELFTEST_TICKS_PER_MS       (DRV_CAPTOUCH_I2C_TIMESTAMP_HZ / 1000)
+#define SELFTEST_CAC_SPAN           (TE_REG_COL0CAC + RAW_MAX_COLS - TE_REG_ROW0CAC)
+#define SELFTEST_OFFSET_SPAN        (TE_REG_COL01OFF + RAW_MAX_COLS / 2 - TE_REG_ROW01OFF)
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Variables
+
+static const SELFTEST_LIMIT_OBJ selftestDefault = {
+    .raw_min        = 0x1000,
+    .raw_max        = 0x2400,
+    .cac_min        = 0x10,
+    .cac_max        = 0x70,
+    .offset_min     = 2,
+    .offset_max     = 14,
+    .budget         = SELFTEST_BUDGET_DEFAULT,
+};
+
+static const char *const selftestPhaseName[SELFTEST_PHASES] = {
+    "enter", "raw", "cac", "offset", "exit"
+};
+
+static RAW_FRAME_OBJ selftestFrame;
+static uint8_t selftestBuffer[SELFTEST_CAC_SPAN];
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+
+// Reads two banks to buf and buf + (reg_b - reg_a), bridged into one burst when the gap is short
+static int8_t SELFTEST_ReadBanks(uint8_t reg_a, uint8_t len_a, uint8_t reg_b, uint8_t len_b, uint8_t *buf)
+{
+    int8_t error = 0;
+
+    if(reg_b - (reg_a + len_a) <= SELFTEST_BRIDGE_MAX)
+        return DRV_CAPTOUCH_I2C_ReadArray(reg_a, buf, reg_b + len_b - reg_a);
+
+    error = DRV_CAPTOUCH_I2C_ReadArray(reg_a, buf, len_a);
+    if(error){
+        return error;
+    }
+
+    return DRV_CAPTOUCH_I2C_ReadArray(reg_b, &buf[reg_b - reg_a], len_b);
+}
+
+static void SELFTEST_Fail(SELFTEST_RESULT_OBJ *result, uint16_t node)
+{
+    uint8_t bit = 1u << (node & 7);
+
+    if(!(result->bitmap[node >> 3] & bit)){
+        result->bitmap[node >> 3] |= bit;
+        result->failed_nodes++;
+    }
+}
+
+static void SELFTEST_FailRow(SELFTEST_RESULT_OBJ *result, uint8_t row)
+{
+    for(uint8_t c = 0; c < result->cols; c++)
+        SELFTEST_Fail(result, row * result->cols + c);
+}
+
+static void SELFTEST_FailCol(SELFTEST_RESULT_OBJ *result, uint8_t col)
+{
+    for(uint8_t r = 0; r < result->rows; r++)
+        SELFTEST_Fail(result, r * result->cols + col);
+}
+
+// Line n of a packed offset bank, two lines per register with the even one in the high nibble
+static uint8_t SELFTEST_Nibble(const uint8_t *bank, uint8_t n)
+{
+    return (n & 1) ? (bank[n >> 1] & 0x0F) : (bank[n >> 1] >> 4);
+}
+
+// remaining is what is left of the budget in ms
+static int8_t SELFTEST_Phase(SELFTEST_PHASE phase, const SELFTEST_LIMIT_OBJ *limit, uint32_t remaining,
+                             SELFTEST_RESULT_OBJ *result)
+{
+    const uint8_t rows = result->rows, cols = result->cols;
+    uint16_t failed = result->failed_nodes;
+    const uint8_t *row, *col;
+    uint8_t v;
+    int8_t error = 0;
+
+    switch(phase){
+      case SELFTEST_PHASE_ENTER:
+        error = DRV_CAPTOUCH_I2C_RAW_Start();
+        if(error){
+            return error;
+        }
+        DRV_CAPTOUCH_I2C_RAW_GetSize(&result->rows, &result->cols);
+        break;
+
+      case SELFTEST_PHASE_RAW:
+        error = DRV_CAPTOUCH_I2C_RAW_CaptureTimeout(&selftestFrame, remaining);
+        if(error){
+            return error;
+        }
+        for(uint16_t n = 0; n < rows * cols; n++)
+            if(selftestFrame.data[n] < limit->raw_min || selftestFrame.data[n] > limit->raw_max)
+                SELFTEST_Fail(result, n);
+        break;
+
+      case SELFTEST_PHASE_CAC:
+        error = SELFTEST_ReadBanks(TE_REG_ROW0CAC, rows, TE_REG_COL0CAC, cols, selftestBuffer);
+        if(error){
+            return error;
+        }
+        row = selftestBuffer;
+        col = &selftestBuffer[TE_REG_COL0CAC - TE_REG_ROW0CAC];
+        for(uint8_t r = 0; r < rows; r++)
+            if(row[r] < limit->cac_min || row[r] > limit->cac_max)
+                SELFTEST_FailRow(result, r);
+        for(uint8_t c = 0; c < cols; c++)
+            if(col[c] < limit->cac_min || col[c] > limit->cac_max)
+                SELFTEST_FailCol(result, c);
+        break;
+
+      case SELFTEST_PHASE_OFFSET:
+        error = SELFTEST_ReadBanks(TE_REG_ROW01OFF, (rows + 1) / 2, TE_REG_COL01OFF, (cols + 1) / 2, selftestBuffer);
+        if(error){
+            return error;
+        }
+        row = selftestBuffer;
+        col = &selftestBuffer[TE_REG_COL01OFF - TE_REG_ROW01OFF];
+        for(uint8_t r = 0; r < rows; r++){
+            v = SELFTEST_Nibble(row, r);
+            if(v < limit->offset_min || v > limit->offset_max)
+                SELFTEST_FailRow(result, r);
+        }
+        for(uint8_t c = 0; c < cols; c++){
+            v = SELFTEST_Nibble(col, c);
+            if(v < limit->offset_min || v > limit->offset_max)
+                SELFTEST_FailCol(result, c);
+        }
+        break;
+
+      case SELFTEST_PHASE_EXIT:
+        error = DRV_CAPTOUCH_I2C_RAW_Stop();
+        break;
+
+      default:
+        return ERR_ARGUMENT;
+    }
+
+    if(result->failed_nodes != failed)
+        result->failed |= 1u << phase;
+
+    return error;
+}
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Self-Test Functions
+
+int8_t DRV_CAPTOUCH_I2C_SELFTEST_Run(const SELFTEST_LIMIT_OBJ *limit, SELFTEST_RESULT_OBJ *result)
+{
+    uint32_t start, t, elapsed;
+    uint32_t remaining = RAW_SCAN_TIMEOUT_MS;
+    int8_t error = 0, exit_error = 0;
+
+    DRV_CAPTOUCH_I2C_TIMESTAMP_ENABLE();
+    start = DRV_CAPTOUCH_I2C_TIMESTAMP();
+
+    if(limit == NULL)
+        limit = &selftestDefault;
+
+    memset(result, 0, sizeof(*result));
+
+    for(uint8_t p = SELFTEST_PHASE_ENTER; p < SELFTEST_PHASE_EXIT; p++){
+        if(limit->budget){
+            elapsed = (DRV_CAPTOUCH_I2C_TIMESTAMP() - start) / SELFTEST_TICKS_PER_MS;
+            if(elapsed >= limit->budget){
+                error = ERR_TIMEOUT;
+                break;
+            }
+            remaining = limit->budget - elapsed;
+            if(remaining > RAW_SCAN_TIMEOUT_MS)
+                remaining = RAW_SCAN_TIMEOUT_MS;
+        }
+
+        t = DRV_CAPTOUCH_I2C_TIMESTAMP();
+        error = SELFTEST_Phase((SELFTEST_PHASE)p, limit, remaining, result);
+        result->phase_time[p] = DRV_CAPTOUCH_I2C_TIMESTAMP() - t;
+        if(error)
+            break;
+        result->completed |= 1u << p;
+    }
+
+    // Leave TEST_MODE whatever happened once it was entered
+    if(result->completed & (1u << SELFTEST_PHASE_ENTER)){
+        t = DRV_CAPTOUCH_I2C_TIMESTAMP();
+        exit_error = SELFTEST_Phase(SELFTEST_PHASE_EXIT, limit, 0, result);
+        result->phase_time[SELFTEST_PHASE_EXIT] = DRV_CAPTOUCH_I2C_TIMESTAMP() - t;
+        if(!exit_error)
+            result->completed |= 1u << SELFTEST_PHASE_EXIT;
+    }
+
+    result->total_time = DRV_CAPTOUCH_I2C_TIMESTAMP() - start;
+
+    return error ? error : exit_error;
+}
+
+bool DRV_CAPTOUCH_I2C_SELFTEST_NodeFailed(const SELFTEST_RESULT_OBJ *result, uint8_t row, uint8_t col)
+{
+    uint16_t node = row * result->cols + col;
+
+    if(row >= result->rows || col >= result->cols)
+        return false;
+
+    return (result->bitmap[node >> 3] >> (node & 7)) & 1;
+}
+
+const char *DRV_CAPTOUCH_I2C_SELFTEST_GetPhaseName(SELFTEST_PHASE phase)
+{
+    return (phase < SELFTEST_PHASES) ? selftestPhaseName[phase] : "";
+}
+
+#endif //TEST_MODE_EN
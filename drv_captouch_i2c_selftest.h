@@ -0,0 +1,91 @@
+/****************************************************************************************
+  I2C Capacitive Touch Driver: Self-Test Header File
+
+  File Name:
+    drv_captouch_i2c_selftest.h
+
+  Summary:
+    This header file provides the end-of-line panel self-test.
+
+  Description:
+    With TEST_MODE_EN one call checks a raw frame (open and shorted nodes), the
+    row and column CAC banks and the row and column offset banks against
+    configurable limits within a time budget. The result is a bitmap with one
+    bit per node plus the time spent in each phase.
+ ***************************************************************************************/
+
+
+#ifndef DRV_CAPTOUCH_I2C_SELFTEST_H
+#define DRV_CAPTOUCH_I2C_SELFTEST_H
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "drv_captouch_i2c_defines.h"
+#include "drv_captouch_i2c_raw.h"
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Defines
+
+#define SELFTEST_BITMAP_SIZE        ((RAW_MAX_ROWS * RAW_MAX_COLS + 7) / 8)
+#define SELFTEST_BRIDGE_MAX         4       // unused registers read rather than opening a new burst
+#define SELFTEST_BUDGET_DEFAULT     250     // ms
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Types
+
+/* Test Phases, in execution order */
+typedef enum {
+    SELFTEST_PHASE_ENTER    = 0x00,     // switch to TEST_MODE, panel size
+    SELFTEST_PHASE_RAW,                 // one scan, open (low) and short (high) nodes
+    SELFTEST_PHASE_CAC,                 // TE_REG_ROW0CAC.. and TE_REG_COL0CAC..
+    SELFTEST_PHASE_OFFSET,              // TE_REG_ROW01OFF.. and TE_REG_COL01OFF.., one nibble per line
+    SELFTEST_PHASE_EXIT,                // back to NORMAL_MODE
+    SELFTEST_PHASES
+} SELFTEST_PHASE;
+
+/* Pass Limits, inclusive */
+typedef struct
+{
+    uint16_t    raw_min;
+    uint16_t    raw_max;
+    uint8_t     cac_min;
+    uint8_t     cac_max;
+    uint8_t     offset_min;
+    uint8_t     offset_max;
+    uint32_t    budget;                 // ms for all phases, 0 unlimited
+} SELFTEST_LIMIT_OBJ;
+
+/* Test Result, node n = row * cols + col is bit n % 8 of bitmap[n / 8] */
+typedef struct
+{
+    uint8_t     rows;
+    uint8_t     cols;
+    uint8_t     completed;              // bit per SELFTEST_PHASE that ran to the end
+    uint8_t     failed;                 // bit per SELFTEST_PHASE with failing nodes
+    uint16_t    failed_nodes;
+    uint32_t    phase_time[SELFTEST_PHASES];        // timestamp ticks
+    uint32_t    total_time;
+    uint8_t     bitmap[SELFTEST_BITMAP_SIZE];       // set bits fail
+} SELFTEST_RESULT_OBJ;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Self-Test Functions
+
+#ifdef TEST_MODE_EN
+int8_t DRV_CAPTOUCH_I2C_SELFTEST_Run(const SELFTEST_LIMIT_OBJ *limit, SELFTEST_RESULT_OBJ *result);
+bool DRV_CAPTOUCH_I2C_SELFTEST_NodeFailed(const SELFTEST_RESULT_OBJ *result, uint8_t row, uint8_t col);
+const char *DRV_CAPTOUCH_I2C_SELFTEST_GetPhaseName(SELFTEST_PHASE phase);
+#endif
+
+#endif //DRV_CAPTOUCH_I2C_SELFTEST_H
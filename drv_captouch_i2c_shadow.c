@@ -0,0 +1,164 @@
+/****************************************************************************************
+  I2C Capacitive Touch Driver: Shadow Registers
+
+  File Name:
+    drv_captouch_i2c_shadow.c
+
+  Summary:
+    Write-through cache of the host controlled registers.
+
+  Description:
+    In TEST_MODE the controller maps the test register page over the same
+    addresses, so apart from DEVICEMODE nothing is cached or served while the
+    shadowed DEVICEMODE selects the test page, or before DEVICEMODE is known.
+ ***************************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include "drv_captouch_i2c.h"
+#include "drv_captouch_i2c_shadow.h"
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Defines
+
+#define SHADOW_ENTRIES              18
+#define SHADOW_DEVICEMODE           0
+#define SHADOW_IDENTITY_MASK        ((1u << 12) | (1u << 13) | (1u << 14) | (1u << 17))
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Variables
+
+static uint8_t shadowValue[SHADOW_ENTRIES];
+static uint32_t shadowValid = 0;
+static uint32_t shadowHits = 0;
+static uint32_t shadowMisses = 0;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+
+// Slot of a shadowed register, -1 for registers that always go to the bus
+static int8_t SHADOW_Index(uint8_t reg)
+{
+    if(reg == OP_REG_DEVICEMODE)
+        return SHADOW_DEVICEMODE;
+    if(reg >= OP_REG_THGROUP && reg <= OP_REG_PERIODMONITOR)
+        return 1 + reg - OP_REG_THGROUP;                    // 1..10
+    if(reg >= OP_REG_AUTOCLBMONITOR && reg <= OP_REG_PMODE)
+        return 11 + reg - OP_REG_AUTOCLBMONITOR;            // 11..16
+    if(reg == OP_REG_FIRMID)
+        return 17;
+
+    return -1;
+}
+
+// Operating register page selected, going by the shadowed DEVICEMODE
+static bool SHADOW_OperatingPage(void)
+{
+    uint8_t mode = shadowValue[SHADOW_DEVICEMODE];
+
+    if(!(shadowValid & (1u << SHADOW_DEVICEMODE)))
+        return false;
+
+    // Datasheet encoding in bits 6:4, the driver also writes DEVICE_MODE raw
+    return ((mode & 0x70) != 0x40) && ((mode & 0x3F) != TEST_MODE);
+}
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Shadow Functions
+
+bool DRV_CAPTOUCH_I2C_SHADOW_Lookup(uint8_t reg, uint8_t *data, uint8_t len)
+{
+    bool operating = SHADOW_OperatingPage();
+
+    // Touch data and other live registers are not counted as misses
+    if(SHADOW_Index(reg) < 0)
+        return false;
+
+    for(uint8_t i = 0; i < len; i++){
+        int8_t idx = SHADOW_Index(reg + i);
+
+        if(idx < 0 || !(shadowValid & (1u << idx)) || (idx != SHADOW_DEVICEMODE && !operating)){
+            shadowMisses++;
+            return false;
+        }
+    }
+
+    for(uint8_t i = 0; i < len; i++)
+        data[i] = shadowValue[SHADOW_Index(reg + i)];
+
+    shadowHits++;
+
+    return true;
+}
+
+bool DRV_CAPTOUCH_I2C_SHADOW_Peek(uint8_t reg, uint8_t *value)
+{
+    int8_t idx = SHADOW_Index(reg);
+
+    // Same rules as a lookup, without touching the statistics
+    if(idx < 0 || !(shadowValid & (1u << idx)) || (idx != SHADOW_DEVICEMODE && !SHADOW_OperatingPage()))
+        return false;
+
+    *value = shadowValue[idx];
+
+    return true;
+}
+
+bool DRV_CAPTOUCH_I2C_SHADOW_Match(uint8_t reg, const uint8_t *data, uint8_t len)
+{
+    bool operating = SHADOW_OperatingPage();
+
+    for(uint8_t i = 0; i < len; i++){
+        int8_t idx = SHADOW_Index(reg + i);
+
+        if(idx < 0 || !(shadowValid & (1u << idx)) || (idx != SHADOW_DEVICEMODE && !operating))
+            return false;
+        if(shadowValue[idx] != data[i])
+            return false;
+    }
+
+    return len > 0;
+}
+
+void DRV_CAPTOUCH_I2C_SHADOW_Update(uint8_t reg, const uint8_t *data, uint8_t len)
+{
+    // Page before the access, a DEVICEMODE write only affects what follows it
+    bool operating = SHADOW_OperatingPage();
+
+    for(uint8_t i = 0; i < len; i++){
+        int8_t idx = SHADOW_Index(reg + i);
+
+        if(idx < 0 || (idx != SHADOW_DEVICEMODE && !operating))
+            continue;
+
+        shadowValue[idx] = data[i];
+        shadowValid |= 1u << idx;
+    }
+}
+
+void DRV_CAPTOUCH_I2C_SHADOW_Invalidate(SHADOW_SCOPE scope)
+{
+    if(scope == SHADOW_ALL)
+        shadowValid = 0;
+    else
+        shadowValid &= SHADOW_IDENTITY_MASK;
+}
+
+void DRV_CAPTOUCH_I2C_SHADOW_GetStats(uint32_t *hits, uint32_t *misses)
+{
+    if(hits != NULL)
+        *hits = shadowHits;
+    if(misses != NULL)
+        *misses = shadowMisses;
+}
@@ -0,0 +1,54 @@
+/****************************************************************************************
+  I2C Capacitive Touch Driver: Shadow Register Header File
+
+  File Name:
+    drv_captouch_i2c_shadow.h
+
+  Summary:
+    This header file provides the write-through shadow of the configuration registers.
+
+  Description:
+    DEVICEMODE, the OP_REG_THGROUP..OP_REG_PERIODMONITOR block, AUTOCLBMONITOR,
+    MODE and PMODE only change when the host writes them, LIBVERSION, CIPHER
+    and FIRMID never change while powered. Reads of these registers are served
+    from the shadow once they have been read or written, costing no bus time,
+    and writes of the value already held are dropped.
+ ***************************************************************************************/
+
+
+#ifndef DRV_CAPTOUCH_I2C_SHADOW_H
+#define DRV_CAPTOUCH_I2C_SHADOW_H
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "drv_captouch_i2c_defines.h"
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Types
+
+/* Invalidation Scope */
+typedef enum {
+    SHADOW_CONFIG       = 0x00,     // after a reset: mode, configuration and power mode
+    SHADOW_ALL          = 0x01      // after a power cycle: also the identity registers
+} SHADOW_SCOPE;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Shadow Functions
+
+bool DRV_CAPTOUCH_I2C_SHADOW_Lookup(uint8_t reg, uint8_t *data, uint8_t len);
+bool DRV_CAPTOUCH_I2C_SHADOW_Peek(uint8_t reg, uint8_t *value);
+bool DRV_CAPTOUCH_I2C_SHADOW_Match(uint8_t reg, const uint8_t *data, uint8_t len);
+void DRV_CAPTOUCH_I2C_SHADOW_Update(uint8_t reg, const uint8_t *data, uint8_t len);
+void DRV_CAPTOUCH_I2C_SHADOW_Invalidate(SHADOW_SCOPE scope);
+void DRV_CAPTOUCH_I2C_SHADOW_GetStats(uint32_t *hits, uint32_t *misses);
+
+#endif //DRV_CAPTOUCH_I2C_SHADOW_H
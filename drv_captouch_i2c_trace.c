@@ -0,0 +1,159 @@
+/****************************************************************************************
+  I2C Capacitive Touch Driver: Trace Capture
+
+  File Name:
+    drv_captouch_i2c_trace.c
+
+  Summary:
+    Binary capture of the I2C transactions issued by the driver.
+
+  Description:
+    Records are appended to a caller supplied buffer. When it fills up the chunk is
+    handed to the flush callback (UART, file, RPMsg...), without one further records
+    are counted as dropped.
+ ***************************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include "drv_captouch_i2c.h"
+#include "drv_captouch_i2c_trace.h"
+#ifndef I2CDEV_EN
+#include "fsl_common.h"
+#endif
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Variables
+
+static uint8_t *traceBuffer = NULL;
+static uint32_t traceSize = 0;
+static uint32_t traceUsed = 0;
+static uint32_t traceTotal = 0;
+static uint32_t traceDropped = 0;
+static TRACE_FLUSH_CALLBACK traceFlush = NULL;
+static bool traceActive = false;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+
+static void TRACE_Put32(uint8_t *dst, uint32_t value)
+{
+    dst[0] = value & 0xFF;
+    dst[1] = (value >> 8) & 0xFF;
+    dst[2] = (value >> 16) & 0xFF;
+    dst[3] = (value >> 24) & 0xFF;
+}
+
+static bool TRACE_Reserve(uint32_t len)
+{
+    if(traceUsed + len <= traceSize)
+        return true;
+
+    if(traceFlush == NULL || len > traceSize)
+        return false;
+
+    traceFlush(traceBuffer, traceUsed);
+    traceUsed = 0;
+
+    return true;
+}
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Trace Functions
+
+void DRV_CAPTOUCH_I2C_TRACE_Start(uint8_t *buffer, uint32_t size, TRACE_FLUSH_CALLBACK flush)
+{
+    traceActive = false;
+
+    if(buffer == NULL || size < TRACE_HEADER_SIZE)
+        return;
+
+    // Timestamps come from the DWT cycle counter on the M4, CLOCK_MONOTONIC with I2CDEV_EN
+    DRV_CAPTOUCH_I2C_TIMESTAMP_ENABLE();
+
+    traceBuffer = buffer;
+    traceSize = size;
+    traceFlush = flush;
+    traceDropped = 0;
+
+    traceBuffer[0] = TRACE_MAGIC0;
+    traceBuffer[1] = TRACE_MAGIC1;
+    traceBuffer[2] = TRACE_MAGIC2;
+    traceBuffer[3] = TRACE_MAGIC3;
+    traceBuffer[4] = TRACE_VERSION;
+    traceBuffer[5] = 0;
+    traceBuffer[6] = 0;
+    traceBuffer[7] = 0;
+    TRACE_Put32(&traceBuffer[8], DRV_CAPTOUCH_I2C_TIMESTAMP_HZ);
+
+    traceUsed = TRACE_HEADER_SIZE;
+    traceTotal = TRACE_HEADER_SIZE;
+    traceActive = true;
+}
+
+void DRV_CAPTOUCH_I2C_TRACE_Stop(void)
+{
+    if(!traceActive)
+        return;
+
+    traceActive = false;
+
+    if(traceFlush != NULL && traceUsed > 0){
+        traceFlush(traceBuffer, traceUsed);
+        traceUsed = 0;
+    }
+}
+
+// Registers auto-increment: a transfer longer than TRACE_LEN_MASK continues in a record at reg + chunk
+void DRV_CAPTOUCH_I2C_TRACE_Record(uint8_t dir, uint8_t reg, const uint8_t *data, uint8_t len)
+{
+    uint32_t timestamp;
+    uint8_t *rec;
+    uint8_t chunk;
+
+    if(!traceActive)
+        return;
+
+    timestamp = DRV_CAPTOUCH_I2C_TIMESTAMP();
+
+    do{
+        chunk = (len > TRACE_LEN_MASK) ? TRACE_LEN_MASK : len;
+
+        if(!TRACE_Reserve(TRACE_RECORD_SIZE + chunk)){
+            traceDropped++;
+            return;
+        }
+
+        rec = &traceBuffer[traceUsed];
+        TRACE_Put32(rec, timestamp);
+        rec[4] = reg;
+        rec[5] = (dir & TRACE_DIR_READ) | chunk;
+        for(uint8_t i = 0; i < chunk; i++)
+            rec[TRACE_RECORD_SIZE + i] = data[i];
+
+        traceUsed += TRACE_RECORD_SIZE + chunk;
+        traceTotal += TRACE_RECORD_SIZE + chunk;
+
+        reg += chunk;
+        data += chunk;
+        len -= chunk;
+    } while(len > 0);
+}
+
+uint32_t DRV_CAPTOUCH_I2C_TRACE_GetLength(void)
+{
+    return traceTotal;
+}
+
+uint32_t DRV_CAPTOUCH_I2C_TRACE_GetDropped(void)
+{
+    return traceDropped;
+}
@@ -0,0 +1,78 @@
+/****************************************************************************************
+  I2C Capacitive Touch Driver: Trace Header File
+
+  File Name:
+    drv_captouch_i2c_trace.h
+
+  Summary:
+    This header file provides the I2C transaction trace format and capture API.
+
+  Description:
+    Every register transfer of the driver can be captured into a compact binary
+    stream (see TRACE_* defines) that the host replayer feeds back through the
+    decode pipeline. Capture is compiled in with TRACE_EN.
+ ***************************************************************************************/
+
+
+#ifndef DRV_CAPTOUCH_I2C_TRACE_H
+#define DRV_CAPTOUCH_I2C_TRACE_H
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "drv_captouch_i2c_defines.h"
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Defines
+
+/*
+ * Stream layout (little endian):
+ *   header  | 'F' 'T' 'T' 'R' | version (1) | reserved (3) | tick_hz (4) |
+ *   record  | timestamp (4) | reg (1) | dir:1 len:7 (1) | payload (len) |
+ * Timestamps are free running DRV_CAPTOUCH_I2C_TIMESTAMP() ticks; consumers must
+ * only use their unsigned 32 bit differences.
+ * Transfers longer than TRACE_LEN_MASK bytes are split into records with the same
+ * timestamp, each continuing at the register after the previous one.
+ */
+#define TRACE_MAGIC0                'F'
+#define TRACE_MAGIC1                'T'
+#define TRACE_MAGIC2                'T'
+#define TRACE_MAGIC3                'R'
+#define TRACE_VERSION               1
+#define TRACE_HEADER_SIZE           12
+#define TRACE_RECORD_SIZE           6       // without payload
+#define TRACE_DIR_READ              0x80
+#define TRACE_LEN_MASK              0x7F
+
+#ifdef TRACE_EN
+#define DRV_CAPTOUCH_I2C_TRACE(dir, reg, data, len)     DRV_CAPTOUCH_I2C_TRACE_Record(dir, reg, data, len)
+#else
+#define DRV_CAPTOUCH_I2C_TRACE(dir, reg, data, len)
+#endif
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Types
+
+/* Called with a full chunk of the stream; the buffer is reused when it returns */
+typedef void (*TRACE_FLUSH_CALLBACK)(const uint8_t *data, uint32_t len);
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Trace Functions
+
+void DRV_CAPTOUCH_I2C_TRACE_Start(uint8_t *buffer, uint32_t size, TRACE_FLUSH_CALLBACK flush);
+void DRV_CAPTOUCH_I2C_TRACE_Stop(void);
+void DRV_CAPTOUCH_I2C_TRACE_Record(uint8_t dir, uint8_t reg, const uint8_t *data, uint8_t len);
+uint32_t DRV_CAPTOUCH_I2C_TRACE_GetLength(void);
+uint32_t DRV_CAPTOUCH_I2C_TRACE_GetDropped(void);
+
+#endif //DRV_CAPTOUCH_I2C_TRACE_H
@@ -0,0 +1,61 @@
+/****************************************************************************************
+  I2C Capacitive Touch Driver: Transport Header File
+
+  File Name:
+    drv_captouch_i2c_transport.h
+
+  Summary:
+    This header file provides the register transport interface of the driver.
+
+  Description:
+    The decode pipeline only needs two bus primitives: a register read (pointer
+    write followed by a repeated start read) and a register write. A transport
+    provides them for one bus implementation, fsl_i2c on the M4 and i2c-dev on
+    the A53 Linux side, and is selected with DRV_CAPTOUCH_I2C_SetTransport.
+ ***************************************************************************************/
+
+
+#ifndef DRV_CAPTOUCH_I2C_TRANSPORT_H
+#define DRV_CAPTOUCH_I2C_TRANSPORT_H
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "drv_captouch_i2c_defines.h"
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Types
+
+/* Called from the completion interrupt of a submitted transfer with its result */
+typedef void (*TRANSPORT_DONE_CALLBACK)(void *arg, int8_t error);
+
+/* Register Transport, submit, poll and notify are optional (NULL when every transfer blocks) */
+typedef struct
+{
+    int8_t      (*init)(void *ctx);
+    int8_t      (*read)(void *ctx, uint8_t reg, uint8_t *rxd, uint8_t len);
+    int8_t      (*write)(void *ctx, uint8_t reg, const uint8_t *txd, uint8_t len);
+    int8_t      (*submit)(void *ctx, bool read, uint8_t reg, uint8_t *data, uint8_t len);
+    int8_t      (*poll)(void *ctx);     // ERR_BUSY until the submitted transfer has finished, never after
+    void        (*notify)(void *ctx, TRANSPORT_DONE_CALLBACK done, void *arg);   // NULL done to detach
+    void        *ctx;
+} TRANSPORT_OBJ;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Transports
+
+extern const TRANSPORT_OBJ DRV_CAPTOUCH_I2C_FSL_Transport;         // drv_captouch_i2c_fsl.c
+extern const TRANSPORT_OBJ DRV_CAPTOUCH_I2C_I2CDEV_Transport;      // drv_captouch_i2c_i2cdev.c
+
+void DRV_CAPTOUCH_I2C_SetTransport(const TRANSPORT_OBJ *transport);
+const TRANSPORT_OBJ *DRV_CAPTOUCH_I2C_GetTransport(void);
+
+#endif //DRV_CAPTOUCH_I2C_TRANSPORT_H
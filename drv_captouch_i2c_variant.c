@@ -0,0 +1,130 @@
+/****************************************************************************************
+  I2C Capacitive Touch Driver: Variant
+
+  File Name:
+    drv_captouch_i2c_variant.c
+
+  Summary:
+    Controller family table and read plans.
+
+  Description:
+    The identity registers come from the shadow after the first read, detection
+    costs no bus time after boot. DRV_CAPTOUCH_I2C_Init detects the variant, the
+    asynchronous boot identifies it from the registers its identify burst read.
+ ***************************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include "drv_captouch_i2c.h"
+#include "drv_captouch_i2c_variant.h"
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Types
+
+typedef struct
+{
+    uint8_t     cipher;
+    VARIANT_ID  id;
+} VARIANT_CIPHER_OBJ;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Variables
+
+static const char *const variantName[VARIANTS] = {
+    "generic", "ft5x06", "ft5x16", "ft5x46", "ft6x06"
+};
+
+static const uint8_t variantTouches[VARIANTS] = {
+    [VARIANT_GENERIC]   = 5,
+    [VARIANT_FT5X06]    = 5,
+    [VARIANT_FT5X16]    = 5,
+    [VARIANT_FT5X46]    = 10,
+    [VARIANT_FT6X06]    = 2,
+};
+
+static const VARIANT_CIPHER_OBJ variantCipher[] = {
+    { VARIANT_CIPHER_FT5X06,    VARIANT_FT5X06 },
+    { VARIANT_CIPHER_FT5606,    VARIANT_FT5X06 },
+    { VARIANT_CIPHER_FT5X16,    VARIANT_FT5X16 },
+    { VARIANT_CIPHER_FT5X46,    VARIANT_FT5X46 },
+    { VARIANT_CIPHER_FT6X06,    VARIANT_FT6X06 },
+    { VARIANT_CIPHER_FT6X36,    VARIANT_FT6X06 },
+};
+
+static VARIANT_OBJ variant;
+static bool variantSelected = false;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Variant Functions
+
+void DRV_CAPTOUCH_I2C_VARIANT_Select(VARIANT_ID id)
+{
+    if(id >= VARIANTS)
+        id = VARIANT_GENERIC;
+
+    variant.id = id;
+    variant.name = variantName[id];
+    variant.max_touches = variantTouches[id];
+
+    variantSelected = true;
+}
+
+void DRV_CAPTOUCH_I2C_VARIANT_Identify(uint8_t cipher, uint8_t firmware_id, uint16_t lib_version)
+{
+    VARIANT_ID id = VARIANT_GENERIC;
+
+    for(uint8_t i = 0; i < sizeof(variantCipher) / sizeof(variantCipher[0]); i++){
+        if(variantCipher[i].cipher == cipher){
+            id = variantCipher[i].id;
+            break;
+        }
+    }
+
+    DRV_CAPTOUCH_I2C_VARIANT_Select(id);
+    variant.cipher = cipher;
+    variant.firmware_id = firmware_id;
+    variant.lib_version = lib_version;
+}
+
+int8_t DRV_CAPTOUCH_I2C_VARIANT_Detect(void)
+{
+    uint8_t cipher, firmware_id;
+    uint16_t lib_version;
+    int8_t error = 0;
+
+    error = DRV_CAPTOUCH_I2C_GetCipher(&cipher);
+    if(error){
+        return error;
+    }
+
+    error = DRV_CAPTOUCH_I2C_GetFirmwareID(&firmware_id);
+    if(error){
+        return error;
+    }
+
+    error = DRV_CAPTOUCH_I2C_GetLibVersion(&lib_version);
+    if(error){
+        return error;
+    }
+
+    DRV_CAPTOUCH_I2C_VARIANT_Identify(cipher, firmware_id, lib_version);
+
+    return error;
+}
+
+const VARIANT_OBJ *DRV_CAPTOUCH_I2C_VARIANT_Get(void)
+{
+    if(!variantSelected)
+        DRV_CAPTOUCH_I2C_VARIANT_Select(VARIANT_GENERIC);
+
+    return &variant;
+}
@@ -0,0 +1,78 @@
+/****************************************************************************************
+  I2C Capacitive Touch Driver: Variant Header File
+
+  File Name:
+    drv_captouch_i2c_variant.h
+
+  Summary:
+    This header file provides the runtime detection of the controller variant.
+
+  Description:
+    OP_REG_CIPHER tells the FocalTech families apart, LIBVERSION and FIRMID are
+    kept for the production log. The families share the register layout, only
+    the number of contact records DRV_CAPTOUCH_I2C_GetFrame reads differs, so
+    one image runs on every part of a mixed bill of materials.
+ ***************************************************************************************/
+
+
+#ifndef DRV_CAPTOUCH_I2C_VARIANT_H
+#define DRV_CAPTOUCH_I2C_VARIANT_H
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "drv_captouch_i2c_defines.h"
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Defines
+
+#define VARIANT_CIPHER_FT5X06       0x55
+#define VARIANT_CIPHER_FT5606       0x08
+#define VARIANT_CIPHER_FT5X16       0x0A
+#define VARIANT_CIPHER_FT5X46       0x54
+#define VARIANT_CIPHER_FT6X06       0x06
+#define VARIANT_CIPHER_FT6X36       0x36
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Types
+
+/* Controller Families */
+typedef enum {
+    VARIANT_GENERIC     = 0x00,     // unknown cipher, five records like the FT5x06
+    VARIANT_FT5X06,
+    VARIANT_FT5X16,
+    VARIANT_FT5X46,
+    VARIANT_FT6X06,
+    VARIANTS
+} VARIANT_ID;
+
+/* Detected Controller */
+typedef struct
+{
+    VARIANT_ID          id;
+    const char          *name;
+    uint8_t             cipher;
+    uint8_t             firmware_id;
+    uint16_t            lib_version;
+    uint8_t             max_touches;
+} VARIANT_OBJ;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Variant Functions
+
+int8_t DRV_CAPTOUCH_I2C_VARIANT_Detect(void);
+void DRV_CAPTOUCH_I2C_VARIANT_Select(VARIANT_ID id);
+void DRV_CAPTOUCH_I2C_VARIANT_Identify(uint8_t cipher, uint8_t firmware_id, uint16_t lib_version);
+const VARIANT_OBJ *DRV_CAPTOUCH_I2C_VARIANT_Get(void);
+
+#endif //DRV_CAPTOUCH_I2C_VARIANT_H
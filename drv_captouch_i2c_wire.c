@@ -0,0 +1,207 @@
+/****************************************************************************************
+  I2C Capacitive Touch Driver: Wire Format
+
+  File Name:
+    drv_captouch_i2c_wire.c
+
+  Summary:
+    Encoder and decoder of the compact touch frame format.
+
+  Description:
+    A contact that did not move costs one byte, a typical moving contact three.
+    The encoder never emits a frame it could not decode itself: both sides
+    update the per-id state with exactly the values carried by the frame.
+ ***************************************************************************************/
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include <string.h>
+#include "drv_captouch_i2c.h"
+#include "drv_captouch_i2c_wire.h"
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Local Functions
+
+static uint32_t WIRE_ZigZag(int32_t v)
+{
+    return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+static int32_t WIRE_UnZigZag(uint32_t v)
+{
+    return (int32_t)(v >> 1) ^ -(int32_t)(v & 1);
+}
+
+static uint8_t *WIRE_PutVarint(uint8_t *dst, uint32_t v)
+{
+    while(v >= 0x80){
+        *dst++ = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    *dst++ = (uint8_t)v;
+
+    return dst;
+}
+
+static bool WIRE_GetVarint(const uint8_t **src, const uint8_t *end, uint32_t *v)
+{
+    uint32_t value = 0;
+
+    for(uint8_t shift = 0; shift < 35; shift += 7){
+        uint8_t b;
+
+        if(*src >= end)
+            return false;
+
+        b = *(*src)++;
+        value |= (uint32_t)(b & 0x7F) << shift;
+        if(!(b & 0x80)){
+            *v = value;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static void WIRE_Reset(WIRE_OBJ *w)
+{
+    memset(w->x, 0, sizeof(w->x));
+    memset(w->y, 0, sizeof(w->y));
+    w->timestamp = 0;
+    w->since_key = 0;
+}
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Wire Functions
+
+void DRV_CAPTOUCH_I2C_WIRE_Init(WIRE_OBJ *w, uint16_t keyframe_interval)
+{
+    WIRE_Reset(w);
+    w->valid = false;
+    w->force_key = true;
+    w->keyframe_interval = keyframe_interval;
+}
+
+void DRV_CAPTOUCH_I2C_WIRE_ForceKeyframe(WIRE_OBJ *w)
+{
+    w->force_key = true;
+}
+
+int8_t DRV_CAPTOUCH_I2C_WIRE_Encode(WIRE_OBJ *w, uint32_t timestamp, const POINT_OBJ *point, uint8_t n,
+                                    uint8_t *buf, uint16_t size, uint16_t *len)
+{
+    uint8_t *dst = buf;
+    bool key;
+
+    if(n > MAX_TOUCHES)
+        return ERR_ARGUMENT;
+
+    // Worst case, checked once instead of per byte
+    if(size < WIRE_MAX_FRAME_SIZE)
+        return ERR_OVERFLOW;
+
+    key = w->force_key || (w->keyframe_interval && w->since_key >= w->keyframe_interval);
+    if(key){
+        WIRE_Reset(w);
+        w->force_key = false;
+    }
+
+    *dst++ = (WIRE_VERSION << 5) | (key ? WIRE_HEADER_KEY : 0) | n;
+    dst = WIRE_PutVarint(dst, key ? timestamp : timestamp - w->timestamp);
+    w->timestamp = timestamp;
+
+    for(uint8_t i = 0; i < n; i++){
+        uint8_t id = point[i].id & (WIRE_IDS - 1);
+        int32_t dx = (int32_t)point[i].x - w->x[id];
+        int32_t dy = (int32_t)point[i].y - w->y[id];
+
+        *dst++ = (id << 4) | ((point[i].event_flag & 0x03) << 2) | (dy ? WIRE_CONTACT_DY : 0) | (dx ? WIRE_CONTACT_DX : 0);
+        if(dx)
+            dst = WIRE_PutVarint(dst, WIRE_ZigZag(dx));
+        if(dy)
+            dst = WIRE_PutVarint(dst, WIRE_ZigZag(dy));
+
+        w->x[id] = point[i].x;
+        w->y[id] = point[i].y;
+    }
+
+    w->since_key++;
+    *len = (uint16_t)(dst - buf);
+
+    return ERR_NONE;
+}
+
+int8_t DRV_CAPTOUCH_I2C_WIRE_Decode(WIRE_OBJ *w, const uint8_t *buf, uint16_t len, uint32_t *timestamp,
+                                    POINT_OBJ *point, uint8_t *n, uint16_t *used)
+{
+    const uint8_t *src = buf;
+    const uint8_t *end = buf + len;
+    uint32_t v;
+    uint8_t header, count;
+
+    if(len < 2)
+        return ERR_FORMAT;
+
+    header = *src++;
+    count = header & WIRE_HEADER_COUNT;
+    if((header >> 5) != WIRE_VERSION || count > MAX_TOUCHES)
+        return ERR_FORMAT;
+
+    if(header & WIRE_HEADER_KEY){
+        WIRE_Reset(w);
+        w->valid = true;
+    }else if(!w->valid){
+        // Deltas without a reference, wait for the next keyframe
+        return ERR_FORMAT;
+    }
+
+    if(!WIRE_GetVarint(&src, end, &v))
+        goto corrupt;
+    w->timestamp = (header & WIRE_HEADER_KEY) ? v : w->timestamp + v;
+
+    for(uint8_t i = 0; i < count; i++){
+        uint8_t contact, id;
+
+        if(src >= end)
+            goto corrupt;
+
+        contact = *src++;
+        id = contact >> 4;
+
+        if(contact & WIRE_CONTACT_DX){
+            if(!WIRE_GetVarint(&src, end, &v))
+                goto corrupt;
+            w->x[id] += WIRE_UnZigZag(v);
+        }
+        if(contact & WIRE_CONTACT_DY){
+            if(!WIRE_GetVarint(&src, end, &v))
+                goto corrupt;
+            w->y[id] += WIRE_UnZigZag(v);
+        }
+
+        point[i].event_flag = (contact >> 2) & 0x03;
+        point[i].id = id;
+        point[i].x = w->x[id];
+        point[i].y = w->y[id];
+    }
+
+    *timestamp = w->timestamp;
+    *n = count;
+    *used = (uint16_t)(src - buf);
+
+    return ERR_NONE;
+
+corrupt:
+    // The state may be half updated, resynchronize on the next keyframe
+    w->valid = false;
+
+    return ERR_FORMAT;
+}
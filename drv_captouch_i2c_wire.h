@@ -0,0 +1,81 @@
+/****************************************************************************************
+  I2C Capacitive Touch Driver: Wire Format Header File
+
+  File Name:
+    drv_captouch_i2c_wire.h
+
+  Summary:
+    This header file provides the compact touch frame encoding.
+
+  Description:
+    Delta encoding of decoded frames for UART, RPMsg or log files. Encoder and
+    decoder keep the same per-slot state, a keyframe resets it so a receiver
+    can join or resynchronize a stream at any keyframe.
+ ***************************************************************************************/
+
+
+#ifndef DRV_CAPTOUCH_I2C_WIRE_H
+#define DRV_CAPTOUCH_I2C_WIRE_H
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "drv_captouch_i2c_defines.h"
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Defines
+
+/*
+ * Frame layout:
+ *   header   | version:3 key:1 count:4 |
+ *   time     | varint, absolute on keyframes, else delta to the previous frame |
+ *   contact  | id:4 event:2 dy:1 dx:1 | zigzag varint dx | zigzag varint dy |  x count
+ * dx/dy are only present when their bit is set and are relative to the last
+ * position sent for the same id (0 after a keyframe). Timestamps are in the
+ * caller's unit, coarse units (us, ms) keep the varints short.
+ */
+#define WIRE_VERSION                1
+#define WIRE_HEADER_KEY             0x10
+#define WIRE_HEADER_COUNT           0x0F
+#define WIRE_CONTACT_DX             0x01
+#define WIRE_CONTACT_DY             0x02
+#define WIRE_IDS                    16
+#define WIRE_MAX_FRAME_SIZE         (1 + 5 + MAX_TOUCHES * (1 + 3 + 3))
+#define WIRE_KEYFRAME_INTERVAL      64      // frames between keyframes, 0 only the first
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Types
+
+/* Encoder or Decoder State */
+typedef struct
+{
+    bool        valid;              // decoder: a keyframe was seen
+    bool        force_key;          // encoder: next frame is a keyframe
+    uint16_t    keyframe_interval;
+    uint16_t    since_key;
+    uint32_t    timestamp;
+    uint16_t    x[WIRE_IDS];
+    uint16_t    y[WIRE_IDS];
+} WIRE_OBJ;
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Wire Functions
+
+void DRV_CAPTOUCH_I2C_WIRE_Init(WIRE_OBJ *w, uint16_t keyframe_interval);
+void DRV_CAPTOUCH_I2C_WIRE_ForceKeyframe(WIRE_OBJ *w);
+int8_t DRV_CAPTOUCH_I2C_WIRE_Encode(WIRE_OBJ *w, uint32_t timestamp, const POINT_OBJ *point, uint8_t n,
+                                    uint8_t *buf, uint16_t size, uint16_t *len);
+int8_t DRV_CAPTOUCH_I2C_WIRE_Decode(WIRE_OBJ *w, const uint8_t *buf, uint16_t len, uint32_t *timestamp,
+                                    POINT_OBJ *point, uint8_t *n, uint16_t *used);
+
+#endif //DRV_CAPTOUCH_I2C_WIRE_H